@@ -122,6 +122,9 @@ void dense_qp_qpoases_opts_initialize_default(void *config_, dense_qp_dims *dims
     opts->set_acado_opts = 1;
     opts->compute_t = 1;
     opts->tolerance = 1e-4;
+    opts->hotstart_reuse = 1;
+    opts->warm_start_shift_nv = 0;
+    opts->warm_start_shift_ng = 0;
 
     return;
 }
@@ -190,6 +193,21 @@ void dense_qp_qpoases_opts_set(void *config_, void *opts_, const char *field, vo
         int *max_iter = value;
         opts->max_nwsr = *max_iter;
     }
+    else if (!strcmp(field, "hotstart_reuse"))
+    {
+        int *tmp_ptr = value;
+        opts->hotstart_reuse = *tmp_ptr;
+    }
+    else if (!strcmp(field, "warm_start_shift_nv"))
+    {
+        int *tmp_ptr = value;
+        opts->warm_start_shift_nv = *tmp_ptr;
+    }
+    else if (!strcmp(field, "warm_start_shift_ng"))
+    {
+        int *tmp_ptr = value;
+        opts->warm_start_shift_ng = *tmp_ptr;
+    }
     else
     {
         printf("\nerror: dense_qp_qpoases_opts_set: wrong field: %s\n", field);
@@ -242,6 +260,8 @@ acados_size_t dense_qp_qpoases_memory_calculate_size(void *config_, dense_qp_dim
     size += 1 * ns * sizeof(int);              // idxs
     size += 1 * nv2 * sizeof(double);          // prim_sol
     size += 1 * (nv2 + ng2) * sizeof(double);  // dual_sol
+    size += 1 * nv2 * nv2 * sizeof(double);    // H_prev
+    size += 1 * nv2 * ng2 * sizeof(double);    // C_prev
     size += 6 * ns * sizeof(double);           // Zl, Zu, zl, zu, d_ls, d_us
 
     if (ns > 0)
@@ -326,6 +346,8 @@ void *dense_qp_qpoases_memory_assign(void *config_, dense_qp_dims *dims, void *o
     assign_and_advance_double(ns, &mem->zu, &c_ptr);
     assign_and_advance_double(nv2, &mem->prim_sol, &c_ptr);
     assign_and_advance_double(nv2 + ng2, &mem->dual_sol, &c_ptr);
+    assign_and_advance_double(nv2 * nv2, &mem->H_prev, &c_ptr);
+    assign_and_advance_double(nv2 * ng2, &mem->C_prev, &c_ptr);
 
     // TODO(dimitris): update assign syntax in qpOASES
     assert((size_t) c_ptr % 8 == 0 && "double not 8-byte aligned!");
@@ -350,6 +372,8 @@ void *dense_qp_qpoases_memory_assign(void *config_, dense_qp_dims *dims, void *o
 
     // assign default values to fields stored in the memory
     mem->first_it = 1;  // only used if hotstart (only constant data matrices) is enabled
+    mem->prev_status = -1;
+    mem->num_hotstarts = 0;
 
     return mem;
 }
@@ -371,6 +395,11 @@ void dense_qp_qpoases_memory_get(void *config_, void *mem_, const char *field, v
         int *tmp_ptr = value;
         *tmp_ptr = mem->iter;
     }
+    else if (!strcmp(field, "num_hotstarts"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->num_hotstarts;
+    }
     else
     {
         printf("\nerror: dense_qp_qpoases_memory_get: field %s not available\n", field);
@@ -398,6 +427,26 @@ acados_size_t dense_qp_qpoases_workspace_calculate_size(void *config_, dense_qp_
  * functions
  ************************************************/
 
+// shift the entries of v by shift towards higher (shift > 0) or lower (shift < 0) indices,
+// the vacated entries keep their value (i.e. the boundary block is duplicated)
+static void shift_multipliers(int n, int shift, double *v)
+{
+    int ii;
+
+    if (shift > 0)
+    {
+        for (ii = n - 1; ii >= shift; ii--)
+            v[ii] = v[ii - shift];
+    }
+    else if (shift < 0)
+    {
+        for (ii = 0; ii < n + shift; ii++)
+            v[ii] = v[ii - shift];
+    }
+}
+
+
+
 int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, void *opts_,
                      void *memory_, void *work_)
 {
@@ -501,6 +550,41 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
     // extract R
     // blasfeo_unpack_dmat(nvd, nvd, sR, 0, 0, R, nvd);
 
+    // data matrices as passed to qpOASES
+    double *H_qp = (ns > 0) ? HH : H;
+    double *C_qp = (ns > 0) ? CC : C;
+
+    // the QProblem of the previous call is reused by a hot start if the data matrices did not
+    // change, e.g. with frozen sensitivities or a constant Hessian and no general constraints
+    int reuse_qp = 0;
+    if (opts->warm_start && !opts->hotstart && opts->hotstart_reuse &&
+        opts->use_precomputed_cholesky == 0 && opts->warm_start_shift_nv == 0 &&
+        opts->warm_start_shift_ng == 0 && memory->prev_status == SUCCESSFUL_RETURN)
+    {
+        reuse_qp = !memcmp(H_qp, memory->H_prev, nv2 * nv2 * sizeof(double));
+        if (ng > 0 || ns > 0)
+            reuse_qp = reuse_qp && !memcmp(C_qp, memory->C_prev, nv2 * ng2 * sizeof(double));
+    }
+    if (opts->hotstart_reuse && !reuse_qp)
+    {
+        memcpy(memory->H_prev, H_qp, nv2 * nv2 * sizeof(double));
+        if (ng > 0 || ns > 0)
+            memcpy(memory->C_prev, C_qp, nv2 * ng2 * sizeof(double));
+    }
+
+    // shift the primal and dual solution of the previous call, from which qpOASES guesses the
+    // working set; the shifted primal solution is passed along as initial guess, so that the
+    // guess stays consistent with the shifted multipliers
+    double *prim_guess = NULL;
+    if (opts->warm_start && !opts->hotstart && memory->prev_status != -1 &&
+        (opts->warm_start_shift_nv != 0 || opts->warm_start_shift_ng != 0))
+    {
+        shift_multipliers(nv, opts->warm_start_shift_nv, prim_sol);
+        shift_multipliers(nv, opts->warm_start_shift_nv, dual_sol);
+        shift_multipliers(ng, opts->warm_start_shift_ng, dual_sol + nv2);
+        prim_guess = prim_sol;
+    }
+
     info->interface_time = acados_toc(&interface_timer);
     acados_tic(&qp_timer);
 
@@ -509,7 +593,27 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
     double cputime = opts->max_cputime;
 
     int qpoases_status = 0;
-    if (opts->hotstart == 1)
+    if (reuse_qp)
+    {
+        if (ng > 0 || ns > 0)
+        {  // QProblem
+            qpoases_status = (ns > 0) ?
+                QProblem_hotstart(QP, gg, d_lb, d_ub, d_lg, d_ug, &nwsr, &cputime) :
+                QProblem_hotstart(QP, g, d_lb, d_ub, d_lg0, d_ug0, &nwsr, &cputime);
+
+            QProblem_getPrimalSolution(QP, prim_sol);
+            QProblem_getDualSolution(QP, dual_sol);
+        }
+        else
+        {  // QProblemB
+            qpoases_status = QProblemB_hotstart(QPB, g, d_lb, d_ub, &nwsr, &cputime);
+
+            QProblemB_getPrimalSolution(QPB, prim_sol);
+            QProblemB_getDualSolution(QPB, dual_sol);
+        }
+        memory->num_hotstarts++;
+    }
+    else if (opts->hotstart == 1)
     {  // only to be used with fixed data matrices!
         if (ng > 0 || ns > 0)
         {  // QProblem
@@ -614,10 +718,11 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
                 {
                     qpoases_status = (ns > 0) ?
                         QProblem_initW(QP, HH, gg, CC, d_lb, d_ub, d_lg, d_ug, &nwsr, &cputime,
-                                      /* primal_sol */ NULL, dual_sol, /* guessed bounds */ NULL,
+                                      /* primal_sol */ prim_guess, dual_sol,
+                                      /* guessed bounds */ NULL,
                                       /* guessed constraints */ NULL, /* R */ NULL) :
                         QProblem_initW(QP, H, g, C, d_lb, d_ub, d_lg0, d_ug0, &nwsr,
-                                       &cputime, NULL, dual_sol, NULL, NULL, NULL);
+                                       &cputime, prim_guess, dual_sol, NULL, NULL, NULL);
                 }
                 else
                 {
@@ -659,7 +764,8 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
                 if (opts->warm_start)
                 {
                     qpoases_status = QProblemB_initW(QPB, H, g, d_lb, d_ub, &nwsr, &cputime,
-                                                     /* primal sol */ NULL, /* dual sol */ dual_sol,
+                                                     /* primal sol */ prim_guess,
+                                                     /* dual sol */ dual_sol,
                                                      /* guessed bounds */ NULL,
                                                      /* R */ NULL);
                 }
@@ -676,6 +782,7 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
     // save solution statistics to memory
     memory->cputime = cputime;
     memory->nwsr = nwsr;
+    memory->prev_status = qpoases_status;
     info->solve_QP_time = acados_toc(&qp_timer);
 
     acados_tic(&interface_timer);
@@ -57,6 +57,10 @@ typedef struct dense_qp_qpoases_opts_
     int set_acado_opts;  // use same options as in acado code generation
     int compute_t;       // compute t in qp_out (to have correct residuals in NLP)
     double tolerance;  // terminationTolerance
+    int hotstart_reuse;  // hot start from the previous call if the data matrices did not change
+    int warm_start_shift_nv;  // shift of the primal solution and bound multipliers before warm
+                              // starting (e.g. by one stage in RTI)
+    int warm_start_shift_ng;  // shift of the general constraint multipliers before warm starting
 } dense_qp_qpoases_opts;
 
 typedef struct dense_qp_qpoases_memory_
@@ -89,6 +93,9 @@ typedef struct dense_qp_qpoases_memory_
     int *idxs;
     double *prim_sol;
     double *dual_sol;
+    double *H_prev;  // data matrices of the previous call, to detect when a hot start is possible
+    double *C_prev;
+    int prev_status;  // qpOASES return value of the previous call
     void *QPB;       // NOTE(giaf): cast to QProblemB to use
     void *QP;        // NOTE(giaf): cast to QProblem to use
     double cputime;  // cputime of qpoases
@@ -97,6 +104,7 @@ typedef struct dense_qp_qpoases_memory_
     dense_qp_in *qp_stacked;
     double time_qp_solver_call; // equal to cputime
     int iter;
+    int num_hotstarts;  // number of calls that reused the factorization of the previous call
 
 } dense_qp_qpoases_memory;
 
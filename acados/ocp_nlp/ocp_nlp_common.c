@@ -47,6 +47,7 @@
 // acados
 #include "acados/utils/mem.h"
 #include "acados/utils/print.h"
+#include "acados/utils/timing.h"
 // openmp
 #if defined(ACADOS_WITH_OPENMP)
 #include <omp.h>
@@ -651,6 +652,26 @@ void ocp_nlp_dims_set_dynamics(void *config_, void *dims_, int stage,
 
 
 
+/************************************************
+ * modify hook
+ ************************************************/
+
+void ocp_nlp_modify_hook_call(ocp_nlp_modify_hook *hook, int stage, const char *field)
+{
+    if (hook->fun)
+        hook->fun(hook->mem, stage, field);
+}
+
+
+
+void ocp_nlp_modify_hook_wait(ocp_nlp_modify_hook *hook)
+{
+    if (hook->wait)
+        hook->wait(hook->mem);
+}
+
+
+
 /************************************************
  * in
  ************************************************/
@@ -734,6 +755,10 @@ ocp_nlp_in *ocp_nlp_in_assign_self(int N, void *raw_memory)
     in->constraints = (void **) c_ptr;
     c_ptr += (N + 1) * sizeof(void *);
 
+    in->modify_hook.fun = NULL;
+    in->modify_hook.wait = NULL;
+    in->modify_hook.mem = NULL;
+
     align_char_to(8, &c_ptr);
 
     return in;
@@ -842,6 +867,10 @@ ocp_nlp_out *ocp_nlp_out_assign(ocp_nlp_config *config, ocp_nlp_dims *dims, void
     ocp_nlp_out *out = (ocp_nlp_out *) c_ptr;
     c_ptr += sizeof(ocp_nlp_out);
 
+    out->modify_hook.fun = NULL;
+    out->modify_hook.wait = NULL;
+    out->modify_hook.mem = NULL;
+
     // blasfeo_struct align
     align_char_to(8, &c_ptr);
 
@@ -908,6 +937,60 @@ ocp_nlp_out *ocp_nlp_out_assign(ocp_nlp_config *config, ocp_nlp_dims *dims, void
 
 
 
+/************************************************
+ * field handle
+ ************************************************/
+
+acados_size_t ocp_nlp_field_handle_calculate_size(int N)
+{
+    acados_size_t size = sizeof(ocp_nlp_field_handle);
+
+    size += (N + 1) * sizeof(struct blasfeo_dvec *);  // vec
+    size += 2 * (N + 1) * sizeof(int);                // offset, size
+
+    size += 8;  // initial align
+    size += 8;  // pointer align
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+ocp_nlp_field_handle *ocp_nlp_field_handle_assign(int N, void *raw_memory)
+{
+    char *c_ptr = (char *) raw_memory;
+
+    // initial align
+    align_char_to(8, &c_ptr);
+
+    ocp_nlp_field_handle *handle = (ocp_nlp_field_handle *) c_ptr;
+    c_ptr += sizeof(ocp_nlp_field_handle);
+
+    handle->N = N;
+    handle->modify_hook = NULL;
+    handle->field[0] = '\0';
+
+    // pointer align
+    align_char_to(8, &c_ptr);
+
+    // vec
+    handle->vec = (struct blasfeo_dvec **) c_ptr;
+    c_ptr += (N + 1) * sizeof(struct blasfeo_dvec *);
+
+    // offset
+    assign_and_advance_int(N + 1, &handle->offset, &c_ptr);
+    // size
+    assign_and_advance_int(N + 1, &handle->size, &c_ptr);
+
+    assert((char *) raw_memory + ocp_nlp_field_handle_calculate_size(N) >= c_ptr);
+
+    return handle;
+}
+
+
+
 /************************************************
  * options
  ************************************************/
@@ -1041,6 +1124,7 @@ void ocp_nlp_opts_initialize_default(void *config_, void *dims_, void *opts_)
     int N = dims->N;
 
     opts->reuse_workspace = 1;
+    opts->num_threads = 1;
 #if defined(ACADOS_WITH_OPENMP)
     #if defined(ACADOS_NUM_THREADS)
     opts->num_threads = ACADOS_NUM_THREADS;
@@ -1054,6 +1138,9 @@ void ocp_nlp_opts_initialize_default(void *config_, void *dims_, void *opts_)
 
     opts->globalization = FIXED_STEP;
     opts->print_level = 0;
+    opts->stage_timings = 0;
+    opts->stage_tasks = 0;
+    opts->dyn_batch_size = 4;
     opts->step_length = 1.0;
     opts->levenberg_marquardt = 0.0;
 
@@ -1064,6 +1151,8 @@ void ocp_nlp_opts_initialize_default(void *config_, void *dims_, void *opts_)
 
     // regularization
     regularize->opts_initialize_default(regularize, dims->regularize, opts->regularize);
+    regularize->opts_set(regularize, dims->regularize, opts->regularize, "num_threads",
+                         &opts->num_threads);
 
     // dynamics
     for (int i = 0; i < N; i++)
@@ -1089,6 +1178,8 @@ void ocp_nlp_opts_initialize_default(void *config_, void *dims_, void *opts_)
     opts->full_step_dual = 0;
     opts->line_search_use_sufficient_descent = 0;
     opts->globalization_use_SOC = 0;
+    opts->filter_gamma_theta = 1e-5;  // Waechter2006
+    opts->filter_gamma_phi = 1e-8;
     opts->eps_sufficient_descent = 1e-4; // Leineweber1999: MUSCOD-I eps_T = 1e-4 (p.89); Note: eps_T = 0.1 originally proposed by Powell 1978 (Leineweber 1999, p. 53)
 
     return;
@@ -1160,6 +1251,12 @@ void ocp_nlp_opts_set(void *config_, void *opts_, const char *field, void* value
         config->qp_solver->opts_set(config->qp_solver, opts->qp_solver_opts,
                                     field+module_length+1, value);
     }
+    // pass options to regularization module
+    else if ( ptr_module!=NULL && (!strcmp(ptr_module, "reg")) )
+    {
+        config->regularize->opts_set(config->regularize, NULL, opts->regularize,
+                                     (char *) field+module_length+1, value);
+    }
     else // nlp opts
     {
         if (!strcmp(field, "reuse_workspace"))
@@ -1171,6 +1268,23 @@ void ocp_nlp_opts_set(void *config_, void *opts_, const char *field, void* value
         {
             int* num_threads = (int *) value;
             opts->num_threads = *num_threads;
+            config->regularize->opts_set(config->regularize, NULL, opts->regularize,
+                                         "num_threads", value);
+        }
+        else if (!strcmp(field, "stage_timings"))
+        {
+            int* stage_timings = (int *) value;
+            opts->stage_timings = *stage_timings;
+        }
+        else if (!strcmp(field, "stage_tasks"))
+        {
+            int* stage_tasks = (int *) value;
+            opts->stage_tasks = *stage_tasks;
+        }
+        else if (!strcmp(field, "dyn_batch_size"))
+        {
+            int* dyn_batch_size = (int *) value;
+            opts->dyn_batch_size = *dyn_batch_size;
         }
         else if (!strcmp(field, "step_length"))
         {
@@ -1202,6 +1316,16 @@ void ocp_nlp_opts_set(void *config_, void *opts_, const char *field, void* value
             int* line_search_use_sufficient_descent = (int *) value;
             opts->line_search_use_sufficient_descent = *line_search_use_sufficient_descent;
         }
+        else if (!strcmp(field, "filter_gamma_theta"))
+        {
+            double* filter_gamma_theta = (double *) value;
+            opts->filter_gamma_theta = *filter_gamma_theta;
+        }
+        else if (!strcmp(field, "filter_gamma_phi"))
+        {
+            double* filter_gamma_phi = (double *) value;
+            opts->filter_gamma_phi = *filter_gamma_phi;
+        }
         else if (!strcmp(field, "globalization_use_SOC"))
         {
             int* globalization_use_SOC = (int *) value;
@@ -1218,6 +1342,10 @@ void ocp_nlp_opts_set(void *config_, void *opts_, const char *field, void* value
             {
                 opts->globalization = MERIT_BACKTRACKING;
             }
+            else if (!strcmp(globalization, "filter_line_search"))
+            {
+                opts->globalization = FILTER_LINE_SEARCH;
+            }
             else
             {
                 printf("\nerror: ocp_nlp_opts_set: not supported value for globalization, got: %s\n",
@@ -1352,7 +1480,6 @@ acados_size_t ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims
 
     // extract dims
     int N = dims->N;
-    int *nv = dims->nv;
     int *nx = dims->nx;
     int *nz = dims->nz;
     int *nu = dims->nu;
@@ -1400,13 +1527,16 @@ acados_size_t ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims
 
     size += (N+1)*sizeof(struct blasfeo_dmat); // dzduxt
     size += 6*(N+1)*sizeof(struct blasfeo_dvec);  // cost_grad ineq_fun ineq_adj dyn_adj sim_guess z_alg
+    // NOTE: cost_grad and ineq_adj alias the module memories, only their structs are allocated here
     size += 1*N*sizeof(struct blasfeo_dvec);        // dyn_fun
 
+    size += 3*(N+1)*sizeof(double);  // time_lin_dyn time_lin_cost time_lin_constr
+    size += OCP_NLP_LATENCY_HIST_SIZE*sizeof(int);  // latency_hist
+
     for (int i = 0; i < N; i++)
     {
         size += 1*blasfeo_memsize_dmat(nu[i]+nx[i], nz[i]); // dzduxt
         size += 1*blasfeo_memsize_dvec(nz[i]); // z_alg
-        size += 2*blasfeo_memsize_dvec(nv[i]);           // cost_grad ineq_adj
         size += 1*blasfeo_memsize_dvec(nu[i] + nx[i]);  // dyn_adj
         size += 1*blasfeo_memsize_dvec(nx[i + 1]);       // dyn_fun
         size += 1*blasfeo_memsize_dvec(2 * ni[i]);       // ineq_fun
@@ -1414,7 +1544,6 @@ acados_size_t ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims
     }
     size += 1*blasfeo_memsize_dmat(nu[N]+nx[N], nz[N]); // dzduxt
     size += 1*blasfeo_memsize_dvec(nz[N]); // z_alg
-    size += 2*blasfeo_memsize_dvec(nv[N]);          // cost_grad ineq_adj
     size += 1*blasfeo_memsize_dvec(nu[N] + nx[N]);  // dyn_adj
     size += 1*blasfeo_memsize_dvec(2 * ni[N]);      // ineq_fun
     size += 1*blasfeo_memsize_dvec(nx[N] + nz[N]);  // sim_guess
@@ -1440,7 +1569,6 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
 
     // extract sizes
     int N = dims->N;
-    int *nv = dims->nv;
     int *nx = dims->nx;
     int *nz = dims->nz;
     int *nu = dims->nu;
@@ -1538,6 +1666,15 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
     // sim_guess
     assign_and_advance_blasfeo_dvec_structs(N + 1, &mem->sim_guess, &c_ptr);
 
+    // timings
+    assign_and_advance_double(N+1, &mem->time_lin_dyn, &c_ptr);
+    assign_and_advance_double(N+1, &mem->time_lin_cost, &c_ptr);
+    assign_and_advance_double(N+1, &mem->time_lin_constr, &c_ptr);
+    assign_and_advance_int(OCP_NLP_LATENCY_HIST_SIZE, &mem->latency_hist, &c_ptr);
+    ocp_nlp_timings_reset(dims, mem);
+    for (int i = 0; i < OCP_NLP_LATENCY_HIST_SIZE; i++)
+        mem->latency_hist[i] = 0;
+
     // set_sim_guess
     assign_and_advance_bool(N+1, &mem->set_sim_guess, &c_ptr);
     for (int i = 0; i <= N; ++i)
@@ -1560,20 +1697,20 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
         c_ptr += blasfeo_memsize_dvec(nz[i]);
     }
 
-    // cost_grad
+    // cost_grad: alias to the cost module memory (only written in update_qp_matrices)
     for (int i = 0; i <= N; i++)
     {
-        assign_and_advance_blasfeo_dvec_mem(nv[i], mem->cost_grad + i, &c_ptr);
+        mem->cost_grad[i] = *cost[i]->memory_get_grad_ptr(mem->cost[i]);
     }
     // ineq_fun
     for (int i = 0; i <= N; i++)
     {
         assign_and_advance_blasfeo_dvec_mem(2 * ni[i], mem->ineq_fun + i, &c_ptr);
     }
-    // ineq_adj
+    // ineq_adj: alias to the constraints module memory (only written in update_qp_matrices)
     for (int i = 0; i <= N; i++)
     {
-        assign_and_advance_blasfeo_dvec_mem(nv[i], mem->ineq_adj + i, &c_ptr);
+        mem->ineq_adj[i] = *constraints[i]->memory_get_adj_ptr(mem->constraints[i]);
     }
     // dyn_fun
     for (int i = 0; i < N; i++)
@@ -1600,6 +1737,75 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
 
 
 
+void ocp_nlp_timings_reset(ocp_nlp_dims *dims, ocp_nlp_memory *mem)
+{
+    for (int i = 0; i <= dims->N; i++)
+    {
+        mem->time_lin_dyn[i] = 0.0;
+        mem->time_lin_cost[i] = 0.0;
+        mem->time_lin_constr[i] = 0.0;
+    }
+}
+
+
+
+void ocp_nlp_timings_add_latency(ocp_nlp_memory *mem, double time)
+{
+    // bin k holds [2^(k-1), 2^k) us
+    double bound = 1e-6;
+    int k = 0;
+    while (time >= bound && k < OCP_NLP_LATENCY_HIST_SIZE-1)
+    {
+        bound *= 2.0;
+        k++;
+    }
+    mem->latency_hist[k]++;
+}
+
+
+
+void ocp_nlp_timings_get(ocp_nlp_dims *dims, ocp_nlp_memory *mem, const char *field, void *value)
+{
+    int N = dims->N;
+
+    if (!strcmp("time_lin_dyn", field))
+    {
+        double *double_values = value;
+        for (int i = 0; i < N; i++)
+            double_values[i] = mem->time_lin_dyn[i];
+    }
+    else if (!strcmp("time_lin_cost", field))
+    {
+        double *double_values = value;
+        for (int i = 0; i <= N; i++)
+            double_values[i] = mem->time_lin_cost[i];
+    }
+    else if (!strcmp("time_lin_constr", field))
+    {
+        double *double_values = value;
+        for (int i = 0; i <= N; i++)
+            double_values[i] = mem->time_lin_constr[i];
+    }
+    else if (!strcmp("latency_hist", field))
+    {
+        int *int_values = value;
+        for (int i = 0; i < OCP_NLP_LATENCY_HIST_SIZE; i++)
+            int_values[i] = mem->latency_hist[i];
+    }
+    else if (!strcmp("latency_hist_size", field))
+    {
+        int *int_value = value;
+        *int_value = OCP_NLP_LATENCY_HIST_SIZE;
+    }
+    else
+    {
+        printf("\nerror: field %s not available in ocp_nlp_timings_get\n", field);
+        exit(1);
+    }
+}
+
+
+
 /************************************************
  * workspace
  ************************************************/
@@ -1916,7 +2122,7 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
          ocp_nlp_out *nlp_out, ocp_nlp_opts *opts, ocp_nlp_memory *nlp_mem, ocp_nlp_workspace *nlp_work)
 {
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel
+    #pragma omp parallel num_threads(opts->num_threads)
     { // beginning of parallel region
 #endif
 
@@ -1924,7 +2130,7 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
 
     // alias to dynamics_memory
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for nowait
+    #pragma omp for schedule(static) nowait
 #endif
     for (int i = 0; i < N; i++)
     {
@@ -1940,15 +2146,9 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
         config->dynamics[i]->memory_set_sim_guess_ptr(nlp_mem->sim_guess+i, nlp_mem->set_sim_guess+i, nlp_mem->dynamics[i]);
         config->dynamics[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, nlp_mem->dynamics[i]);
     }
-#pragma omp parallel for
-    for (int i = 0; i < N; i++)
-    {
-        i+=1;
-    }
-    
     // alias to cost_memory
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for nowait
+    #pragma omp for schedule(static) nowait
 #endif
     for (int i = 0; i <= N; i++)
     {
@@ -1962,7 +2162,7 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
 
     // alias to constraints_memory
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for nowait
+    #pragma omp for schedule(static) nowait
 #endif
     for (int i = 0; i <= N; i++)
     {
@@ -1980,6 +2180,10 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
     }
 
     // alias to regularize memory
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp single nowait
+    {
+#endif
     config->regularize->memory_set_RSQrq_ptr(dims->regularize, nlp_mem->qp_in->RSQrq, nlp_mem->regularize_mem);
     config->regularize->memory_set_rq_ptr(dims->regularize, nlp_mem->qp_in->rqz, nlp_mem->regularize_mem);
     config->regularize->memory_set_BAbt_ptr(dims->regularize, nlp_mem->qp_in->BAbt, nlp_mem->regularize_mem);
@@ -1989,10 +2193,13 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
     config->regularize->memory_set_ux_ptr(dims->regularize, nlp_mem->qp_out->ux, nlp_mem->regularize_mem);
     config->regularize->memory_set_pi_ptr(dims->regularize, nlp_mem->qp_out->pi, nlp_mem->regularize_mem);
     config->regularize->memory_set_lam_ptr(dims->regularize, nlp_mem->qp_out->lam, nlp_mem->regularize_mem);
+#if defined(ACADOS_WITH_OPENMP)
+    }
+#endif
 
     // copy sampling times into dynamics model
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for nowait
+    #pragma omp for schedule(static) nowait
 #endif
     // NOTE(oj): this will lead in an error for irk_gnsf, T must be set in precompute;
     //    -> remove here and make sure precompute is called everywhere (e.g. Python interface).
@@ -2016,7 +2223,7 @@ void ocp_nlp_initialize_qp(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_i
     int N = dims->N;
 
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opts->num_threads) schedule(static)
 #endif
     for (int i = 0; i <= N; i++)
     {
@@ -2047,7 +2254,7 @@ void ocp_nlp_initialize_t_slacks(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp
     int *nu = dims->nu;
 
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opts->num_threads) schedule(static)
 #endif
     for (int i = 0; i <= N; i++)
     {
@@ -2068,105 +2275,341 @@ void ocp_nlp_initialize_t_slacks(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp
 
 
 
-void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
-    ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
-    ocp_nlp_workspace *work)
+// initialization of the Hessian of stage i, before any module adds its contribution
+static void ocp_nlp_approximate_qp_matrices_init_hess(ocp_nlp_dims *dims, ocp_nlp_in *in,
+    ocp_nlp_opts *opts, ocp_nlp_memory *mem, int i)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    // init Hessian to 0 
+    blasfeo_dgese(nu[i] + nx[i], nu[i] + nx[i], 0.0, mem->qp_in->RSQrq+i, 0, 0);
+
+    if (i < N)
+    {
+        // Levenberg Marquardt term: Ts[i] * levenberg_marquardt * eye()
+        if (opts->levenberg_marquardt > 0.0)
+            blasfeo_ddiare(nu[i] + nx[i], in->Ts[i] * opts->levenberg_marquardt,
+                           mem->qp_in->RSQrq+i, 0, 0);
+    }
+    else
+    {
+        // Levenberg Marquardt term: 1.0 * levenberg_marquardt * eye()
+        if (opts->levenberg_marquardt > 0.0)
+            blasfeo_ddiare(nu[i] + nx[i], opts->levenberg_marquardt,
+                           mem->qp_in->RSQrq+i, 0, 0);
+    }
+}
+
+
+
+// linearization of stage i and collection of the stage-wise evaluations;
+// with dyn_done, Hessian init and dynamics of stages i < N were done by a batched call
+static void ocp_nlp_approximate_qp_matrices_stage(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_in *in, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i,
+    int dyn_done)
 {
     int N = dims->N;
-    int *nv = dims->nv;
     int *nx = dims->nx;
     int *nu = dims->nu;
     int *ni = dims->ni;
 
-    /* stage-wise multiple shooting lagrangian evaluation */
+    acados_timer timer;
+    int trace_ev;
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i = 0; i <= N; i++)
+    if (!dyn_done || i == N)
+        ocp_nlp_approximate_qp_matrices_init_hess(dims, in, opts, mem, i);
+
+    if (i < N && !dyn_done)
     {
-        // init Hessian to 0 
-        blasfeo_dgese(nu[i] + nx[i], nu[i] + nx[i], 0.0, mem->qp_in->RSQrq+i, 0, 0);
+        // dynamics
+        if (opts->stage_timings)
+            acados_tic(&timer);
+        trace_ev = acados_trace_begin("dynamics", i);
+        config->dynamics[i]->update_qp_matrices(config->dynamics[i], dims->dynamics[i],
+                in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+        acados_trace_end(trace_ev);
+        if (opts->stage_timings)
+            mem->time_lin_dyn[i] += acados_toc(&timer);
+    }
 
+    // cost
+    if (opts->stage_timings)
+        acados_tic(&timer);
+    trace_ev = acados_trace_begin("cost", i);
+    config->cost[i]->update_qp_matrices(config->cost[i], dims->cost[i], in->cost[i],
+            opts->cost[i], mem->cost[i], work->cost[i]);
+    acados_trace_end(trace_ev);
+    if (opts->stage_timings)
+        mem->time_lin_cost[i] += acados_toc(&timer);
 
-        if (i < N)
-        {
-            // Levenberg Marquardt term: Ts[i] * levenberg_marquardt * eye()
-            if (opts->levenberg_marquardt > 0.0)
-                blasfeo_ddiare(nu[i] + nx[i], in->Ts[i] * opts->levenberg_marquardt,
-                               mem->qp_in->RSQrq+i, 0, 0);
+    // constraints
+    if (opts->stage_timings)
+        acados_tic(&timer);
+    trace_ev = acados_trace_begin("constraints", i);
+    config->constraints[i]->update_qp_matrices(config->constraints[i], dims->constraints[i],
+            in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+    acados_trace_end(trace_ev);
+    if (opts->stage_timings)
+        mem->time_lin_constr[i] += acados_toc(&timer);
 
-            // dynamics
-            config->dynamics[i]->update_qp_matrices(config->dynamics[i], dims->dynamics[i],
-                    in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
-        }
-        else
-        {
-            // Levenberg Marquardt term: 1.0 * levenberg_marquardt * eye()
-            if (opts->levenberg_marquardt > 0.0)
-                blasfeo_ddiare(nu[i] + nx[i], opts->levenberg_marquardt,
-                               mem->qp_in->RSQrq+i, 0, 0);
-        }
+    /* collect stage-wise evaluations, while they are still in cache */
+    // NOTE: cost_grad and ineq_adj alias the module memories, see ocp_nlp_memory_assign
 
-        // cost
-        config->cost[i]->update_qp_matrices(config->cost[i], dims->cost[i], in->cost[i],
-                opts->cost[i], mem->cost[i], work->cost[i]);
+    // nlp mem: dyn_fun, dyn_adj
+    if (i < N)
+    {
+        struct blasfeo_dvec *dyn_fun
+            = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
+        blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
 
-        // constraints
-        config->constraints[i]->update_qp_matrices(config->constraints[i], dims->constraints[i],
-                in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+        struct blasfeo_dvec *dyn_adj
+            = config->dynamics[i]->memory_get_adj_ptr(mem->dynamics[i]);
+        blasfeo_dveccp(nu[i] + nx[i], dyn_adj, 0, mem->dyn_adj + i, 0);
+    }
+    else
+    {
+        blasfeo_dvecse(nu[N] + nx[N], 0.0, mem->dyn_adj + N, 0);
     }
 
-    /* collect stage-wise evaluations */
+    // nlp mem: ineq_fun
+    struct blasfeo_dvec *ineq_fun =
+        config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
+    blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->ineq_fun + i, 0);
+}
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+
+
+// number of stages linearized together by the dynamics modules, 1 if not supported by all stages
+static int ocp_nlp_dynamics_batch_size(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_opts *opts)
+{
+    int N = dims->N;
+
+    if (opts->dyn_batch_size <= 1)
+        return 1;
+
+#if !defined(ACADOS_WITH_OPENMP)
+    // NOTE: the stages of a batch are in flight together and need their own workspace
+    if (opts->reuse_workspace)
+        return 1;
 #endif
-    for (int i=0; i <= N; i++)
+
+    for (int i = 0; i < N; i++)
     {
+        if (config->dynamics[i]->update_qp_matrices_batch == NULL
+            || config->dynamics[i]->sim_solver == NULL
+            || config->dynamics[i]->sim_solver->evaluate_batch == NULL)
+            return 1;
+    }
 
-        // nlp mem: cost_grad
-        struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(mem->cost[i]);
-        blasfeo_dveccp(nv[i], cost_grad, 0, mem->cost_grad + i, 0);
+    return opts->dyn_batch_size < OCP_NLP_DYNAMICS_BATCH_MAX ?
+           opts->dyn_batch_size : OCP_NLP_DYNAMICS_BATCH_MAX;
+}
 
-        // nlp mem: dyn_fun
-        if (i < N)
-        {
-            struct blasfeo_dvec *dyn_fun
-                = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
-            blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
-        }
 
-        // nlp mem: dyn_adj
-        if (i < N)
+
+// dynamics of stages i0, ..., i0+nb-1 in one batched call
+static void ocp_nlp_approximate_qp_matrices_dyn_batch(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_in *in, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i0,
+    int nb)
+{
+    void *dyn_config[OCP_NLP_DYNAMICS_BATCH_MAX];
+    void *dyn_dims[OCP_NLP_DYNAMICS_BATCH_MAX];
+    void *dyn_in[OCP_NLP_DYNAMICS_BATCH_MAX];
+    void *dyn_opts[OCP_NLP_DYNAMICS_BATCH_MAX];
+    void *dyn_mem[OCP_NLP_DYNAMICS_BATCH_MAX];
+    void *dyn_work[OCP_NLP_DYNAMICS_BATCH_MAX];
+
+    acados_timer timer;
+
+    for (int b = 0; b < nb; b++)
+    {
+        int i = i0 + b;
+        ocp_nlp_approximate_qp_matrices_init_hess(dims, in, opts, mem, i);
+
+        dyn_config[b] = config->dynamics[i];
+        dyn_dims[b] = dims->dynamics[i];
+        dyn_in[b] = in->dynamics[i];
+        dyn_opts[b] = opts->dynamics[i];
+        dyn_mem[b] = mem->dynamics[i];
+        dyn_work[b] = work->dynamics[i];
+    }
+
+    if (opts->stage_timings)
+        acados_tic(&timer);
+    int trace_ev = acados_trace_begin("dynamics_batch", i0);
+    config->dynamics[i0]->update_qp_matrices_batch(dyn_config, dyn_dims, dyn_in, dyn_opts,
+                                                   dyn_mem, dyn_work, nb);
+    acados_trace_end(trace_ev);
+    if (opts->stage_timings)
+    {
+        // NOTE: the stages of a batch are not timed separately
+        double time = acados_toc(&timer) / nb;
+        for (int b = 0; b < nb; b++)
+            mem->time_lin_dyn[i0 + b] += time;
+    }
+}
+
+
+
+// external functions of cost and constraints of stages i0, ..., i0+nb-1, evaluated together by
+// runs of stages whose module provides update_qp_matrices_eval_batch
+static void ocp_nlp_approximate_qp_matrices_fun_batch(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_in *in, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i0,
+    int nb)
+{
+    acados_timer timer;
+    int trace_ev;
+    int n;
+
+    // cost
+    for (int i = i0; i < i0 + nb; i += n)
+    {
+        n = 1;
+        if (config->cost[i]->update_qp_matrices_eval_batch == NULL)
+            continue;
+        while (i + n < i0 + nb && config->cost[i + n]->update_qp_matrices_eval_batch
+                                  == config->cost[i]->update_qp_matrices_eval_batch)
+            n++;
+
+        if (opts->stage_timings)
+            acados_tic(&timer);
+        trace_ev = acados_trace_begin("cost_batch", i);
+        config->cost[i]->update_qp_matrices_eval_batch((void **) config->cost + i,
+                dims->cost + i, in->cost + i, opts->cost + i, mem->cost + i, work->cost + i, n);
+        acados_trace_end(trace_ev);
+        if (opts->stage_timings)
         {
-            struct blasfeo_dvec *dyn_adj
-                = config->dynamics[i]->memory_get_adj_ptr(mem->dynamics[i]);
-            blasfeo_dveccp(nu[i] + nx[i], dyn_adj, 0, mem->dyn_adj + i, 0);
+            // NOTE: the stages of a batch are not timed separately
+            double time = acados_toc(&timer) / n;
+            for (int b = 0; b < n; b++)
+                mem->time_lin_cost[i + b] += time;
         }
-        else
+    }
+
+    // constraints
+    for (int i = i0; i < i0 + nb; i += n)
+    {
+        n = 1;
+        if (config->constraints[i]->update_qp_matrices_eval_batch == NULL)
+            continue;
+        while (i + n < i0 + nb && config->constraints[i + n]->update_qp_matrices_eval_batch
+                                  == config->constraints[i]->update_qp_matrices_eval_batch)
+            n++;
+
+        if (opts->stage_timings)
+            acados_tic(&timer);
+        trace_ev = acados_trace_begin("constraints_batch", i);
+        config->constraints[i]->update_qp_matrices_eval_batch((void **) config->constraints + i,
+                dims->constraints + i, in->constraints + i, opts->constraints + i,
+                mem->constraints + i, work->constraints + i, n);
+        acados_trace_end(trace_ev);
+        if (opts->stage_timings)
         {
-            blasfeo_dvecse(nu[N] + nx[N], 0.0, mem->dyn_adj + N, 0);
+            double time = acados_toc(&timer) / n;
+            for (int b = 0; b < n; b++)
+                mem->time_lin_constr[i + b] += time;
         }
-        if (i > 0)
+    }
+}
+
+
+
+void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
+    ocp_nlp_workspace *work)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    int dyn_batch = ocp_nlp_dynamics_batch_size(config, dims, opts);
+    int dyn_done = dyn_batch > 1;
+
+    // stages of cost and constraints evaluated together: one contiguous range per thread
+#if defined(ACADOS_WITH_OPENMP)
+    int n_fun_batches = opts->num_threads < N + 1 ? opts->num_threads : N + 1;
+#else
+    int n_fun_batches = 1;
+#endif
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel num_threads(opts->num_threads)
+    { // beginning of parallel region
+#endif
+
+    /* batched dynamics, consecutive stages in lockstep */
+
+    if (dyn_done)
+    {
+        int n_batches = (N + dyn_batch - 1) / dyn_batch;
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp for schedule(static)
+#endif
+        for (int ib = 0; ib < n_batches; ib++)
         {
-            struct blasfeo_dvec *dyn_adj
-                = config->dynamics[i-1]->memory_get_adj_ptr(mem->dynamics[i-1]);
-            blasfeo_daxpy(nx[i], 1.0, dyn_adj, nu[i-1]+nx[i-1], mem->dyn_adj+i, nu[i],
-                mem->dyn_adj+i, nu[i]);
+            int i0 = ib * dyn_batch;
+            int nb = N - i0 < dyn_batch ? N - i0 : dyn_batch;
+            ocp_nlp_approximate_qp_matrices_dyn_batch(config, dims, in, opts, mem, work, i0, nb);
         }
+    }
 
-        // nlp mem: ineq_fun
-        struct blasfeo_dvec *ineq_fun =
-            config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
-        blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->ineq_fun + i, 0);
+    /* batched external functions of cost and constraints, reused by the stage-wise evaluation */
 
-        // nlp mem: ineq_adj
-        struct blasfeo_dvec *ineq_adj =
-            config->constraints[i]->memory_get_adj_ptr(mem->constraints[i]);
-        blasfeo_dveccp(nv[i], ineq_adj, 0, mem->ineq_adj + i, 0);
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp for schedule(static)
+#endif
+    for (int ib = 0; ib < n_fun_batches; ib++)
+    {
+        int i0 = ib * (N + 1) / n_fun_batches;
+        int i1 = (ib + 1) * (N + 1) / n_fun_batches;
+        ocp_nlp_approximate_qp_matrices_fun_batch(config, dims, in, opts, mem, work, i0, i1 - i0);
+    }
+
+    /* stage-wise multiple shooting lagrangian evaluation */
 
+    if (opts->stage_tasks)
+    {
+        // NOTE: one task per stage, idle threads pick up the remaining stages;
+        // balances stages of uneven cost, e.g. integrators with many steps or refactorizations
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp single
+        #pragma omp taskloop grainsize(1)
+#endif
+        for (int i = 0; i <= N; i++)
+            ocp_nlp_approximate_qp_matrices_stage(config, dims, in, opts, mem, work, i,
+                                                  dyn_done);
     }
+    else
+    {
+        // NOTE: static schedule, such that every stage is evaluated by the same thread in all calls
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp for schedule(static)
+#endif
+        for (int i = 0; i <= N; i++)
+            ocp_nlp_approximate_qp_matrices_stage(config, dims, in, opts, mem, work, i,
+                                                  dyn_done);
+    }
+
+    /* add adjoint of dynamics i-1 to stage i */
+
+    // NOTE: the implicit barrier above is needed, stage i uses the memory of dynamics i-1
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp for schedule(static)
+#endif
+    for (int i = 1; i <= N; i++)
+    {
+        struct blasfeo_dvec *dyn_adj
+            = config->dynamics[i-1]->memory_get_adj_ptr(mem->dynamics[i-1]);
+        blasfeo_daxpy(nx[i], 1.0, dyn_adj, nu[i-1]+nx[i-1], mem->dyn_adj+i, nu[i],
+            mem->dyn_adj+i, nu[i]);
+    }
+
+#if defined(ACADOS_WITH_OPENMP)
+    } // end of parallel region
+#endif
 
     for (int i = 0; i <= N; i++)
     {
@@ -2201,9 +2644,7 @@ void ocp_nlp_approximate_qp_vectors_sqp(ocp_nlp_config *config,
     // int *nu = dims->nu;
     int *ni = dims->ni;
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
+    // NOTE: not parallelized, copies only
     for (int i = 0; i <= N; i++)
     {
         // g
@@ -2424,48 +2865,49 @@ static double ocp_nlp_get_violation(ocp_nlp_config *config, ocp_nlp_dims *dims,
 
 
 
-double ocp_nlp_evaluate_merit_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
-                                  ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
-                                  ocp_nlp_memory *mem, ocp_nlp_workspace *work)
+void ocp_nlp_evaluate_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                          ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
+                          ocp_nlp_memory *mem, ocp_nlp_workspace *work)
 {
-    /* computes merit function value at iterate: tmp_nlp_out, with weights: work->weight_merit_fun */
-    //int j;
-
+    /* computes the function values of all modules at iterate: tmp_nlp_out */
     int N = dims->N;
-    int *nx = dims->nx;
-    int *ni = dims->ni;
-
-    double merit_fun = 0.0;
 
-    // compute fun value
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opts->num_threads) schedule(static)
 #endif
     for (int i=0; i<=N; i++)
     {
         // cost
         config->cost[i]->compute_fun(config->cost[i], dims->cost[i], in->cost[i], opts->cost[i],
                                     mem->cost[i], work->cost[i]);
-    }
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i=0; i<N; i++)
-    {
         // dynamics
-        config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
-                                         opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
-    }
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i=0; i<=N; i++)
-    {
+        if (i < N)
+            config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
+                                             opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
         // constr
         config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
                                             in->constraints[i], opts->constraints[i],
                                             mem->constraints[i], work->constraints[i]);
     }
+}
+
+
+
+double ocp_nlp_evaluate_merit_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                  ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
+                                  ocp_nlp_memory *mem, ocp_nlp_workspace *work)
+{
+    /* computes merit function value at iterate: tmp_nlp_out, with weights: work->weight_merit_fun */
+    //int j;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *ni = dims->ni;
+
+    double merit_fun = 0.0;
+
+    // compute fun value
+    ocp_nlp_evaluate_fun(config, dims, in, out, opts, mem, work);
 
     double *tmp_fun;
     double tmp;
@@ -2722,7 +3164,7 @@ void ocp_nlp_update_variables_sqp(ocp_nlp_config *config, ocp_nlp_dims *dims, oc
 
 
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opts->num_threads) schedule(static)
 #endif
     for (int i = 0; i <= N; i++)
     {
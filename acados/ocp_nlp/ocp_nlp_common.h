@@ -99,6 +99,8 @@ typedef struct ocp_nlp_config
     void (*get)(void *config_, void *dims, void *mem_, const char *field, void *return_value_);
     void (*opts_get)(void *config_, void *dims, void *opts_, const char *field, void *return_value_);
     void (*work_get)(void *config_, void *dims, void *work_, const char *field, void *return_value_);
+    // release resources not owned by the solver memory (e.g. threads), can be NULL
+    void (*terminate)(void *config, void *mem, void *work);
     // config structs of submodules
     ocp_qp_xcond_solver_config *qp_solver; // TODO rename xcond_solver
     ocp_nlp_dynamics_config **dynamics;
@@ -186,6 +188,28 @@ void ocp_nlp_dims_set_cost(void *config_, void *dims_, int stage, const char *fi
 void ocp_nlp_dims_set_dynamics(void *config_, void *dims_, int stage, const char *field,
                                const void* value);
 
+/************************************************
+ * modify hook
+ ************************************************/
+
+/// Hook of an nlp solver which reads the nlp inputs or outputs concurrently to the caller, e.g. the
+/// asynchronous preparation phase of ocp_nlp_sqp_rti. The interface calls it before a field is
+/// modified, with the stage and the name of the field, and with field NULL before the struct is freed.
+/// Getters call wait before a field is read.
+typedef struct ocp_nlp_modify_hook
+{
+    void (*fun)(void *mem, int stage, const char *field);  // NULL if not set
+    void (*wait)(void *mem);  // NULL if not set
+    void *mem;
+} ocp_nlp_modify_hook;
+
+//
+void ocp_nlp_modify_hook_call(ocp_nlp_modify_hook *hook, int stage, const char *field);
+//
+void ocp_nlp_modify_hook_wait(ocp_nlp_modify_hook *hook);
+
+
+
 /************************************************
  * Inputs
  ************************************************/
@@ -205,6 +229,9 @@ typedef struct ocp_nlp_in
     /// Pointers to constraints functions (TBC).
     void **constraints;
 
+    /// Called before a field is modified.
+    ocp_nlp_modify_hook modify_hook;
+
     /// Pointer to allocated memory, to be used for freeing.
     void *raw_memory;
 
@@ -236,6 +263,8 @@ typedef struct ocp_nlp_out
     // [ lbu lbx lg lh lphi ubu ubx ug uh uphi; lsbu lsbx lsg lsh lsphi usbu usbx usg ush usphi]
     double inf_norm_res;
 
+    ocp_nlp_modify_hook modify_hook; // called before a field is modified
+
     void *raw_memory; // Pointer to allocated memory, to be used for freeing
 
 } ocp_nlp_out;
@@ -248,6 +277,30 @@ ocp_nlp_out *ocp_nlp_out_assign(ocp_nlp_config *config, ocp_nlp_dims *dims,
 
 
 
+/************************************************
+ * field handle
+ ************************************************/
+
+/// Vector field of the nlp inputs or outputs over the horizon, resolved once by name to its position
+/// in a blasfeo_dvec of each stage, such that it can be set and read without string comparisons.
+typedef struct ocp_nlp_field_handle
+{
+    int N;
+    struct blasfeo_dvec **vec;  // per stage, vector holding the field (NULL if not available)
+    int *offset;                // per stage, position of the field in vec
+    int *size;                  // per stage, number of elements of the field
+    ocp_nlp_modify_hook *modify_hook;  // hook of the nlp inputs or outputs holding the field
+    char field[32];             // name of the field, passed to modify_hook
+    void *raw_memory;           // pointer to allocated memory, to be used for freeing
+} ocp_nlp_field_handle;
+
+//
+acados_size_t ocp_nlp_field_handle_calculate_size(int N);
+//
+ocp_nlp_field_handle *ocp_nlp_field_handle_assign(int N, void *raw_memory);
+
+
+
 /************************************************
  * options
  ************************************************/
@@ -257,6 +310,7 @@ typedef enum
 {
     FIXED_STEP,
     MERIT_BACKTRACKING,
+    FILTER_LINE_SEARCH,  // ocp_nlp_sqp only
 } ocp_nlp_globalization_t;
 
 typedef struct ocp_nlp_opts
@@ -271,6 +325,10 @@ typedef struct ocp_nlp_opts
     int reuse_workspace;
     int num_threads;
     int print_level;
+    int stage_timings;  // measure linearization time per stage and module
+    int stage_tasks;    // linearize the stages as OpenMP tasks instead of a static loop;
+                        // for N+1 <= num_threads also set "dynamics_sens_forw_tasks" (IRK)
+    int dyn_batch_size; // stages per batched dynamics call, if supported (e.g. ERK_INTERLEAVED)
 
     // TODO: move to separate struct?
     ocp_nlp_globalization_t globalization;
@@ -280,6 +338,8 @@ typedef struct ocp_nlp_opts
     double alpha_min;
     double alpha_reduction;
     double eps_sufficient_descent;
+    double filter_gamma_theta;  // filter margin on the infeasibility
+    double filter_gamma_phi;    // filter margin on the objective
 } ocp_nlp_opts;
 
 //
@@ -324,6 +384,10 @@ void ocp_nlp_res_get_inf_norm(ocp_nlp_res *res, double *out);
  * memory
  ************************************************/
 
+// number of bins of the solve time histogram: bin 0 counts calls below 1 us,
+// bin k counts calls in [2^(k-1), 2^k) us, the last bin collects all slower calls
+#define OCP_NLP_LATENCY_HIST_SIZE 24
+
 typedef struct ocp_nlp_memory
 {
 //    void *qp_solver_mem; // xcond solver mem instead ???
@@ -356,6 +420,14 @@ typedef struct ocp_nlp_memory
 
     int *sqp_iter; // pointer to iteration number
 
+    // linearization times per stage, accumulated over one solver call (opts->stage_timings),
+    // written by the preparation phase, possibly on the SQP-RTI preparation thread
+    double *time_lin_dyn;  // N
+    double *time_lin_cost;  // N+1
+    double *time_lin_constr;  // N+1
+    // histogram of the solver call times, accumulated over all calls
+    int *latency_hist;
+
 } ocp_nlp_memory;
 
 //
@@ -363,6 +435,14 @@ acados_size_t ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims
 //
 ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims,
                                       ocp_nlp_opts *opts, void *raw_memory);
+//
+void ocp_nlp_timings_reset(ocp_nlp_dims *dims, ocp_nlp_memory *mem);
+//
+void ocp_nlp_timings_add_latency(ocp_nlp_memory *mem, double time);
+// per stage linearization times of dynamics, cost and constraints and the latency histogram;
+// regularization and QP solution act on the whole horizon and are only timed in total by the solvers.
+// NOTE: not synchronized, the solver getters calling it wait for an asynchronous preparation phase
+void ocp_nlp_timings_get(ocp_nlp_dims *dims, ocp_nlp_memory *mem, const char *field, void *value);
 
 
 
@@ -421,6 +501,9 @@ double ocp_nlp_line_search(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_i
             ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work,
             int check_early_termination);
 //
+void ocp_nlp_evaluate_fun(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+          ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work);
+//
 double ocp_nlp_evaluate_merit_fun(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
           ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work);
 //
@@ -823,6 +823,120 @@ int ocp_nlp_constraints_bgh_model_set(void *config_, void *dims_,
 }
 
 
+
+int ocp_nlp_constraints_bgh_model_get_vec_ptr(void *config_, void *dims_, void *model_,
+                         const char *field, struct blasfeo_dvec **vec, int *offset, int *size)
+{
+    ocp_nlp_constraints_bgh_dims *dims = (ocp_nlp_constraints_bgh_dims *) dims_;
+    ocp_nlp_constraints_bgh_model *model = (ocp_nlp_constraints_bgh_model *) model_;
+
+    int nb = dims->nb;
+    int ng = dims->ng;
+    int nh = dims->nh;
+    int ns = dims->ns;
+    int nsbu = dims->nsbu;
+    int nsbx = dims->nsbx;
+    int nsg = dims->nsg;
+    int nsh = dims->nsh;
+    int nbx = dims->nbx;
+    int nbu = dims->nbu;
+
+    // d = [lbu lbx lg lh ubu ubx ug uh lsbu lsbx lsg lsh usbu usbx usg ush]
+    *vec = &model->d;
+
+    if (!strcmp(field, "lbx"))
+    {
+        *offset = nbu;
+        *size = nbx;
+    }
+    else if (!strcmp(field, "ubx"))
+    {
+        *offset = nb + ng + nh + nbu;
+        *size = nbx;
+    }
+    else if (!strcmp(field, "lbu"))
+    {
+        *offset = 0;
+        *size = nbu;
+    }
+    else if (!strcmp(field, "ubu"))
+    {
+        *offset = nb + ng + nh;
+        *size = nbu;
+    }
+    else if (!strcmp(field, "lg"))
+    {
+        *offset = nb;
+        *size = ng;
+    }
+    else if (!strcmp(field, "ug"))
+    {
+        *offset = 2*nb+ng+nh;
+        *size = ng;
+    }
+    else if (!strcmp(field, "lh"))
+    {
+        *offset = nb+ng;
+        *size = nh;
+    }
+    else if (!strcmp(field, "uh"))
+    {
+        *offset = 2*nb+2*ng+nh;
+        *size = nh;
+    }
+    else if (!strcmp(field, "lsbu"))
+    {
+        *offset = 2*nb+2*ng+2*nh;
+        *size = nsbu;
+    }
+    else if (!strcmp(field, "usbu"))
+    {
+        *offset = 2*nb+2*ng+2*nh+ns;
+        *size = nsbu;
+    }
+    else if (!strcmp(field, "lsbx"))
+    {
+        *offset = 2*nb+2*ng+2*nh+nsbu;
+        *size = nsbx;
+    }
+    else if (!strcmp(field, "usbx"))
+    {
+        *offset = 2*nb+2*ng+2*nh+ns+nsbu;
+        *size = nsbx;
+    }
+    else if (!strcmp(field, "lsg"))
+    {
+        *offset = 2*nb+2*ng+2*nh+nsbu+nsbx;
+        *size = nsg;
+    }
+    else if (!strcmp(field, "usg"))
+    {
+        *offset = 2*nb+2*ng+2*nh+ns+nsbu+nsbx;
+        *size = nsg;
+    }
+    else if (!strcmp(field, "lsh"))
+    {
+        *offset = 2*nb+2*ng+2*nh+nsbu+nsbx+nsg;
+        *size = nsh;
+    }
+    else if (!strcmp(field, "ush"))
+    {
+        *offset = 2*nb+2*ng+2*nh+ns+nsbu+nsbx+nsg;
+        *size = nsh;
+    }
+    else
+    {
+        // not a vector field of the model
+        *vec = NULL;
+        *offset = 0;
+        *size = 0;
+        return ACADOS_FAILURE;
+    }
+
+    return ACADOS_SUCCESS;
+}
+
+
 /************************************************
  * options
  ************************************************/
@@ -963,6 +1077,8 @@ void *ocp_nlp_constraints_bgh_memory_assign(void *config_, void *dims_, void *op
     // adj
     assign_and_advance_blasfeo_dvec_mem(nu + nx + 2 * ns, &memory->adj, &c_ptr);
 
+    memory->fun_jac_ready = 0;
+
     assert((char *) raw_memory +
                ocp_nlp_constraints_bgh_memory_calculate_size(config_, dims, opts_) >=
            c_ptr);
@@ -1373,8 +1489,17 @@ void ocp_nlp_constraints_bgh_update_qp_matrices(void *config_, void *dims_, void
             ext_fun_type_out[2] = BLASFEO_DMAT_ARGS;
             ext_fun_out[2] = &jac_z_tran_out;  // jac_z': nz * nh
 
-            model->nl_constr_h_fun_jac->evaluate(model->nl_constr_h_fun_jac, ext_fun_type_in,
-                                                    ext_fun_in, ext_fun_type_out, ext_fun_out);
+            // evaluate external function, unless done by update_qp_matrices_eval_batch
+            if (memory->fun_jac_ready)
+            {
+                blasfeo_dveccp(nh, &memory->fun, nb+ng, &work->tmp_ni, nb+ng);
+                memory->fun_jac_ready = 0;
+            }
+            else
+            {
+                model->nl_constr_h_fun_jac->evaluate(model->nl_constr_h_fun_jac, ext_fun_type_in,
+                                                     ext_fun_in, ext_fun_type_out, ext_fun_out);
+            }
 
             // expand h:
             // h(x, u, z) ~
@@ -1438,6 +1563,98 @@ void ocp_nlp_constraints_bgh_update_qp_matrices(void *config_, void *dims_, void
 
 
 
+void ocp_nlp_constraints_bgh_update_qp_matrices_eval_batch(void **config_, void **dims_,
+        void **model_, void **opts_, void **memory_, void **work_, int n_batch)
+{
+    // process larger batches in chunks
+    if (n_batch > OCP_NLP_CONSTRAINTS_BATCH_MAX)
+    {
+        for (int b0 = 0; b0 < n_batch; b0 += OCP_NLP_CONSTRAINTS_BATCH_MAX)
+        {
+            int nb = n_batch - b0 < OCP_NLP_CONSTRAINTS_BATCH_MAX ?
+                     n_batch - b0 : OCP_NLP_CONSTRAINTS_BATCH_MAX;
+            ocp_nlp_constraints_bgh_update_qp_matrices_eval_batch(config_ + b0, dims_ + b0,
+                    model_ + b0, opts_ + b0, memory_ + b0, work_ + b0, nb);
+        }
+        return;
+    }
+
+    external_function_generic *fun[OCP_NLP_CONSTRAINTS_BATCH_MAX];
+    struct blasfeo_dvec_args x_in[OCP_NLP_CONSTRAINTS_BATCH_MAX];  // input x of external fun;
+    struct blasfeo_dvec_args u_in[OCP_NLP_CONSTRAINTS_BATCH_MAX];  // input u of external fun;
+    struct blasfeo_dvec_args z_in[OCP_NLP_CONSTRAINTS_BATCH_MAX];  // input z of external fun;
+    struct blasfeo_dvec_args fun_out[OCP_NLP_CONSTRAINTS_BATCH_MAX];
+    struct blasfeo_dmat_args jac_tran_out[OCP_NLP_CONSTRAINTS_BATCH_MAX];
+    void *ext_fun_in[OCP_NLP_CONSTRAINTS_BATCH_MAX][3];
+    void *ext_fun_out[OCP_NLP_CONSTRAINTS_BATCH_MAX][3];
+    void **h_in[OCP_NLP_CONSTRAINTS_BATCH_MAX];
+    void **h_out[OCP_NLP_CONSTRAINTS_BATCH_MAX];
+    ocp_nlp_constraints_bgh_memory *h_mem[OCP_NLP_CONSTRAINTS_BATCH_MAX];
+
+    ext_fun_arg_t ext_fun_type_in[3] = {BLASFEO_DVEC_ARGS, BLASFEO_DVEC_ARGS, BLASFEO_DVEC_ARGS};
+    // NOTE: jac_z' is not needed, only stages without algebraic variables are batched
+    ext_fun_arg_t ext_fun_type_out[3] = {BLASFEO_DVEC_ARGS, BLASFEO_DMAT_ARGS, IGNORE_ARGUMENT};
+
+    // stages whose h and jacobian are evaluated together; the remaining ones evaluate them in
+    // update_qp_matrices, in particular the exact hessian, which goes through the workspace
+    int n_fun = 0;
+    int batch = 0;
+    for (int b = 0; b < n_batch; b++)
+    {
+        ocp_nlp_constraints_bgh_dims *dims = dims_[b];
+        ocp_nlp_constraints_bgh_model *model = model_[b];
+        ocp_nlp_constraints_bgh_opts *opts = opts_[b];
+        ocp_nlp_constraints_bgh_memory *memory = memory_[b];
+
+        if (dims->nh == 0 || dims->nz > 0 || opts->compute_hess)
+            continue;
+
+        x_in[n_fun].x = memory->ux;
+        x_in[n_fun].xi = dims->nu;
+        u_in[n_fun].x = memory->ux;
+        u_in[n_fun].xi = 0;
+        z_in[n_fun].x = memory->z_alg;
+        z_in[n_fun].xi = 0;
+
+        // h is kept in the lower part of fun until update_qp_matrices
+        fun_out[n_fun].x = &memory->fun;
+        fun_out[n_fun].xi = dims->nb + dims->ng;
+        jac_tran_out[n_fun].A = memory->DCt;
+        jac_tran_out[n_fun].ai = 0;
+        jac_tran_out[n_fun].aj = dims->ng;
+
+        ext_fun_in[n_fun][0] = &x_in[n_fun];
+        ext_fun_in[n_fun][1] = &u_in[n_fun];
+        ext_fun_in[n_fun][2] = &z_in[n_fun];
+        ext_fun_out[n_fun][0] = &fun_out[n_fun];  // fun: nh
+        ext_fun_out[n_fun][1] = &jac_tran_out[n_fun];  // jac_ux': (nu+nx) * nh
+        ext_fun_out[n_fun][2] = NULL;
+
+        fun[n_fun] = model->nl_constr_h_fun_jac;
+        h_in[n_fun] = ext_fun_in[n_fun];
+        h_out[n_fun] = ext_fun_out[n_fun];
+        h_mem[n_fun] = memory;
+
+        if (model->nl_constr_h_fun_jac->evaluate_batch != NULL)
+            batch = 1;
+
+        n_fun++;
+    }
+
+    // nothing to gain if no function of the batch provides a batched evaluation
+    if (!batch)
+        return;
+
+    external_function_evaluate_batch(fun, n_fun, ext_fun_type_in, h_in, ext_fun_type_out, h_out);
+
+    for (int b = 0; b < n_fun; b++)
+        h_mem[b]->fun_jac_ready = 1;
+
+    return;
+}
+
+
+
 void ocp_nlp_constraints_bgh_compute_fun(void *config_, void *dims_, void *model_,
                                             void *opts_, void *memory_, void *work_)
 {
@@ -1574,6 +1791,7 @@ void ocp_nlp_constraints_bgh_config_initialize_default(void *config_)
     config->model_calculate_size = &ocp_nlp_constraints_bgh_model_calculate_size;
     config->model_assign = &ocp_nlp_constraints_bgh_model_assign;
     config->model_set = &ocp_nlp_constraints_bgh_model_set;
+    config->model_get_vec_ptr = &ocp_nlp_constraints_bgh_model_get_vec_ptr;
     config->opts_calculate_size = &ocp_nlp_constraints_bgh_opts_calculate_size;
     config->opts_assign = &ocp_nlp_constraints_bgh_opts_assign;
     config->opts_initialize_default = &ocp_nlp_constraints_bgh_opts_initialize_default;
@@ -1597,6 +1815,7 @@ void ocp_nlp_constraints_bgh_config_initialize_default(void *config_)
     config->workspace_calculate_size = &ocp_nlp_constraints_bgh_workspace_calculate_size;
     config->initialize = &ocp_nlp_constraints_bgh_initialize;
     config->update_qp_matrices = &ocp_nlp_constraints_bgh_update_qp_matrices;
+    config->update_qp_matrices_eval_batch = &ocp_nlp_constraints_bgh_update_qp_matrices_eval_batch;
     config->compute_fun = &ocp_nlp_constraints_bgh_compute_fun;
     config->bounds_update = &ocp_nlp_constraints_bgh_bounds_update;
     config->config_initialize_default = &ocp_nlp_constraints_bgh_config_initialize_default;
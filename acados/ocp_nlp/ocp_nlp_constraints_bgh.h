@@ -115,6 +115,9 @@ void *ocp_nlp_constraints_bgh_model_assign(void *config, void *dims, void *raw_m
 //
 int ocp_nlp_constraints_bgh_model_set(void *config_, void *dims_,
                          void *model_, const char *field, void *value);
+//
+int ocp_nlp_constraints_bgh_model_get_vec_ptr(void *config_, void *dims_, void *model_,
+                         const char *field, struct blasfeo_dvec **vec, int *offset, int *size);
 
 
 
@@ -160,6 +163,7 @@ typedef struct
     int *idxb;                   // pointer to idxb[ii] in qp_in
     int *idxs_rev;               // pointer to idxs_rev[ii] in qp_in
     int *idxe;                   // pointer to idxe[ii] in qp_in
+    int fun_jac_ready;           // h (in fun) and jacobian evaluated by update_qp_matrices_eval_batch
 } ocp_nlp_constraints_bgh_memory;
 
 //
@@ -223,6 +227,9 @@ void ocp_nlp_constraints_bgh_initialize(void *config, void *dims, void *model, v
 //
 void ocp_nlp_constraints_bgh_update_qp_matrices(void *config_, void *dims, void *model_,
                                             void *opts_, void *memory_, void *work_);
+//
+void ocp_nlp_constraints_bgh_update_qp_matrices_eval_batch(void **config_, void **dims,
+        void **model_, void **opts_, void **memory_, void **work_, int n_batch);
 
 //
 void ocp_nlp_constraints_bgh_compute_fun(void *config_, void *dims, void *model_,
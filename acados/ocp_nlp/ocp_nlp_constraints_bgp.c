@@ -816,6 +816,120 @@ int ocp_nlp_constraints_bgp_model_set(void *config_, void *dims_,
 
 
 
+int ocp_nlp_constraints_bgp_model_get_vec_ptr(void *config_, void *dims_, void *model_,
+                         const char *field, struct blasfeo_dvec **vec, int *offset, int *size)
+{
+    ocp_nlp_constraints_bgp_dims *dims = (ocp_nlp_constraints_bgp_dims *) dims_;
+    ocp_nlp_constraints_bgp_model *model = (ocp_nlp_constraints_bgp_model *) model_;
+
+    int nb = dims->nb;
+    int ng = dims->ng;
+    int nphi = dims->nphi;
+    int ns = dims->ns;
+    int nsbu = dims->nsbu;
+    int nsbx = dims->nsbx;
+    int nsg = dims->nsg;
+    int nsphi = dims->nsphi;
+    int nbx = dims->nbx;
+    int nbu = dims->nbu;
+
+    // d = [lbu lbx lg lphi ubu ubx ug uphi lsbu lsbx lsg lsphi usbu usbx usg usphi]
+    *vec = &model->d;
+
+    if (!strcmp(field, "lbx"))
+    {
+        *offset = nbu;
+        *size = nbx;
+    }
+    else if (!strcmp(field, "ubx"))
+    {
+        *offset = nb + ng + nphi + nbu;
+        *size = nbx;
+    }
+    else if (!strcmp(field, "lbu"))
+    {
+        *offset = 0;
+        *size = nbu;
+    }
+    else if (!strcmp(field, "ubu"))
+    {
+        *offset = nb + ng + nphi;
+        *size = nbu;
+    }
+    else if (!strcmp(field, "lg"))
+    {
+        *offset = nb;
+        *size = ng;
+    }
+    else if (!strcmp(field, "ug"))
+    {
+        *offset = 2*nb+ng+nphi;
+        *size = ng;
+    }
+    else if (!strcmp(field, "lphi"))
+    {
+        *offset = nb+ng;
+        *size = nphi;
+    }
+    else if (!strcmp(field, "uphi"))
+    {
+        *offset = 2*nb+2*ng+nphi;
+        *size = nphi;
+    }
+    else if (!strcmp(field, "lsbu"))
+    {
+        *offset = 2*nb+2*ng+2*nphi;
+        *size = nsbu;
+    }
+    else if (!strcmp(field, "usbu"))
+    {
+        *offset = 2*nb+2*ng+2*nphi+ns;
+        *size = nsbu;
+    }
+    else if (!strcmp(field, "lsbx"))
+    {
+        *offset = 2*nb+2*ng+2*nphi+nsbu;
+        *size = nsbx;
+    }
+    else if (!strcmp(field, "usbx"))
+    {
+        *offset = 2*nb+2*ng+2*nphi+ns+nsbu;
+        *size = nsbx;
+    }
+    else if (!strcmp(field, "lsg"))
+    {
+        *offset = 2*nb+2*ng+2*nphi+nsbu+nsbx;
+        *size = nsg;
+    }
+    else if (!strcmp(field, "usg"))
+    {
+        *offset = 2*nb+2*ng+2*nphi+ns+nsbu+nsbx;
+        *size = nsg;
+    }
+    else if (!strcmp(field, "lsphi"))
+    {
+        *offset = 2*nb+2*ng+2*nphi+nsbu+nsbx+nsg;
+        *size = nsphi;
+    }
+    else if (!strcmp(field, "usphi"))
+    {
+        *offset = 2*nb+2*ng+2*nphi+ns+nsbu+nsbx+nsg;
+        *size = nsphi;
+    }
+    else
+    {
+        // not a vector field of the model
+        *vec = NULL;
+        *offset = 0;
+        *size = 0;
+        return ACADOS_FAILURE;
+    }
+
+    return ACADOS_SUCCESS;
+}
+
+
+
 /* options */
 
 acados_size_t ocp_nlp_constraints_bgp_opts_calculate_size(void *config_, void *dims_)
@@ -1501,6 +1615,7 @@ void ocp_nlp_constraints_bgp_config_initialize_default(void *config_)
     config->model_calculate_size = &ocp_nlp_constraints_bgp_model_calculate_size;
     config->model_assign = &ocp_nlp_constraints_bgp_model_assign;
     config->model_set = &ocp_nlp_constraints_bgp_model_set;
+    config->model_get_vec_ptr = &ocp_nlp_constraints_bgp_model_get_vec_ptr;
     config->opts_calculate_size = &ocp_nlp_constraints_bgp_opts_calculate_size;
     config->opts_assign = &ocp_nlp_constraints_bgp_opts_assign;
     config->opts_initialize_default = &ocp_nlp_constraints_bgp_opts_initialize_default;
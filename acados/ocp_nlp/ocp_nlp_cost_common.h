@@ -58,6 +58,11 @@ extern "C" {
  * config
  ************************************************/
 
+// maximum number of stages evaluated together by update_qp_matrices_eval_batch
+#define OCP_NLP_COST_BATCH_MAX 32
+
+
+
 typedef struct
 {
     acados_size_t (*dims_calculate_size)(void *config);
@@ -68,6 +73,9 @@ typedef struct
     acados_size_t (*model_calculate_size)(void *config, void *dims);
     void *(*model_assign)(void *config, void *dims, void *raw_memory);
     int (*model_set)(void *config_, void *dims_, void *model_, const char *field, void *value_);
+    // resolves a vector field of the model to its position in a blasfeo_dvec of the model
+    int (*model_get_vec_ptr)(void *config_, void *dims_, void *model_, const char *field,
+                             struct blasfeo_dvec **vec, int *offset, int *size);
     acados_size_t (*opts_calculate_size)(void *config, void *dims);
     void *(*opts_assign)(void *config, void *dims, void *raw_memory);
     void (*opts_initialize_default)(void *config, void *dims, void *opts);
@@ -88,6 +96,11 @@ typedef struct
 
     // computes the function value, gradient and hessian (approximation) of the cost function
     void (*update_qp_matrices)(void *config_, void *dims, void *model_, void *opts_, void *mem_, void *work_);
+    // optional, NULL if not supported: evaluates the external functions of update_qp_matrices
+    // of n_batch stages at once, where they provide evaluate_batch; update_qp_matrices then
+    // reuses the result
+    void (*update_qp_matrices_eval_batch)(void **config_, void **dims, void **model_, void **opts_,
+                                          void **mem_, void **work_, int n_batch);
     // computes the cost function value (intended for globalization)
     void (*compute_fun)(void *config_, void *dims, void *model_, void *opts_, void *mem_, void *work_);
     void (*config_initialize_default)(void *config);
@@ -402,6 +402,60 @@ int ocp_nlp_cost_ls_model_set(void *config_, void *dims_, void *model_,
 
 
 
+int ocp_nlp_cost_ls_model_get_vec_ptr(void *config_, void *dims_, void *model_,
+                                 const char *field, struct blasfeo_dvec **vec, int *offset, int *size)
+{
+    ocp_nlp_cost_ls_dims *dims = dims_;
+    ocp_nlp_cost_ls_model *model = model_;
+
+    int ns = dims->ns;
+
+    if (!strcmp(field, "y_ref") || !strcmp(field, "yref"))
+    {
+        *vec = &model->y_ref;
+        *offset = 0;
+        *size = dims->ny;
+        return ACADOS_SUCCESS;
+    }
+
+    if (!strcmp(field, "Zl"))
+    {
+        *vec = &model->Z;
+        *offset = 0;
+        *size = ns;
+    }
+    else if (!strcmp(field, "Zu"))
+    {
+        *vec = &model->Z;
+        *offset = ns;
+        *size = ns;
+    }
+    else if (!strcmp(field, "zl"))
+    {
+        *vec = &model->z;
+        *offset = 0;
+        *size = ns;
+    }
+    else if (!strcmp(field, "zu"))
+    {
+        *vec = &model->z;
+        *offset = ns;
+        *size = ns;
+    }
+    else
+    {
+        // not a vector field of the model
+        *vec = NULL;
+        *offset = 0;
+        *size = 0;
+        return ACADOS_FAILURE;
+    }
+
+    return ACADOS_SUCCESS;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //                                   options                                  //
 ////////////////////////////////////////////////////////////////////////////////
@@ -932,6 +986,7 @@ void ocp_nlp_cost_ls_config_initialize_default(void *config_)
     config->model_calculate_size = &ocp_nlp_cost_ls_model_calculate_size;
     config->model_assign = &ocp_nlp_cost_ls_model_assign;
     config->model_set = &ocp_nlp_cost_ls_model_set;
+    config->model_get_vec_ptr = &ocp_nlp_cost_ls_model_get_vec_ptr;
     config->opts_calculate_size = &ocp_nlp_cost_ls_opts_calculate_size;
     config->opts_assign = &ocp_nlp_cost_ls_opts_assign;
     config->opts_initialize_default = &ocp_nlp_cost_ls_opts_initialize_default;
@@ -137,6 +137,9 @@ void *ocp_nlp_cost_ls_model_assign(void *config, void *dims, void *raw_memory);
 //
 int ocp_nlp_cost_ls_model_set(void *config_, void *dims_, void *model_,
                               const char *field, void *value_);
+//
+int ocp_nlp_cost_ls_model_get_vec_ptr(void *config_, void *dims_, void *model_,
+                              const char *field, struct blasfeo_dvec **vec, int *offset, int *size);
 
 
 
@@ -343,6 +343,60 @@ int ocp_nlp_cost_nls_model_set(void *config_, void *dims_, void *model_,
 
 
 
+int ocp_nlp_cost_nls_model_get_vec_ptr(void *config_, void *dims_, void *model_,
+                                 const char *field, struct blasfeo_dvec **vec, int *offset, int *size)
+{
+    ocp_nlp_cost_nls_dims *dims = dims_;
+    ocp_nlp_cost_nls_model *model = model_;
+
+    int ns = dims->ns;
+
+    if (!strcmp(field, "y_ref") || !strcmp(field, "yref"))
+    {
+        *vec = &model->y_ref;
+        *offset = 0;
+        *size = dims->ny;
+        return ACADOS_SUCCESS;
+    }
+
+    if (!strcmp(field, "Zl"))
+    {
+        *vec = &model->Z;
+        *offset = 0;
+        *size = ns;
+    }
+    else if (!strcmp(field, "Zu"))
+    {
+        *vec = &model->Z;
+        *offset = ns;
+        *size = ns;
+    }
+    else if (!strcmp(field, "zl"))
+    {
+        *vec = &model->z;
+        *offset = 0;
+        *size = ns;
+    }
+    else if (!strcmp(field, "zu"))
+    {
+        *vec = &model->z;
+        *offset = ns;
+        *size = ns;
+    }
+    else
+    {
+        // not a vector field of the model
+        *vec = NULL;
+        *offset = 0;
+        *size = 0;
+        return ACADOS_FAILURE;
+    }
+
+    return ACADOS_SUCCESS;
+}
+
+
+
 /************************************************
  * options
  ************************************************/
@@ -495,6 +549,8 @@ void *ocp_nlp_cost_nls_memory_assign(void *config_, void *dims_, void *opts_, vo
     // grad
     assign_and_advance_blasfeo_dvec_mem(nu + nx + 2 * ns, &memory->grad, &c_ptr);
 
+    memory->fun_jac_ready = 0;
+
     assert((char *) raw_memory + ocp_nlp_cost_nls_memory_calculate_size(config_, dims, opts_) >=
            c_ptr);
 
@@ -728,9 +784,12 @@ void ocp_nlp_cost_nls_update_qp_matrices(void *config_, void *dims_, void *model
     ext_fun_type_out[1] = BLASFEO_DMAT;
     ext_fun_out[1] = &memory->Jt;  // jac': (nu+nx) * ny
 
-    // evaluate external function
-    model->nls_y_fun_jac->evaluate(model->nls_y_fun_jac, ext_fun_type_in, ext_fun_in,
-                                 ext_fun_type_out, ext_fun_out);
+    // evaluate external function, unless done by update_qp_matrices_eval_batch
+    if (memory->fun_jac_ready)
+        memory->fun_jac_ready = 0;
+    else
+        model->nls_y_fun_jac->evaluate(model->nls_y_fun_jac, ext_fun_type_in, ext_fun_in,
+                                       ext_fun_type_out, ext_fun_out);
 
     /* gradient */
     // res = res - y_ref
@@ -822,6 +881,75 @@ void ocp_nlp_cost_nls_update_qp_matrices(void *config_, void *dims_, void *model
 
 
 
+void ocp_nlp_cost_nls_update_qp_matrices_eval_batch(void **config_, void **dims_, void **model_,
+                                                    void **opts_, void **memory_, void **work_,
+                                                    int n_batch)
+{
+    // process larger batches in chunks
+    if (n_batch > OCP_NLP_COST_BATCH_MAX)
+    {
+        for (int b0 = 0; b0 < n_batch; b0 += OCP_NLP_COST_BATCH_MAX)
+        {
+            int nb = n_batch - b0 < OCP_NLP_COST_BATCH_MAX ? n_batch - b0 : OCP_NLP_COST_BATCH_MAX;
+            ocp_nlp_cost_nls_update_qp_matrices_eval_batch(config_ + b0, dims_ + b0, model_ + b0,
+                    opts_ + b0, memory_ + b0, work_ + b0, nb);
+        }
+        return;
+    }
+
+    // nothing to gain if no function of the batch provides a batched evaluation
+    int batch = 0;
+    for (int b = 0; b < n_batch; b++)
+    {
+        ocp_nlp_cost_nls_model *model = model_[b];
+        if (model->nls_y_fun_jac->evaluate_batch != NULL)
+            batch = 1;
+    }
+    if (!batch)
+        return;
+
+    external_function_generic *fun[OCP_NLP_COST_BATCH_MAX];
+    struct blasfeo_dvec_args x_in[OCP_NLP_COST_BATCH_MAX];  // input x of external fun;
+    struct blasfeo_dvec_args u_in[OCP_NLP_COST_BATCH_MAX];  // input u of external fun;
+    void *ext_fun_in[OCP_NLP_COST_BATCH_MAX][2];
+    void *ext_fun_out[OCP_NLP_COST_BATCH_MAX][2];
+    void **fun_in[OCP_NLP_COST_BATCH_MAX];
+    void **fun_out[OCP_NLP_COST_BATCH_MAX];
+
+    ext_fun_arg_t ext_fun_type_in[2] = {BLASFEO_DVEC_ARGS, BLASFEO_DVEC_ARGS};
+    ext_fun_arg_t ext_fun_type_out[2] = {BLASFEO_DVEC, BLASFEO_DMAT};
+
+    for (int b = 0; b < n_batch; b++)
+    {
+        ocp_nlp_cost_nls_dims *dims = dims_[b];
+        ocp_nlp_cost_nls_model *model = model_[b];
+        ocp_nlp_cost_nls_memory *memory = memory_[b];
+
+        x_in[b].x = memory->ux;
+        x_in[b].xi = dims->nu;
+        u_in[b].x = memory->ux;
+        u_in[b].xi = 0;
+
+        ext_fun_in[b][0] = &x_in[b];
+        ext_fun_in[b][1] = &u_in[b];
+        ext_fun_out[b][0] = &memory->res;  // fun: ny
+        ext_fun_out[b][1] = &memory->Jt;  // jac': (nu+nx) * ny
+
+        fun[b] = model->nls_y_fun_jac;
+        fun_in[b] = ext_fun_in[b];
+        fun_out[b] = ext_fun_out[b];
+
+        memory->fun_jac_ready = 1;
+    }
+
+    external_function_evaluate_batch(fun, n_batch, ext_fun_type_in, fun_in, ext_fun_type_out,
+                                     fun_out);
+
+    return;
+}
+
+
+
 void ocp_nlp_cost_nls_compute_fun(void *config_, void *dims_, void *model_,
                                   void *opts_, void *memory_, void *work_)
 {
@@ -909,6 +1037,7 @@ void ocp_nlp_cost_nls_config_initialize_default(void *config_)
     config->model_calculate_size = &ocp_nlp_cost_nls_model_calculate_size;
     config->model_assign = &ocp_nlp_cost_nls_model_assign;
     config->model_set = &ocp_nlp_cost_nls_model_set;
+    config->model_get_vec_ptr = &ocp_nlp_cost_nls_model_get_vec_ptr;
     config->opts_calculate_size = &ocp_nlp_cost_nls_opts_calculate_size;
     config->opts_assign = &ocp_nlp_cost_nls_opts_assign;
     config->opts_initialize_default = &ocp_nlp_cost_nls_opts_initialize_default;
@@ -927,6 +1056,7 @@ void ocp_nlp_cost_nls_config_initialize_default(void *config_)
     config->workspace_calculate_size = &ocp_nlp_cost_nls_workspace_calculate_size;
     config->initialize = &ocp_nlp_cost_nls_initialize;
     config->update_qp_matrices = &ocp_nlp_cost_nls_update_qp_matrices;
+    config->update_qp_matrices_eval_batch = &ocp_nlp_cost_nls_update_qp_matrices_eval_batch;
     config->compute_fun = &ocp_nlp_cost_nls_compute_fun;
     config->config_initialize_default = &ocp_nlp_cost_nls_config_initialize_default;
 
@@ -107,6 +107,9 @@ acados_size_t ocp_nlp_cost_nls_model_calculate_size(void *config, void *dims);
 void *ocp_nlp_cost_nls_model_assign(void *config, void *dims, void *raw_memory);
 //
 int ocp_nlp_cost_nls_model_set(void *config_, void *dims_, void *model_, const char *field, void *value_);
+//
+int ocp_nlp_cost_nls_model_get_vec_ptr(void *config_, void *dims_, void *model_, const char *field,
+                                       struct blasfeo_dvec **vec, int *offset, int *size);
 
 
 
@@ -149,6 +152,7 @@ typedef struct
     struct blasfeo_dmat *RSQrq;  // pointer to RSQrq in qp_in
     struct blasfeo_dvec *Z;      // pointer to Z in qp_in
 	double fun;                         ///< value of the cost function
+    int fun_jac_ready;           // res and Jt evaluated by update_qp_matrices_eval_batch
 } ocp_nlp_cost_nls_memory;
 
 //
@@ -198,6 +202,10 @@ void ocp_nlp_cost_nls_initialize(void *config_, void *dims, void *model_, void *
 //
 void ocp_nlp_cost_nls_update_qp_matrices(void *config_, void *dims, void *model_, void *opts_, void *memory_, void *work_);
 //
+void ocp_nlp_cost_nls_update_qp_matrices_eval_batch(void **config_, void **dims, void **model_,
+                                                    void **opts_, void **memory_, void **work_,
+                                                    int n_batch);
+//
 void ocp_nlp_cost_nls_compute_fun(void *config_, void *dims, void *model_, void *opts_, void *memory_, void *work_);
 
 #ifdef __cplusplus
@@ -61,6 +61,11 @@ extern "C" {
  * config
  ************************************************/
 
+// maximum number of stages linearized together by update_qp_matrices_batch
+#define OCP_NLP_DYNAMICS_BATCH_MAX 8
+
+
+
 typedef struct
 {
     void (*config_initialize_default)(void *config);
@@ -103,6 +108,9 @@ typedef struct
     acados_size_t (*workspace_calculate_size)(void *config, void *dims, void *opts);
     void (*initialize)(void *config_, void *dims, void *model_, void *opts_, void *mem_, void *work_);
     void (*update_qp_matrices)(void *config_, void *dims, void *model_, void *opts_, void *mem_, void *work_);
+    // optional, NULL if not supported: update_qp_matrices of n_batch stages at once
+    void (*update_qp_matrices_batch)(void **config_, void **dims, void **model_, void **opts_,
+                                     void **mem_, void **work_, int n_batch);
     void (*compute_fun)(void *config_, void *dims, void *model_, void *opts_, void *mem_, void *work_);
     int (*precompute)(void *config_, void *dims, void *model_, void *opts_, void *mem_, void *work_);
 } ocp_nlp_dynamics_config;
@@ -44,6 +44,7 @@
 #include "blasfeo/include/blasfeo_d_blas.h"
 // acados
 #include "acados/utils/mem.h"
+#include "acados/utils/timing.h"
 
 
 
@@ -572,7 +573,8 @@ void ocp_nlp_dynamics_cont_memory_get(void *config_, void *dims_, void *mem_, co
 
 	sim_config *sim = config->sim_solver;
 
-    if (!strcmp(field, "time_sim") || !strcmp(field, "time_sim_ad") || !strcmp(field, "time_sim_la"))
+    if (!strcmp(field, "time_sim") || !strcmp(field, "time_sim_ad") || !strcmp(field, "time_sim_la")
+        || !strcmp(field, "num_factorizations"))
     {
 		sim->memory_get(sim, dims->sim, mem->sim_solver, field, value);
     }
@@ -746,13 +748,12 @@ void ocp_nlp_dynamics_cont_initialize(void *config_, void *dims_, void *model_,
 
 
 
-void ocp_nlp_dynamics_cont_update_qp_matrices(void *config_, void *dims_, void *model_, void *opts_, void *mem_, void *work_)
+// set up the integrator input: model, state, control and seeds
+static void ocp_nlp_dynamics_cont_setup_sim_in(void *config_, void *dims_, void *model_, void *opts_,
+    void *mem_, void *work_)
 {
-    ocp_nlp_dynamics_cont_cast_workspace(config_, dims_, opts_, work_);
-
     ocp_nlp_dynamics_config *config = config_;
     ocp_nlp_dynamics_cont_dims *dims = dims_;
-    ocp_nlp_dynamics_cont_opts *opts = opts_;
     ocp_nlp_dynamics_cont_workspace *work = work_;
     ocp_nlp_dynamics_cont_memory *mem = mem_;
     ocp_nlp_dynamics_cont_model *model = model_;
@@ -761,9 +762,7 @@ void ocp_nlp_dynamics_cont_update_qp_matrices(void *config_, void *dims_, void *
 
     int nx = dims->nx;
     int nu = dims->nu;
-    int nz = dims->nz;
     int nx1 = dims->nx1;
-    int nu1 = dims->nu1;
 
     // setup model
     work->sim_in->model = model->sim_model;
@@ -798,9 +797,26 @@ void ocp_nlp_dynamics_cont_update_qp_matrices(void *config_, void *dims_, void *
         work->sim_in->S_adj[jj] = 0.0;
     blasfeo_unpack_dvec(nx1, mem->pi, 0, work->sim_in->S_adj, 1);
 
-    // call integrator
-    config->sim_solver->evaluate(config->sim_solver, work->sim_in, work->sim_out, opts->sim_solver,
-            mem->sim_solver, work->sim_solver);
+    return;
+}
+
+
+
+// build the QP matrices from the integrator output
+static void ocp_nlp_dynamics_cont_collect_sim_out(void *config_, void *dims_, void *model_,
+    void *opts_, void *mem_, void *work_)
+{
+    ocp_nlp_dynamics_config *config = config_;
+    ocp_nlp_dynamics_cont_dims *dims = dims_;
+    ocp_nlp_dynamics_cont_opts *opts = opts_;
+    ocp_nlp_dynamics_cont_workspace *work = work_;
+    ocp_nlp_dynamics_cont_memory *mem = mem_;
+
+    int nx = dims->nx;
+    int nu = dims->nu;
+    int nz = dims->nz;
+    int nx1 = dims->nx1;
+    int nu1 = dims->nu1;
 
     // TODO transition functions for changing dimensions not yet implemented!
 
@@ -862,6 +878,91 @@ void ocp_nlp_dynamics_cont_update_qp_matrices(void *config_, void *dims_, void *
 
 
 
+void ocp_nlp_dynamics_cont_update_qp_matrices(void *config_, void *dims_, void *model_, void *opts_, void *mem_, void *work_)
+{
+    ocp_nlp_dynamics_cont_cast_workspace(config_, dims_, opts_, work_);
+
+    ocp_nlp_dynamics_config *config = config_;
+    ocp_nlp_dynamics_cont_opts *opts = opts_;
+    ocp_nlp_dynamics_cont_workspace *work = work_;
+    ocp_nlp_dynamics_cont_memory *mem = mem_;
+
+    ocp_nlp_dynamics_cont_setup_sim_in(config_, dims_, model_, opts_, mem_, work_);
+
+    // call integrator
+    int trace_ev = acados_trace_begin("integrator", -1);
+    config->sim_solver->evaluate(config->sim_solver, work->sim_in, work->sim_out, opts->sim_solver,
+            mem->sim_solver, work->sim_solver);
+    acados_trace_end(trace_ev);
+
+    ocp_nlp_dynamics_cont_collect_sim_out(config_, dims_, model_, opts_, mem_, work_);
+
+    return;
+}
+
+
+
+void ocp_nlp_dynamics_cont_update_qp_matrices_batch(void **config_, void **dims_, void **model_,
+    void **opts_, void **mem_, void **work_, int n_batch)
+{
+    ocp_nlp_dynamics_config *config0 = config_[0];
+    sim_config *sim = config0->sim_solver;
+
+    // all integrators of the batch must share the batched entry point
+    int batch = sim->evaluate_batch != NULL;
+    for (int b = 1; b < n_batch; b++)
+    {
+        ocp_nlp_dynamics_config *config_b = config_[b];
+        if (config_b->sim_solver->evaluate_batch != sim->evaluate_batch)
+            batch = 0;
+    }
+
+    if (!batch || n_batch > OCP_NLP_DYNAMICS_BATCH_MAX)
+    {
+        for (int b = 0; b < n_batch; b++)
+            ocp_nlp_dynamics_cont_update_qp_matrices(config_[b], dims_[b], model_[b], opts_[b],
+                                                     mem_[b], work_[b]);
+        return;
+    }
+
+    sim_in *sim_in_b[OCP_NLP_DYNAMICS_BATCH_MAX];
+    sim_out *sim_out_b[OCP_NLP_DYNAMICS_BATCH_MAX];
+    void *sim_opts_b[OCP_NLP_DYNAMICS_BATCH_MAX];
+    void *sim_mem_b[OCP_NLP_DYNAMICS_BATCH_MAX];
+    void *sim_work_b[OCP_NLP_DYNAMICS_BATCH_MAX];
+
+    for (int b = 0; b < n_batch; b++)
+    {
+        ocp_nlp_dynamics_cont_cast_workspace(config_[b], dims_[b], opts_[b], work_[b]);
+
+        ocp_nlp_dynamics_cont_opts *opts = opts_[b];
+        ocp_nlp_dynamics_cont_workspace *work = work_[b];
+        ocp_nlp_dynamics_cont_memory *mem = mem_[b];
+
+        ocp_nlp_dynamics_cont_setup_sim_in(config_[b], dims_[b], model_[b], opts_[b], mem_[b],
+                                           work_[b]);
+
+        sim_in_b[b] = work->sim_in;
+        sim_out_b[b] = work->sim_out;
+        sim_opts_b[b] = opts->sim_solver;
+        sim_mem_b[b] = mem->sim_solver;
+        sim_work_b[b] = work->sim_solver;
+    }
+
+    // call integrators
+    int trace_ev = acados_trace_begin("integrator_batch", n_batch);
+    sim->evaluate_batch(sim, sim_in_b, sim_out_b, sim_opts_b, sim_mem_b, sim_work_b, n_batch);
+    acados_trace_end(trace_ev);
+
+    for (int b = 0; b < n_batch; b++)
+        ocp_nlp_dynamics_cont_collect_sim_out(config_[b], dims_[b], model_[b], opts_[b], mem_[b],
+                                              work_[b]);
+
+    return;
+}
+
+
+
 void ocp_nlp_dynamics_cont_compute_fun(void *config_, void *dims_, void *model_, void *opts_, void *mem_, void *work_)
 {
     ocp_nlp_dynamics_cont_cast_workspace(config_, dims_, opts_, work_);
@@ -995,6 +1096,7 @@ void ocp_nlp_dynamics_cont_config_initialize_default(void *config_)
     config->workspace_calculate_size = &ocp_nlp_dynamics_cont_workspace_calculate_size;
     config->initialize = &ocp_nlp_dynamics_cont_initialize;
     config->update_qp_matrices = &ocp_nlp_dynamics_cont_update_qp_matrices;
+    config->update_qp_matrices_batch = &ocp_nlp_dynamics_cont_update_qp_matrices_batch;
     config->compute_fun = &ocp_nlp_dynamics_cont_compute_fun;
     config->precompute = &ocp_nlp_dynamics_cont_precompute;
     config->config_initialize_default = &ocp_nlp_dynamics_cont_config_initialize_default;
@@ -0,0 +1,324 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#include "acados/ocp_nlp/ocp_nlp_globalization_filter.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// blasfeo
+#include "blasfeo/include/blasfeo_d_aux.h"
+#include "blasfeo/include/blasfeo_d_blas.h"
+// acados
+#include "acados/utils/mem.h"
+
+// switching condition: alpha * (-dphi)^S_PHI > DELTA * theta^S_THETA (Waechter2006, eq. (19))
+#define FILTER_S_THETA 1.1
+#define FILTER_S_PHI 2.3
+#define FILTER_DELTA 1.0
+
+
+
+/************************************************
+ * memory
+ ************************************************/
+
+acados_size_t ocp_nlp_filter_memory_calculate_size(int max_size)
+{
+    acados_size_t size = 0;
+
+    size += sizeof(ocp_nlp_filter_memory);
+
+    size += 2*max_size*sizeof(double);  // theta phi
+
+    size += 8;  // align
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+ocp_nlp_filter_memory *ocp_nlp_filter_memory_assign(int max_size, void *raw_memory)
+{
+    char *c_ptr = (char *) raw_memory;
+
+    ocp_nlp_filter_memory *filter = (ocp_nlp_filter_memory *) c_ptr;
+    c_ptr += sizeof(ocp_nlp_filter_memory);
+
+    align_char_to(8, &c_ptr);
+
+    assign_and_advance_double(max_size, &filter->theta, &c_ptr);
+    assign_and_advance_double(max_size, &filter->phi, &c_ptr);
+
+    filter->max_size = max_size;
+    filter->size = 0;
+    filter->theta_max = 0.0;
+    filter->theta_min = 0.0;
+
+    assert((char *) raw_memory + ocp_nlp_filter_memory_calculate_size(max_size) >= c_ptr);
+
+    return filter;
+}
+
+
+
+/************************************************
+ * functions
+ ************************************************/
+
+void ocp_nlp_filter_reset(ocp_nlp_filter_memory *filter)
+{
+    filter->size = 0;
+}
+
+
+
+int ocp_nlp_filter_is_acceptable(ocp_nlp_filter_memory *filter, double theta, double phi)
+{
+    // not acceptable if dominated by any filter entry
+    for (int j = 0; j < filter->size; j++)
+    {
+        if (theta >= filter->theta[j] && phi >= filter->phi[j])
+            return 0;
+    }
+    return 1;
+}
+
+
+
+void ocp_nlp_filter_add(ocp_nlp_filter_memory *filter, double theta, double phi)
+{
+    // remove the entries dominated by the new one
+    int n = 0;
+    for (int j = 0; j < filter->size; j++)
+    {
+        if (filter->theta[j] < theta || filter->phi[j] < phi)
+        {
+            filter->theta[n] = filter->theta[j];
+            filter->phi[n] = filter->phi[j];
+            n++;
+        }
+    }
+    filter->size = n;
+
+    if (filter->size == filter->max_size)
+    {
+        // drop the entry with the largest infeasibility
+        int j_max = 0;
+        for (int j = 1; j < filter->size; j++)
+        {
+            if (filter->theta[j] > filter->theta[j_max])
+                j_max = j;
+        }
+        filter->size--;
+        filter->theta[j_max] = filter->theta[filter->size];
+        filter->phi[j_max] = filter->phi[filter->size];
+    }
+
+    filter->theta[filter->size] = theta;
+    filter->phi[filter->size] = phi;
+    filter->size++;
+}
+
+
+
+// infeasibility measure: max norm of the dynamics residual and of the inequality violation
+static double ocp_nlp_filter_ineq_violation(int n, struct blasfeo_dvec *ineq_fun)
+{
+    double tmp, viol = 0.0;
+    for (int j = 0; j < n; j++)
+    {
+        tmp = BLASFEO_DVECEL(ineq_fun, j);
+        viol = tmp > viol ? tmp : viol;
+    }
+    return viol;
+}
+
+
+
+// infeasibility and objective at the trial point, after ocp_nlp_evaluate_fun
+static void ocp_nlp_filter_theta_phi_trial(ocp_nlp_config *config, ocp_nlp_dims *dims,
+            ocp_nlp_memory *mem, double *theta, double *phi)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *ni = dims->ni;
+
+    double tmp;
+
+    *theta = 0.0;
+    *phi = 0.0;
+    for (int i = 0; i <= N; i++)
+    {
+        *phi += *config->cost[i]->memory_get_fun_ptr(mem->cost[i]);
+
+        if (i < N)
+        {
+            blasfeo_dvecnrm_inf(nx[i+1], config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]),
+                                0, &tmp);
+            *theta = tmp > *theta ? tmp : *theta;
+        }
+
+        tmp = ocp_nlp_filter_ineq_violation(2*ni[i],
+                    config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]));
+        *theta = tmp > *theta ? tmp : *theta;
+    }
+}
+
+
+
+int ocp_nlp_filter_line_search(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+            ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work,
+            ocp_nlp_filter_memory *filter, double *alpha_out)
+{
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *ni = dims->ni;
+
+    ocp_qp_out *qp_out = mem->qp_out;
+
+    double gamma_theta = opts->filter_gamma_theta;
+    double gamma_phi = opts->filter_gamma_phi;
+    double tmp;
+
+    /* measures at the current iterate, from the linearization and the residuals in mem->nlp_res */
+    // NOTE: the module memories hold the function values at out until the first trial point
+    double theta_k = mem->nlp_res->inf_norm_res_eq;
+    double phi_k = 0.0;
+    double dphi = 0.0;  // directional derivative of the objective along the step
+    for (int i = 0; i <= N; i++)
+    {
+        tmp = ocp_nlp_filter_ineq_violation(2*ni[i], mem->ineq_fun+i);
+        theta_k = tmp > theta_k ? tmp : theta_k;
+        phi_k += *config->cost[i]->memory_get_fun_ptr(mem->cost[i]);
+        dphi += blasfeo_ddot(nv[i], mem->cost_grad+i, 0, qp_out->ux+i, 0);
+    }
+
+    if (mem->sqp_iter[0] == 0)
+    {
+        ocp_nlp_filter_reset(filter);
+        tmp = theta_k > 1.0 ? theta_k : 1.0;
+        filter->theta_max = 1e4 * tmp;
+        filter->theta_min = 1e-4 * tmp;
+    }
+
+    // f-type step: objective decrease dominates the infeasibility (switching condition)
+    int f_type = 0;
+    int accepted = 0;
+    double alpha = 1.0;
+    double theta, phi;
+    // trial point of least infeasibility, for the restoration step
+    double alpha_restore = 1.0;
+    double theta_restore = ACADOS_POS_INFTY;
+
+    for (int j = 0; ; j++)
+    {
+        // tmp_nlp_out = out + alpha * qp_out
+        for (int i = 0; i <= N; i++)
+            blasfeo_daxpy(nv[i], alpha, qp_out->ux+i, 0, out->ux+i, 0, work->tmp_nlp_out->ux+i, 0);
+
+        ocp_nlp_evaluate_fun(config, dims, in, out, opts, mem, work);
+        ocp_nlp_filter_theta_phi_trial(config, dims, mem, &theta, &phi);
+
+        if (opts->print_level > 1)
+        {
+            printf("filter line search %d: alpha %e, theta %e, phi %e; theta_k %e, phi_k %e\n",
+                   j, alpha, theta, phi, theta_k, phi_k);
+        }
+
+        if (theta < theta_restore)
+        {
+            theta_restore = theta;
+            alpha_restore = alpha;
+        }
+
+        if (theta <= filter->theta_max && ocp_nlp_filter_is_acceptable(filter, theta, phi))
+        {
+            f_type = dphi < 0.0 && theta_k <= filter->theta_min &&
+                     alpha * pow(-dphi, FILTER_S_PHI) > FILTER_DELTA * pow(theta_k, FILTER_S_THETA);
+            if (f_type)
+            {
+                // Armijo condition on the objective
+                if (phi <= phi_k + opts->eps_sufficient_descent * alpha * dphi)
+                {
+                    accepted = 1;
+                    break;
+                }
+            }
+            else if (theta <= (1.0 - gamma_theta) * theta_k || phi <= phi_k - gamma_phi * theta_k)
+            {
+                accepted = 1;
+                break;
+            }
+        }
+
+        if (alpha * opts->alpha_reduction <= opts->alpha_min)
+            break;
+        alpha *= opts->alpha_reduction;
+    }
+
+    if (!accepted)
+    {
+        /* minimal feasibility restoration: the trial step of least infeasibility, if it reduces the
+           infeasibility sufficiently; the current iterate enters the filter, such that the
+           iterates cannot return to it (instead of resetting the filter, which can cycle) */
+        if (theta_restore <= (1.0 - gamma_theta) * theta_k)
+        {
+            if (opts->print_level > 0)
+            {
+                printf("\nacados filter line search: no acceptable step length, "
+                       "restoration step alpha %e, theta %e -> %e\n",
+                       alpha_restore, theta_k, theta_restore);
+            }
+            ocp_nlp_filter_add(filter, theta_k, phi_k);
+            *alpha_out = alpha_restore;
+            return ACADOS_SUCCESS;
+        }
+
+        if (opts->print_level > 0)
+            printf("\nacados filter line search: no acceptable step length, no restoration step\n");
+        *alpha_out = alpha;
+        return ACADOS_MINSTEP;
+    }
+
+    if (!f_type)
+        ocp_nlp_filter_add(filter, (1.0 - gamma_theta) * theta_k, phi_k - gamma_phi * theta_k);
+
+    *alpha_out = alpha;
+    return ACADOS_SUCCESS;
+}
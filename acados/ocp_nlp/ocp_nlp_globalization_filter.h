@@ -0,0 +1,101 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+/// \addtogroup ocp_nlp
+/// @{
+/// \addtogroup ocp_nlp_solver
+/// @{
+/// \addtogroup ocp_nlp_globalization_filter ocp_nlp_globalization_filter
+/// \brief Filter line search globalization, following Waechter2006 (Section 2.3), with a
+/// minimal feasibility restoration: the backtracking step of least infeasibility.
+/// @{
+
+#ifndef ACADOS_OCP_NLP_OCP_NLP_GLOBALIZATION_FILTER_H_
+#define ACADOS_OCP_NLP_OCP_NLP_GLOBALIZATION_FILTER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// acados
+#include "acados/ocp_nlp/ocp_nlp_common.h"
+#include "acados/utils/types.h"
+
+
+
+/************************************************
+ * memory
+ ************************************************/
+
+typedef struct
+{
+    double *theta;      // infeasibility of the filter entries
+    double *phi;        // objective of the filter entries
+    int size;           // number of filter entries
+    int max_size;
+    double theta_max;   // trial points with larger infeasibility are rejected
+    double theta_min;   // f-type (Armijo) steps only below this infeasibility
+} ocp_nlp_filter_memory;
+
+//
+acados_size_t ocp_nlp_filter_memory_calculate_size(int max_size);
+//
+ocp_nlp_filter_memory *ocp_nlp_filter_memory_assign(int max_size, void *raw_memory);
+
+
+
+/************************************************
+ * functions
+ ************************************************/
+
+//
+void ocp_nlp_filter_reset(ocp_nlp_filter_memory *filter);
+//
+int ocp_nlp_filter_is_acceptable(ocp_nlp_filter_memory *filter, double theta, double phi);
+//
+void ocp_nlp_filter_add(ocp_nlp_filter_memory *filter, double theta, double phi);
+// step length in alpha; the trial points are evaluated in work->tmp_nlp_out;
+// returns ACADOS_MINSTEP if neither an acceptable nor a restoration step is found
+int ocp_nlp_filter_line_search(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+            ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work,
+            ocp_nlp_filter_memory *filter, double *alpha);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_OCP_NLP_OCP_NLP_GLOBALIZATION_FILTER_H_
+/// @}
+/// @}
+/// @}
@@ -41,6 +41,9 @@
 
 #include "acados/ocp_nlp/ocp_nlp_reg_common.h"
 
+#include "blasfeo/include/blasfeo_d_aux.h"
+#include "blasfeo/include/blasfeo_d_blas.h"
+
 
 
 /************************************************
@@ -224,4 +227,36 @@ void acados_project(int dim, double *A, double *V, double *d, double *e, double
 
 
 
+// projecting regularization, in place on the BLASFEO matrix
+void acados_project_dmat(int dim, struct blasfeo_dmat *A, int ai, int aj, struct blasfeo_dmat *V,
+                         struct blasfeo_dmat *W, double *d, double *work, double epsilon)
+{
+    int i;
+    int projected = 0;
+
+    acados_eigen_decomposition_dmat(dim, A, ai, aj, V, 0, 0, d, work);
+
+    // project
+    for (i = 0; i < dim; i++)
+    {
+        if (d[i] < epsilon)
+        {
+            d[i] = epsilon;
+            projected = 1;
+        }
+    }
+
+    // A is left untouched by the decomposition
+    if (!projected)
+        return;
+
+    // A = V * diag(d) * V'
+    blasfeo_dgecp(dim, dim, V, 0, 0, W, 0, 0);
+    for (i = 0; i < dim; i++)
+        blasfeo_dcolsc(dim, d[i], W, 0, i);
+    blasfeo_dgemm_nt(dim, dim, dim, 1.0, W, 0, 0, V, 0, 0, 0.0, A, ai, aj, A, ai, aj);
+}
+
+
+
 
@@ -97,6 +97,8 @@ typedef struct
     void (*memory_set_ux_ptr)(ocp_nlp_reg_dims *dims, struct blasfeo_dvec *vec, void *memory);
     void (*memory_set_pi_ptr)(ocp_nlp_reg_dims *dims, struct blasfeo_dvec *vec, void *memory);
     void (*memory_set_lam_ptr)(ocp_nlp_reg_dims *dims, struct blasfeo_dvec *vec, void *memory);
+    // optional, NULL if not implemented by the module
+    void (*memory_get)(void *config, ocp_nlp_reg_dims *dims, void *memory, char *field, void *value);
     /* functions */
     void (*regularize_hessian)(void *config, ocp_nlp_reg_dims *dims, void *opts, void *memory);
     void (*correct_dual_sol)(void *config, ocp_nlp_reg_dims *dims, void *opts, void *memory);
@@ -113,6 +115,10 @@ void *ocp_nlp_reg_config_assign(void *raw_memory);
 void acados_reconstruct_A(int dim, double *A, double *V, double *d);
 void acados_mirror(int dim, double *A, double *V, double *d, double *e, double epsilon);
 void acados_project(int dim, double *A, double *V, double *d, double *e, double epsilon);
+// projecting regularization on a BLASFEO matrix holding the full symmetric matrix,
+// V and W are dim x dim workspace matrices, work has acados_eigen_decomposition_dmat_work_size
+void acados_project_dmat(int dim, struct blasfeo_dmat *A, int ai, int aj, struct blasfeo_dmat *V,
+                         struct blasfeo_dmat *W, double *d, double *work, double epsilon);
 
 
 
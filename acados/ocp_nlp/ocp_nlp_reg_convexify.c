@@ -93,6 +93,10 @@ void ocp_nlp_reg_convexify_opts_set(void *config_, ocp_nlp_reg_dims *dims, void
         double *d_ptr = value;
         opts->epsilon = *d_ptr;
     }
+    else if (!strcmp(field, "num_threads"))
+    {
+        // sequential, nothing to do
+    }
     else
     {
         printf("\nerror: field %s not available in ocp_nlp_reg_convexify_opts_set\n", field);
@@ -86,6 +86,10 @@ void ocp_nlp_reg_mirror_opts_set(void *config_, ocp_nlp_reg_dims *dims, void *op
         double *d_ptr = value;
         opts->epsilon = *d_ptr;
     }
+    else if (!strcmp(field, "num_threads"))
+    {
+        // sequential, nothing to do
+    }
     else
     {
         printf("\nerror: field %s not available in ocp_nlp_reg_mirror_opts_set\n", field);
@@ -78,9 +78,17 @@ void ocp_nlp_reg_noreg_opts_initialize_default(void *config_, ocp_nlp_reg_dims *
 void ocp_nlp_reg_noreg_opts_set(void *config_, ocp_nlp_reg_dims *dims, void *opts_, char *field, void* value)
 {
 
-    printf("\nerror: field %s not available in ocp_nlp_reg_noreg_opts_set\n", field);
-    exit(1);
+    if (!strcmp(field, "num_threads"))
+    {
+        // sequential, nothing to do
+    }
+    else
+    {
+        printf("\nerror: field %s not available in ocp_nlp_reg_noreg_opts_set\n", field);
+        exit(1);
+    }
 
+    return;
 }
 
 
@@ -41,6 +41,7 @@
 
 #include "acados/ocp_nlp/ocp_nlp_reg_common.h"
 #include "acados/utils/math.h"
+#include "acados/utils/mem.h"
 
 #include "blasfeo/include/blasfeo_d_aux.h"
 #include "blasfeo/include/blasfeo_d_blas.h"
@@ -70,6 +71,8 @@ void ocp_nlp_reg_project_opts_initialize_default(void *config_, ocp_nlp_reg_dims
     ocp_nlp_reg_project_opts *opts = opts_;
 
     opts->epsilon = 1e-4;
+    opts->cholesky_first = 0;
+    opts->num_threads = 1;  // overwritten by the nlp opts num_threads
 
     return;
 }
@@ -86,6 +89,16 @@ void ocp_nlp_reg_project_opts_set(void *config_, ocp_nlp_reg_dims *dims, void *o
         double *d_ptr = value;
         opts->epsilon = *d_ptr;
     }
+    else if (!strcmp(field, "cholesky_first"))
+    {
+        int *i_ptr = value;
+        opts->cholesky_first = *i_ptr;
+    }
+    else if (!strcmp(field, "num_threads"))
+    {
+        int *i_ptr = value;
+        opts->num_threads = *i_ptr;
+    }
     else
     {
         printf("\nerror: field %s not available in ocp_nlp_reg_project_opts_set\n", field);
@@ -109,20 +122,24 @@ acados_size_t ocp_nlp_reg_project_memory_calculate_size(void *config_, ocp_nlp_r
 
     int ii;
 
-    int nuxM = nu[0]+nx[0];
-    for(ii=1; ii<=N; ii++)
-    {
-        nuxM = nu[ii]+nx[ii]>nuxM ? nu[ii]+nx[ii] : nuxM;
-    }
-
     acados_size_t size = 0;
 
     size += sizeof(ocp_nlp_reg_project_memory);
 
-    size += nuxM*nuxM*sizeof(double);  // reg_hess
-    size += nuxM*nuxM*sizeof(double);  // V
-    size += 2*nuxM*sizeof(double);     // d e
+    size += 2*(N+1)*sizeof(double *);  // d eig_work
     size += (N+1)*sizeof(struct blasfeo_dmat *); // RSQrq
+    size += 2*(N+1)*sizeof(struct blasfeo_dmat); // V W
+
+    for(ii=0; ii<=N; ii++)
+    {
+        int nux = nu[ii]+nx[ii];
+        size += nux*sizeof(double);  // d
+        size += acados_eigen_decomposition_dmat_work_size(nux)*sizeof(double);  // eig_work
+        size += 2*blasfeo_memsize_dmat(nux, nux);  // V W
+    }
+
+    size += 8;  // initial align
+    size += 64;  // blasfeo_mem align
 
     return size;
 }
@@ -137,32 +154,40 @@ void *ocp_nlp_reg_project_memory_assign(void *config_, ocp_nlp_reg_dims *dims, v
 
     int ii;
 
-    int nuxM = nu[0]+nx[0];
-    for(ii=1; ii<=N; ii++)
-    {
-        nuxM = nu[ii]+nx[ii]>nuxM ? nu[ii]+nx[ii] : nuxM;
-    }
-
     char *c_ptr = (char *) raw_memory;
 
     ocp_nlp_reg_project_memory *mem = (ocp_nlp_reg_project_memory *) c_ptr;
     c_ptr += sizeof(ocp_nlp_reg_project_memory);
 
-    mem->reg_hess = (double *) c_ptr;
-    c_ptr += nuxM*nuxM*sizeof(double);  // reg_hess
+    align_char_to(8, &c_ptr);
 
-    mem->V = (double *) c_ptr;
-    c_ptr += nuxM*nuxM*sizeof(double);  // V
-
-    mem->d = (double *) c_ptr;
-    c_ptr += nuxM*sizeof(double); // d
-
-    mem->e = (double *) c_ptr;
-    c_ptr += nuxM*sizeof(double); // e
+    assign_and_advance_double_ptrs(N+1, &mem->d, &c_ptr);
+    assign_and_advance_double_ptrs(N+1, &mem->eig_work, &c_ptr);
 
     mem->RSQrq = (struct blasfeo_dmat **) c_ptr;
     c_ptr += (N+1)*sizeof(struct blasfeo_dmat *); // RSQrq
 
+    assign_and_advance_blasfeo_dmat_structs(N+1, &mem->V, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(N+1, &mem->W, &c_ptr);
+
+    // blasfeo_mem align
+    align_char_to(64, &c_ptr);
+
+    for(ii=0; ii<=N; ii++)
+    {
+        assign_and_advance_blasfeo_dmat_mem(nu[ii]+nx[ii], nu[ii]+nx[ii], mem->V+ii, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nu[ii]+nx[ii], nu[ii]+nx[ii], mem->W+ii, &c_ptr);
+    }
+
+    for(ii=0; ii<=N; ii++)
+    {
+        assign_and_advance_double(nu[ii]+nx[ii], &mem->d[ii], &c_ptr);
+        assign_and_advance_double(acados_eigen_decomposition_dmat_work_size(nu[ii]+nx[ii]),
+                                  &mem->eig_work[ii], &c_ptr);
+    }
+
+    mem->num_projected = 0;
+
     assert((char *) mem + ocp_nlp_reg_project_memory_calculate_size(config_, dims, opts_) >= c_ptr);
 
     return mem;
@@ -170,6 +195,26 @@ void *ocp_nlp_reg_project_memory_assign(void *config_, ocp_nlp_reg_dims *dims, v
 
 
 
+void ocp_nlp_reg_project_memory_get(void *config_, ocp_nlp_reg_dims *dims, void *memory_, char *field, void *value)
+{
+    ocp_nlp_reg_project_memory *mem = memory_;
+
+    if (!strcmp(field, "num_projected"))
+    {
+        int *i_ptr = value;
+        *i_ptr = mem->num_projected;
+    }
+    else
+    {
+        printf("\nerror: field %s not available in ocp_nlp_reg_project_memory_get\n", field);
+        exit(1);
+    }
+
+    return;
+}
+
+
+
 void ocp_nlp_reg_project_memory_set_RSQrq_ptr(ocp_nlp_reg_dims *dims, struct blasfeo_dmat *RSQrq, void *memory_)
 {
     ocp_nlp_reg_project_memory *memory = memory_;
@@ -275,21 +320,51 @@ void ocp_nlp_reg_project_regularize_hessian(void *config, ocp_nlp_reg_dims *dims
     ocp_nlp_reg_project_memory *mem = (ocp_nlp_reg_project_memory *) mem_;
     ocp_nlp_reg_project_opts *opts = opts_;
 
-    int ii;
-
     int *nx = dims->nx;
     int *nu = dims->nu;
 
-    for(ii=0; ii<=dims->N; ii++)
+    int num_projected = 0;
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(opts->num_threads) schedule(static) reduction(+:num_projected)
+#endif
+    for(int ii=0; ii<=dims->N; ii++)
     {
-        // make symmetric
-        blasfeo_dtrtr_l(nu[ii]+nx[ii], mem->RSQrq[ii], 0, 0, mem->RSQrq[ii], 0, 0);
+        int nux = nu[ii]+nx[ii];
 
-        // regularize
-        blasfeo_unpack_dmat(nu[ii]+nx[ii], nu[ii]+nx[ii], mem->RSQrq[ii], 0, 0, mem->reg_hess, nu[ii]+nx[ii]);
-        acados_project(nu[ii]+nx[ii], mem->reg_hess, mem->V, mem->d, mem->e, opts->epsilon);
-        blasfeo_pack_dmat(nu[ii]+nx[ii], nu[ii]+nx[ii], mem->reg_hess, nu[ii]+nx[ii], mem->RSQrq[ii], 0, 0);
+        // make symmetric
+        blasfeo_dtrtr_l(nux, mem->RSQrq[ii], 0, 0, mem->RSQrq[ii], 0, 0);
+
+        if (opts->cholesky_first)
+        {
+            // all eigenvalues larger than epsilon <=> RSQrq - epsilon*I positive definite,
+            // in that case the projection would not change the Hessian
+            blasfeo_dgecp(nux, nux, mem->RSQrq[ii], 0, 0, mem->W+ii, 0, 0);
+            blasfeo_ddiare(nux, -opts->epsilon, mem->W+ii, 0, 0);
+            blasfeo_dpotrf_l(nux, mem->W+ii, 0, 0, mem->W+ii, 0, 0);
+
+            // NOTE: dpotrf sets the diagonal to zero at non-positive pivots
+            int pos_def = 1;
+            for(int jj=0; jj<nux; jj++)
+            {
+                if (!(blasfeo_dgeex1(mem->W+ii, jj, jj) > 0.0))
+                {
+                    pos_def = 0;
+                    break;
+                }
+            }
+            if (pos_def)
+                continue;
+        }
+
+        num_projected++;
+
+        // regularize, in place on RSQrq
+        acados_project_dmat(nux, mem->RSQrq[ii], 0, 0, mem->V+ii, mem->W+ii, mem->d[ii],
+                            mem->eig_work[ii], opts->epsilon);
     }
+
+    mem->num_projected = num_projected;
 }
 
 
@@ -325,6 +400,7 @@ void ocp_nlp_reg_project_config_initialize_default(ocp_nlp_reg_config *config)
     config->memory_set_ux_ptr = &ocp_nlp_reg_project_memory_set_ux_ptr;
     config->memory_set_pi_ptr = &ocp_nlp_reg_project_memory_set_pi_ptr;
     config->memory_set_lam_ptr = &ocp_nlp_reg_project_memory_set_lam_ptr;
+    config->memory_get = &ocp_nlp_reg_project_memory_get;
     // functions
     config->regularize_hessian = &ocp_nlp_reg_project_regularize_hessian;
     config->correct_dual_sol = &ocp_nlp_reg_project_correct_dual_sol;
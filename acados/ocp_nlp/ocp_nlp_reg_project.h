@@ -67,6 +67,8 @@ extern "C" {
 typedef struct
 {
     double epsilon;
+    int cholesky_first;  // skip the projection of stages whose Cholesky shows eig > epsilon
+    int num_threads;
 } ocp_nlp_reg_project_opts;
 
 //
@@ -86,19 +88,24 @@ void ocp_nlp_reg_project_opts_set(void *config_, ocp_nlp_reg_dims *dims, void *o
 
 typedef struct
 {
-    double *reg_hess; // TODO move to workspace
-    double *V; // TODO move to workspace
-    double *d; // TODO move to workspace
-    double *e; // TODO move to workspace
+    // per stage scratch, such that the stages can be regularized in parallel
+    struct blasfeo_dmat *V;  // eigenvectors
+    struct blasfeo_dmat *W;  // Cholesky factor for the positive definiteness test, projection workspace
+    double **d;  // eigenvalues
+    double **eig_work;  // eigen decomposition workspace
 
     // giaf's
     struct blasfeo_dmat **RSQrq;  // pointer to RSQrq in qp_in
+
+    int num_projected;  // number of stages projected in the last call
 } ocp_nlp_reg_project_memory;
 
 //
 acados_size_t ocp_nlp_reg_project_memory_calculate_size(void *config, ocp_nlp_reg_dims *dims, void *opts);
 //
 void *ocp_nlp_reg_project_memory_assign(void *config, ocp_nlp_reg_dims *dims, void *opts, void *raw_memory);
+//
+void ocp_nlp_reg_project_memory_get(void *config, ocp_nlp_reg_dims *dims, void *memory, char *field, void *value);
 
 /************************************************
  * workspace
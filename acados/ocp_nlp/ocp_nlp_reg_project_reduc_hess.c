@@ -105,6 +105,10 @@ void ocp_nlp_reg_project_reduc_hess_opts_set(void *config_, ocp_nlp_reg_dims *di
         int *i_ptr = value;
         opts->pivoting = *i_ptr;
     }
+    else if (!strcmp(field, "num_threads"))
+    {
+        // sequential, nothing to do
+    }
     else
     {
         printf("\nerror: field %s not available in ocp_nlp_reg_project_reduc_hess_opts_set\n", field);
@@ -52,7 +52,9 @@
 #include "acados/ocp_nlp/ocp_nlp_common.h"
 #include "acados/ocp_nlp/ocp_nlp_dynamics_cont.h"
 #include "acados/ocp_nlp/ocp_nlp_reg_common.h"
+#include "acados/dense_qp/dense_qp_hpipm.h"
 #include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/ocp_qp/ocp_qp_hpipm.h"
 #include "acados/utils/mem.h"
 #include "acados/utils/print.h"
 #include "acados/utils/timing.h"
@@ -126,12 +128,17 @@ void ocp_nlp_sqp_opts_initialize_default(void *config_, void *dims_, void *opts_
 
     opts->qp_warm_start = 0;
     opts->warm_start_first_qp = false;
+    opts->soc_qp_hot_start = 0;
     opts->rti_phase = 0;
     opts->initialize_t_slacks = 0;
 
     // overwrite default submodules opts
 
     // qp tolerance
+    opts->qp_tol_stat = opts->tol_stat;
+    opts->qp_tol_eq = opts->tol_eq;
+    opts->qp_tol_ineq = opts->tol_ineq;
+    opts->qp_tol_comp = opts->tol_comp;
     qp_solver->opts_set(qp_solver, opts->nlp_opts->qp_solver_opts, "tol_stat", &opts->tol_stat);
     qp_solver->opts_set(qp_solver, opts->nlp_opts->qp_solver_opts, "tol_eq", &opts->tol_eq);
     qp_solver->opts_set(qp_solver, opts->nlp_opts->qp_solver_opts, "tol_ineq", &opts->tol_ineq);
@@ -189,6 +196,26 @@ void ocp_nlp_sqp_opts_set(void *config_, void *opts_, const char *field, void* v
             int* i_ptr = (int *) value;
             opts->qp_warm_start = *i_ptr;
         }
+        else if (!strcmp(field, "qp_tol_stat"))
+        {
+            double* d_ptr = (double *) value;
+            opts->qp_tol_stat = *d_ptr;
+        }
+        else if (!strcmp(field, "qp_tol_eq"))
+        {
+            double* d_ptr = (double *) value;
+            opts->qp_tol_eq = *d_ptr;
+        }
+        else if (!strcmp(field, "qp_tol_ineq"))
+        {
+            double* d_ptr = (double *) value;
+            opts->qp_tol_ineq = *d_ptr;
+        }
+        else if (!strcmp(field, "qp_tol_comp"))
+        {
+            double* d_ptr = (double *) value;
+            opts->qp_tol_comp = *d_ptr;
+        }
     }
     else // nlp opts
     {
@@ -201,6 +228,7 @@ void ocp_nlp_sqp_opts_set(void *config_, void *opts_, const char *field, void* v
         {
             double* tol_stat = (double *) value;
             opts->tol_stat = *tol_stat;
+            opts->qp_tol_stat = *tol_stat;
             // TODO: set accuracy of the qp_solver to the minimum of current QP accuracy and the one specified.
             config->qp_solver->opts_set(config->qp_solver, opts->nlp_opts->qp_solver_opts, "tol_stat", value);
         }
@@ -208,6 +236,7 @@ void ocp_nlp_sqp_opts_set(void *config_, void *opts_, const char *field, void* v
         {
             double* tol_eq = (double *) value;
             opts->tol_eq = *tol_eq;
+            opts->qp_tol_eq = *tol_eq;
             // TODO: set accuracy of the qp_solver to the minimum of current QP accuracy and the one specified.
             config->qp_solver->opts_set(config->qp_solver, opts->nlp_opts->qp_solver_opts, "tol_eq", value);
         }
@@ -215,6 +244,7 @@ void ocp_nlp_sqp_opts_set(void *config_, void *opts_, const char *field, void* v
         {
             double* tol_ineq = (double *) value;
             opts->tol_ineq = *tol_ineq;
+            opts->qp_tol_ineq = *tol_ineq;
             // TODO: set accuracy of the qp_solver to the minimum of current QP accuracy and the one specified.
             config->qp_solver->opts_set(config->qp_solver, opts->nlp_opts->qp_solver_opts, "tol_ineq", value);
         }
@@ -222,6 +252,7 @@ void ocp_nlp_sqp_opts_set(void *config_, void *opts_, const char *field, void* v
         {
             double* tol_comp = (double *) value;
             opts->tol_comp = *tol_comp;
+            opts->qp_tol_comp = *tol_comp;
             // TODO: set accuracy of the qp_solver to the minimum of current QP accuracy and the one specified.
             config->qp_solver->opts_set(config->qp_solver, opts->nlp_opts->qp_solver_opts, "tol_comp", value);
         }
@@ -235,6 +266,19 @@ void ocp_nlp_sqp_opts_set(void *config_, void *opts_, const char *field, void* v
             bool* warm_start_first_qp = (bool *) value;
             opts->warm_start_first_qp = *warm_start_first_qp;
         }
+        else if (!strcmp(field, "soc_qp_hot_start"))
+        {
+            int* soc_qp_hot_start = (int *) value;
+            // needs the QP sensitivities, only implemented in HPIPM
+            qp_solver_config *qp_solver = config->qp_solver->qp_solver;
+            if (*soc_qp_hot_start && qp_solver->eval_sens != &ocp_qp_hpipm_eval_sens &&
+                qp_solver->eval_sens != &dense_qp_hpipm_eval_sens)
+            {
+                printf("\nerror: ocp_nlp_sqp_opts_set: soc_qp_hot_start needs HPIPM.\n");
+                exit(1);
+            }
+            opts->soc_qp_hot_start = *soc_qp_hot_start;
+        }
         else if (!strcmp(field, "rti_phase"))
         {
             int* rti_phase = (int *) value;
@@ -310,7 +354,10 @@ acados_size_t ocp_nlp_sqp_memory_calculate_size(void *config_, void *dims_, void
         stat_n += 4;
     size += stat_n*stat_m*sizeof(double);
 
-    size += 3*8;  // align
+    // filter
+    size += ocp_nlp_filter_memory_calculate_size(opts->max_iter+1);
+
+    size += 4*8;  // align
 
     make_int_multiple_of(8, &size);
 
@@ -358,6 +405,12 @@ void *ocp_nlp_sqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
         mem->stat_n += 4;
     c_ptr += mem->stat_m*mem->stat_n*sizeof(double);
 
+    align_char_to(8, &c_ptr);
+
+    // filter
+    mem->filter = ocp_nlp_filter_memory_assign(opts->max_iter+1, c_ptr);
+    c_ptr += ocp_nlp_filter_memory_calculate_size(opts->max_iter+1);
+
     mem->status = ACADOS_READY;
 
     align_char_to(8, &c_ptr);
@@ -379,6 +432,9 @@ acados_size_t ocp_nlp_sqp_workspace_calculate_size(void *config_, void *dims_, v
     ocp_nlp_config *config = config_;
     ocp_nlp_sqp_opts *opts = opts_;
     ocp_nlp_opts *nlp_opts = opts->nlp_opts;
+    ocp_qp_dims *qp_dims = dims->qp_solver->orig_dims;
+
+    int N = dims->N;
 
     acados_size_t size = 0;
 
@@ -394,15 +450,25 @@ acados_size_t ocp_nlp_sqp_workspace_calculate_size(void *config_, void *dims_, v
     // tmp qp out
     size += ocp_qp_out_calculate_size(dims->qp_solver->orig_dims);
 
-    if (opts->ext_qp_res)
-    {
-        // qp res
-        size += ocp_qp_res_calculate_size(dims->qp_solver->orig_dims);
+    // qp res (always, soc_qp_hot_start can be set after memory allocation)
+    size += ocp_qp_res_calculate_size(qp_dims);
+
+    // qp res ws
+    size += ocp_qp_res_workspace_calculate_size(qp_dims);
 
-        // qp res ws
-        size += ocp_qp_res_workspace_calculate_size(dims->qp_solver->orig_dims);
+    // soc_b, soc_d, soc_rqz
+    size += (3*N+2)*sizeof(struct blasfeo_dvec);
+    for (int ii = 0; ii <= N; ii++)
+    {
+        if (ii < N)
+            size += blasfeo_memsize_dvec(qp_dims->nx[ii+1]);
+        size += blasfeo_memsize_dvec(2*qp_dims->nb[ii]+2*qp_dims->ng[ii]+2*qp_dims->ns[ii]);
+        size += blasfeo_memsize_dvec(qp_dims->nx[ii]+qp_dims->nu[ii]+2*qp_dims->ns[ii]);
     }
 
+    size += 8;   // blasfeo_struct align
+    size += 64;  // blasfeo_mem align
+
     return size;
 }
 
@@ -413,6 +479,9 @@ static void ocp_nlp_sqp_cast_workspace(ocp_nlp_config *config, ocp_nlp_dims *dim
 {
     ocp_nlp_opts *nlp_opts = opts->nlp_opts;
     ocp_nlp_memory *nlp_mem = mem->nlp_mem;
+    ocp_qp_dims *qp_dims = dims->qp_solver->orig_dims;
+
+    int N = dims->N;
 
     // sqp
     char *c_ptr = (char *) work;
@@ -430,15 +499,31 @@ static void ocp_nlp_sqp_cast_workspace(ocp_nlp_config *config, ocp_nlp_dims *dim
     work->tmp_qp_out = ocp_qp_out_assign(dims->qp_solver->orig_dims, c_ptr);
     c_ptr += ocp_qp_out_calculate_size(dims->qp_solver->orig_dims);
 
-    if (opts->ext_qp_res)
-    {
-        // qp res
-        work->qp_res = ocp_qp_res_assign(dims->qp_solver->orig_dims, c_ptr);
-        c_ptr += ocp_qp_res_calculate_size(dims->qp_solver->orig_dims);
+    // qp res (always, soc_qp_hot_start can be set after memory allocation)
+    work->qp_res = ocp_qp_res_assign(qp_dims, c_ptr);
+    c_ptr += ocp_qp_res_calculate_size(qp_dims);
+
+    // qp res ws
+    work->qp_res_ws = ocp_qp_res_workspace_assign(qp_dims, c_ptr);
+    c_ptr += ocp_qp_res_workspace_calculate_size(qp_dims);
+
+    align_char_to(8, &c_ptr);
+
+    // soc_b, soc_d, soc_rqz
+    assign_and_advance_blasfeo_dvec_structs(N, &work->soc_b, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->soc_d, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->soc_rqz, &c_ptr);
 
-        // qp res ws
-        work->qp_res_ws = ocp_qp_res_workspace_assign(dims->qp_solver->orig_dims, c_ptr);
-        c_ptr += ocp_qp_res_workspace_calculate_size(dims->qp_solver->orig_dims);
+    align_char_to(64, &c_ptr);
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        if (ii < N)
+            assign_and_advance_blasfeo_dvec_mem(qp_dims->nx[ii+1], work->soc_b+ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(2*qp_dims->nb[ii]+2*qp_dims->ng[ii]+2*qp_dims->ns[ii],
+                                            work->soc_d+ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(qp_dims->nx[ii]+qp_dims->nu[ii]+2*qp_dims->ns[ii],
+                                            work->soc_rqz+ii, &c_ptr);
     }
 
     assert((char *) work + ocp_nlp_sqp_workspace_calculate_size(config, dims, opts) >= c_ptr);
@@ -448,6 +533,105 @@ static void ocp_nlp_sqp_cast_workspace(ocp_nlp_config *config, ocp_nlp_dims *dim
 
 
 
+// SOC QP by back-substitution with the KKT factorization of the last QP solve:
+// the SOC QP in qp_in differs from the last QP only in b and d, whose values are kept in
+// work->soc_b and work->soc_d. The step of the solution is linear in their difference as long as
+// the active set does not change, returns 1 if so and the corrected point satisfies the KKT
+// conditions of the SOC QP up to the QP solver tolerances (opts->qp_tol_*), the SOC QP solution
+// is then in qp_out; returns 0 otherwise (qp_out unchanged).
+static int ocp_nlp_sqp_soc_qp_hot_start(ocp_nlp_config *config, ocp_nlp_dims *dims,
+         ocp_nlp_sqp_opts *opts, ocp_nlp_sqp_memory *mem, ocp_nlp_sqp_workspace *work)
+{
+    ocp_nlp_memory *nlp_mem = mem->nlp_mem;
+    ocp_qp_in *qp_in = nlp_mem->qp_in;
+    ocp_qp_out *qp_out = nlp_mem->qp_out;
+    ocp_qp_out *dqp_out = work->tmp_qp_out;
+
+    int N = dims->N;
+    int *nx = qp_out->dim->nx;
+    int *nu = qp_out->dim->nu;
+    int *nb = qp_out->dim->nb;
+    int *ng = qp_out->dim->ng;
+    int *ns = qp_out->dim->ns;
+
+    int ii, jj, ni, nv;
+    double qp_res[4];
+
+    // rhs of the sensitivity: difference in b and d, zero gradient (in place in qp_in)
+    for (ii = 0; ii <= N; ii++)
+    {
+        ni = 2*(nb[ii]+ng[ii]+ns[ii]);
+        nv = nx[ii]+nu[ii]+2*ns[ii];
+        if (ii < N)
+            blasfeo_daxpy(nx[ii+1], -1.0, work->soc_b+ii, 0, qp_in->b+ii, 0, qp_in->b+ii, 0);
+        blasfeo_daxpy(ni, -1.0, work->soc_d+ii, 0, qp_in->d+ii, 0, qp_in->d+ii, 0);
+        blasfeo_dveccp(nv, qp_in->rqz+ii, 0, work->soc_rqz+ii, 0);
+        blasfeo_dvecse(nv, 0.0, qp_in->rqz+ii, 0);
+    }
+
+    config->qp_solver->eval_sens(config->qp_solver, dims->qp_solver, qp_in, dqp_out,
+                                 opts->nlp_opts->qp_solver_opts, nlp_mem->qp_solver_mem,
+                                 work->nlp_work->qp_work);
+
+    // restore the SOC QP
+    for (ii = 0; ii <= N; ii++)
+    {
+        ni = 2*(nb[ii]+ng[ii]+ns[ii]);
+        nv = nx[ii]+nu[ii]+2*ns[ii];
+        if (ii < N)
+            blasfeo_daxpy(nx[ii+1], 1.0, work->soc_b+ii, 0, qp_in->b+ii, 0, qp_in->b+ii, 0);
+        blasfeo_daxpy(ni, 1.0, work->soc_d+ii, 0, qp_in->d+ii, 0, qp_in->d+ii, 0);
+        blasfeo_dveccp(nv, work->soc_rqz+ii, 0, qp_in->rqz+ii, 0);
+    }
+
+    // corrected point in dqp_out
+    for (ii = 0; ii <= N; ii++)
+    {
+        ni = 2*(nb[ii]+ng[ii]+ns[ii]);
+        nv = nx[ii]+nu[ii]+2*ns[ii];
+        blasfeo_daxpy(nv, 1.0, qp_out->ux+ii, 0, dqp_out->ux+ii, 0, dqp_out->ux+ii, 0);
+        blasfeo_daxpy(ni, 1.0, qp_out->lam+ii, 0, dqp_out->lam+ii, 0, dqp_out->lam+ii, 0);
+        blasfeo_daxpy(ni, 1.0, qp_out->t+ii, 0, dqp_out->t+ii, 0, dqp_out->t+ii, 0);
+        if (ii < N)
+            blasfeo_daxpy(nx[ii+1], 1.0, qp_out->pi+ii, 0, dqp_out->pi+ii, 0, dqp_out->pi+ii, 0);
+    }
+
+    // active set has to be unchanged, i.e. multipliers and slacks stay nonnegative
+    for (ii = 0; ii <= N; ii++)
+    {
+        ni = 2*(nb[ii]+ng[ii]+ns[ii]);
+        for (jj = 0; jj < ni; jj++)
+        {
+            if (BLASFEO_DVECEL(dqp_out->lam+ii, jj) < 0.0 ||
+                BLASFEO_DVECEL(dqp_out->t+ii, jj) < 0.0)
+                return 0;
+        }
+    }
+
+    // KKT residual of the corrected point, complementarity is violated by dlam*dt
+    ((qp_info *) dqp_out->misc)->t_computed = 1;
+    ocp_qp_res_compute(qp_in, dqp_out, work->qp_res, work->qp_res_ws);
+    ocp_qp_res_compute_nrm_inf(work->qp_res, qp_res);
+    if (qp_res[0] > opts->qp_tol_stat || qp_res[1] > opts->qp_tol_eq ||
+        qp_res[2] > opts->qp_tol_ineq || qp_res[3] > opts->qp_tol_comp)
+        return 0;
+
+    for (ii = 0; ii <= N; ii++)
+    {
+        ni = 2*(nb[ii]+ng[ii]+ns[ii]);
+        nv = nx[ii]+nu[ii]+2*ns[ii];
+        blasfeo_dveccp(nv, dqp_out->ux+ii, 0, qp_out->ux+ii, 0);
+        blasfeo_dveccp(ni, dqp_out->lam+ii, 0, qp_out->lam+ii, 0);
+        blasfeo_dveccp(ni, dqp_out->t+ii, 0, qp_out->t+ii, 0);
+        if (ii < N)
+            blasfeo_dveccp(nx[ii+1], dqp_out->pi+ii, 0, qp_out->pi+ii, 0);
+    }
+
+    return 1;
+}
+
+
+
 /************************************************
  * functions
  ************************************************/
@@ -487,17 +671,14 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
     mem->time_sim = 0.0;
     mem->time_sim_la = 0.0;
     mem->time_sim_ad = 0.0;
+    mem->time_qp_soc = 0.0;
+    mem->qp_iter_soc = 0;
+    ocp_nlp_timings_reset(dims, nlp_mem);
 
     int N = dims->N;
     int ii, qp_iter, qp_status;
     double alpha;
 
-#if defined(ACADOS_WITH_OPENMP)
-    // backup number of threads
-    int num_threads_bkp = omp_get_num_threads();
-    // set number of threads
-    omp_set_num_threads(opts->nlp_opts->num_threads);
-#endif
     ocp_nlp_alias_memory_to_submodules(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
 
     //
@@ -511,11 +692,17 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
     int sqp_iter = 0;
     nlp_mem->sqp_iter = &sqp_iter;
 
+    int trace_iter, trace_ev;
+
     for (; sqp_iter < opts->max_iter; sqp_iter++)
     {
+        trace_iter = acados_trace_begin("sqp_iter", sqp_iter);
+
         // linearizate NLP and update QP matrices
         acados_tic(&timer1);
+        trace_ev = acados_trace_begin("linearization", -1);
         ocp_nlp_approximate_qp_matrices(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
+        acados_trace_end(trace_ev);
         mem->time_lin += acados_toc(&timer1);
 
         #ifdef MEASURE_TIMINGS
@@ -559,13 +746,11 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
             (nlp_res->inf_norm_res_ineq < opts->tol_ineq) &
             (nlp_res->inf_norm_res_comp < opts->tol_comp))
         {
-#if defined(ACADOS_WITH_OPENMP)
-            // restore number of threads
-            omp_set_num_threads(num_threads_bkp);
-#endif
             mem->status = ACADOS_SUCCESS;
             mem->sqp_iter = sqp_iter;
+            acados_trace_end(trace_iter);
             mem->time_tot = acados_toc(&timer0);
+            ocp_nlp_timings_add_latency(nlp_mem, mem->time_tot);
 
             if (nlp_opts->print_level > 0)
             {
@@ -602,8 +787,10 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
         }
         // solve qp
         acados_tic(&timer1);
+        trace_ev = acados_trace_begin("qp", -1);
         qp_status = qp_solver->evaluate(qp_solver, dims->qp_solver, qp_in, qp_out,
                                         opts->nlp_opts->qp_solver_opts, nlp_mem->qp_solver_mem, nlp_work->qp_work);
+        acados_trace_end(trace_ev);
         mem->time_qp_sol += acados_toc(&timer1);
 
         qp_solver->memory_get(qp_solver, nlp_mem->qp_solver_mem, "time_qp_solver_call", &tmp_time);
@@ -676,10 +863,6 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
             printf("\nQP solver returned error status %d in SQP iteration %d, QP iteration %d.\n",
                    qp_status, sqp_iter, qp_iter);
 #endif
-#if defined(ACADOS_WITH_OPENMP)
-            // restore number of threads
-            omp_set_num_threads(num_threads_bkp);
-#endif
 
             if (nlp_opts->print_level > 1)
             {
@@ -690,7 +873,9 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 
             mem->status = ACADOS_QP_FAILURE;
             mem->sqp_iter = sqp_iter;
+            acados_trace_end(trace_iter);
             mem->time_tot = acados_toc(&timer0);
+            ocp_nlp_timings_add_latency(nlp_mem, mem->time_tot);
 
             return mem->status;
         }
@@ -699,6 +884,7 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
         // NOTE on timings: currently all within globalization is accounted for within time_glob.
         //   QP solver times could be also attributed there alternatively. Cleanest would be to save them seperately.
         acados_tic(&timer1);
+        trace_ev = acados_trace_begin("globalization", -1);
         bool do_line_search = true;
         if (opts->nlp_opts->globalization_use_SOC && opts->nlp_opts->globalization == MERIT_BACKTRACKING)
         {
@@ -762,6 +948,18 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
     // #if defined(ACADOS_WITH_OPENMP)
     //     #pragma omp parallel for
     // #endif
+                // keep the rhs of the last QP, to get the SOC rhs as difference to it
+                if (opts->soc_qp_hot_start)
+                {
+                    for (ii = 0; ii <= N; ii++)
+                    {
+                        if (ii < N)
+                            blasfeo_dveccp(nx[ii+1], qp_in->b+ii, 0, work->soc_b+ii, 0);
+                        blasfeo_dveccp(2*nb[ii]+2*ng[ii]+2*ns[ii], qp_in->d+ii, 0,
+                                       work->soc_d+ii, 0);
+                    }
+                }
+
                 // update QP rhs
                 // d_i = c_i(x_k + p_k) - \nabla c_i(x_k)^T * p_k
                 struct blasfeo_dvec *tmp_fun_vec;
@@ -838,9 +1036,33 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
                 }
 
                 // solve QP
-                // acados_tic(&timer1);
-                qp_status = qp_solver->evaluate(qp_solver, dims->qp_solver, qp_in, qp_out,
-                                                opts->nlp_opts->qp_solver_opts, nlp_mem->qp_solver_mem, nlp_work->qp_work);
+                acados_timer timer_soc;
+                acados_tic(&timer_soc);
+                if (opts->soc_qp_hot_start && ocp_nlp_sqp_soc_qp_hot_start(config, dims, opts, mem, work))
+                {
+                    qp_status = ACADOS_SUCCESS;
+                    qp_iter = 0;
+                }
+                else
+                {
+                    // active set changed or correction not accurate enough:
+                    // IPM warm started from the last QP solution
+                    if (opts->soc_qp_hot_start)
+                    {
+                        int tmp_int = 2;
+                        qp_solver->opts_set(qp_solver, opts->nlp_opts->qp_solver_opts, "warm_start", &tmp_int);
+                    }
+                    qp_status = qp_solver->evaluate(qp_solver, dims->qp_solver, qp_in, qp_out,
+                                                    opts->nlp_opts->qp_solver_opts, nlp_mem->qp_solver_mem, nlp_work->qp_work);
+                    if (opts->soc_qp_hot_start)
+                    {
+                        qp_solver->opts_set(qp_solver, opts->nlp_opts->qp_solver_opts, "warm_start", &opts->qp_warm_start);
+                    }
+                    ocp_qp_out_get(qp_out, "qp_info", &qp_info_);
+                    qp_iter = qp_info_->num_iter;
+                }
+                mem->time_qp_soc += acados_toc(&timer_soc);
+                mem->qp_iter_soc += qp_iter;
                 // tmp_time = acados_toc(&timer1);
                 // mem->time_qp_sol += tmp_time;
                 // qp_solver->memory_get(qp_solver, nlp_mem->qp_solver_mem, "time_qp_solver_call", &tmp_time);
@@ -854,11 +1076,7 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
                                                     opts->nlp_opts->regularize, nlp_mem->regularize_mem);
                 // mem->time_reg += acados_toc(&timer1);
 
-                ocp_qp_out_get(qp_out, "qp_info", &qp_info_);
-                qp_iter = qp_info_->num_iter;
-
                 // save statistics of last qp solver call
-                // TODO: SOC QP solver call should be warm / hot started!
                 if (sqp_iter+1 < mem->stat_m)
                 {
                     // mem->stat[mem->stat_n*(sqp_iter+1)+4] = qp_status;
@@ -895,10 +1113,6 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
                     printf("\nQP solver returned error status %d in SQP iteration %d for SOC QP in QP iteration %d.\n",
                         qp_status, sqp_iter, qp_iter);
         #endif
-        #if defined(ACADOS_WITH_OPENMP)
-                    // restore number of threads
-                    omp_set_num_threads(num_threads_bkp);
-        #endif
 
                     if (nlp_opts->print_level > 1)
                     {
@@ -909,7 +1123,10 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 
                     mem->status = ACADOS_QP_FAILURE;
                     mem->sqp_iter = sqp_iter;
+                    acados_trace_end(trace_ev);
+                    acados_trace_end(trace_iter);
                     mem->time_tot = acados_toc(&timer0);
+                    ocp_nlp_timings_add_latency(nlp_mem, mem->time_tot);
 
                     return mem->status;
                 }
@@ -920,10 +1137,32 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
             }
         }
 
-        if (do_line_search)
+        if (nlp_opts->globalization == FILTER_LINE_SEARCH)
+        {
+            int ls_status = ocp_nlp_filter_line_search(config, dims, nlp_in, nlp_out, nlp_opts,
+                                                       nlp_mem, nlp_work, mem->filter, &alpha);
+            if (ls_status != ACADOS_SUCCESS)
+            {
+#ifndef ACADOS_SILENT
+                printf("\nocp_nlp_sqp: filter line search found no step in SQP iteration %d.\n",
+                       sqp_iter);
+#endif
+                mem->status = ls_status;
+                mem->sqp_iter = sqp_iter;
+                acados_trace_end(trace_ev);
+                acados_trace_end(trace_iter);
+                mem->time_glob += acados_toc(&timer1);
+                mem->time_tot = acados_toc(&timer0);
+                ocp_nlp_timings_add_latency(nlp_mem, mem->time_tot);
+
+                return mem->status;
+            }
+        }
+        else if (do_line_search)
         {
             alpha = ocp_nlp_line_search(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work, 0);
         }
+        acados_trace_end(trace_ev);
         mem->time_glob += acados_toc(&timer1);
         mem->stat[mem->stat_n*(sqp_iter+1)+6] = alpha;
 
@@ -939,6 +1178,8 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
             printf("%i\t%e\t%e\t%e\t%e.\n", sqp_iter, nlp_res->inf_norm_res_stat,
                 nlp_res->inf_norm_res_eq, nlp_res->inf_norm_res_ineq, nlp_res->inf_norm_res_comp );
         }
+
+        acados_trace_end(trace_iter);
     }  // end SQP loop
 
     if (nlp_opts->print_level > 0)
@@ -947,14 +1188,11 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
     // ocp_nlp_out_print(dims, nlp_out);
 
     // maximum number of iterations reached
-#if defined(ACADOS_WITH_OPENMP)
-    // restore number of threads
-    omp_set_num_threads(num_threads_bkp);
-#endif
 
     mem->status = ACADOS_MAXITER;
     mem->sqp_iter = sqp_iter;
     mem->time_tot = acados_toc(&timer0);
+    ocp_nlp_timings_add_latency(nlp_mem, mem->time_tot);
 
 #ifndef ACADOS_SILENT
     printf("\n ocp_nlp_sqp: maximum iterations reached\n");
@@ -1135,6 +1373,16 @@ void ocp_nlp_sqp_get(void *config_, void *dims_, void *mem_, const char *field,
         double *value = return_value_;
         *value = mem->time_reg;
     }
+    else if (!strcmp("reg_num_projected", field))
+    {
+        if (config->regularize->memory_get == NULL)
+        {
+            printf("\nerror: ocp_nlp_sqp_get: field reg_num_projected not available for this regularization\n");
+            exit(1);
+        }
+        config->regularize->memory_get(config->regularize, dims->regularize,
+                                       mem->nlp_mem->regularize_mem, "num_projected", return_value_);
+    }
     else if (!strcmp("time_glob", field))
     {
         double *value = return_value_;
@@ -1145,6 +1393,16 @@ void ocp_nlp_sqp_get(void *config_, void *dims_, void *mem_, const char *field,
         double *value = return_value_;
         *value = mem->time_solution_sensitivities;
     }
+    else if (!strcmp("time_qp_soc", field))
+    {
+        double *value = return_value_;
+        *value = mem->time_qp_soc;
+    }
+    else if (!strcmp("qp_iter_soc", field))
+    {
+        int *value = return_value_;
+        *value = mem->qp_iter_soc;
+    }
     else if (!strcmp("time_sim", field))
     {
         double *value = return_value_;
@@ -1160,6 +1418,12 @@ void ocp_nlp_sqp_get(void *config_, void *dims_, void *mem_, const char *field,
         double *value = return_value_;
         *value = mem->time_sim_ad;
     }
+    else if (!strcmp("time_lin_dyn", field) || !strcmp("time_lin_cost", field) ||
+             !strcmp("time_lin_constr", field) || !strcmp("latency_hist", field) ||
+             !strcmp("latency_hist_size", field))
+    {
+        ocp_nlp_timings_get(dims, mem->nlp_mem, field, return_value_);
+    }
     else if (!strcmp("stat", field))
     {
         double **value = return_value_;
@@ -1226,6 +1490,21 @@ void ocp_nlp_sqp_get(void *config_, void *dims_, void *mem_, const char *field,
         config->qp_solver->memory_get(config->qp_solver,
             mem->nlp_mem->qp_solver_mem, "iter", return_value_);
     }
+    else if (!strcmp("qp_cond_N", field))
+    {
+        config->qp_solver->memory_get(config->qp_solver,
+            mem->nlp_mem->qp_solver_mem, "cond_N", return_value_);
+    }
+    else if (!strcmp("qp_cond_N_cost", field))
+    {
+        config->qp_solver->memory_get(config->qp_solver,
+            mem->nlp_mem->qp_solver_mem, "cond_N_cost", return_value_);
+    }
+    else if (!strcmp("qp_cond_num_recond_blocks", field))
+    {
+        config->qp_solver->memory_get(config->qp_solver,
+            mem->nlp_mem->qp_solver_mem, "num_recond_blocks", return_value_);
+    }
     else if (!strcmp("res_stat", field))
     {
         double *value = return_value_;
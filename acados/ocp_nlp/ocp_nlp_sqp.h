@@ -48,6 +48,7 @@ extern "C" {
 
 // acados
 #include "acados/ocp_nlp/ocp_nlp_common.h"
+#include "acados/ocp_nlp/ocp_nlp_globalization_filter.h"
 #include "acados/utils/types.h"
 
 
@@ -67,6 +68,11 @@ typedef struct
     int ext_qp_res;      // compute external QP residuals (i.e. at SQP level) at each SQP iteration (for debugging)
     int qp_warm_start;   // qp_warm_start in all but the first sqp iterations
     bool warm_start_first_qp; // to set qp_warm_start in first iteration
+    int soc_qp_hot_start; // SOC QP by back-substitution with the factorization of the last QP (HPIPM only)
+    double qp_tol_stat;  // tolerances passed to the QP solver, accepted by the SOC QP hot start
+    double qp_tol_eq;
+    double qp_tol_ineq;
+    double qp_tol_comp;
     int rti_phase;       // only phase 0 at the moment 
     int print_level;     // verbosity
     int initialize_t_slacks;  // 0-false or 1-true
@@ -97,6 +103,9 @@ typedef struct
     // nlp memory
     ocp_nlp_memory *nlp_mem;
 
+    // filter for globalization FILTER_LINE_SEARCH
+    ocp_nlp_filter_memory *filter;
+
     double time_qp_sol;
     double time_qp_solver_call;
     double time_qp_xcond;
@@ -108,6 +117,7 @@ typedef struct
     double time_sim_la;
     double time_sim_ad;
     double time_solution_sensitivities;
+    double time_qp_soc;  // second order correction QPs, not included in time_qp_sol
 
     // statistics
     double *stat;
@@ -116,6 +126,7 @@ typedef struct
 
     int status;
     int sqp_iter;
+    int qp_iter_soc;  // QP solver iterations in second order correction QPs
 
 } ocp_nlp_sqp_memory;
 
@@ -142,6 +153,11 @@ typedef struct
     ocp_qp_res *qp_res;
     ocp_qp_res_ws *qp_res_ws;
 
+    // rhs of the last QP, for the SOC QP hot start
+    struct blasfeo_dvec *soc_b;
+    struct blasfeo_dvec *soc_d;
+    struct blasfeo_dvec *soc_rqz;
+
 } ocp_nlp_sqp_workspace;
 
 //
@@ -125,6 +125,7 @@ void ocp_nlp_sqp_rti_opts_initialize_default(void *config_,
     opts->ext_qp_res = 0;
     opts->warm_start_first_qp = false;
     opts->rti_phase = 0;
+    opts->async_preparation = 0;
 
     // overwrite default submodules opts
 
@@ -220,6 +221,18 @@ void ocp_nlp_sqp_rti_opts_set(void *config_, void *opts_,
                 exit(1);
             } else opts->rti_phase = *rti_phase;
         }
+        else if (!strcmp(field, "async_preparation"))
+        {
+            int* async_preparation = (int *) value;
+#if !defined(ACADOS_WITH_PTHREADS)
+            if (*async_preparation != 0)
+            {
+                printf("\nerror: ocp_nlp_sqp_rti_opts_set: async_preparation requires acados to be compiled with ACADOS_WITH_PTHREADS\n");
+                exit(1);
+            }
+#endif
+            opts->async_preparation = *async_preparation;
+        }
         else if (!strcmp(field, "print_level"))
         {
             int* print_level = (int *) value;
@@ -340,6 +353,15 @@ void *ocp_nlp_sqp_rti_memory_assign(void *config_, void *dims_,
 
     mem->status = ACADOS_READY;
 
+    mem->prep_pending = 0;
+    mem->prep_valid = 0;
+    mem->prep_nlp_in = NULL;
+    mem->prep_nlp_out = NULL;
+    mem->time_prep_wait = 0.0;
+#if defined(ACADOS_WITH_PTHREADS)
+    mem->prep_thread_active = 0;
+#endif
+
     assert((char *) raw_memory+ocp_nlp_sqp_rti_memory_calculate_size(
         config, dims, opts) >= c_ptr);
 
@@ -437,20 +459,252 @@ static void ocp_nlp_sqp_rti_cast_workspace(
  * functions
  ************************************************/
 
+#if defined(ACADOS_WITH_PTHREADS)
+static void *ocp_nlp_sqp_rti_preparation_worker(void *mem_)
+{
+    ocp_nlp_sqp_rti_memory *mem = mem_;
+
+    pthread_mutex_lock(&mem->prep_mutex);
+    while (1)
+    {
+        while (!mem->prep_requested && !mem->prep_exit)
+            pthread_cond_wait(&mem->prep_cond, &mem->prep_mutex);
+
+        if (mem->prep_exit)
+            break;
+
+        mem->prep_requested = 0;
+        pthread_mutex_unlock(&mem->prep_mutex);
+
+        ocp_nlp_sqp_rti_preparation_step(mem->prep_config, mem->prep_dims, mem->prep_nlp_in,
+            mem->prep_nlp_out, mem->prep_opts, mem, mem->prep_work);
+
+        pthread_mutex_lock(&mem->prep_mutex);
+        // publish the linearization, the feedback phase can pick it up without locking
+        __atomic_store_n(&mem->prep_done, 1, __ATOMIC_RELEASE);
+        pthread_cond_broadcast(&mem->prep_cond);
+    }
+    pthread_mutex_unlock(&mem->prep_mutex);
+
+    return NULL;
+}
+#endif
+
+
+
+// modify hook of nlp_in and nlp_out: the preparation in flight reads them, so wait for it first.
+// Any change but the one of the initial state bounds, which are embedded in the feedback phase,
+// invalidates the preparation.
+static void ocp_nlp_sqp_rti_modify_hook(ocp_nlp_sqp_rti_memory *mem, int stage, const char *field)
+{
+    ocp_nlp_sqp_rti_preparation_wait(mem);
+
+    if (field && stage == 0 && (!strcmp(field, "lbx") || !strcmp(field, "ubx") ||
+                                !strcmp(field, "lbu") || !strcmp(field, "ubu")))
+        return;
+
+    mem->prep_valid = 0;
+
+    return;
+}
+
+
+
+static void ocp_nlp_sqp_rti_nlp_in_modify_hook(void *mem_, int stage, const char *field)
+{
+    ocp_nlp_sqp_rti_memory *mem = mem_;
+
+    ocp_nlp_sqp_rti_modify_hook(mem, stage, field);
+
+    // nlp_in is freed
+    if (!field)
+        mem->prep_nlp_in = NULL;
+
+    return;
+}
+
+
+
+static void ocp_nlp_sqp_rti_nlp_out_modify_hook(void *mem_, int stage, const char *field)
+{
+    ocp_nlp_sqp_rti_memory *mem = mem_;
+
+    ocp_nlp_sqp_rti_modify_hook(mem, stage, field);
+
+    // nlp_out is freed
+    if (!field)
+        mem->prep_nlp_out = NULL;
+
+    return;
+}
+
+
+
+// the last launched preparation can be used by the feedback phase on nlp_in, nlp_out
+static int ocp_nlp_sqp_rti_preparation_valid(ocp_nlp_sqp_rti_memory *mem, void *nlp_in_,
+    void *nlp_out_)
+{
+    return mem->prep_valid && mem->prep_nlp_in == nlp_in_ && mem->prep_nlp_out == nlp_out_;
+}
+
+
+
+// launch the preparation phase on the background thread and return immediately
+static void ocp_nlp_sqp_rti_preparation_launch(void *config_, void *dims_,
+    void *nlp_in_, void *nlp_out_, void *opts_, void *mem_, void *work_)
+{
+    ocp_nlp_sqp_rti_memory *mem = mem_;
+    ocp_nlp_in *nlp_in = nlp_in_;
+    ocp_nlp_out *nlp_out = nlp_out_;
+
+    // setters and getters of the nlp inputs and outputs wait for the preparation
+    nlp_in->modify_hook.fun = &ocp_nlp_sqp_rti_nlp_in_modify_hook;
+    nlp_in->modify_hook.wait = &ocp_nlp_sqp_rti_preparation_wait;
+    nlp_in->modify_hook.mem = mem;
+    nlp_out->modify_hook.fun = &ocp_nlp_sqp_rti_nlp_out_modify_hook;
+    nlp_out->modify_hook.wait = &ocp_nlp_sqp_rti_preparation_wait;
+    nlp_out->modify_hook.mem = mem;
+
+    mem->prep_config = config_;
+    mem->prep_dims = dims_;
+    mem->prep_nlp_in = nlp_in_;
+    mem->prep_nlp_out = nlp_out_;
+    mem->prep_opts = opts_;
+    mem->prep_work = work_;
+    mem->prep_valid = 1;
+
+#if defined(ACADOS_WITH_PTHREADS)
+    if (!mem->prep_thread_active)
+    {
+        pthread_mutex_init(&mem->prep_mutex, NULL);
+        pthread_cond_init(&mem->prep_cond, NULL);
+        mem->prep_requested = 0;
+        mem->prep_exit = 0;
+        mem->prep_done = 0;
+        if (pthread_create(&mem->prep_thread, NULL, &ocp_nlp_sqp_rti_preparation_worker, mem))
+        {
+            printf("\nerror: ocp_nlp_sqp_rti: failed to create preparation thread\n");
+            exit(1);
+        }
+        mem->prep_thread_active = 1;
+    }
+
+    pthread_mutex_lock(&mem->prep_mutex);
+    __atomic_store_n(&mem->prep_done, 0, __ATOMIC_RELAXED);
+    mem->prep_requested = 1;
+    pthread_cond_broadcast(&mem->prep_cond);
+    pthread_mutex_unlock(&mem->prep_mutex);
+#else
+    // no threading available: prepare synchronously
+    ocp_nlp_sqp_rti_preparation_step(config_, dims_, nlp_in_, nlp_out_, opts_, mem_, work_);
+#endif
+
+    mem->prep_pending = 1;
+
+    return;
+}
+
+
+
+// wait for a launched preparation phase to finish
+void ocp_nlp_sqp_rti_preparation_wait(void *mem_)
+{
+    ocp_nlp_sqp_rti_memory *mem = mem_;
+
+    if (!mem->prep_pending)
+        return;
+
+#if defined(ACADOS_WITH_PTHREADS)
+    // spin shortly, the preparation is usually done by the time the next feedback is due
+    for (int ii = 0; ii < 1000; ii++)
+    {
+        if (__atomic_load_n(&mem->prep_done, __ATOMIC_ACQUIRE))
+        {
+            mem->prep_pending = 0;
+            return;
+        }
+    }
+
+    // park
+    pthread_mutex_lock(&mem->prep_mutex);
+    while (!__atomic_load_n(&mem->prep_done, __ATOMIC_ACQUIRE))
+        pthread_cond_wait(&mem->prep_cond, &mem->prep_mutex);
+    pthread_mutex_unlock(&mem->prep_mutex);
+#endif
+
+    mem->prep_pending = 0;
+
+    return;
+}
+
+
+
+void ocp_nlp_sqp_rti_terminate(void *config_, void *mem_, void *work_)
+{
+    ocp_nlp_sqp_rti_memory *mem = mem_;
+
+    ocp_nlp_sqp_rti_preparation_wait(mem);
+
+    // nlp_in, nlp_out can outlive the solver
+    ocp_nlp_in *nlp_in = mem->prep_nlp_in;
+    if (nlp_in && nlp_in->modify_hook.mem == mem)
+    {
+        nlp_in->modify_hook.fun = NULL;
+        nlp_in->modify_hook.wait = NULL;
+        nlp_in->modify_hook.mem = NULL;
+    }
+    ocp_nlp_out *nlp_out = mem->prep_nlp_out;
+    if (nlp_out && nlp_out->modify_hook.mem == mem)
+    {
+        nlp_out->modify_hook.fun = NULL;
+        nlp_out->modify_hook.wait = NULL;
+        nlp_out->modify_hook.mem = NULL;
+    }
+    mem->prep_nlp_in = NULL;
+    mem->prep_nlp_out = NULL;
+    mem->prep_valid = 0;
+
+#if defined(ACADOS_WITH_PTHREADS)
+    if (mem->prep_thread_active)
+    {
+        pthread_mutex_lock(&mem->prep_mutex);
+        mem->prep_exit = 1;
+        pthread_cond_broadcast(&mem->prep_cond);
+        pthread_mutex_unlock(&mem->prep_mutex);
+
+        pthread_join(mem->prep_thread, NULL);
+        pthread_cond_destroy(&mem->prep_cond);
+        pthread_mutex_destroy(&mem->prep_mutex);
+        mem->prep_thread_active = 0;
+    }
+#endif
+
+    return;
+}
+
+
+
 int ocp_nlp_sqp_rti(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
     void *opts_, void *mem_, void *work_)
 {
     ocp_nlp_sqp_rti_memory *mem = mem_;
     
     // zero timers
-    acados_timer timer0;
+    acados_timer timer0, timer1;
     double total_time = 0.0;
     mem->time_tot = 0.0;
+    mem->time_prep_wait = 0.0;
 
     ocp_nlp_sqp_rti_opts *nlp_opts = opts_;
     int rti_phase = nlp_opts->rti_phase; 
 
     acados_tic(&timer0);
+
+    // the preparation phase of the previous call might still be running
+    acados_tic(&timer1);
+    ocp_nlp_sqp_rti_preparation_wait(mem);
+    mem->time_prep_wait = acados_toc(&timer1);
+
     switch(rti_phase) 
     {
         
@@ -461,26 +715,51 @@ int ocp_nlp_sqp_rti(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 
             ocp_nlp_sqp_rti_feedback_step(
                 config_, dims_, nlp_in_, nlp_out_, opts_, mem_, work_);
+            mem->prep_valid = 0;
 
             break;
 
         // perform preparation rti_phase
         case 1:
-            ocp_nlp_sqp_rti_preparation_step(
-                config_, dims_, nlp_in_, nlp_out_, opts_, mem_, work_);
+            if (nlp_opts->async_preparation)
+            {
+                // skip if already launched by the previous feedback phase
+                if (!ocp_nlp_sqp_rti_preparation_valid(mem, nlp_in_, nlp_out_))
+                    ocp_nlp_sqp_rti_preparation_launch(
+                        config_, dims_, nlp_in_, nlp_out_, opts_, mem_, work_);
+            }
+            else
+            {
+                ocp_nlp_sqp_rti_preparation_step(
+                    config_, dims_, nlp_in_, nlp_out_, opts_, mem_, work_);
+                mem->prep_valid = 0;
+            }
 
             break;
 
         // perform feedback rti_phase
         case 2:
+            // the linearization has to match nlp_in and nlp_out, i.e. these were not changed after
+            // the preparation was launched (but for the initial state bounds)
+            if (nlp_opts->async_preparation && !ocp_nlp_sqp_rti_preparation_valid(mem, nlp_in_, nlp_out_))
+                ocp_nlp_sqp_rti_preparation_step(
+                    config_, dims_, nlp_in_, nlp_out_, opts_, mem_, work_);
+
             ocp_nlp_sqp_rti_feedback_step(
                 config_, dims_, nlp_in_, nlp_out_, opts_, mem_, work_);
+            mem->prep_valid = 0;
+
+            // pipelined: prepare the next step in the background while the control is applied
+            if (nlp_opts->async_preparation && mem->status == ACADOS_SUCCESS)
+                ocp_nlp_sqp_rti_preparation_launch(
+                    config_, dims_, nlp_in_, nlp_out_, opts_, mem_, work_);
 
             break;
     }
 
     total_time += acados_toc(&timer0);
     mem->time_tot = total_time;
+    ocp_nlp_timings_add_latency(mem->nlp_mem, mem->time_tot);
 
     return mem->status;
 
@@ -509,13 +788,7 @@ void ocp_nlp_sqp_rti_preparation_step(void *config_, void *dims_,
 
     mem->time_lin = 0.0;
     mem->time_reg = 0.0;
-
-#if defined(ACADOS_WITH_OPENMP)
-    // backup number of threads
-    int num_threads_bkp = omp_get_num_threads();
-    // set number of threads
-    omp_set_num_threads(opts->nlp_opts->num_threads);
-#endif
+    ocp_nlp_timings_reset(dims, nlp_mem);
 
     ocp_nlp_alias_memory_to_submodules(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
 
@@ -528,15 +801,13 @@ void ocp_nlp_sqp_rti_preparation_step(void *config_, void *dims_,
 
     // linearizate NLP and update QP matrices
     acados_tic(&timer1);
+    int trace_ev = acados_trace_begin("rti_preparation", -1);
     ocp_nlp_approximate_qp_matrices(config, dims, nlp_in,
         nlp_out, nlp_opts, nlp_mem, nlp_work);
+    acados_trace_end(trace_ev);
 
     mem->time_lin += acados_toc(&timer1);
 
-#if defined(ACADOS_WITH_OPENMP)
-    // restore number of threads
-    omp_set_num_threads(num_threads_bkp);
-#endif
 	
 	return;
 
@@ -571,6 +842,8 @@ void ocp_nlp_sqp_rti_feedback_step(void *config_, void *dims_,
     mem->time_qp_xcond = 0.0;
     mem->time_glob = 0.0;
 
+    int trace_ev = acados_trace_begin("rti_feedback", -1);
+
     // embed initial value (this actually updates all bounds at stage 0...)
     ocp_nlp_embed_initial_value(config, dims, nlp_in,
         nlp_out, nlp_opts, nlp_mem, nlp_work);
@@ -655,6 +928,7 @@ void ocp_nlp_sqp_rti_feedback_step(void *config_, void *dims_,
             print_ocp_qp_in(nlp_mem->qp_in);
         }
         mem->status = ACADOS_QP_FAILURE;
+        acados_trace_end(trace_ev);
         return;
     }
 
@@ -674,6 +948,7 @@ void ocp_nlp_sqp_rti_feedback_step(void *config_, void *dims_,
     // print_ocp_qp_in(mem->qp_in);
 
     mem->status = ACADOS_SUCCESS;
+    acados_trace_end(trace_ev);
 
 }
 
@@ -699,6 +974,8 @@ int ocp_nlp_sqp_rti_precompute(void *config_, void *dims_, void *nlp_in_,
 
     int ii;
 
+    ocp_nlp_sqp_rti_preparation_wait(mem);
+
     // TODO(giaf) flag to enable/disable checks
     for (ii = 0; ii <= N; ii++)
     {
@@ -751,6 +1028,8 @@ void ocp_nlp_sqp_rti_eval_param_sens(void *config_, void *dims_, void *opts_,
     ocp_nlp_memory *nlp_mem = mem->nlp_mem;
     ocp_nlp_out *sens_nlp_out = sens_nlp_out_;
 
+    ocp_nlp_sqp_rti_preparation_wait(mem);
+
     ocp_nlp_sqp_rti_workspace *work = work_;
     ocp_nlp_sqp_rti_cast_workspace(config, dims, opts, mem, work);
     ocp_nlp_workspace *nlp_work = work->nlp_work;
@@ -824,6 +1103,10 @@ void ocp_nlp_sqp_rti_get(void *config_, void *dims_, void *mem_,
     ocp_nlp_dims *dims = dims_;
     ocp_nlp_sqp_rti_memory *mem = mem_;
 
+    // timings, statistics and the nlp memory are written by the preparation in flight
+    if (strcmp("prep_pending", field))
+        ocp_nlp_sqp_rti_preparation_wait(mem);
+
     if (!strcmp("sqp_iter", field))
     {
         int *value = return_value_;
@@ -864,11 +1147,27 @@ void ocp_nlp_sqp_rti_get(void *config_, void *dims_, void *mem_,
         double *value = return_value_;
         *value = mem->time_reg;
     }
+    else if (!strcmp("reg_num_projected", field))
+    {
+        if (config->regularize->memory_get == NULL)
+        {
+            printf("\nerror: ocp_nlp_sqp_rti_get: field reg_num_projected not available for this regularization\n");
+            exit(1);
+        }
+        config->regularize->memory_get(config->regularize, dims->regularize,
+                                       mem->nlp_mem->regularize_mem, "num_projected", return_value_);
+    }
     else if (!strcmp("time_glob", field))
     {
         double *value = return_value_;
         *value = mem->time_glob;
     }
+    else if (!strcmp("time_lin_dyn", field) || !strcmp("time_lin_cost", field) ||
+             !strcmp("time_lin_constr", field) || !strcmp("latency_hist", field) ||
+             !strcmp("latency_hist_size", field))
+    {
+        ocp_nlp_timings_get(dims, mem->nlp_mem, field, return_value_);
+    }
     else if (!strcmp("time_sim", field) || !strcmp("time_sim_ad", field) || !strcmp("time_sim_la", field))
     {
         double tmp = 0.0;
@@ -887,6 +1186,16 @@ void ocp_nlp_sqp_rti_get(void *config_, void *dims_, void *mem_,
         double *value = return_value_;
         *value = mem->time_solution_sensitivities;
     }
+    else if (!strcmp("time_prep_wait", field))
+    {
+        double *value = return_value_;
+        *value = mem->time_prep_wait;
+    }
+    else if (!strcmp("prep_pending", field))
+    {
+        int *value = return_value_;
+        *value = mem->prep_pending;
+    }
     else if (!strcmp("stat", field))
     {
         double **value = return_value_;
@@ -953,6 +1262,26 @@ void ocp_nlp_sqp_rti_get(void *config_, void *dims_, void *mem_,
         config->qp_solver->memory_get(config->qp_solver,
             mem->nlp_mem->qp_solver_mem, "iter", return_value_);
     }
+    else if (!strcmp("qp_num_hotstarts", field))
+    {
+        config->qp_solver->memory_get(config->qp_solver,
+            mem->nlp_mem->qp_solver_mem, "num_hotstarts", return_value_);
+    }
+    else if (!strcmp("qp_cond_N", field))
+    {
+        config->qp_solver->memory_get(config->qp_solver,
+            mem->nlp_mem->qp_solver_mem, "cond_N", return_value_);
+    }
+    else if (!strcmp("qp_cond_N_cost", field))
+    {
+        config->qp_solver->memory_get(config->qp_solver,
+            mem->nlp_mem->qp_solver_mem, "cond_N_cost", return_value_);
+    }
+    else if (!strcmp("qp_cond_num_recond_blocks", field))
+    {
+        config->qp_solver->memory_get(config->qp_solver,
+            mem->nlp_mem->qp_solver_mem, "num_recond_blocks", return_value_);
+    }
     else if (!strcmp("res_stat", field))
     {
         double *value = return_value_;
@@ -1044,6 +1373,7 @@ void ocp_nlp_sqp_rti_config_initialize_default(void *config_)
     config->get = &ocp_nlp_sqp_rti_get;
     config->opts_get = &ocp_nlp_sqp_rti_opts_get;
     config->work_get = &ocp_nlp_sqp_rti_work_get;
+    config->terminate = &ocp_nlp_sqp_rti_terminate;
 
     return;
 }
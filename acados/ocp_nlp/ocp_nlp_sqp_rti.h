@@ -50,6 +50,10 @@ extern "C" {
 #include "acados/ocp_nlp/ocp_nlp_common.h"
 #include "acados/utils/types.h"
 
+#if defined(ACADOS_WITH_PTHREADS)
+#include <pthread.h>
+#endif
+
 
 
 /************************************************
@@ -64,6 +68,7 @@ typedef struct
     int qp_warm_start;        // NOTE: this is not actually setting the warm_start! Just for compatibility with sqp.
     bool warm_start_first_qp; // to set qp_warm_start in first iteration
     int rti_phase;            // phase of RTI. Possible values 1 (preparation), 2 (feedback) 0 (both)
+    int async_preparation;    // run the preparation phase on a background thread (needs ACADOS_WITH_PTHREADS)
     int print_level;     // verbosity
 
 } ocp_nlp_sqp_rti_opts;
@@ -101,6 +106,7 @@ typedef struct
     double time_tot;
     double time_glob;
     double time_solution_sensitivities;
+    double time_prep_wait;  // time the feedback phase waited for the asynchronous preparation
 
     // statistics
     double *stat;
@@ -109,6 +115,26 @@ typedef struct
 
     int status;
 
+    // asynchronous preparation phase
+    int prep_pending;        // a preparation has been launched and not yet waited for
+    int prep_valid;          // the launched preparation is valid for the current prep_nlp_in, prep_nlp_out
+    // arguments of the preparation phase
+    void *prep_config;
+    void *prep_dims;
+    void *prep_nlp_in;
+    void *prep_nlp_out;
+    void *prep_opts;
+    void *prep_work;
+#if defined(ACADOS_WITH_PTHREADS)
+    pthread_t prep_thread;
+    pthread_mutex_t prep_mutex;
+    pthread_cond_t prep_cond;
+    int prep_thread_active;  // worker thread is running
+    int prep_requested;      // worker has to perform a preparation phase
+    int prep_exit;           // worker has to terminate
+    int prep_done;           // preparation finished, accessed atomically
+#endif
+
 } ocp_nlp_sqp_rti_memory;
 
 //
@@ -156,6 +182,10 @@ void ocp_nlp_sqp_rti_feedback_step(void *config_, void *dims_,
 int ocp_nlp_sqp_rti(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
     void *opts_, void *mem_, void *work_);
 //
+void ocp_nlp_sqp_rti_preparation_wait(void *mem_);
+//
+void ocp_nlp_sqp_rti_terminate(void *config_, void *mem_, void *work_);
+//
 void ocp_nlp_sqp_rti_config_initialize_default(void *config_);
 //
 int ocp_nlp_sqp_rti_precompute(void *config_, void *dims_,
@@ -36,6 +36,12 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
+#if defined(ACADOS_WITH_OPENMP)
+#include <omp.h>
+#endif
+// blasfeo
+#include "blasfeo/include/blasfeo_d_aux.h"
+#include "blasfeo/include/blasfeo_d_blas.h"
 // hpipm
 #include "hpipm/include/hpipm_d_cond.h"
 #include "hpipm/include/hpipm_d_dense_qp.h"
@@ -48,6 +54,7 @@
 #include "acados/dense_qp/dense_qp_common.h"
 #include "acados/ocp_qp/ocp_qp_common.h"
 #include "acados/ocp_qp/ocp_qp_full_condensing.h"
+#include "acados/utils/math.h"
 #include "acados/utils/mem.h"
 #include "acados/utils/types.h"
 #include "acados/utils/timing.h"
@@ -246,6 +253,8 @@ void ocp_qp_full_condensing_opts_initialize_default(void *dims_, void *opts_)
 
     opts->mem_qp_in = 1;
 
+    opts->num_threads = 0;
+
     return;
 }
 
@@ -285,6 +294,11 @@ void ocp_qp_full_condensing_opts_set(void *opts_, const char *field, void* value
         d_ocp_qp_reduce_eq_dof_arg_set_comp_dual_sol_eq(opts->hpipm_red_opts, *tmp_ptr);
         d_ocp_qp_reduce_eq_dof_arg_set_comp_dual_sol_ineq(opts->hpipm_red_opts, *tmp_ptr);
     }
+    else if(!strcmp(field, "num_threads"))
+    {
+        int *tmp_ptr = value;
+        opts->num_threads = *tmp_ptr;
+    }
     else
     {
         printf("\nerror: field %s not available in ocp_qp_full_condensing_opts_set\n", field);
@@ -301,6 +315,171 @@ void ocp_qp_full_condensing_opts_set(void *opts_, const char *field, void* value
  * memory
  ************************************************/
 
+// the block-column condensing supports qps without soft constraints and equalities, laid out as
+// the dense qp of HPIPM: v = [u_N, ..., u_0, x_0], bounds on inputs and on x_0, state bounds of
+// the other stages as general constraints
+static int ocp_qp_full_condensing_par_supported(ocp_qp_full_condensing_dims *dims)
+{
+    ocp_qp_dims *red_dims = dims->red_dims;
+    dense_qp_dims *fcond_dims = dims->fcond_dims;
+
+    int N = red_dims->N;
+
+    int nv = red_dims->nx[0];
+    int nb = red_dims->nb[0];
+    int ng = 0;
+    for (int ii = 0; ii <= N; ii++)
+    {
+        if (red_dims->ns[ii] > 0)
+            return 0;
+        nv += red_dims->nu[ii];
+        ng += red_dims->ng[ii];
+        if (ii > 0)
+        {
+            nb += red_dims->nbu[ii];
+            ng += red_dims->nbx[ii];
+        }
+    }
+
+    return fcond_dims->ne == 0 && fcond_dims->ns == 0 && fcond_dims->nv == nv &&
+           fcond_dims->nb == nb && fcond_dims->ng == ng;
+}
+
+
+
+static acados_size_t ocp_qp_full_condensing_par_memory_calculate_size(ocp_qp_dims *dims,
+    int num_threads)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *ng = dims->ng;
+
+    int nxM = 0, nuxM = 0, ngM = 0, ncolM = nx[0];
+    for (int ii = 0; ii <= N; ii++)
+    {
+        nxM = MAX(nxM, nx[ii]);
+        nuxM = MAX(nuxM, nu[ii]+nx[ii]);
+        ngM = MAX(ngM, ng[ii]);
+        ncolM = MAX(ncolM, nu[ii]);
+    }
+
+    acados_size_t size = 0;
+
+    size += (N+2 + 2*(N+1) + N+3) * sizeof(int);  // voff boff goff cgrp
+
+    size += (N+1) * sizeof(struct blasfeo_dmat);  // RSQ_sym
+    size += num_threads*(N+1) * sizeof(struct blasfeo_dmat);  // Y
+    size += num_threads*2 * sizeof(struct blasfeo_dmat);  // Wt
+    size += (2*(N+1) + 2) * sizeof(struct blasfeo_dvec);  // gamma w tmp_nuxM tmp_ngM
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        size += blasfeo_memsize_dmat(nu[ii]+nx[ii], nu[ii]+nx[ii]);  // RSQ_sym
+        size += blasfeo_memsize_dvec(nx[ii]);  // gamma
+        size += blasfeo_memsize_dvec(nu[ii]+nx[ii]);  // w
+    }
+    size += num_threads*(N+1) * blasfeo_memsize_dmat(ncolM, nxM);  // Y
+    size += num_threads*2 * blasfeo_memsize_dmat(ncolM, nuxM);  // Wt
+    size += blasfeo_memsize_dvec(nuxM);  // tmp_nuxM
+    size += blasfeo_memsize_dvec(ngM);  // tmp_ngM
+
+    size += 8 + 64;  // align
+
+    return size;
+}
+
+
+
+static void ocp_qp_full_condensing_par_memory_assign(ocp_qp_dims *dims, int num_threads,
+    ocp_qp_full_condensing_memory *mem, char **c_ptr)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nb = dims->nb;
+    int *nbu = dims->nbu;
+    int *nbx = dims->nbx;
+    int *ng = dims->ng;
+
+    int nxM = 0, nuxM = 0, ngM = 0, ncolM = nx[0];
+    for (int ii = 0; ii <= N; ii++)
+    {
+        nxM = MAX(nxM, nx[ii]);
+        nuxM = MAX(nuxM, nu[ii]+nx[ii]);
+        ngM = MAX(ngM, ng[ii]);
+        ncolM = MAX(ncolM, nu[ii]);
+    }
+
+    align_char_to(8, c_ptr);
+
+    assign_and_advance_blasfeo_dmat_structs(N+1, &mem->RSQ_sym, c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(num_threads*(N+1), &mem->Y, c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(num_threads*2, &mem->Wt, c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->gamma, c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->w, c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(1, &mem->tmp_nuxM, c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(1, &mem->tmp_ngM, c_ptr);
+
+    assign_and_advance_int(N+2, &mem->voff, c_ptr);
+    assign_and_advance_int(N+1, &mem->boff, c_ptr);
+    assign_and_advance_int(N+1, &mem->goff, c_ptr);
+    assign_and_advance_int(N+3, &mem->cgrp, c_ptr);
+
+    align_char_to(64, c_ptr);
+
+    for (int ii = 0; ii <= N; ii++)
+        assign_and_advance_blasfeo_dmat_mem(nu[ii]+nx[ii], nu[ii]+nx[ii], mem->RSQ_sym+ii, c_ptr);
+    for (int ii = 0; ii < num_threads*(N+1); ii++)
+        assign_and_advance_blasfeo_dmat_mem(ncolM, nxM, mem->Y+ii, c_ptr);
+    for (int ii = 0; ii < num_threads*2; ii++)
+        assign_and_advance_blasfeo_dmat_mem(ncolM, nuxM, mem->Wt+ii, c_ptr);
+    for (int ii = 0; ii <= N; ii++)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nx[ii], mem->gamma+ii, c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nu[ii]+nx[ii], mem->w+ii, c_ptr);
+    }
+    assign_and_advance_blasfeo_dvec_mem(nuxM, mem->tmp_nuxM, c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(ngM, mem->tmp_ngM, c_ptr);
+
+    // layout of the dense qp
+    mem->voff[N+1] = 0;
+    for (int ii = N; ii >= 0; ii--)
+    {
+        mem->voff[ii] = mem->voff[N+1];
+        mem->voff[N+1] += nu[ii];
+    }
+    int nbd = 0, ngd = 0;
+    for (int ii = 0; ii <= N; ii++)
+    {
+        mem->boff[ii] = nbd;
+        mem->goff[ii] = ngd;
+        nbd += ii == 0 ? nb[ii] : nbu[ii];
+        ngd += ii == 0 ? ng[ii] : nbx[ii] + ng[ii];
+    }
+
+    // column groups: consecutive blocks of the dense order u_N, ..., u_0, x_0, a new group starts
+    // whenever the column offset is a multiple of the panel size; a thread writing the columns of
+    // Hv and the rows of Ct of a whole group does not share panels (cache lines) with the others
+    mem->n_cgrp = 0;
+    int col = 0;
+    for (int bb = 0; bb <= N+1; bb++)
+    {
+        if (col % D_PS == 0)
+        {
+            mem->cgrp[mem->n_cgrp] = bb;
+            mem->n_cgrp++;
+        }
+        col += bb <= N ? nu[N-bb] : nx[0];
+    }
+    mem->cgrp[mem->n_cgrp] = N+2;
+
+    mem->par_num_threads = num_threads;
+}
+
+
+
+
 acados_size_t ocp_qp_full_condensing_memory_calculate_size(void *dims_, void *opts_)
 {
     ocp_qp_full_condensing_dims *dims = dims_;
@@ -321,6 +500,8 @@ acados_size_t ocp_qp_full_condensing_memory_calculate_size(void *dims_, void *op
 
     size += dense_qp_out_calculate_size(dims->fcond_dims);
 
+    size += dense_qp_out_calculate_size(dims->fcond_dims);  // fcond_sens_qp_out
+
     size += ocp_qp_in_calculate_size(dims->red_dims);
 
     size += ocp_qp_out_calculate_size(dims->red_dims);
@@ -331,6 +512,9 @@ acados_size_t ocp_qp_full_condensing_memory_calculate_size(void *dims_, void *op
     size += sizeof(struct d_ocp_qp_reduce_eq_dof_ws);
     size += d_ocp_qp_reduce_eq_dof_ws_memsize(dims->orig_dims);
 
+    if (opts->num_threads > 0 && ocp_qp_full_condensing_par_supported(dims))
+        size += ocp_qp_full_condensing_par_memory_calculate_size(dims->red_dims, opts->num_threads);
+
     size += 2*8;
 
     return size;
@@ -376,6 +560,9 @@ void *ocp_qp_full_condensing_memory_assign(void *dims_, void *opts_, void *raw_m
     mem->fcond_qp_out = dense_qp_out_assign(dims->fcond_dims, c_ptr);
     c_ptr += dense_qp_out_calculate_size(dims->fcond_dims);
 
+    mem->fcond_sens_qp_out = dense_qp_out_assign(dims->fcond_dims, c_ptr);
+    c_ptr += dense_qp_out_calculate_size(dims->fcond_dims);
+
     mem->red_qp = ocp_qp_in_assign(dims->red_dims, c_ptr);
     c_ptr += ocp_qp_in_calculate_size(dims->red_dims);
 
@@ -384,6 +571,11 @@ void *ocp_qp_full_condensing_memory_assign(void *dims_, void *opts_, void *raw_m
 
     mem->qp_out_info = (qp_info *) mem->fcond_qp_out->misc;
 
+    mem->par_num_threads = 0;
+    mem->par_cond_used = 0;
+    if (opts->num_threads > 0 && ocp_qp_full_condensing_par_supported(dims))
+        ocp_qp_full_condensing_par_memory_assign(dims->red_dims, opts->num_threads, mem, &c_ptr);
+
     assert((char *) raw_memory + ocp_qp_full_condensing_memory_calculate_size(dims, opts) >= c_ptr);
 
     return mem;
@@ -405,6 +597,11 @@ void ocp_qp_full_condensing_memory_get(void *config_, void *mem_, const char *fi
         dense_qp_out **ptr = value;
         *ptr = mem->fcond_qp_out;
     }
+    else if(!strcmp(field, "xcond_sens_qp_out"))
+    {
+        dense_qp_out **ptr = value;
+        *ptr = mem->fcond_sens_qp_out;
+    }
     else if(!strcmp(field, "qp_out_info"))
     {
         qp_info **ptr = value;
@@ -415,6 +612,17 @@ void ocp_qp_full_condensing_memory_get(void *config_, void *mem_, const char *fi
         double *ptr = value;
         *ptr = mem->time_qp_xcond;
     }
+    else if (!strcmp(field, "cond_N") || !strcmp(field, "num_recond_blocks"))
+    {
+        // only defined for partial condensing
+        int *ptr = value;
+        *ptr = -1;
+    }
+    else if (!strcmp(field, "cond_N_cost"))
+    {
+        double **ptr = value;
+        *ptr = NULL;
+    }
     else
     {
         printf("\nerror: ocp_qp_full_condensing_memory_get: field %s not available\n", field);
@@ -444,6 +652,297 @@ acados_size_t ocp_qp_full_condensing_workspace_calculate_size(void *dims_, void
  * functions
  ************************************************/
 
+// Block-column condensing of the Hessian and of the constraint matrix. The columns of the dense
+// qp belonging to u_j (and to x_0) only need the sensitivities of the states after stage j: a
+// forward sweep propagates them, a backward (adjoint) sweep accumulates the Hessian column.
+// Columns are independent and distributed over the threads.
+static void ocp_qp_full_condensing_par_lhs(ocp_qp_in *qp, dense_qp_in *dqp,
+    ocp_qp_full_condensing_memory *mem, int num_threads)
+{
+    int N = qp->dim->N;
+    int *nx = qp->dim->nx;
+    int *nu = qp->dim->nu;
+    int *nb = qp->dim->nb;
+    int *ng = qp->dim->ng;
+
+    int nvd = dqp->dim->nv;
+    int ngd = dqp->dim->ng;
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(num_threads) schedule(static)
+#endif
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nux = nu[ii]+nx[ii];
+        blasfeo_dgecp(nux, nux, qp->RSQrq+ii, 0, 0, mem->RSQ_sym+ii, 0, 0);
+        blasfeo_dtrtr_l(nux, mem->RSQ_sym+ii, 0, 0, mem->RSQ_sym+ii, 0, 0);
+    }
+
+    // column groups, the last ones (x_0 and the early stages) are the most expensive
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+#endif
+    for (int gg = mem->n_cgrp-1; gg >= 0; gg--)
+    {
+        int thread = 0;
+#if defined(ACADOS_WITH_OPENMP)
+        thread = omp_get_thread_num();
+#endif
+        struct blasfeo_dmat *Y = mem->Y + thread*(N+1);
+        struct blasfeo_dmat *Wt = mem->Wt + 2*thread;
+
+        for (int bb = mem->cgrp[gg]; bb < mem->cgrp[gg+1]; bb++)
+        {
+            int jj = bb <= N ? N-bb : N+1;  // variable block: u_jj, or x_0 for N+1
+            int is_x0 = jj == N+1;
+            int ss = is_x0 ? 0 : jj;  // stage of the variable
+            int ncol = is_x0 ? nx[0] : nu[jj];
+            int coff = mem->voff[jj];
+
+            if (ncol == 0)
+                continue;
+
+            // forward: Y[kk] = (d x_kk / d v_jj)^T for kk >= first
+            int first = is_x0 ? 0 : ss+1;
+            if (is_x0)
+            {
+                blasfeo_dgese(ncol, ncol, 0.0, Y+0, 0, 0);
+                blasfeo_ddiare(ncol, 1.0, Y+0, 0, 0);
+            }
+            else if (ss < N)
+            {
+                blasfeo_dgecp(ncol, nx[ss+1], qp->BAbt+ss, 0, 0, Y+ss+1, 0, 0);
+            }
+            for (int kk = first; kk < N; kk++)
+                blasfeo_dgemm_nn(ncol, nx[kk+1], nx[kk], 1.0, Y+kk, 0, 0, qp->BAbt+kk, nu[kk], 0,
+                                 0.0, Y+kk+1, 0, 0, Y+kk+1, 0, 0);
+
+            // constraint matrix, rows of v_jj (zero for the stages before ss)
+            blasfeo_dgese(ncol, ngd, 0.0, dqp->Ct, coff, 0);
+            for (int kk = ss; kk <= N; kk++)
+            {
+                int row = mem->goff[kk];
+                if (kk >= first && kk > 0)
+                {
+                    // state bounds
+                    for (int ii = 0; ii < nb[kk]; ii++)
+                    {
+                        int idx = qp->idxb[kk][ii] - nu[kk];
+                        if (idx >= 0)
+                        {
+                            blasfeo_dgecp(ncol, 1, Y+kk, 0, idx, dqp->Ct, coff, row);
+                            row++;
+                        }
+                    }
+                }
+                else if (kk > 0)
+                {
+                    row += nb[kk] - qp->dim->nbu[kk];
+                }
+                // general constraints
+                if (kk >= first)
+                    blasfeo_dgemm_nn(ncol, ng[kk], nx[kk], 1.0, Y+kk, 0, 0, qp->DCt+kk, nu[kk], 0,
+                                     0.0, dqp->Ct, coff, row, dqp->Ct, coff, row);
+                else
+                    blasfeo_dgecp(ncol, ng[kk], qp->DCt+kk, 0, 0, dqp->Ct, coff, row);
+            }
+
+            // backward: Wt = [d (grad_u_kk) / d v_jj, Lambda_kk]^T, with the adjoint
+            // Lambda_kk = Q_kk X_kk + S_kk U_kk + A_kk^T Lambda_kk+1
+            for (int kk = N; kk >= 0; kk--)
+            {
+                struct blasfeo_dmat *Wc = Wt + kk%2;
+                struct blasfeo_dmat *Wp = Wt + (kk+1)%2;
+                int nux = nu[kk]+nx[kk];
+                double beta = 1.0;
+
+                if (kk >= first)
+                    blasfeo_dgemm_nn(ncol, nux, nx[kk], 1.0, Y+kk, 0, 0, mem->RSQ_sym+kk, nu[kk], 0,
+                                     0.0, Wc, 0, 0, Wc, 0, 0);
+                else if (kk == ss)
+                    blasfeo_dgecp(ncol, nux, mem->RSQ_sym+kk, 0, 0, Wc, 0, 0);
+                else
+                    beta = 0.0;
+
+                if (kk < N)
+                    blasfeo_dgemm_nt(ncol, nux, nx[kk+1], 1.0, Wp, 0, nu[kk+1], qp->BAbt+kk, 0, 0,
+                                     beta, Wc, 0, 0, Wc, 0, 0);
+
+                // lower triangle: rows of u_kk for kk <= ss
+                if (!is_x0 && kk <= ss)
+                    blasfeo_dgetr(ncol, nu[kk], Wc, 0, 0, dqp->Hv, mem->voff[kk], coff);
+            }
+            // row of x_0
+            blasfeo_dgetr(ncol, nx[0], Wt+0, 0, nu[0], dqp->Hv, mem->voff[N+1], coff);
+        }
+    }
+
+    // upper triangle
+    blasfeo_dtrtr_l(nvd, dqp->Hv, 0, 0, dqp->Hv, 0, 0);
+}
+
+
+
+// gradient, bounds and constraint bounds of the dense qp, relative to the state trajectory gamma
+// obtained with zero dense variables
+static void ocp_qp_full_condensing_par_rhs(ocp_qp_in *qp, dense_qp_in *dqp,
+    ocp_qp_full_condensing_memory *mem)
+{
+    int N = qp->dim->N;
+    int *nx = qp->dim->nx;
+    int *nu = qp->dim->nu;
+    int *nb = qp->dim->nb;
+    int *ng = qp->dim->ng;
+
+    int nbd = dqp->dim->nb;
+    int ngd = dqp->dim->ng;
+
+    struct blasfeo_dvec *gamma = mem->gamma;
+    struct blasfeo_dvec *w = mem->w;
+
+    // state trajectory
+    blasfeo_dvecse(nx[0], 0.0, gamma+0, 0);
+    for (int kk = 0; kk < N; kk++)
+        blasfeo_dgemv_t(nx[kk], nx[kk+1], 1.0, qp->BAbt+kk, nu[kk], 0, gamma+kk, 0, 1.0,
+                        qp->b+kk, 0, gamma+kk+1, 0);
+
+    // gradient, backward: w_kk = RSQ_kk [0; gamma_kk] + rq_kk + [B_kk A_kk]^T mu_kk+1
+    for (int kk = N; kk >= 0; kk--)
+    {
+        int nux = nu[kk]+nx[kk];
+        blasfeo_dvecse(nu[kk], 0.0, mem->tmp_nuxM, 0);
+        blasfeo_dveccp(nx[kk], gamma+kk, 0, mem->tmp_nuxM, nu[kk]);
+        blasfeo_dsymv_l(nux, 1.0, qp->RSQrq+kk, 0, 0, mem->tmp_nuxM, 0, 1.0, qp->rqz+kk, 0,
+                        w+kk, 0);
+        if (kk < N)
+            blasfeo_dgemv_n(nux, nx[kk+1], 1.0, qp->BAbt+kk, 0, 0, w+kk+1, nu[kk+1], 1.0,
+                            w+kk, 0, w+kk, 0);
+        blasfeo_dveccp(nu[kk], w+kk, 0, dqp->gz, mem->voff[kk]);
+    }
+    blasfeo_dveccp(nx[0], w+0, nu[0], dqp->gz, mem->voff[N+1]);
+
+    // bounds and general constraints, with their masks
+    for (int kk = 0; kk <= N; kk++)
+    {
+        int ib = mem->boff[kk];
+        int ig = mem->goff[kk];
+        for (int ii = 0; ii < nb[kk]; ii++)
+        {
+            int idx = qp->idxb[kk][ii];
+            double lb = BLASFEO_DVECEL(qp->d+kk, ii);
+            double mub = BLASFEO_DVECEL(qp->d+kk, nb[kk]+ng[kk]+ii);  // -ub
+            if (idx < nu[kk] || kk == 0)
+            {
+                dqp->idxb[ib] = idx < nu[kk] ? mem->voff[kk] + idx : mem->voff[N+1] + idx - nu[kk];
+                BLASFEO_DVECEL(dqp->d, ib) = lb;
+                BLASFEO_DVECEL(dqp->d, nbd+ngd+ib) = mub;
+                BLASFEO_DVECEL(dqp->d_mask, ib) = BLASFEO_DVECEL(qp->d_mask+kk, ii);
+                BLASFEO_DVECEL(dqp->d_mask, nbd+ngd+ib) =
+                    BLASFEO_DVECEL(qp->d_mask+kk, nb[kk]+ng[kk]+ii);
+                ib++;
+            }
+            else
+            {
+                double gam = BLASFEO_DVECEL(gamma+kk, idx-nu[kk]);
+                BLASFEO_DVECEL(dqp->d, nbd+ig) = lb - gam;
+                BLASFEO_DVECEL(dqp->d, 2*nbd+ngd+ig) = mub + gam;
+                BLASFEO_DVECEL(dqp->d_mask, nbd+ig) = BLASFEO_DVECEL(qp->d_mask+kk, ii);
+                BLASFEO_DVECEL(dqp->d_mask, 2*nbd+ngd+ig) =
+                    BLASFEO_DVECEL(qp->d_mask+kk, nb[kk]+ng[kk]+ii);
+                ig++;
+            }
+        }
+        blasfeo_dgemv_t(nx[kk], ng[kk], 1.0, qp->DCt+kk, nu[kk], 0, gamma+kk, 0, 0.0,
+                        mem->tmp_ngM, 0, mem->tmp_ngM, 0);
+        blasfeo_daxpy(ng[kk], -1.0, mem->tmp_ngM, 0, qp->d+kk, nb[kk], dqp->d, nbd+ig);
+        blasfeo_daxpy(ng[kk], 1.0, mem->tmp_ngM, 0, qp->d+kk, 2*nb[kk]+ng[kk], dqp->d,
+                      2*nbd+ngd+ig);
+        blasfeo_dveccp(ng[kk], qp->d_mask+kk, nb[kk], dqp->d_mask, nbd+ig);
+        blasfeo_dveccp(ng[kk], qp->d_mask+kk, 2*nb[kk]+ng[kk], dqp->d_mask, 2*nbd+ngd+ig);
+    }
+
+    for (int ii = 0; ii < nbd+ngd; ii++)
+        dqp->idxs_rev[ii] = -1;
+}
+
+
+
+// inverse of the block-column condensing: states by forward simulation, multipliers of the
+// inequalities by the inverse permutation, multipliers of the dynamics by a backward sweep
+static void ocp_qp_full_condensing_par_expand(ocp_qp_in *qp, dense_qp_out *dsol, ocp_qp_out *sol,
+    ocp_qp_full_condensing_memory *mem, int expand_dual_sol)
+{
+    int N = qp->dim->N;
+    int *nx = qp->dim->nx;
+    int *nu = qp->dim->nu;
+    int *nb = qp->dim->nb;
+    int *ng = qp->dim->ng;
+
+    int nbd = dsol->dim->nb;
+    int ngd = dsol->dim->ng;
+
+    struct blasfeo_dvec *w = mem->w;
+
+    // primal
+    for (int kk = 0; kk <= N; kk++)
+        blasfeo_dveccp(nu[kk], dsol->v, mem->voff[kk], sol->ux+kk, 0);
+    blasfeo_dveccp(nx[0], dsol->v, mem->voff[N+1], sol->ux+0, nu[0]);
+    for (int kk = 0; kk < N; kk++)
+        blasfeo_dgemv_t(nu[kk]+nx[kk], nx[kk+1], 1.0, qp->BAbt+kk, 0, 0, sol->ux+kk, 0, 1.0,
+                        qp->b+kk, 0, sol->ux+kk+1, nu[kk+1]);
+
+    if (!expand_dual_sol)
+        return;
+
+    // multipliers of the inequalities
+    for (int kk = 0; kk <= N; kk++)
+    {
+        int ib = mem->boff[kk];
+        int ig = mem->goff[kk];
+        for (int ii = 0; ii < nb[kk]; ii++)
+        {
+            if (qp->idxb[kk][ii] < nu[kk] || kk == 0)
+            {
+                BLASFEO_DVECEL(sol->lam+kk, ii) = BLASFEO_DVECEL(dsol->lam, ib);
+                BLASFEO_DVECEL(sol->lam+kk, nb[kk]+ng[kk]+ii) =
+                    BLASFEO_DVECEL(dsol->lam, nbd+ngd+ib);
+                ib++;
+            }
+            else
+            {
+                BLASFEO_DVECEL(sol->lam+kk, ii) = BLASFEO_DVECEL(dsol->lam, nbd+ig);
+                BLASFEO_DVECEL(sol->lam+kk, nb[kk]+ng[kk]+ii) =
+                    BLASFEO_DVECEL(dsol->lam, 2*nbd+ngd+ig);
+                ig++;
+            }
+        }
+        blasfeo_dveccp(ng[kk], dsol->lam, nbd+ig, sol->lam+kk, nb[kk]);
+        blasfeo_dveccp(ng[kk], dsol->lam, 2*nbd+ngd+ig, sol->lam+kk, 2*nb[kk]+ng[kk]);
+    }
+
+    ocp_qp_compute_t(qp, sol);
+
+    // multipliers of the dynamics: pi_kk-1 = x-part of the stationarity terms of stage kk
+    for (int kk = N; kk > 0; kk--)
+    {
+        int nux = nu[kk]+nx[kk];
+        blasfeo_dsymv_l(nux, 1.0, qp->RSQrq+kk, 0, 0, sol->ux+kk, 0, 1.0, qp->rqz+kk, 0, w+kk, 0);
+        if (kk < N)
+            blasfeo_dgemv_n(nux, nx[kk+1], 1.0, qp->BAbt+kk, 0, 0, sol->pi+kk, 0, 1.0, w+kk, 0,
+                            w+kk, 0);
+        for (int ii = 0; ii < nb[kk]; ii++)
+            BLASFEO_DVECEL(w+kk, qp->idxb[kk][ii]) += BLASFEO_DVECEL(sol->lam+kk, nb[kk]+ng[kk]+ii)
+                                                     - BLASFEO_DVECEL(sol->lam+kk, ii);
+        blasfeo_daxpy(ng[kk], -1.0, sol->lam+kk, nb[kk], sol->lam+kk, 2*nb[kk]+ng[kk],
+                      mem->tmp_ngM, 0);
+        blasfeo_dgemv_n(nux, ng[kk], 1.0, qp->DCt+kk, 0, 0, mem->tmp_ngM, 0, 1.0, w+kk, 0,
+                        w+kk, 0);
+        blasfeo_dveccp(nx[kk], w+kk, nu[kk], sol->pi+kk-1, 0);
+    }
+}
+
+
+
 int ocp_qp_full_condensing(void *qp_in_, void *fcond_qp_in_, void *opts_, void *mem_, void *work_)
 {
     ocp_qp_in *qp_in = qp_in_;
@@ -468,7 +967,16 @@ int ocp_qp_full_condensing(void *qp_in_, void *fcond_qp_in_, void *opts_, void *
 //exit(1);
 
     // convert to dense qp structure
-    if (opts->cond_hess == 0)
+    mem->par_cond_used = opts->num_threads > 0 && mem->par_num_threads > 0;
+    if (mem->par_cond_used)
+    {
+        // block-column condensing
+        if (opts->cond_hess != 0)
+            ocp_qp_full_condensing_par_lhs(mem->red_qp, fcond_qp_in, mem,
+                                           MIN(opts->num_threads, mem->par_num_threads));
+        ocp_qp_full_condensing_par_rhs(mem->red_qp, fcond_qp_in, mem);
+    }
+    else if (opts->cond_hess == 0)
     {
         // condense gradient only
         d_cond_qp_cond_rhs(mem->red_qp, fcond_qp_in, opts->hpipm_cond_opts, mem->hpipm_cond_work);
@@ -506,7 +1014,11 @@ int ocp_qp_full_condensing_rhs(void *qp_in_, void *fcond_qp_in_, void *opts_, vo
     d_ocp_qp_reduce_eq_dof(qp_in, mem->red_qp, opts->hpipm_red_opts, mem->hpipm_red_work);
 
     // condense gradient only
-    d_cond_qp_cond_rhs(mem->red_qp, fcond_qp_in, opts->hpipm_cond_opts, mem->hpipm_cond_work);
+    mem->par_cond_used = opts->num_threads > 0 && mem->par_num_threads > 0;
+    if (mem->par_cond_used)
+        ocp_qp_full_condensing_par_rhs(mem->red_qp, fcond_qp_in, mem);
+    else
+        d_cond_qp_cond_rhs(mem->red_qp, fcond_qp_in, opts->hpipm_cond_opts, mem->hpipm_cond_work);
 
     // stop timer
     mem->time_qp_xcond = acados_toc(&timer);
@@ -529,7 +1041,12 @@ int ocp_qp_full_expansion(void *fcond_qp_out_, void *qp_out_, void *opts_, void
     acados_tic(&timer);
 
     // expand solution
-    if (opts->expand_dual_sol == 0)
+    if (mem->par_cond_used)
+    {
+        ocp_qp_full_condensing_par_expand(mem->red_qp, fcond_qp_out, mem->red_sol, mem,
+                                          opts->expand_dual_sol);
+    }
+    else if (opts->expand_dual_sol == 0)
     {
         d_cond_qp_expand_primal_sol(mem->red_qp, fcond_qp_out, mem->red_sol, opts->hpipm_cond_opts, mem->hpipm_cond_work);
     }
@@ -66,6 +66,7 @@ typedef struct ocp_qp_full_condensing_opts_
     int expand_dual_sol; // 0 primal sol only, 1 primal + dual sol
     int ric_alg;
     int mem_qp_in; // allocate qp_in in memory
+    int num_threads; // 0 HPIPM condensing, >0 block-column condensing on num_threads threads
 } ocp_qp_full_condensing_opts;
 
 
@@ -77,12 +78,28 @@ typedef struct ocp_qp_full_condensing_memory_
     // in memory
     dense_qp_in *fcond_qp_in;
     dense_qp_out *fcond_qp_out;
+    dense_qp_out *fcond_sens_qp_out; // solution sensitivities, keeps fcond_qp_out for warm start
     ocp_qp_in *red_qp; // reduced qp
     ocp_qp_out *red_sol; // reduced qp sol
     // only pointer
     ocp_qp_in *ptr_qp_in;
     qp_info *qp_out_info; // info in fcond_qp_in
     double time_qp_xcond;
+    // block-column condensing
+    int par_num_threads; // threads the workspace is allocated for, 0 if not supported
+    int par_cond_used; // fcond_qp_in built by the block-column condensing
+    int *voff; // offset of u_k in the dense variables (stages 0..N), of x_0 (N+1)
+    int *boff; // offset of the dense bounds of stage k
+    int *goff; // offset of the dense general constraints of stage k (state bounds first)
+    int *cgrp; // first block of each column group in the dense order, n_cgrp+1 entries
+    int n_cgrp; // column groups, each starting on a panel boundary of Hv and Ct
+    struct blasfeo_dmat *RSQ_sym; // symmetric copy of RSQrq of the reduced qp
+    struct blasfeo_dmat *Y; // per thread: transposed state sensitivities, N+1 stages
+    struct blasfeo_dmat *Wt; // per thread: 2 buffers for the backward recursion
+    struct blasfeo_dvec *gamma; // state trajectory for zero dense variables
+    struct blasfeo_dvec *w; // per stage vector of the backward recursions
+    struct blasfeo_dvec *tmp_nuxM;
+    struct blasfeo_dvec *tmp_ngM;
 } ocp_qp_full_condensing_memory;
 
 
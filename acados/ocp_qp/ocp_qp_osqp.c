@@ -332,7 +332,7 @@ static void update_hessian_structure(const ocp_qp_in *in, ocp_qp_osqp_memory *me
 
 
 
-static void update_hessian_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
+static void update_hessian_data(const ocp_qp_in *in, c_float *P_x)
 {
     c_int ii, jj, kk, nn = 0;
     ocp_qp_dims *dims = in->dim;
@@ -348,7 +348,7 @@ static void update_hessian_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
                 // we write the lower triangular part in row-major order
                 // that's the same as writing the upper triangular part in
                 // column-major order
-                mem->P_x[nn++] = BLASFEO_DMATEL(&in->RSQrq[kk], ii, jj);
+                P_x[nn++] = BLASFEO_DMATEL(&in->RSQrq[kk], ii, jj);
             }
         }
     }
@@ -453,7 +453,7 @@ static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp
 
 
 
-static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
+static void update_constraints_matrix_data(const ocp_qp_in *in, c_float *A_x)
 {
     c_int ii, jj, kk, nn = 0;
     ocp_qp_dims *dims = in->dim;
@@ -583,6 +583,28 @@ static void update_bounds(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
 
 
 
+// compares the new data x_new with x, copies the changed entries to x and compacts them
+// in place in x_new, with their indices in idx; returns the number of changed entries
+static c_int collect_changed_entries(c_int nnz, c_float *x_new, c_float *x, c_int *idx)
+{
+    c_int ii, nn = 0;
+
+    for (ii = 0; ii < nnz; ii++)
+    {
+        if (x_new[ii] != x[ii])
+        {
+            x[ii] = x_new[ii];
+            x_new[nn] = x_new[ii];
+            idx[nn] = ii;
+            nn++;
+        }
+    }
+
+    return nn;
+}
+
+
+
 static void ocp_qp_osqp_update_memory(const ocp_qp_in *in, const ocp_qp_osqp_opts *opts,
                                       ocp_qp_osqp_memory *mem)
 {
@@ -594,8 +616,23 @@ static void ocp_qp_osqp_update_memory(const ocp_qp_in *in, const ocp_qp_osqp_opt
 
     update_bounds(in, mem);
     update_gradient(in, mem);
-    update_hessian_data(in, mem);
-    update_constraints_matrix_data(in, mem);
+
+    if (opts->partial_update && !mem->first_run)
+    {
+        // the CSC structure is fixed after the first run, only the data of the
+        // blocks that changed since the last call is passed on to OSQP
+        update_hessian_data(in, mem->P_x_upd);
+        update_constraints_matrix_data(in, mem->A_x_upd);
+        mem->P_num_upd = collect_changed_entries(mem->P_p[mem->osqp_data->n], mem->P_x_upd,
+                                                 mem->P_x, mem->P_x_idx);
+        mem->A_num_upd = collect_changed_entries(mem->A_p[mem->osqp_data->n], mem->A_x_upd,
+                                                 mem->A_x, mem->A_x_idx);
+    }
+    else
+    {
+        update_hessian_data(in, mem->P_x);
+        update_constraints_matrix_data(in, mem->A_x);
+    }
 }
 
 
@@ -643,6 +680,8 @@ void ocp_qp_osqp_opts_initialize_default(void *config_, void *dims_, void *opts_
     opts->osqp_opts->check_termination = 5;
     opts->osqp_opts->warm_start = 1;
 
+    opts->partial_update = 1;
+
     return;
 }
 
@@ -707,6 +746,11 @@ void ocp_qp_osqp_opts_set(void *config_, void *opts_, const char *field, void *v
         opts->osqp_opts->warm_start = *tmp_ptr;
         // printf("\nwarm start %d\n", opts->osqp_opts->warm_start);
     }
+    else if (!strcmp(field, "partial_update"))
+    {
+        int *tmp_ptr = value;
+        opts->partial_update = *tmp_ptr;
+    }
     else
     {
         printf("\nerror: ocp_qp_osqp_opts_set: wrong field: %s\n", field);
@@ -819,6 +863,11 @@ acados_size_t ocp_qp_osqp_memory_calculate_size(void *config_, void *dims_, void
     size += A_nnzmax * sizeof(c_int);    // A_i
     size += (n + 1) * sizeof(c_int);     // A_p
 
+    size += P_nnzmax * sizeof(c_float);  // P_x_upd
+    size += P_nnzmax * sizeof(c_int);    // P_x_idx
+    size += A_nnzmax * sizeof(c_float);  // A_x_upd
+    size += A_nnzmax * sizeof(c_int);    // A_x_idx
+
     size += sizeof(OSQPData);
     size += 2 * sizeof(csc);  // matrices P and A
     size += osqp_workspace_calculate_size(n, m, P_nnzmax, A_nnzmax);
@@ -1130,6 +1179,9 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     mem->P_nnzmax = P_nnzmax;
     mem->A_nnzmax = A_nnzmax;
     mem->first_run = 1;
+    mem->P_num_upd = 0;
+    mem->A_num_upd = 0;
+    mem->num_factorizations = 0;
 
     align_char_to(8, &c_ptr);
 
@@ -1149,6 +1201,12 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     mem->A_x = (c_float *) c_ptr;
     c_ptr += (mem->A_nnzmax) * sizeof(c_float);
 
+    mem->P_x_upd = (c_float *) c_ptr;
+    c_ptr += (mem->P_nnzmax) * sizeof(c_float);
+
+    mem->A_x_upd = (c_float *) c_ptr;
+    c_ptr += (mem->A_nnzmax) * sizeof(c_float);
+
     // ints
     mem->P_i = (c_int *) c_ptr;
     c_ptr += (mem->P_nnzmax) * sizeof(c_int);
@@ -1162,6 +1220,12 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     mem->A_p = (c_int *) c_ptr;
     c_ptr += (n + 1) * sizeof(c_int);
 
+    mem->P_x_idx = (c_int *) c_ptr;
+    c_ptr += (mem->P_nnzmax) * sizeof(c_int);
+
+    mem->A_x_idx = (c_int *) c_ptr;
+    c_ptr += (mem->A_nnzmax) * sizeof(c_int);
+
     mem->osqp_data = (OSQPData *) c_ptr;
     c_ptr += sizeof(OSQPData);
 
@@ -1210,6 +1274,11 @@ void ocp_qp_osqp_memory_get(void *config_, void *mem_, const char *field, void*
         int *tmp_ptr = value;
         *tmp_ptr = mem->iter;
     }
+    else if(!strcmp(field, "num_factorizations"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->num_factorizations;
+    }
     else
     {
         printf("\nerror: ocp_qp_osqp_memory_get: field %s not available\n", field);
@@ -1333,8 +1402,19 @@ int ocp_qp_osqp(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *m
     if (!mem->first_run)
     {
         osqp_update_lin_cost(mem->osqp_work, mem->q);
-        osqp_update_P_A(mem->osqp_work, mem->P_x, NULL, mem->P_nnzmax, mem->A_x, NULL,
-                        mem->A_nnzmax);
+        if (!opts->partial_update)
+        {
+            osqp_update_P_A(mem->osqp_work, mem->P_x, NULL, mem->P_nnzmax, mem->A_x, NULL,
+                            mem->A_nnzmax);
+            mem->num_factorizations++;
+        }
+        else if (mem->P_num_upd > 0 || mem->A_num_upd > 0)
+        {
+            osqp_update_P_A(mem->osqp_work, mem->P_x_upd, mem->P_x_idx, mem->P_num_upd,
+                            mem->A_x_upd, mem->A_x_idx, mem->A_num_upd);
+            mem->num_factorizations++;
+        }
+        // else: only vectors changed, the KKT factorization of the previous call is reused
         osqp_update_bounds(mem->osqp_work, mem->l, mem->u);
         // TODO(oj): update OSQP options here if they were updated?
     }
@@ -1343,6 +1423,7 @@ int ocp_qp_osqp(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *m
         // mem->osqp_work = osqp_setup(mem->osqp_data, opts->osqp_opts);
         osqp_init_data(mem->osqp_data, opts->osqp_opts, mem->osqp_work);
         mem->first_run = 0;
+        mem->num_factorizations++;
     }
 
     // check settings:
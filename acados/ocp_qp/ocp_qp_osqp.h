@@ -49,6 +49,7 @@ extern "C" {
 typedef struct ocp_qp_osqp_opts_
 {
     OSQPSettings *osqp_opts;
+    int partial_update;  // pass only the changed entries of P and A to OSQP, skip the refactorization if none changed
 } ocp_qp_osqp_opts;
 
 
@@ -70,11 +71,20 @@ typedef struct ocp_qp_osqp_memory_
     c_int *A_p;
     c_float *A_x;
 
+    // partial update: new data of P and A, compacted to the changed entries, and their indices
+    c_float *P_x_upd;
+    c_int *P_x_idx;
+    c_float *A_x_upd;
+    c_int *A_x_idx;
+    c_int P_num_upd;
+    c_int A_num_upd;
+
     OSQPData *osqp_data;
     OSQPWorkspace *osqp_work;
 
     double time_qp_solver_call;
     int iter;
+    int num_factorizations;  // number of KKT factorizations since the memory was assigned
 
 } ocp_qp_osqp_memory;
 
@@ -36,9 +36,13 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
+// blasfeo
+#include "blasfeo/include/blasfeo_d_aux.h"
+#include "blasfeo/include/blasfeo_d_blas.h"
 // acados
 #include "acados/ocp_qp/ocp_qp_common.h"
 #include "acados/ocp_qp/ocp_qp_partial_condensing.h"
+#include "acados/utils/math.h"
 #include "acados/utils/mem.h"
 #include "hpipm/include/hpipm_d_ocp_qp_red.h"
 // hpipm
@@ -190,6 +194,8 @@ acados_size_t ocp_qp_partial_condensing_opts_calculate_size(void *dims_)
     size += sizeof(struct d_ocp_qp_reduce_eq_dof_arg);
     size += d_ocp_qp_reduce_eq_dof_arg_memsize();
 
+    size += (N + 1) * sizeof(double);  // N2_cost
+
     size += 2*8;
     make_int_multiple_of(8, &size);
 
@@ -221,6 +227,9 @@ void *ocp_qp_partial_condensing_opts_assign(void *dims_, void *raw_memory)
 
     align_char_to(8, &c_ptr);
 
+    // N2_cost
+    assign_and_advance_double(N + 1, &opts->N2_cost, &c_ptr);
+
     // hpipm_pcond_opts
     d_part_cond_qp_arg_create(N, opts->hpipm_pcond_opts, c_ptr);
     c_ptr += opts->hpipm_pcond_opts->memsize;
@@ -255,16 +264,182 @@ void ocp_qp_partial_condensing_opts_initialize_default(void *dims_, void *opts_)
 
     opts->mem_qp_in = 1;
 
+    opts->N2_auto = 0;
+    for (int ii = 0; ii <= N; ii++)
+        opts->N2_cost[ii] = 0.0;
+
+    opts->incremental = 1;
+
     return;
 }
 
 
 
+// interior point iterations assumed when weighting the condensing (once per QP)
+// against the Riccati recursion (once per iteration) in the automatic choice of N2
+#define PCOND_AUTO_IPM_ITER 10
+// size of the kernel used to measure the flop rate
+#define PCOND_AUTO_CAL_SIZE 32
+#define PCOND_AUTO_CAL_REP 10
+#define PCOND_AUTO_CAL_CALLS 100
+
+// the calibration only depends on the machine, it is done once per process
+static int pcond_auto_calibrated = 0;
+static double pcond_auto_flop_time;
+static double pcond_auto_call_time;
+
+// measure the time per flop of a medium size BLASFEO kernel and the overhead of a kernel call
+static void ocp_qp_partial_condensing_calibrate(double *flop_time, double *call_time)
+{
+    int n = PCOND_AUTO_CAL_SIZE;
+    int m = 4;
+    int ii, jj;
+
+    acados_timer timer;
+    double tmp_time, time_large = 1e30, time_small = 1e30;
+
+    acados_size_t size = 3 * blasfeo_memsize_dmat(n, n) + 64;
+    void *raw_memory = acados_malloc(size, 1);
+    char *c_ptr = raw_memory;
+    align_char_to(64, &c_ptr);
+
+    struct blasfeo_dmat A, B, C;
+    blasfeo_create_dmat(n, n, &A, c_ptr);
+    c_ptr += blasfeo_memsize_dmat(n, n);
+    blasfeo_create_dmat(n, n, &B, c_ptr);
+    c_ptr += blasfeo_memsize_dmat(n, n);
+    blasfeo_create_dmat(n, n, &C, c_ptr);
+    c_ptr += blasfeo_memsize_dmat(n, n);
+
+    blasfeo_dgese(n, n, 1e-2, &A, 0, 0);
+    blasfeo_dgese(n, n, 1e-2, &B, 0, 0);
+    blasfeo_dgese(n, n, 0.0, &C, 0, 0);
+
+    for (ii = 0; ii < PCOND_AUTO_CAL_REP; ii++)
+    {
+        acados_tic(&timer);
+        blasfeo_dgemm_nt(n, n, n, 1.0, &A, 0, 0, &B, 0, 0, 0.0, &C, 0, 0, &C, 0, 0);
+        tmp_time = acados_toc(&timer);
+        time_large = MIN(time_large, tmp_time);
+
+        acados_tic(&timer);
+        for (jj = 0; jj < PCOND_AUTO_CAL_CALLS; jj++)
+            blasfeo_dgemm_nt(m, m, m, 1.0, &A, 0, 0, &B, 0, 0, 0.0, &C, 0, 0, &C, 0, 0);
+        tmp_time = acados_toc(&timer) / PCOND_AUTO_CAL_CALLS;
+        time_small = MIN(time_small, tmp_time);
+    }
+
+    free(raw_memory);
+
+    *flop_time = time_large / (2.0 * n * n * n);
+    *call_time = MAX(time_small - 2.0 * m * m * m * (*flop_time), 0.0);
+}
+
+
+
+// predict the time of one QP solution for the partial condensing horizon N2
+static double ocp_qp_partial_condensing_predict_time(ocp_qp_partial_condensing_dims *dims, int N2,
+                                                     double flop_time, double call_time)
+{
+    ocp_qp_dims *red_dims = dims->red_dims;
+    ocp_qp_dims *pcond_dims = dims->pcond_dims;
+    int N = red_dims->N;
+
+    int ii, jj;
+    double nux, nx1, nu_acc, nc_acc;
+
+    // dimensions of the partially condensed QP, as computed by hpipm
+    pcond_dims->N = N2;
+    d_part_cond_qp_compute_block_size(N, N2, dims->block_size);
+    d_part_cond_qp_compute_dim(red_dims, dims->block_size, pcond_dims);
+
+    // condensing: within a block the stages are eliminated backwards, the sensitivities
+    // w.r.t. the inputs and constraints of the later stages of the block grow
+    double flops_cond = 0.0;
+    int calls_cond = 0;
+    int stage = 0;
+    for (ii = 0; ii < N2; ii++)
+    {
+        if (dims->block_size[ii] > 1)
+        {
+            nu_acc = 0.0;
+            nc_acc = 0.0;
+            for (jj = stage + dims->block_size[ii] - 1; jj >= stage; jj--)
+            {
+                nux = nu_acc + red_dims->nu[jj] + red_dims->nx[jj];
+                nx1 = red_dims->nx[jj+1];
+                flops_cond += nux * nx1 * nx1 + nux * nux * nx1 + nux * nx1 * nc_acc;
+                calls_cond += 3;
+                nu_acc += red_dims->nu[jj];
+                nc_acc += red_dims->nbx[jj] + red_dims->ng[jj];
+            }
+        }
+        stage += dims->block_size[ii];
+    }
+
+    // Riccati recursion on the partially condensed QP
+    double flops_ric = 0.0;
+    int calls_ric = 0;
+    for (ii = 0; ii <= N2; ii++)
+    {
+        nux = pcond_dims->nu[ii] + pcond_dims->nx[ii];
+        nx1 = ii < N2 ? pcond_dims->nx[ii+1] : 0;
+        flops_ric += nux * nx1 * nx1 + nux * nux * (nx1 + pcond_dims->ng[ii]) + nux * nux * nux / 3.0;
+        calls_ric += 4;
+    }
+
+    return flop_time * (flops_cond + PCOND_AUTO_IPM_ITER * flops_ric)
+           + call_time * (calls_cond + PCOND_AUTO_IPM_ITER * calls_ric);
+}
+
+
+
+// choose the N2 with the smallest predicted time, the predictions are stored in opts->N2_cost
+static int ocp_qp_partial_condensing_choose_N2(ocp_qp_partial_condensing_dims *dims,
+                                               ocp_qp_partial_condensing_opts *opts)
+{
+    int N = dims->red_dims->N;
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp critical (ocp_qp_partial_condensing_calibrate)
+#endif
+    {
+        if (!pcond_auto_calibrated)
+        {
+            ocp_qp_partial_condensing_calibrate(&pcond_auto_flop_time, &pcond_auto_call_time);
+            pcond_auto_calibrated = 1;
+        }
+    }
+    double flop_time = pcond_auto_flop_time;
+    double call_time = pcond_auto_call_time;
+
+    int N2_best = N;
+    double cost_best = 1e30;
+
+    opts->N2_cost[0] = 0.0;
+    for (int N2 = 1; N2 <= N; N2++)
+    {
+        opts->N2_cost[N2] = ocp_qp_partial_condensing_predict_time(dims, N2, flop_time, call_time);
+        if (opts->N2_cost[N2] < cost_best)
+        {
+            cost_best = opts->N2_cost[N2];
+            N2_best = N2;
+        }
+    }
+
+    return N2_best;
+}
+
+
+
 void ocp_qp_partial_condensing_opts_update(void *dims_, void *opts_)
 {
     ocp_qp_partial_condensing_dims *dims = dims_;
     ocp_qp_partial_condensing_opts *opts = opts_;
 
+    if (opts->N2_auto)
+        opts->N2 = ocp_qp_partial_condensing_choose_N2(dims, opts);
+
     dims->pcond_dims->N = opts->N2;
     opts->N2_bkp = opts->N2;
     // hpipm_pcond_opts
@@ -297,6 +472,16 @@ void ocp_qp_partial_condensing_opts_set(void *opts_, const char *field, void* va
         int *tmp_ptr = value;
         opts->ric_alg = *tmp_ptr;
     }
+    else if(!strcmp(field, "N_auto"))
+    {
+        int *tmp_ptr = value;
+        opts->N2_auto = *tmp_ptr;
+    }
+    else if(!strcmp(field, "incremental"))
+    {
+        int *tmp_ptr = value;
+        opts->incremental = *tmp_ptr;
+    }
     // TODO dual_sol ???
     else
     {
@@ -336,10 +521,17 @@ acados_size_t ocp_qp_partial_condensing_memory_calculate_size(void *dims_, void
 
     size += ocp_qp_out_calculate_size(dims->pcond_dims);
 
+    size += ocp_qp_out_calculate_size(dims->pcond_dims);  // pcond_sens_qp_out
+
     size += ocp_qp_in_calculate_size(dims->red_dims);
 
     size += ocp_qp_out_calculate_size(dims->red_dims);
 
+    // red_qp_cache
+    size += ocp_qp_in_calculate_size(dims->red_dims);
+    // stage_dirty
+    size += (dims->red_dims->N + 1) * sizeof(int);
+
     // hpipm_pcond_work
     size += sizeof(struct d_part_cond_qp_ws);
     size += d_part_cond_qp_ws_memsize(dims->red_dims, dims->block_size, dims->pcond_dims, opts->hpipm_pcond_opts);
@@ -392,14 +584,29 @@ void *ocp_qp_partial_condensing_memory_assign(void *dims_, void *opts_, void *ra
     mem->pcond_qp_out = ocp_qp_out_assign(dims->pcond_dims, c_ptr);
     c_ptr += ocp_qp_out_calculate_size(dims->pcond_dims);
 
+    mem->pcond_sens_qp_out = ocp_qp_out_assign(dims->pcond_dims, c_ptr);
+    c_ptr += ocp_qp_out_calculate_size(dims->pcond_dims);
+
     mem->red_qp = ocp_qp_in_assign(dims->red_dims, c_ptr);
     c_ptr += ocp_qp_in_calculate_size(dims->red_dims);
 
     mem->red_sol = ocp_qp_out_assign(dims->red_dims, c_ptr);
     c_ptr += ocp_qp_out_calculate_size(dims->red_dims);
 
+    mem->red_qp_cache = ocp_qp_in_assign(dims->red_dims, c_ptr);
+    c_ptr += ocp_qp_in_calculate_size(dims->red_dims);
+
+    assign_and_advance_int(dims->red_dims->N + 1, &mem->stage_dirty, &c_ptr);
+    mem->block_size = dims->block_size;
+    mem->pcond_qp_in_prev = NULL;
+    mem->cache_valid = 0;
+    mem->num_recond_blocks = 0;
+
     mem->qp_out_info = (qp_info *) mem->pcond_qp_out->misc;
 
+    mem->N2 = opts->N2;
+    mem->N2_cost = opts->N2_cost;
+
     assert((char *) raw_memory + ocp_qp_partial_condensing_memory_calculate_size(dims, opts) >= c_ptr);
 
     return mem;
@@ -421,6 +628,11 @@ void ocp_qp_partial_condensing_memory_get(void *config_, void *mem_, const char
         ocp_qp_out **ptr = value;
         *ptr = mem->pcond_qp_out;
     }
+    else if(!strcmp(field, "xcond_sens_qp_out"))
+    {
+        ocp_qp_out **ptr = value;
+        *ptr = mem->pcond_sens_qp_out;
+    }
     else if(!strcmp(field, "qp_out_info"))
     {
         qp_info **ptr = value;
@@ -431,6 +643,21 @@ void ocp_qp_partial_condensing_memory_get(void *config_, void *mem_, const char
         double *ptr = value;
         *ptr = mem->time_qp_xcond;
     }
+    else if (!strcmp(field, "cond_N"))
+    {
+        int *ptr = value;
+        *ptr = mem->N2;
+    }
+    else if (!strcmp(field, "cond_N_cost"))
+    {
+        double **ptr = value;
+        *ptr = mem->N2_cost;
+    }
+    else if (!strcmp(field, "num_recond_blocks"))
+    {
+        int *ptr = value;
+        *ptr = mem->num_recond_blocks;
+    }
     else
     {
         printf("\nerror: ocp_qp_partial_condensing_memory_get: field %s not available\n", field);
@@ -458,6 +685,106 @@ acados_size_t ocp_qp_partial_condensing_workspace_calculate_size(void *dims_, vo
  * functions
  ************************************************/
 
+// compare the lower triangle (lower_tri != 0) or the whole m x n block of A against the cache B
+static int ocp_qp_partial_condensing_dmat_changed(int m, int n, int lower_tri,
+    struct blasfeo_dmat *A, struct blasfeo_dmat *B)
+{
+    for (int jj = 0; jj < n; jj++)
+    {
+        for (int ii = lower_tri ? jj : 0; ii < m; ii++)
+        {
+            if (BLASFEO_DMATEL(A, ii, jj) != BLASFEO_DMATEL(B, ii, jj))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+
+
+// flag the stages of the reduced qp whose condensing data (everything but the rhs) differs from
+// the last condensing and refresh the cache for them; returns the number of changed stages
+static int ocp_qp_partial_condensing_update_dirty(ocp_qp_in *qp, ocp_qp_partial_condensing_memory *mem)
+{
+    ocp_qp_dims *dims = qp->dim;
+    ocp_qp_in *cache = mem->red_qp_cache;
+    int *stage_dirty = mem->stage_dirty;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nb = dims->nb;
+    int *ng = dims->ng;
+    int *ns = dims->ns;
+
+    int num_dirty = 0;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nv = nu[ii] + nx[ii];
+        int dirty = !mem->cache_valid;
+
+        if (!dirty && ii < N)
+            dirty = ocp_qp_partial_condensing_dmat_changed(nv, nx[ii+1], 0, qp->BAbt+ii, cache->BAbt+ii);
+        if (!dirty)
+            dirty = ocp_qp_partial_condensing_dmat_changed(nv, nv, 1, qp->RSQrq+ii, cache->RSQrq+ii);
+        if (!dirty)
+            dirty = ocp_qp_partial_condensing_dmat_changed(nv, ng[ii], 0, qp->DCt+ii, cache->DCt+ii);
+        if (!dirty && nb[ii] > 0)
+            dirty = memcmp(qp->idxb[ii], cache->idxb[ii], nb[ii]*sizeof(int));
+        if (!dirty && ns[ii] > 0)
+        {
+            dirty = memcmp(qp->idxs_rev[ii], cache->idxs_rev[ii], (nb[ii]+ng[ii])*sizeof(int));
+            for (int jj = 0; jj < 2*ns[ii] && !dirty; jj++)
+                dirty = BLASFEO_DVECEL(qp->Z+ii, jj) != BLASFEO_DVECEL(cache->Z+ii, jj);
+        }
+
+        if (dirty)
+        {
+            if (ii < N)
+                blasfeo_dgecp(nv, nx[ii+1], qp->BAbt+ii, 0, 0, cache->BAbt+ii, 0, 0);
+            blasfeo_dgecp(nv, nv, qp->RSQrq+ii, 0, 0, cache->RSQrq+ii, 0, 0);
+            blasfeo_dgecp(nv, ng[ii], qp->DCt+ii, 0, 0, cache->DCt+ii, 0, 0);
+            if (nb[ii] > 0)
+                memcpy(cache->idxb[ii], qp->idxb[ii], nb[ii]*sizeof(int));
+            if (ns[ii] > 0)
+            {
+                memcpy(cache->idxs_rev[ii], qp->idxs_rev[ii], (nb[ii]+ng[ii])*sizeof(int));
+                blasfeo_dveccp(2*ns[ii], qp->Z+ii, 0, cache->Z+ii, 0);
+            }
+            num_dirty++;
+        }
+
+        stage_dirty[ii] = dirty != 0;
+    }
+
+    mem->cache_valid = 1;
+
+    return num_dirty;
+}
+
+
+
+// number of blocks of the partially condensed qp (last stage included) containing a dirty stage
+static int ocp_qp_partial_condensing_count_dirty_blocks(int N2, int *block_size, int *stage_dirty)
+{
+    int num_blocks = 0;
+    int stage = 0;
+
+    for (int ii = 0; ii < N2; ii++)
+    {
+        int dirty = 0;
+        for (int jj = 0; jj < block_size[ii]; jj++, stage++)
+            dirty |= stage_dirty[stage];
+        num_blocks += dirty;
+    }
+    num_blocks += stage_dirty[stage];
+
+    return num_blocks;
+}
+
+
+
 int ocp_qp_partial_condensing(void *qp_in_, void *pcond_qp_in_, void *opts_, void *mem_, void *work)
 {
     ocp_qp_in *qp_in = qp_in_;
@@ -486,7 +813,36 @@ int ocp_qp_partial_condensing(void *qp_in_, void *pcond_qp_in_, void *opts_, voi
 
     // convert to partially condensed qp structure
     // TODO only if N2<N
-    d_part_cond_qp_cond(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    if (opts->incremental)
+    {
+        // the cache describes the last qp condensed into this pcond_qp_in only
+        if (pcond_qp_in != mem->pcond_qp_in_prev)
+            mem->cache_valid = 0;
+        mem->pcond_qp_in_prev = pcond_qp_in;
+
+        int N = mem->red_qp->dim->N;
+        int num_dirty = ocp_qp_partial_condensing_update_dirty(mem->red_qp, mem);
+        mem->num_recond_blocks = ocp_qp_partial_condensing_count_dirty_blocks(opts->N2, mem->block_size,
+                                                                              mem->stage_dirty);
+
+        if (num_dirty == N + 1)
+        {
+            d_part_cond_qp_cond(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+        }
+        else
+        {
+            // recondense the blocks containing a changed stage, then the rhs of all blocks
+            if (num_dirty > 0)
+                d_part_cond_qp_update(mem->stage_dirty, mem->red_qp, pcond_qp_in,
+                                      opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+            d_part_cond_qp_cond_rhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+        }
+    }
+    else
+    {
+        d_part_cond_qp_cond(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+        mem->num_recond_blocks = opts->N2 + 1;
+    }
 
     // stop timer
     mem->time_qp_xcond = acados_toc(&timer);
@@ -69,6 +69,9 @@ typedef struct ocp_qp_partial_condensing_opts_
 //    int expand_dual_sol; // 0 primal sol only, 1 primal + dual sol
     int ric_alg;
     int mem_qp_in; // allocate qp_in in memory
+    int N2_auto;  // choose N2 from a machine-calibrated cost model in opts_update
+    double *N2_cost;  // predicted time of a QP solution [s] for N2 = 1, ..., N (entry 0 unused)
+    int incremental;  // recondense only the blocks containing stages whose matrices changed
 } ocp_qp_partial_condensing_opts;
 
 
@@ -80,13 +83,22 @@ typedef struct ocp_qp_partial_condensing_memory_
     // in memory
     ocp_qp_in *pcond_qp_in;
     ocp_qp_out *pcond_qp_out;
+    ocp_qp_out *pcond_sens_qp_out; // solution sensitivities, keeps pcond_qp_out for warm start
     ocp_qp_in *red_qp; // reduced qp
     ocp_qp_out *red_sol; // reduced qp sol
+    ocp_qp_in *red_qp_cache; // stage matrices of the reduced qp at the last condensing
+    int *stage_dirty; // stages of the reduced qp whose matrices changed since the last condensing
+    int cache_valid;
+    int num_recond_blocks; // blocks recondensed in the last call (lhs), N2+1 for a full condensing
     // only pointer
     ocp_qp_in *ptr_qp_in;
     ocp_qp_in *ptr_pcond_qp_in;
+    ocp_qp_in *pcond_qp_in_prev; // pcond_qp_in of the last condensing, for the cache
+    int *block_size; // pointer to block_size in dims
     qp_info *qp_out_info; // info in pcond_qp_in
     double time_qp_xcond;
+    int N2;  // horizon of the partially condensed QP
+    double *N2_cost;  // pointer to N2_cost in opts
 } ocp_qp_partial_condensing_memory;
 
 
@@ -0,0 +1,1207 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// external
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(ACADOS_WITH_OPENMP)
+#include <omp.h>
+#endif
+// blasfeo
+#include "blasfeo/include/blasfeo_d_aux.h"
+#include "blasfeo/include/blasfeo_d_blas.h"
+// acados
+#include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/ocp_qp/ocp_qp_pric.h"
+#include "acados/utils/math.h"
+#include "acados/utils/mem.h"
+#include "acados/utils/timing.h"
+#include "acados/utils/types.h"
+
+
+
+/************************************************
+ * opts
+ ************************************************/
+
+acados_size_t ocp_qp_pric_opts_calculate_size(void *config_, void *dims_)
+{
+    acados_size_t size = 0;
+    size += sizeof(ocp_qp_pric_opts);
+
+    return size;
+}
+
+
+
+void *ocp_qp_pric_opts_assign(void *config_, void *dims_, void *raw_memory)
+{
+    ocp_qp_pric_opts *opts;
+
+    char *c_ptr = (char *) raw_memory;
+
+    opts = (ocp_qp_pric_opts *) c_ptr;
+    c_ptr += sizeof(ocp_qp_pric_opts);
+
+    assert((char *) raw_memory + ocp_qp_pric_opts_calculate_size(config_, dims_) >= c_ptr);
+
+    return (void *) opts;
+}
+
+
+
+void ocp_qp_pric_opts_initialize_default(void *config_, void *dims_, void *opts_)
+{
+    ocp_qp_pric_opts *opts = opts_;
+
+    opts->mu0 = 1e0;
+    opts->tol_stat = 1e-6;
+    opts->tol_eq = 1e-8;
+    opts->tol_ineq = 1e-8;
+    opts->tol_comp = 1e-8;
+    opts->reg_prim = 1e-15;
+    opts->alpha_min = 1e-8;
+    opts->iter_max = 50;
+    opts->warm_start = 0;
+    opts->num_threads = 1;
+
+    return;
+}
+
+
+
+void ocp_qp_pric_opts_update(void *config_, void *dims_, void *opts_)
+{
+    return;
+}
+
+
+
+void ocp_qp_pric_opts_set(void *config_, void *opts_, const char *field, void *value)
+{
+    ocp_qp_pric_opts *opts = opts_;
+
+    if (!strcmp(field, "iter_max"))
+    {
+        int *tmp_ptr = value;
+        opts->iter_max = *tmp_ptr;
+    }
+    else if (!strcmp(field, "tol_stat"))
+    {
+        double *tmp_ptr = value;
+        opts->tol_stat = *tmp_ptr;
+    }
+    else if (!strcmp(field, "tol_eq"))
+    {
+        double *tmp_ptr = value;
+        opts->tol_eq = *tmp_ptr;
+    }
+    else if (!strcmp(field, "tol_ineq"))
+    {
+        double *tmp_ptr = value;
+        opts->tol_ineq = *tmp_ptr;
+    }
+    else if (!strcmp(field, "tol_comp"))
+    {
+        double *tmp_ptr = value;
+        opts->tol_comp = *tmp_ptr;
+    }
+    else if (!strcmp(field, "mu0"))
+    {
+        double *tmp_ptr = value;
+        opts->mu0 = *tmp_ptr;
+    }
+    else if (!strcmp(field, "reg_prim"))
+    {
+        double *tmp_ptr = value;
+        opts->reg_prim = *tmp_ptr;
+    }
+    else if (!strcmp(field, "alpha_min"))
+    {
+        double *tmp_ptr = value;
+        opts->alpha_min = *tmp_ptr;
+    }
+    else if (!strcmp(field, "warm_start"))
+    {
+        int *tmp_ptr = value;
+        opts->warm_start = *tmp_ptr;
+    }
+    else if (!strcmp(field, "num_threads"))
+    {
+        int *tmp_ptr = value;
+        opts->num_threads = *tmp_ptr;
+    }
+    else
+    {
+        printf("\nerror: ocp_qp_pric_opts_set: wrong field: %s\n", field);
+        exit(1);
+    }
+
+    return;
+}
+
+
+
+/************************************************
+ * memory
+ ************************************************/
+
+static int ocp_qp_pric_num_chunks(int N, ocp_qp_pric_opts *opts)
+{
+#if defined(ACADOS_WITH_OPENMP)
+    int num_chunks = opts->num_threads > 1 ? opts->num_threads : 1;
+#else
+    // the chunks would run serially, their coupling is pure overhead
+    int num_chunks = 1;
+#endif
+    if (num_chunks > N)
+        num_chunks = N > 1 ? N : 1;
+    return num_chunks;
+}
+
+
+
+// number of columns of the parametric part of the recursion of chunk c, i.e. the size of the
+// costate at its end; the last chunk ends with the terminal cost and has none
+static int ocp_qp_pric_nlam(int N, int *nx, int num_chunks, int c)
+{
+    return c < num_chunks-1 ? nx[(c+1) * N / num_chunks] : 0;
+}
+
+
+
+acados_size_t ocp_qp_pric_memory_calculate_size(void *config_, void *dims_, void *opts_)
+{
+    ocp_qp_dims *dims = dims_;
+    ocp_qp_pric_opts *opts = opts_;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nb = dims->nb;
+    int *ng = dims->ng;
+    int *ns = dims->ns;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        if (ns[ii] > 0)
+        {
+            printf("\nerror: ocp_qp_pric: soft constraints are not supported, ns[%d] = %d\n",
+                   ii, ns[ii]);
+            exit(1);
+        }
+    }
+
+    int num_chunks = ocp_qp_pric_num_chunks(N, opts);
+
+    int nxM = 0, nvM = 0, ngM = 0, nbgM = 0;
+    for (int ii = 0; ii <= N; ii++)
+    {
+        nxM = MAX(nxM, nx[ii]);
+        nvM = MAX(nvM, nu[ii]+nx[ii]);
+        ngM = MAX(ngM, ng[ii]);
+        nbgM = MAX(nbgM, nb[ii]+ng[ii]);
+    }
+
+    acados_size_t size = 0;
+    size += sizeof(ocp_qp_pric_memory);
+
+    size += (num_chunks+1) * sizeof(int);  // chunk_start
+    size += num_chunks*nxM * sizeof(int);  // ipiv
+
+    size += (12*(N+1)) * sizeof(struct blasfeo_dvec);  // res_g ... q, pbar lr
+    size += (4*(N+1)) * sizeof(struct blasfeo_dmat);  // L P M Zl
+    size += 4*num_chunks * sizeof(struct blasfeo_dmat);  // Psi T G LU
+    size += 4*num_chunks * sizeof(struct blasfeo_dvec);  // phi tau g lam_c
+    size += 3*num_chunks * sizeof(struct blasfeo_dmat);  // AL GM Ct
+    size += 3*num_chunks * sizeof(struct blasfeo_dvec);  // v w sig
+    size += 2 * sizeof(struct blasfeo_dmat);  // L0 W0
+    size += 1 * sizeof(struct blasfeo_dvec);  // w0
+
+    for (int c = 0; c < num_chunks; c++)
+    {
+        int nlam = ocp_qp_pric_nlam(N, nx, num_chunks, c);
+        int s = c * N / num_chunks;
+        int e = c < num_chunks-1 ? (c+1) * N / num_chunks - 1 : N;
+        for (int ii = s; ii <= e; ii++)
+        {
+            int nv = nu[ii]+nx[ii];
+            int nbg = nb[ii]+ng[ii];
+            size += 3 * blasfeo_memsize_dvec(nv);  // res_g dux gm
+            size += 4 * blasfeo_memsize_dvec(2*nbg);  // res_d res_m dt dlam
+            size += blasfeo_memsize_dvec(nbg);  // q
+            if (ii < N)
+                size += 2 * blasfeo_memsize_dvec(nx[ii+1]);  // res_b dpi
+            size += blasfeo_memsize_dmat(nv, nv);  // L
+            size += blasfeo_memsize_dmat(nx[ii], nx[ii]);  // P
+            size += blasfeo_memsize_dmat(nx[ii], nlam);  // M
+            size += blasfeo_memsize_dmat(nu[ii], nlam);  // Zl
+            size += blasfeo_memsize_dvec(nx[ii]);  // pbar
+            size += blasfeo_memsize_dvec(nu[ii]);  // lr
+        }
+        size += 2 * blasfeo_memsize_dmat(nlam, nlam);  // Psi LU
+        size += blasfeo_memsize_dmat(nx[s], nx[s]);  // T
+        size += blasfeo_memsize_dmat(nlam, nx[s]);  // G
+        size += 3 * blasfeo_memsize_dvec(nlam);  // phi g lam_c
+        size += blasfeo_memsize_dvec(nx[s]);  // tau
+        size += 2 * blasfeo_memsize_dmat(nvM, nxM);  // AL GM
+        size += blasfeo_memsize_dmat(nvM, ngM);  // Ct
+        size += blasfeo_memsize_dvec(nxM);  // v
+        size += blasfeo_memsize_dvec(nvM);  // w
+        size += blasfeo_memsize_dvec(nbgM);  // sig
+    }
+    int nlam0 = ocp_qp_pric_nlam(N, nx, num_chunks, 0);
+    size += blasfeo_memsize_dmat(nx[0], nx[0]);  // L0
+    size += blasfeo_memsize_dmat(nx[0], nlam0);  // W0
+    size += blasfeo_memsize_dvec(nx[0]);  // w0
+
+    size += 8 + 64;  // align
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+void *ocp_qp_pric_memory_assign(void *config_, void *dims_, void *opts_, void *raw_memory)
+{
+    ocp_qp_dims *dims = dims_;
+    ocp_qp_pric_opts *opts = opts_;
+    ocp_qp_pric_memory *mem;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nb = dims->nb;
+    int *ng = dims->ng;
+
+    int num_chunks = ocp_qp_pric_num_chunks(N, opts);
+
+    int nxM = 0, nvM = 0, ngM = 0, nbgM = 0;
+    for (int ii = 0; ii <= N; ii++)
+    {
+        nxM = MAX(nxM, nx[ii]);
+        nvM = MAX(nvM, nu[ii]+nx[ii]);
+        ngM = MAX(ngM, ng[ii]);
+        nbgM = MAX(nbgM, nb[ii]+ng[ii]);
+    }
+
+    // char pointer
+    char *c_ptr = (char *) raw_memory;
+
+    mem = (ocp_qp_pric_memory *) c_ptr;
+    c_ptr += sizeof(ocp_qp_pric_memory);
+
+    align_char_to(8, &c_ptr);
+
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->res_g, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->res_b, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->res_d, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->res_m, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->dux, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->dpi, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->dt, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->dlam, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->gm, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->q, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(N+1, &mem->L, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(N+1, &mem->P, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(N+1, &mem->M, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(N+1, &mem->Zl, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->pbar, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->lr, &c_ptr);
+
+    assign_and_advance_blasfeo_dmat_structs(num_chunks, &mem->Psi, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(num_chunks, &mem->T, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(num_chunks, &mem->G, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(num_chunks, &mem->LU, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(num_chunks, &mem->phi, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(num_chunks, &mem->tau, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(num_chunks, &mem->g, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(num_chunks, &mem->lam_c, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(num_chunks, &mem->AL, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(num_chunks, &mem->GM, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(num_chunks, &mem->Ct, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(num_chunks, &mem->v, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(num_chunks, &mem->w, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(num_chunks, &mem->sig, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(1, &mem->L0, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(1, &mem->W0, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(1, &mem->w0, &c_ptr);
+
+    assign_and_advance_int(num_chunks+1, &mem->chunk_start, &c_ptr);
+    assign_and_advance_int(num_chunks*nxM, &mem->ipiv, &c_ptr);
+
+    mem->num_chunks = num_chunks;
+    for (int c = 0; c <= num_chunks; c++)
+        mem->chunk_start[c] = c * N / num_chunks;
+
+    align_char_to(64, &c_ptr);
+
+    for (int c = 0; c < num_chunks; c++)
+    {
+        int nlam = ocp_qp_pric_nlam(N, nx, num_chunks, c);
+        int s = mem->chunk_start[c];
+        int e = c < num_chunks-1 ? mem->chunk_start[c+1]-1 : N;
+        for (int ii = s; ii <= e; ii++)
+        {
+            int nv = nu[ii]+nx[ii];
+            int nbg = nb[ii]+ng[ii];
+            assign_and_advance_blasfeo_dmat_mem(nv, nv, mem->L+ii, &c_ptr);
+            assign_and_advance_blasfeo_dmat_mem(nx[ii], nx[ii], mem->P+ii, &c_ptr);
+            assign_and_advance_blasfeo_dmat_mem(nx[ii], nlam, mem->M+ii, &c_ptr);
+            assign_and_advance_blasfeo_dmat_mem(nu[ii], nlam, mem->Zl+ii, &c_ptr);
+            assign_and_advance_blasfeo_dvec_mem(nv, mem->res_g+ii, &c_ptr);
+            assign_and_advance_blasfeo_dvec_mem(nv, mem->dux+ii, &c_ptr);
+            assign_and_advance_blasfeo_dvec_mem(nv, mem->gm+ii, &c_ptr);
+            assign_and_advance_blasfeo_dvec_mem(2*nbg, mem->res_d+ii, &c_ptr);
+            assign_and_advance_blasfeo_dvec_mem(2*nbg, mem->res_m+ii, &c_ptr);
+            assign_and_advance_blasfeo_dvec_mem(2*nbg, mem->dt+ii, &c_ptr);
+            assign_and_advance_blasfeo_dvec_mem(2*nbg, mem->dlam+ii, &c_ptr);
+            assign_and_advance_blasfeo_dvec_mem(nbg, mem->q+ii, &c_ptr);
+            if (ii < N)
+            {
+                assign_and_advance_blasfeo_dvec_mem(nx[ii+1], mem->res_b+ii, &c_ptr);
+                assign_and_advance_blasfeo_dvec_mem(nx[ii+1], mem->dpi+ii, &c_ptr);
+            }
+            assign_and_advance_blasfeo_dvec_mem(nx[ii], mem->pbar+ii, &c_ptr);
+            assign_and_advance_blasfeo_dvec_mem(nu[ii], mem->lr+ii, &c_ptr);
+        }
+        assign_and_advance_blasfeo_dmat_mem(nlam, nlam, mem->Psi+c, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nlam, nlam, mem->LU+c, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nx[s], nx[s], mem->T+c, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nlam, nx[s], mem->G+c, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nvM, nxM, mem->AL+c, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nvM, nxM, mem->GM+c, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nvM, ngM, mem->Ct+c, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nlam, mem->phi+c, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nlam, mem->g+c, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nlam, mem->lam_c+c, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nx[s], mem->tau+c, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nxM, mem->v+c, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nvM, mem->w+c, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nbgM, mem->sig+c, &c_ptr);
+    }
+    int nlam0 = ocp_qp_pric_nlam(N, nx, num_chunks, 0);
+    assign_and_advance_blasfeo_dmat_mem(nx[0], nx[0], mem->L0, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(nx[0], nlam0, mem->W0, &c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(nx[0], mem->w0, &c_ptr);
+
+    mem->time_qp_solver_call = 0.0;
+    mem->iter = 0;
+    mem->status = ACADOS_READY;
+
+    assert((char *) raw_memory + ocp_qp_pric_memory_calculate_size(config_, dims, opts_) >= c_ptr);
+
+    return mem;
+}
+
+
+
+void ocp_qp_pric_memory_get(void *config_, void *mem_, const char *field, void* value)
+{
+    ocp_qp_pric_memory *mem = mem_;
+
+    if (!strcmp(field, "time_qp_solver_call"))
+    {
+        double *tmp_ptr = value;
+        *tmp_ptr = mem->time_qp_solver_call;
+    }
+    else if (!strcmp(field, "iter"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->iter;
+    }
+    else if (!strcmp(field, "status"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->status;
+    }
+    else
+    {
+        printf("\nerror: ocp_qp_pric_memory_get: field %s not available\n", field);
+        exit(1);
+    }
+
+    return;
+}
+
+
+
+/************************************************
+ * workspace
+ ************************************************/
+
+acados_size_t ocp_qp_pric_workspace_calculate_size(void *config_, void *dims_, void *opts_)
+{
+    return 0;
+}
+
+
+
+/************************************************
+ * partitioned Riccati recursion
+ ************************************************/
+
+// Newton step subproblem of stage ii: Hessian with the barrier term of the inequalities, in L
+static void ocp_qp_pric_hessian(ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_qp_pric_opts *opts,
+                                ocp_qp_pric_memory *mem, int ii, int c)
+{
+    int nu = qp_in->dim->nu[ii];
+    int nx = qp_in->dim->nx[ii];
+    int nb = qp_in->dim->nb[ii];
+    int ng = qp_in->dim->ng[ii];
+    int nv = nu + nx;
+    int nbg = nb + ng;
+
+    struct blasfeo_dmat *L = mem->L+ii;
+    struct blasfeo_dmat *Ct = mem->Ct+c;
+    struct blasfeo_dvec *sig = mem->sig+c;
+    int *idxb = qp_in->idxb[ii];
+
+    blasfeo_dgecp(nv, nv, qp_in->RSQrq+ii, 0, 0, L, 0, 0);
+    blasfeo_dtrtr_l(nv, L, 0, 0, L, 0, 0);
+    blasfeo_ddiare(nv, opts->reg_prim, L, 0, 0);
+
+    for (int jj = 0; jj < nbg; jj++)
+    {
+        BLASFEO_DVECEL(sig, jj) =
+            BLASFEO_DVECEL(qp_out->lam+ii, jj) / BLASFEO_DVECEL(qp_out->t+ii, jj)
+            + BLASFEO_DVECEL(qp_out->lam+ii, nbg+jj) / BLASFEO_DVECEL(qp_out->t+ii, nbg+jj);
+    }
+    for (int jj = 0; jj < nb; jj++)
+        BLASFEO_DMATEL(L, idxb[jj], idxb[jj]) += BLASFEO_DVECEL(sig, jj);
+    if (ng > 0)
+    {
+        for (int jj = 0; jj < ng; jj++)
+            for (int kk = 0; kk < nv; kk++)
+                BLASFEO_DMATEL(Ct, kk, jj) =
+                    BLASFEO_DMATEL(qp_in->DCt+ii, kk, jj) * BLASFEO_DVECEL(sig, nb+jj);
+        blasfeo_dgemm_nt(nv, nv, ng, 1.0, Ct, 0, 0, qp_in->DCt+ii, 0, 0, 1.0, L, 0, 0, L, 0, 0);
+    }
+}
+
+
+
+// Newton step subproblem of stage ii: gradient with the barrier term of the inequalities, in gm
+static void ocp_qp_pric_gradient(ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_qp_pric_memory *mem,
+                                 int ii)
+{
+    int nu = qp_in->dim->nu[ii];
+    int nx = qp_in->dim->nx[ii];
+    int nb = qp_in->dim->nb[ii];
+    int ng = qp_in->dim->ng[ii];
+    int nv = nu + nx;
+    int nbg = nb + ng;
+
+    struct blasfeo_dvec *lam = qp_out->lam+ii;
+    struct blasfeo_dvec *t = qp_out->t+ii;
+    struct blasfeo_dvec *res_d = mem->res_d+ii;
+    struct blasfeo_dvec *res_m = mem->res_m+ii;
+    struct blasfeo_dvec *q = mem->q+ii;
+    int *idxb = qp_in->idxb[ii];
+
+    for (int jj = 0; jj < nbg; jj++)
+    {
+        double q_lb = (BLASFEO_DVECEL(res_m, jj)
+                       - BLASFEO_DVECEL(lam, jj) * BLASFEO_DVECEL(res_d, jj))
+                      / BLASFEO_DVECEL(t, jj);
+        double q_ub = (BLASFEO_DVECEL(res_m, nbg+jj)
+                       - BLASFEO_DVECEL(lam, nbg+jj) * BLASFEO_DVECEL(res_d, nbg+jj))
+                      / BLASFEO_DVECEL(t, nbg+jj);
+        BLASFEO_DVECEL(q, jj) = q_lb - q_ub;
+    }
+
+    blasfeo_dveccp(nv, mem->res_g+ii, 0, mem->gm+ii, 0);
+    for (int jj = 0; jj < nb; jj++)
+        BLASFEO_DVECEL(mem->gm+ii, idxb[jj]) += BLASFEO_DVECEL(q, jj);
+    blasfeo_dgemv_n(nv, ng, 1.0, qp_in->DCt+ii, 0, 0, q, nb, 1.0, mem->gm+ii, 0, mem->gm+ii, 0);
+}
+
+
+
+// backward factorization of chunk c; the recursion is parametrized by the costate lam_c at the
+// end of the chunk, through M (cost-to-go gradient) and Zl (inputs); Psi accumulates the
+// sensitivity of the end state of the chunk wrt lam_c
+static void ocp_qp_pric_chunk_fact(ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_qp_pric_opts *opts,
+                                   ocp_qp_pric_memory *mem, int c)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+
+    int num_chunks = mem->num_chunks;
+    int s = mem->chunk_start[c];
+    int e = c < num_chunks-1 ? mem->chunk_start[c+1]-1 : N;
+    int nlam = ocp_qp_pric_nlam(N, nx, num_chunks, c);
+
+    struct blasfeo_dmat *AL = mem->AL+c;
+    struct blasfeo_dmat *GM = mem->GM+c;
+    struct blasfeo_dmat *Psi = mem->Psi+c;
+
+    blasfeo_dgese(nlam, nlam, 0.0, Psi, 0, 0);
+
+    for (int ii = e; ii >= s; ii--)
+    {
+        int nv = nu[ii] + nx[ii];
+        struct blasfeo_dmat *L = mem->L+ii;
+
+        ocp_qp_pric_hessian(qp_in, qp_out, opts, mem, ii, c);
+
+        // at the end of the chunk the cost-to-go is replaced by the linear term lam_c' x
+        if (ii < N && ii < e)
+        {
+            blasfeo_dgemm_nn(nv, nx[ii+1], nx[ii+1], 1.0, qp_in->BAbt+ii, 0, 0, mem->P+ii+1, 0, 0,
+                             0.0, AL, 0, 0, AL, 0, 0);
+            blasfeo_dgemm_nt(nv, nv, nx[ii+1], 1.0, AL, 0, 0, qp_in->BAbt+ii, 0, 0, 1.0,
+                             L, 0, 0, L, 0, 0);
+        }
+
+        blasfeo_dpotrf_l_mn(nv, nu[ii], L, 0, 0, L, 0, 0);
+        blasfeo_dgemm_nt(nx[ii], nx[ii], nu[ii], -1.0, L, nu[ii], 0, L, nu[ii], 0, 1.0,
+                         L, nu[ii], nu[ii], mem->P+ii, 0, 0);
+
+        if (nlam > 0)
+        {
+            if (ii < e)
+                blasfeo_dgemm_nn(nv, nlam, nx[ii+1], 1.0, qp_in->BAbt+ii, 0, 0, mem->M+ii+1, 0, 0,
+                                 0.0, GM, 0, 0, GM, 0, 0);
+            else
+                blasfeo_dgecp(nv, nlam, qp_in->BAbt+ii, 0, 0, GM, 0, 0);
+
+            blasfeo_dtrsm_llnn(nu[ii], nlam, 1.0, L, 0, 0, GM, 0, 0, mem->Zl+ii, 0, 0);
+            blasfeo_dgemm_nn(nx[ii], nlam, nu[ii], -1.0, L, nu[ii], 0, mem->Zl+ii, 0, 0, 1.0,
+                             GM, nu[ii], 0, mem->M+ii, 0, 0);
+            blasfeo_dgemm_tn(nlam, nlam, nu[ii], -1.0, mem->Zl+ii, 0, 0, mem->Zl+ii, 0, 0, 1.0,
+                             Psi, 0, 0, Psi, 0, 0);
+        }
+    }
+
+    // free initial state: minimize over x_0 as well
+    if (c == 0 && nx[0] > 0)
+    {
+        blasfeo_dpotrf_l(nx[0], mem->P+0, 0, 0, mem->L0, 0, 0);
+        if (nlam > 0)
+        {
+            blasfeo_dtrsm_llnn(nx[0], nlam, 1.0, mem->L0, 0, 0, mem->M+0, 0, 0, mem->W0, 0, 0);
+            blasfeo_dgemm_tn(nlam, nlam, nx[0], -1.0, mem->W0, 0, 0, mem->W0, 0, 0, 1.0,
+                             Psi, 0, 0, Psi, 0, 0);
+        }
+    }
+}
+
+
+
+// backward substitution of chunk c, the affine part of the factorization
+static void ocp_qp_pric_chunk_solve_backward(ocp_qp_in *qp_in, ocp_qp_out *qp_out,
+                                             ocp_qp_pric_memory *mem, int c)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+
+    int num_chunks = mem->num_chunks;
+    int s = mem->chunk_start[c];
+    int e = c < num_chunks-1 ? mem->chunk_start[c+1]-1 : N;
+    int nlam = ocp_qp_pric_nlam(N, nx, num_chunks, c);
+
+    struct blasfeo_dvec *v = mem->v+c;
+    struct blasfeo_dvec *phi = mem->phi+c;
+
+    blasfeo_dvecse(nlam, 0.0, phi, 0);
+
+    for (int ii = e; ii >= s; ii--)
+    {
+        int nv = nu[ii] + nx[ii];
+        struct blasfeo_dmat *L = mem->L+ii;
+        struct blasfeo_dvec *gm = mem->gm+ii;
+
+        ocp_qp_pric_gradient(qp_in, qp_out, mem, ii);
+
+        if (ii < N && ii < e)
+        {
+            blasfeo_dgemv_n(nx[ii+1], nx[ii+1], 1.0, mem->P+ii+1, 0, 0, mem->res_b+ii, 0, 1.0,
+                            mem->pbar+ii+1, 0, v, 0);
+            blasfeo_dgemv_n(nv, nx[ii+1], 1.0, qp_in->BAbt+ii, 0, 0, v, 0, 1.0, gm, 0, gm, 0);
+        }
+
+        blasfeo_dtrsv_lnn(nu[ii], L, 0, 0, gm, 0, mem->lr+ii, 0);
+        blasfeo_dgemv_n(nx[ii], nu[ii], -1.0, L, nu[ii], 0, mem->lr+ii, 0, 1.0, gm, nu[ii],
+                        mem->pbar+ii, 0);
+
+        if (nlam > 0)
+        {
+            if (ii < e)
+                blasfeo_dgemv_t(nx[ii+1], nlam, 1.0, mem->M+ii+1, 0, 0, mem->res_b+ii, 0, 1.0,
+                                phi, 0, phi, 0);
+            else
+                blasfeo_daxpy(nlam, 1.0, mem->res_b+ii, 0, phi, 0, phi, 0);
+            blasfeo_dgemv_t(nu[ii], nlam, -1.0, mem->Zl+ii, 0, 0, mem->lr+ii, 0, 1.0,
+                            phi, 0, phi, 0);
+        }
+    }
+
+    if (c == 0 && nx[0] > 0)
+    {
+        blasfeo_dtrsv_lnn(nx[0], mem->L0, 0, 0, mem->pbar+0, 0, mem->w0, 0);
+        blasfeo_dgemv_t(nx[0], nlam, -1.0, mem->W0, 0, 0, mem->w0, 0, 1.0, phi, 0, phi, 0);
+    }
+}
+
+
+
+// forward substitution of chunk c, given its start state in dux and its end costate lam_c
+static void ocp_qp_pric_chunk_solve_forward(ocp_qp_in *qp_in, ocp_qp_pric_memory *mem, int c)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+
+    int num_chunks = mem->num_chunks;
+    int s = mem->chunk_start[c];
+    int e = c < num_chunks-1 ? mem->chunk_start[c+1]-1 : N;
+    int nlam = ocp_qp_pric_nlam(N, nx, num_chunks, c);
+
+    struct blasfeo_dvec *w = mem->w+c;
+    struct blasfeo_dvec *lam_c = mem->lam_c+c;
+
+    if (c == 0 && nx[0] > 0)
+    {
+        blasfeo_dgemv_n(nx[0], nlam, -1.0, mem->W0, 0, 0, lam_c, 0, -1.0, mem->w0, 0, w, 0);
+        blasfeo_dtrsv_ltn(nx[0], mem->L0, 0, 0, w, 0, mem->dux+0, nu[0]);
+    }
+
+    for (int ii = s; ii <= e; ii++)
+    {
+        int nv = nu[ii] + nx[ii];
+        struct blasfeo_dmat *L = mem->L+ii;
+        struct blasfeo_dvec *dux = mem->dux+ii;
+
+        blasfeo_dgemv_t(nx[ii], nu[ii], -1.0, L, nu[ii], 0, dux, nu[ii], -1.0, mem->lr+ii, 0,
+                        w, 0);
+        blasfeo_dgemv_n(nu[ii], nlam, -1.0, mem->Zl+ii, 0, 0, lam_c, 0, 1.0, w, 0, w, 0);
+        blasfeo_dtrsv_ltn(nu[ii], L, 0, 0, w, 0, dux, 0);
+
+        if (ii < N)
+        {
+            if (ii < e)
+            {
+                blasfeo_dgemv_t(nv, nx[ii+1], 1.0, qp_in->BAbt+ii, 0, 0, dux, 0, 1.0,
+                                mem->res_b+ii, 0, mem->dux+ii+1, nu[ii+1]);
+                blasfeo_dgemv_n(nx[ii+1], nx[ii+1], 1.0, mem->P+ii+1, 0, 0, mem->dux+ii+1, nu[ii+1],
+                                1.0, mem->pbar+ii+1, 0, mem->dpi+ii, 0);
+                blasfeo_dgemv_n(nx[ii+1], nlam, 1.0, mem->M+ii+1, 0, 0, lam_c, 0, 1.0,
+                                mem->dpi+ii, 0, mem->dpi+ii, 0);
+            }
+            else
+            {
+                blasfeo_dveccp(nx[ii+1], lam_c, 0, mem->dpi+ii, 0);
+            }
+        }
+    }
+}
+
+
+
+// Newton step subproblem factorization: chunks in parallel, then the serial recursion over the
+// chunk boundaries, which eliminates the start state of each chunk from its end costate:
+//   lam_{c-1} = T_c x_{s_c} + tau_c,  lam_c = G_c x_{s_c} + g_c
+static void ocp_qp_pric_fact(ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_qp_pric_opts *opts,
+                             ocp_qp_pric_memory *mem)
+{
+    int *nx = qp_in->dim->nx;
+
+    int num_chunks = mem->num_chunks;
+    int *chunk_start = mem->chunk_start;
+    int nxM = 0;
+    for (int ii = 0; ii <= qp_in->dim->N; ii++)
+        nxM = MAX(nxM, nx[ii]);
+
+    int c;
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(num_chunks) schedule(static)
+#endif
+    for (c = 0; c < num_chunks; c++)
+        ocp_qp_pric_chunk_fact(qp_in, qp_out, opts, mem, c);
+
+    if (num_chunks > 1)
+        blasfeo_dgecp(nx[chunk_start[num_chunks-1]], nx[chunk_start[num_chunks-1]],
+                      mem->P+chunk_start[num_chunks-1], 0, 0, mem->T+num_chunks-1, 0, 0);
+
+    for (c = num_chunks-2; c >= 0; c--)
+    {
+        int s = chunk_start[c];
+        int nlam = nx[chunk_start[c+1]];
+        struct blasfeo_dmat *LU = mem->LU+c;
+        int *ipiv = mem->ipiv+c*nxM;
+
+        blasfeo_dgese(nlam, nlam, 0.0, LU, 0, 0);
+        blasfeo_ddiare(nlam, 1.0, LU, 0, 0);
+        blasfeo_dgemm_nn(nlam, nlam, nlam, -1.0, mem->T+c+1, 0, 0, mem->Psi+c, 0, 0, 1.0,
+                         LU, 0, 0, LU, 0, 0);
+        blasfeo_dgetrf_rp(nlam, nlam, LU, 0, 0, LU, 0, 0, ipiv);
+
+        if (c > 0)
+        {
+            blasfeo_dgemm_nt(nlam, nx[s], nlam, 1.0, mem->T+c+1, 0, 0, mem->M+s, 0, 0, 0.0,
+                             mem->G+c, 0, 0, mem->G+c, 0, 0);
+            blasfeo_drowpe(nlam, ipiv, mem->G+c);
+            blasfeo_dtrsm_llnu(nlam, nx[s], 1.0, LU, 0, 0, mem->G+c, 0, 0, mem->G+c, 0, 0);
+            blasfeo_dtrsm_lunn(nlam, nx[s], 1.0, LU, 0, 0, mem->G+c, 0, 0, mem->G+c, 0, 0);
+            blasfeo_dgemm_nn(nx[s], nx[s], nlam, 1.0, mem->M+s, 0, 0, mem->G+c, 0, 0, 1.0,
+                             mem->P+s, 0, 0, mem->T+c, 0, 0);
+        }
+    }
+}
+
+
+
+// Newton step subproblem solution into dux, dpi, with the factorization from ocp_qp_pric_fact
+static void ocp_qp_pric_solve(ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_qp_pric_memory *mem)
+{
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+
+    int num_chunks = mem->num_chunks;
+    int *chunk_start = mem->chunk_start;
+    int nxM = 0;
+    for (int ii = 0; ii <= qp_in->dim->N; ii++)
+        nxM = MAX(nxM, nx[ii]);
+
+    int c;
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(num_chunks) schedule(static)
+#endif
+    for (c = 0; c < num_chunks; c++)
+        ocp_qp_pric_chunk_solve_backward(qp_in, qp_out, mem, c);
+
+    if (num_chunks > 1)
+        blasfeo_dveccp(nx[chunk_start[num_chunks-1]], mem->pbar+chunk_start[num_chunks-1], 0,
+                       mem->tau+num_chunks-1, 0);
+
+    for (c = num_chunks-2; c >= 0; c--)
+    {
+        int s = chunk_start[c];
+        int nlam = nx[chunk_start[c+1]];
+        struct blasfeo_dmat *LU = mem->LU+c;
+        int *ipiv = mem->ipiv+c*nxM;
+
+        blasfeo_dgemv_n(nlam, nlam, 1.0, mem->T+c+1, 0, 0, mem->phi+c, 0, 1.0, mem->tau+c+1, 0,
+                        mem->g+c, 0);
+        blasfeo_dvecpe(nlam, ipiv, mem->g+c, 0);
+        blasfeo_dtrsv_lnu(nlam, LU, 0, 0, mem->g+c, 0, mem->g+c, 0);
+        blasfeo_dtrsv_unn(nlam, LU, 0, 0, mem->g+c, 0, mem->g+c, 0);
+
+        if (c > 0)
+            blasfeo_dgemv_n(nx[s], nlam, 1.0, mem->M+s, 0, 0, mem->g+c, 0, 1.0, mem->pbar+s, 0,
+                            mem->tau+c, 0);
+    }
+
+    // chunk boundaries: costate at the end and state at the start of each chunk
+    for (c = 0; c < num_chunks-1; c++)
+    {
+        int s = chunk_start[c];
+        int s1 = chunk_start[c+1];
+        int nlam = nx[s1];
+
+        if (c == 0)
+        {
+            blasfeo_dveccp(nlam, mem->g+0, 0, mem->lam_c+0, 0);
+            blasfeo_dgemv_n(nlam, nlam, 1.0, mem->Psi+0, 0, 0, mem->lam_c+0, 0, 1.0, mem->phi+0, 0,
+                            mem->dux+s1, nu[s1]);
+        }
+        else
+        {
+            blasfeo_dgemv_n(nlam, nx[s], 1.0, mem->G+c, 0, 0, mem->dux+s, nu[s], 1.0, mem->g+c, 0,
+                            mem->lam_c+c, 0);
+            blasfeo_dgemv_t(nx[s], nlam, 1.0, mem->M+s, 0, 0, mem->dux+s, nu[s], 1.0,
+                            mem->phi+c, 0, mem->dux+s1, nu[s1]);
+            blasfeo_dgemv_n(nlam, nlam, 1.0, mem->Psi+c, 0, 0, mem->lam_c+c, 0, 1.0,
+                            mem->dux+s1, nu[s1], mem->dux+s1, nu[s1]);
+        }
+    }
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(num_chunks) schedule(static)
+#endif
+    for (c = 0; c < num_chunks; c++)
+        ocp_qp_pric_chunk_solve_forward(qp_in, mem, c);
+}
+
+
+
+/************************************************
+ * interior point method
+ ************************************************/
+
+// residuals of the KKT conditions at stage ii; returns the sum of the complementarity products
+static double ocp_qp_pric_res_stage(ocp_qp_in *qp_in, ocp_qp_out *qp_out,
+                                    ocp_qp_pric_memory *mem, int ii, double *res_max)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int nb = qp_in->dim->nb[ii];
+    int ng = qp_in->dim->ng[ii];
+    int nv = nu[ii] + nx[ii];
+    int nbg = nb + ng;
+
+    struct blasfeo_dvec *ux = qp_out->ux+ii;
+    struct blasfeo_dvec *lam = qp_out->lam+ii;
+    struct blasfeo_dvec *t = qp_out->t+ii;
+    struct blasfeo_dvec *res_g = mem->res_g+ii;
+    struct blasfeo_dvec *res_d = mem->res_d+ii;
+    struct blasfeo_dvec *res_m = mem->res_m+ii;
+    struct blasfeo_dvec *q = mem->q+ii;
+    int *idxb = qp_in->idxb[ii];
+
+    // stationarity
+    blasfeo_dsymv_l(nv, 1.0, qp_in->RSQrq+ii, 0, 0, ux, 0, 1.0, qp_in->rqz+ii, 0, res_g, 0);
+    if (ii < N)
+        blasfeo_dgemv_n(nv, nx[ii+1], 1.0, qp_in->BAbt+ii, 0, 0, qp_out->pi+ii, 0, 1.0,
+                        res_g, 0, res_g, 0);
+    if (ii > 0)
+        blasfeo_daxpy(nx[ii], -1.0, qp_out->pi+ii-1, 0, res_g, nu[ii], res_g, nu[ii]);
+    for (int jj = 0; jj < nbg; jj++)
+        BLASFEO_DVECEL(q, jj) = BLASFEO_DVECEL(lam, nbg+jj) - BLASFEO_DVECEL(lam, jj);
+    for (int jj = 0; jj < nb; jj++)
+        BLASFEO_DVECEL(res_g, idxb[jj]) += BLASFEO_DVECEL(q, jj);
+    blasfeo_dgemv_n(nv, ng, 1.0, qp_in->DCt+ii, 0, 0, q, nb, 1.0, res_g, 0, res_g, 0);
+
+    // dynamics
+    if (ii < N)
+    {
+        blasfeo_dgemv_t(nv, nx[ii+1], 1.0, qp_in->BAbt+ii, 0, 0, ux, 0, 1.0, qp_in->b+ii, 0,
+                        mem->res_b+ii, 0);
+        blasfeo_daxpy(nx[ii+1], -1.0, qp_out->ux+ii+1, nu[ii+1], mem->res_b+ii, 0,
+                      mem->res_b+ii, 0);
+    }
+
+    // inequalities: t_lb = D ux - d_lb, t_ub = - D ux - d_ub
+    for (int jj = 0; jj < nb; jj++)
+        BLASFEO_DVECEL(res_d, jj) = BLASFEO_DVECEL(ux, idxb[jj]);
+    blasfeo_dgemv_t(nv, ng, 1.0, qp_in->DCt+ii, 0, 0, ux, 0, 0.0, res_d, nb, res_d, nb);
+    for (int jj = 0; jj < nbg; jj++)
+    {
+        double Dux = BLASFEO_DVECEL(res_d, jj);
+        BLASFEO_DVECEL(res_d, jj) = BLASFEO_DVECEL(t, jj) - Dux + BLASFEO_DVECEL(qp_in->d+ii, jj);
+        BLASFEO_DVECEL(res_d, nbg+jj) = BLASFEO_DVECEL(t, nbg+jj) + Dux
+                                        + BLASFEO_DVECEL(qp_in->d+ii, nbg+jj);
+    }
+
+    double mu_sum = 0.0;
+    for (int jj = 0; jj < 2*nbg; jj++)
+    {
+        BLASFEO_DVECEL(res_m, jj) = BLASFEO_DVECEL(lam, jj) * BLASFEO_DVECEL(t, jj);
+        mu_sum += BLASFEO_DVECEL(res_m, jj);
+    }
+
+    for (int jj = 0; jj < nv; jj++)
+        res_max[0] = fmax(res_max[0], fabs(BLASFEO_DVECEL(res_g, jj)));
+    if (ii < N)
+        for (int jj = 0; jj < nx[ii+1]; jj++)
+            res_max[1] = fmax(res_max[1], fabs(BLASFEO_DVECEL(mem->res_b+ii, jj)));
+    for (int jj = 0; jj < 2*nbg; jj++)
+        res_max[2] = fmax(res_max[2], fabs(BLASFEO_DVECEL(res_d, jj)));
+
+    return mu_sum;
+}
+
+
+
+// step in the slacks and multipliers of stage ii from the primal step; returns the largest
+// admissible step length
+static double ocp_qp_pric_step_stage(ocp_qp_in *qp_in, ocp_qp_out *qp_out,
+                                     ocp_qp_pric_memory *mem, int ii)
+{
+    int nu = qp_in->dim->nu[ii];
+    int nx = qp_in->dim->nx[ii];
+    int nb = qp_in->dim->nb[ii];
+    int ng = qp_in->dim->ng[ii];
+    int nv = nu + nx;
+    int nbg = nb + ng;
+
+    struct blasfeo_dvec *lam = qp_out->lam+ii;
+    struct blasfeo_dvec *t = qp_out->t+ii;
+    struct blasfeo_dvec *dt = mem->dt+ii;
+    struct blasfeo_dvec *dlam = mem->dlam+ii;
+    struct blasfeo_dvec *res_d = mem->res_d+ii;
+    struct blasfeo_dvec *res_m = mem->res_m+ii;
+    int *idxb = qp_in->idxb[ii];
+
+    for (int jj = 0; jj < nb; jj++)
+        BLASFEO_DVECEL(dt, jj) = BLASFEO_DVECEL(mem->dux+ii, idxb[jj]);
+    blasfeo_dgemv_t(nv, ng, 1.0, qp_in->DCt+ii, 0, 0, mem->dux+ii, 0, 0.0, dt, nb, dt, nb);
+
+    double alpha = 1.0;
+    for (int jj = 0; jj < nbg; jj++)
+    {
+        double Ddux = BLASFEO_DVECEL(dt, jj);
+        BLASFEO_DVECEL(dt, jj) = Ddux - BLASFEO_DVECEL(res_d, jj);
+        BLASFEO_DVECEL(dt, nbg+jj) = - Ddux - BLASFEO_DVECEL(res_d, nbg+jj);
+    }
+    for (int jj = 0; jj < 2*nbg; jj++)
+    {
+        BLASFEO_DVECEL(dlam, jj) = - (BLASFEO_DVECEL(res_m, jj)
+                                      + BLASFEO_DVECEL(lam, jj) * BLASFEO_DVECEL(dt, jj))
+                                   / BLASFEO_DVECEL(t, jj);
+        if (BLASFEO_DVECEL(dt, jj) < 0.0)
+            alpha = fmin(alpha, - BLASFEO_DVECEL(t, jj) / BLASFEO_DVECEL(dt, jj));
+        if (BLASFEO_DVECEL(dlam, jj) < 0.0)
+            alpha = fmin(alpha, - BLASFEO_DVECEL(lam, jj) / BLASFEO_DVECEL(dlam, jj));
+    }
+
+    return alpha;
+}
+
+
+
+static void ocp_qp_pric_init(ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_qp_pric_opts *opts)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    double thr = 1e0;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nv = nu[ii] + nx[ii];
+        int nbg = nb[ii] + ng[ii];
+        struct blasfeo_dvec *ux = qp_out->ux+ii;
+        struct blasfeo_dvec *t = qp_out->t+ii;
+        struct blasfeo_dvec *lam = qp_out->lam+ii;
+
+        if (opts->warm_start == 0)
+            blasfeo_dvecse(nv, 0.0, ux, 0);
+        if (ii < N)
+            blasfeo_dvecse(nx[ii+1], 0.0, qp_out->pi+ii, 0);
+
+        for (int jj = 0; jj < nb[ii]; jj++)
+            BLASFEO_DVECEL(t, jj) = BLASFEO_DVECEL(ux, qp_in->idxb[ii][jj]);
+        blasfeo_dgemv_t(nv, ng[ii], 1.0, qp_in->DCt+ii, 0, 0, ux, 0, 0.0, t, nb[ii], t, nb[ii]);
+        for (int jj = 0; jj < nbg; jj++)
+        {
+            double Dux = BLASFEO_DVECEL(t, jj);
+            BLASFEO_DVECEL(t, jj) = fmax(thr, Dux - BLASFEO_DVECEL(qp_in->d+ii, jj));
+            BLASFEO_DVECEL(t, nbg+jj) = fmax(thr, - Dux - BLASFEO_DVECEL(qp_in->d+ii, nbg+jj));
+        }
+        for (int jj = 0; jj < 2*nbg; jj++)
+            BLASFEO_DVECEL(lam, jj) = opts->mu0 / BLASFEO_DVECEL(t, jj);
+    }
+}
+
+
+
+int ocp_qp_pric(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, void *work_)
+{
+    ocp_qp_in *qp_in = qp_in_;
+    ocp_qp_out *qp_out = qp_out_;
+    ocp_qp_pric_opts *opts = opts_;
+    ocp_qp_pric_memory *mem = mem_;
+
+    qp_info *info = qp_out->misc;
+    acados_timer tot_timer, qp_timer;
+
+    acados_tic(&tot_timer);
+    acados_tic(&qp_timer);
+
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    int nc = 0;
+    for (int ii = 0; ii <= N; ii++)
+        nc += 2 * (nb[ii] + ng[ii]);
+
+    ocp_qp_pric_init(qp_in, qp_out, opts);
+
+    int status = ACADOS_MAXITER;
+    int iter;
+    int ii;
+
+    for (iter = 0; ; iter++)
+    {
+        // residuals
+        double res_g = 0.0, res_b = 0.0, res_d = 0.0, mu = 0.0;
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp parallel for num_threads(mem->num_chunks) schedule(static) \
+            reduction(max:res_g, res_b, res_d) reduction(+:mu)
+#endif
+        for (ii = 0; ii <= N; ii++)
+        {
+            double res_max[3] = {0.0, 0.0, 0.0};
+            mu += ocp_qp_pric_res_stage(qp_in, qp_out, mem, ii, res_max);
+            res_g = fmax(res_g, res_max[0]);
+            res_b = fmax(res_b, res_max[1]);
+            res_d = fmax(res_d, res_max[2]);
+        }
+        mu = nc > 0 ? mu / nc : 0.0;
+
+        if (res_g <= opts->tol_stat && res_b <= opts->tol_eq && res_d <= opts->tol_ineq &&
+            mu <= opts->tol_comp)
+        {
+            status = ACADOS_SUCCESS;
+            break;
+        }
+        if (iter >= opts->iter_max)
+        {
+            status = ACADOS_MAXITER;
+            break;
+        }
+
+        ocp_qp_pric_fact(qp_in, qp_out, opts, mem);
+
+        // predictor
+        ocp_qp_pric_solve(qp_in, qp_out, mem);
+
+        double alpha = 1.0;
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp parallel for num_threads(mem->num_chunks) schedule(static) \
+            reduction(min:alpha)
+#endif
+        for (ii = 0; ii <= N; ii++)
+            alpha = fmin(alpha, ocp_qp_pric_step_stage(qp_in, qp_out, mem, ii));
+
+        // corrector
+        if (nc > 0)
+        {
+            double mu_aff = 0.0;
+            for (ii = 0; ii <= N; ii++)
+            {
+                for (int jj = 0; jj < 2*(nb[ii]+ng[ii]); jj++)
+                {
+                    mu_aff += (BLASFEO_DVECEL(qp_out->lam+ii, jj)
+                               + alpha * BLASFEO_DVECEL(mem->dlam+ii, jj))
+                              * (BLASFEO_DVECEL(qp_out->t+ii, jj)
+                                 + alpha * BLASFEO_DVECEL(mem->dt+ii, jj));
+                }
+            }
+            mu_aff /= nc;
+            double sigma = mu_aff / mu;
+            sigma = sigma * sigma * sigma;
+
+            for (ii = 0; ii <= N; ii++)
+            {
+                for (int jj = 0; jj < 2*(nb[ii]+ng[ii]); jj++)
+                {
+                    BLASFEO_DVECEL(mem->res_m+ii, jj) +=
+                        BLASFEO_DVECEL(mem->dlam+ii, jj) * BLASFEO_DVECEL(mem->dt+ii, jj)
+                        - sigma * mu;
+                }
+            }
+
+            ocp_qp_pric_solve(qp_in, qp_out, mem);
+
+            alpha = 1.0;
+#if defined(ACADOS_WITH_OPENMP)
+            #pragma omp parallel for num_threads(mem->num_chunks) schedule(static) \
+                reduction(min:alpha)
+#endif
+            for (ii = 0; ii <= N; ii++)
+                alpha = fmin(alpha, ocp_qp_pric_step_stage(qp_in, qp_out, mem, ii));
+            alpha = fmin(1.0, 0.995 * alpha);
+        }
+
+        if (alpha < opts->alpha_min)
+        {
+            status = ACADOS_MINSTEP;
+            break;
+        }
+
+        // update
+        for (ii = 0; ii <= N; ii++)
+        {
+            int nbg2 = 2 * (nb[ii] + ng[ii]);
+            blasfeo_daxpy(nu[ii]+nx[ii], alpha, mem->dux+ii, 0, qp_out->ux+ii, 0,
+                          qp_out->ux+ii, 0);
+            if (ii < N)
+                blasfeo_daxpy(nx[ii+1], alpha, mem->dpi+ii, 0, qp_out->pi+ii, 0,
+                              qp_out->pi+ii, 0);
+            blasfeo_daxpy(nbg2, alpha, mem->dt+ii, 0, qp_out->t+ii, 0, qp_out->t+ii, 0);
+            blasfeo_daxpy(nbg2, alpha, mem->dlam+ii, 0, qp_out->lam+ii, 0, qp_out->lam+ii, 0);
+        }
+    }
+
+    info->solve_QP_time = acados_toc(&qp_timer);
+    info->interface_time = 0;
+    info->total_time = acados_toc(&tot_timer);
+    info->num_iter = iter;
+    info->t_computed = 1;
+
+    mem->time_qp_solver_call = info->solve_QP_time;
+    mem->iter = iter;
+    mem->status = status;
+
+    return status;
+}
+
+
+
+void ocp_qp_pric_eval_sens(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_,
+                           void *work_)
+{
+    printf("\nerror: ocp_qp_pric_eval_sens: not implemented yet\n");
+    exit(1);
+}
+
+
+
+void ocp_qp_pric_config_initialize_default(void *config_)
+{
+    qp_solver_config *config = config_;
+
+    config->dims_set = &ocp_qp_dims_set;
+    config->opts_calculate_size = &ocp_qp_pric_opts_calculate_size;
+    config->opts_assign = &ocp_qp_pric_opts_assign;
+    config->opts_initialize_default = &ocp_qp_pric_opts_initialize_default;
+    config->opts_update = &ocp_qp_pric_opts_update;
+    config->opts_set = &ocp_qp_pric_opts_set;
+    config->memory_calculate_size = &ocp_qp_pric_memory_calculate_size;
+    config->memory_assign = &ocp_qp_pric_memory_assign;
+    config->memory_get = &ocp_qp_pric_memory_get;
+    config->workspace_calculate_size = &ocp_qp_pric_workspace_calculate_size;
+    config->evaluate = &ocp_qp_pric;
+    config->eval_sens = &ocp_qp_pric_eval_sens;
+
+    return;
+}
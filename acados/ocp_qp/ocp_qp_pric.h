@@ -0,0 +1,159 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// Primal-dual interior point method for OCP QPs, whose Newton systems are solved by a
+// partitioned (parallel-in-time) Riccati recursion: the horizon is split into one chunk per
+// thread, each chunk runs a Riccati recursion parametrized by its initial state and by the
+// costate of its last stage, and the chunks are coupled through a small recursion over the
+// chunk boundaries, which is the only serial part of the factorization.
+
+#ifndef ACADOS_OCP_QP_OCP_QP_PRIC_H_
+#define ACADOS_OCP_QP_OCP_QP_PRIC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// blasfeo
+#include "blasfeo/include/blasfeo_common.h"
+// acados
+#include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/utils/types.h"
+
+
+
+typedef struct ocp_qp_pric_opts_
+{
+    double mu0;         // initial barrier parameter
+    double tol_stat;    // exit tolerance on the stationarity residual
+    double tol_eq;      // exit tolerance on the equality (dynamics) residual
+    double tol_ineq;    // exit tolerance on the inequality residual
+    double tol_comp;    // exit tolerance on the complementarity
+    double reg_prim;    // regularization added to the Hessian diagonal
+    double alpha_min;   // minimum step length
+    int iter_max;
+    int warm_start;     // 0: cold start; 1: primal warm start from qp_out
+    int num_threads;    // number of chunks the horizon is split into (and threads solving them)
+} ocp_qp_pric_opts;
+
+
+
+typedef struct ocp_qp_pric_memory_
+{
+    // interior point residuals and step, per stage
+    struct blasfeo_dvec *res_g;
+    struct blasfeo_dvec *res_b;
+    struct blasfeo_dvec *res_d;
+    struct blasfeo_dvec *res_m;
+    struct blasfeo_dvec *dux;
+    struct blasfeo_dvec *dpi;
+    struct blasfeo_dvec *dt;
+    struct blasfeo_dvec *dlam;
+    struct blasfeo_dvec *gm;    // gradient of the Newton step subproblem
+    struct blasfeo_dvec *q;     // constraint contribution to gm
+
+    // Riccati factorization, per stage
+    struct blasfeo_dmat *L;     // [chol(R~); S~ chol(R~)^-T; Q~]
+    struct blasfeo_dmat *P;     // cost-to-go Hessian
+    struct blasfeo_dmat *M;     // sensitivity of the cost-to-go gradient wrt the chunk costate
+    struct blasfeo_dmat *Zl;    // sensitivity of the input wrt the chunk costate
+    struct blasfeo_dvec *pbar;  // cost-to-go gradient
+    struct blasfeo_dvec *lr;
+
+    // coupling of the chunks, per chunk
+    int num_chunks;
+    int *chunk_start;
+    int *ipiv;
+    struct blasfeo_dmat *Psi;   // sensitivity of the chunk end state wrt the chunk costate
+    struct blasfeo_dmat *T;     // reduced cost-to-go Hessian at the chunk start
+    struct blasfeo_dmat *G;     // chunk costate as function of the chunk start state
+    struct blasfeo_dmat *LU;
+    struct blasfeo_dvec *phi;
+    struct blasfeo_dvec *tau;
+    struct blasfeo_dvec *g;
+    struct blasfeo_dvec *lam_c; // chunk costate
+
+    // free initial state
+    struct blasfeo_dmat *L0;
+    struct blasfeo_dmat *W0;
+    struct blasfeo_dvec *w0;
+
+    // per chunk workspace
+    struct blasfeo_dmat *AL;
+    struct blasfeo_dmat *GM;
+    struct blasfeo_dmat *Ct;
+    struct blasfeo_dvec *v;
+    struct blasfeo_dvec *w;
+    struct blasfeo_dvec *sig;
+
+    double time_qp_solver_call;
+    int iter;
+    int status;
+
+} ocp_qp_pric_memory;
+
+
+
+//
+acados_size_t ocp_qp_pric_opts_calculate_size(void *config, void *dims);
+//
+void *ocp_qp_pric_opts_assign(void *config, void *dims, void *raw_memory);
+//
+void ocp_qp_pric_opts_initialize_default(void *config, void *dims, void *opts_);
+//
+void ocp_qp_pric_opts_update(void *config, void *dims, void *opts_);
+//
+void ocp_qp_pric_opts_set(void *config_, void *opts_, const char *field, void *value);
+//
+acados_size_t ocp_qp_pric_memory_calculate_size(void *config, void *dims, void *opts_);
+//
+void *ocp_qp_pric_memory_assign(void *config, void *dims, void *opts_, void *raw_memory);
+//
+void ocp_qp_pric_memory_get(void *config_, void *mem_, const char *field, void* value);
+//
+acados_size_t ocp_qp_pric_workspace_calculate_size(void *config, void *dims, void *opts_);
+//
+int ocp_qp_pric(void *config, void *qp_in, void *qp_out, void *opts_, void *mem_, void *work_);
+//
+void ocp_qp_pric_eval_sens(void *config, void *qp_in, void *qp_out, void *opts_, void *mem_, void *work_);
+//
+void ocp_qp_pric_config_initialize_default(void *config);
+
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_OCP_QP_OCP_QP_PRIC_H_
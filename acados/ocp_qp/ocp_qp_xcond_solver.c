@@ -335,6 +335,7 @@ void *ocp_qp_xcond_solver_memory_assign(void *config_, ocp_qp_xcond_solver_dims
 
     xcond->memory_get(xcond, mem->xcond_memory, "xcond_qp_in", &mem->xcond_qp_in);
     xcond->memory_get(xcond, mem->xcond_memory, "xcond_qp_out", &mem->xcond_qp_out);
+    xcond->memory_get(xcond, mem->xcond_memory, "xcond_sens_qp_out", &mem->xcond_sens_qp_out);
 
     assert((char *) raw_memory + ocp_qp_xcond_solver_memory_calculate_size(config_, dims, opts_) >= c_ptr);
 
@@ -361,7 +362,12 @@ void ocp_qp_xcond_solver_memory_get(void *config_, void *mem_, const char *field
     {
         qp_solver->memory_get(qp_solver, mem->solver_memory, field, value);
     }
-    else if (!strcmp(field, "time_qp_xcond"))
+    else if (!strcmp(field, "num_hotstarts") || !strcmp(field, "num_factorizations"))
+    {
+        qp_solver->memory_get(qp_solver, mem->solver_memory, field, value);
+    }
+    else if (!strcmp(field, "time_qp_xcond") || !strcmp(field, "cond_N") ||
+             !strcmp(field, "cond_N_cost") || !strcmp(field, "num_recond_blocks"))
     {
         xcond->memory_get(xcond, mem->xcond_memory, field, value);
     }
@@ -457,19 +463,26 @@ int ocp_qp_xcond_solver(void *config_, ocp_qp_xcond_solver_dims *dims, ocp_qp_in
     cast_workspace(config_, dims, opts, memory, work);
 
     int solver_status = ACADOS_SUCCESS;
+    int trace_ev;
 
     // condensing
     acados_tic(&cond_timer);
+    trace_ev = acados_trace_begin("condensing", -1);
     xcond->condensing(qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    acados_trace_end(trace_ev);
     info->condensing_time = acados_toc(&cond_timer);
 
     // solve qp
+    trace_ev = acados_trace_begin("qp_solver", -1);
     solver_status = qp_solver->evaluate(qp_solver, memory->xcond_qp_in, memory->xcond_qp_out,
                                 opts->qp_solver_opts, memory->solver_memory, work->qp_solver_work);
+    acados_trace_end(trace_ev);
 
     // expansion
     acados_tic(&cond_timer);
+    trace_ev = acados_trace_begin("expansion", -1);
     xcond->expansion(memory->xcond_qp_out, qp_out, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    acados_trace_end(trace_ev);
     info->condensing_time += acados_toc(&cond_timer);
 
     // output qp info
@@ -513,11 +526,12 @@ void ocp_qp_xcond_solver_eval_sens(void *config_, ocp_qp_xcond_solver_dims *dims
 //    info->condensing_time = acados_toc(&cond_timer);
 
     // qp evaluate sensitivity
-    qp_solver->eval_sens(qp_solver, memory->xcond_qp_in, memory->xcond_qp_out, opts->qp_solver_opts, memory->solver_memory, work->qp_solver_work);
+    // NOTE: into xcond_sens_qp_out, xcond_qp_out keeps the last solution for warm starts
+    qp_solver->eval_sens(qp_solver, memory->xcond_qp_in, memory->xcond_sens_qp_out, opts->qp_solver_opts, memory->solver_memory, work->qp_solver_work);
 
     // expansion
 //    acados_tic(&cond_timer);
-    xcond->expansion(memory->xcond_qp_out, sens_qp_out, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    xcond->expansion(memory->xcond_sens_qp_out, sens_qp_out, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
 //    info->condensing_time += acados_toc(&cond_timer);
 
     // output qp info
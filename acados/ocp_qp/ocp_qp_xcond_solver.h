@@ -67,6 +67,7 @@ typedef struct ocp_qp_xcond_solver_memory_
     void *solver_memory;
     void *xcond_qp_in;
     void *xcond_qp_out;
+    void *xcond_sens_qp_out;
 } ocp_qp_xcond_solver_memory;
 
 
@@ -444,6 +444,21 @@ void sim_opts_set_(sim_opts *opts, const char *field, void *value)
         bool *jac_reuse = (bool *) value;
         opts->jac_reuse = *jac_reuse;
     }
+    else if (!strcmp(field, "jac_reuse_lazy"))
+    {
+        bool *jac_reuse_lazy = (bool *) value;
+        opts->jac_reuse_lazy = *jac_reuse_lazy;
+    }
+    else if (!strcmp(field, "jac_reuse_theta_max"))
+    {
+        double *jac_reuse_theta_max = (double *) value;
+        opts->jac_reuse_theta_max = *jac_reuse_theta_max;
+    }
+    else if (!strcmp(field, "sens_forw_tasks"))
+    {
+        int *sens_forw_tasks = (int *) value;
+        opts->sens_forw_tasks = *sens_forw_tasks;
+    }
     else if (!strcmp(field, "sens_forw"))
     {
         bool *sens_forw = (bool *) value;
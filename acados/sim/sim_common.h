@@ -147,6 +147,13 @@ typedef struct
     // && jac_reuse=false
     int newton_iter;
     bool jac_reuse;
+    // IRK only: keep the factorization of the Newton matrix across integrator calls
+    // and refactorize only if the Newton contraction rate exceeds jac_reuse_theta_max
+    bool jac_reuse_lazy;
+    double jac_reuse_theta_max;
+    // IRK only: number of tasks the nx+nu forward sensitivity columns of an integration step
+    // are split into, picked up by idle threads of the enclosing OpenMP team (1: no split)
+    int sens_forw_tasks;
     // Newton_scheme *scheme;
 
     // workspace
@@ -160,6 +167,9 @@ typedef struct
 {
     int (*evaluate)(void *config_, sim_in *in, sim_out *out, void *opts, void *mem, void *work);
     int (*precompute)(void *config_, sim_in *in, sim_out *out, void *opts, void *mem, void *work);
+    // optional, NULL if not supported: evaluate n_batch independent problems at once
+    int (*evaluate_batch)(void *config_, sim_in **in, sim_out **out, void **opts, void **mem,
+                          void **work, int n_batch);
     // opts
     acados_size_t (*opts_calculate_size)(void *config_, void *dims);
     void *(*opts_assign)(void *config_, void *dims, void *raw_memory);
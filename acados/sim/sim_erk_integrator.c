@@ -228,6 +228,9 @@ void *sim_erk_opts_assign(void *config_, void *dims, void *raw_memory)
     opts->newton_iter = 0;
     // opts->scheme = NULL;
     opts->jac_reuse = false;
+    opts->jac_reuse_lazy = false;
+    opts->jac_reuse_theta_max = 0.5;
+    opts->sens_forw_tasks = 1;
 
     return (void *) opts;
 }
@@ -1025,6 +1028,206 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 }
 
 
+int sim_erk_interleaved(void *config_, sim_in **in, sim_out **out, void **opts_, void **mem_,
+                        void **work_, int n_batch)
+{
+    sim_config *config = config_;
+    sim_opts *opts = opts_[0];
+    sim_erk_dims *dims = (sim_erk_dims *) in[0]->dims;
+
+    int status = ACADOS_SUCCESS;
+
+    // process larger batches in chunks
+    if (n_batch > SIM_ERK_INTERLEAVED_MAX)
+    {
+        for (int b0 = 0; b0 < n_batch; b0 += SIM_ERK_INTERLEAVED_MAX)
+        {
+            int nb = n_batch - b0 < SIM_ERK_INTERLEAVED_MAX ?
+                     n_batch - b0 : SIM_ERK_INTERLEAVED_MAX;
+            int tmp_status = sim_erk_interleaved(config_, in + b0, out + b0, opts_ + b0, mem_ + b0,
+                                                 work_ + b0, nb);
+            if (tmp_status != ACADOS_SUCCESS)
+                status = tmp_status;
+        }
+        return status;
+    }
+
+    // the lockstep sweep covers simulation and forward sensitivities of problems with
+    // identical dimensions and integrator settings; everything else goes one by one
+    bool lockstep = opts->sens_forw && !opts->sens_adj && !opts->sens_hess
+                    && opts->ns == opts->tableau_size && dims->nz == 0;
+    for (int b = 1; b < n_batch; b++)
+    {
+        sim_opts *opts_b = opts_[b];
+        sim_erk_dims *dims_b = (sim_erk_dims *) in[b]->dims;
+        if (opts_b->ns != opts->ns || opts_b->num_steps != opts->num_steps
+            || opts_b->num_forw_sens != opts->num_forw_sens || opts_b->sens_forw != opts->sens_forw
+            || opts_b->sens_adj != opts->sens_adj || opts_b->sens_hess != opts->sens_hess
+            || memcmp(opts_b->A_mat, opts->A_mat, opts->ns * opts->ns * sizeof(double))
+            || memcmp(opts_b->b_vec, opts->b_vec, opts->ns * sizeof(double))
+            || dims_b->nx != dims->nx || dims_b->nu != dims->nu || dims_b->nz != dims->nz)
+        {
+            lockstep = false;
+        }
+    }
+
+    if (!lockstep)
+    {
+        for (int b = 0; b < n_batch; b++)
+        {
+            int tmp_status = sim_erk(config_, in[b], out[b], opts_[b], mem_[b], work_[b]);
+            if (tmp_status != ACADOS_SUCCESS)
+                status = tmp_status;
+        }
+        return status;
+    }
+
+    int ns = opts->ns;
+    int nx = dims->nx;
+    int nu = dims->nu;
+    int nf = opts->num_forw_sens;
+    int nX = nx + nx * nf;
+    int num_steps = opts->num_steps;
+
+    double *A_mat = opts->A_mat;
+    double *b_vec = opts->b_vec;
+
+    sim_erk_workspace *work[SIM_ERK_INTERLEAVED_MAX];
+    double step[SIM_ERK_INTERLEAVED_MAX];
+
+    ext_fun_arg_t ext_fun_type_in[4];
+    void *ext_fun_in[SIM_ERK_INTERLEAVED_MAX][4];
+    ext_fun_arg_t ext_fun_type_out[3];
+    void *ext_fun_out[SIM_ERK_INTERLEAVED_MAX][3];
+
+    // forward VDEs of the batch, evaluated together
+    external_function_generic *vde_for[SIM_ERK_INTERLEAVED_MAX];
+    void **vde_for_in[SIM_ERK_INTERLEAVED_MAX];
+    void **vde_for_out[SIM_ERK_INTERLEAVED_MAX];
+
+    for (int j = 0; j < 4; j++)
+        ext_fun_type_in[j] = COLMAJ;
+    for (int j = 0; j < 3; j++)
+        ext_fun_type_out[j] = COLMAJ;
+
+    acados_timer timer, timer_ad;
+    double timing_ad = 0.0;
+
+    // start timer
+    acados_tic(&timer);
+
+    // initialize integrator variables
+    for (int b = 0; b < n_batch; b++)
+    {
+        work[b] = sim_erk_cast_workspace(config, in[b]->dims, opts_[b], work_[b]);
+        step[b] = in[b]->T / num_steps;
+
+        double *forw_traj = work[b]->out_forw_traj;
+        double *rhs_forw_in = work[b]->rhs_forw_in;
+        for (int i = 0; i < nx; i++)
+            forw_traj[i] = in[b]->x[i];
+        for (int i = 0; i < nx * nf; i++)
+            forw_traj[nx + i] = in[b]->S_forw[i];
+        for (int i = 0; i < nu; i++)
+            rhs_forw_in[nX + i] = in[b]->u[i];
+
+        vde_for[b] = ((erk_model *) in[b]->model)->expl_vde_for;
+        vde_for_in[b] = ext_fun_in[b];
+        vde_for_out[b] = ext_fun_out[b];
+    }
+
+    /************************************************
+     * forward sweep, all problems in lockstep
+     ************************************************/
+
+    for (int istep = 0; istep < num_steps; istep++)
+    {
+        for (int s = 0; s < ns; s++)
+        {
+            // stage values
+            for (int b = 0; b < n_batch; b++)
+            {
+                double *forw_traj = work[b]->out_forw_traj;
+                double *rhs_forw_in = work[b]->rhs_forw_in;
+                double *K_traj = work[b]->K_traj;
+
+                for (int i = 0; i < nX; i++)
+                    rhs_forw_in[i] = forw_traj[i];
+                for (int j = 0; j < s; j++)
+                {
+                    double a = A_mat[j * ns + s];
+                    if (a != 0)
+                    {
+                        a *= step[b];
+                        for (int i = 0; i < nX; i++)
+                            rhs_forw_in[i] += a * K_traj[j * nX + i];
+                    }
+                }
+            }
+
+            // forward VDE evaluations, batched if supported by the external functions
+            acados_tic(&timer_ad);
+            for (int b = 0; b < n_batch; b++)
+            {
+                double *rhs_forw_in = work[b]->rhs_forw_in;
+                double *K_traj = work[b]->K_traj;
+
+                ext_fun_in[b][0] = rhs_forw_in + 0;  // x: nx
+                ext_fun_in[b][1] = rhs_forw_in + nx;  // Sx: nx*nx
+                ext_fun_in[b][2] = rhs_forw_in + nx + nx * nx;  // Su: nx*nu
+                ext_fun_in[b][3] = rhs_forw_in + nx + nx * nx + nx * nu;  // u: nu
+
+                ext_fun_out[b][0] = K_traj + s * nX + 0;  // fun: nx
+                ext_fun_out[b][1] = K_traj + s * nX + nx;  // Sx: nx*nx
+                ext_fun_out[b][2] = K_traj + s * nX + nx + nx * nx;  // Su: nx*nu
+            }
+            external_function_evaluate_batch(vde_for, n_batch, ext_fun_type_in, vde_for_in,
+                                             ext_fun_type_out, vde_for_out);
+            timing_ad += acados_toc(&timer_ad);
+        }
+
+        // ERK step
+        for (int b = 0; b < n_batch; b++)
+        {
+            double *forw_traj = work[b]->out_forw_traj;
+            double *K_traj = work[b]->K_traj;
+            for (int s = 0; s < ns; s++)
+            {
+                double bs = step[b] * b_vec[s];
+                for (int i = 0; i < nX; i++)
+                    forw_traj[i] += bs * K_traj[s * nX + i];
+            }
+        }
+    }
+
+    // store trajectory, forward sensitivities and timings
+    double time_tot = acados_toc(&timer);
+
+    for (int b = 0; b < n_batch; b++)
+    {
+        double *forw_traj = work[b]->out_forw_traj;
+        sim_erk_memory *mem = mem_[b];
+
+        for (int i = 0; i < nx; i++)
+            out[b]->xn[i] = forw_traj[i];
+        for (int i = 0; i < nx * nf; i++)
+            out[b]->S_forw[i] = forw_traj[nx + i];
+
+        // NOTE: timings are shared evenly among the problems of the batch
+        out[b]->info->CPUtime = time_tot / n_batch;
+        out[b]->info->LAtime = 0.0;
+        out[b]->info->ADtime = timing_ad / n_batch;
+
+        mem->time_sim = out[b]->info->CPUtime;
+        mem->time_ad = out[b]->info->ADtime;
+        mem->time_la = out[b]->info->LAtime;
+    }
+
+    return status;
+}
+
+
+
 void sim_erk_config_initialize_default(void *config_)
 {
     sim_config *config = config_;
@@ -1053,3 +1256,16 @@ void sim_erk_config_initialize_default(void *config_)
     config->dims_get = &sim_erk_dims_get;
     return;
 }
+
+
+
+void sim_erk_interleaved_config_initialize_default(void *config_)
+{
+    sim_config *config = config_;
+
+    sim_erk_config_initialize_default(config_);
+
+    config->evaluate_batch = &sim_erk_interleaved;
+    config->config_initialize_default = &sim_erk_interleaved_config_initialize_default;
+    return;
+}
@@ -136,6 +136,15 @@ int sim_erk(void *config, sim_in *in, sim_out *out, void *opts_, void *mem_, voi
 //
 void sim_erk_config_initialize_default(void *config);
 
+// interleaved ERK: integrates up to SIM_ERK_INTERLEAVED_MAX problems in lockstep, stage by stage,
+// each problem keeps its own contiguous buffers; larger batches are processed in chunks
+#define SIM_ERK_INTERLEAVED_MAX 8
+//
+int sim_erk_interleaved(void *config, sim_in **in, sim_out **out, void **opts_, void **mem_,
+                        void **work_, int n_batch);
+//
+void sim_erk_interleaved_config_initialize_default(void *config);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -310,6 +310,9 @@ void sim_gnsf_opts_initialize_default(void *config_, void *dims_, void *opts_)
     opts->sens_adj = false;
     opts->sens_hess = false;
     opts->jac_reuse = true;
+    opts->jac_reuse_lazy = false;
+    opts->jac_reuse_theta_max = 0.5;
+    opts->sens_forw_tasks = 1;
     opts->exact_z_output = false;
     opts->ns = 3;
     opts->collocation_type = GAUSS_LEGENDRE;
@@ -268,6 +268,9 @@ void sim_irk_opts_initialize_default(void *config_, void *dims_, void *opts_)
     opts->sens_adj = false;
     opts->sens_hess = false;
     opts->jac_reuse = true;
+    opts->jac_reuse_lazy = false;
+    opts->jac_reuse_theta_max = 0.5;
+    opts->sens_forw_tasks = 1;
     opts->exact_z_output = false;
     opts->ns = 3;
     opts->collocation_type = GAUSS_LEGENDRE;
@@ -350,17 +353,21 @@ acados_size_t sim_irk_memory_calculate_size(void *config, void *dims_, void *opt
 {
     // typecast
     sim_irk_dims *dims = (sim_irk_dims *) dims_;
-    // sim_opts *opts = opts_;
+    sim_opts *opts = opts_;
 
     // necessary integers
     int nx = dims->nx;
     int nz = dims->nz;
+    int nK = (nx + nz) * opts->ns;
 
     acados_size_t size = sizeof(sim_irk_memory);
 
     size += nx * sizeof(double); // xdot
     size += nz * sizeof(double); // z
+    size += nK * sizeof(int); // ipiv_lu
+    size += blasfeo_memsize_dmat(nK, nK); // dG_dK_lu
     size += 8;  // corresponds to memory alignment
+    size += 64;  // blasfeo_mem align
 
     return size;
 }
@@ -372,11 +379,12 @@ void *sim_irk_memory_assign(void *config, void *dims_, void *opts_, void *raw_me
 
     // typecast
     sim_irk_dims *dims = (sim_irk_dims *) dims_;
-    // sim_opts *opts = opts_;
+    sim_opts *opts = opts_;
 
     // necessary integers
     int nx = dims->nx;
     int nz = dims->nz;
+    int nK = (nx + nz) * opts->ns;
 
     // struct
     sim_irk_memory *mem = (sim_irk_memory *) c_ptr;
@@ -388,12 +396,24 @@ void *sim_irk_memory_assign(void *config, void *dims_, void *opts_, void *raw_me
     assign_and_advance_double(nz, &mem->z, &c_ptr);
     assign_and_advance_double(nx, &mem->xdot, &c_ptr);
 
+    // blasfeo_mem align
+    align_char_to(64, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(nK, nK, &mem->dG_dK_lu, &c_ptr);
+
+    // assign ints
+    assign_and_advance_int(nK, &mem->ipiv_lu, &c_ptr);
+
+    mem->lu_valid = false;
+    mem->num_factorizations = 0;
+
     // initialization of xdot, z is 0 if not changed
     for (int ii = 0; ii < nx; ii++)
         mem->xdot[ii] = 0.0;
     for (int ii = 0; ii < nz; ii++)
         mem->z[ii] = 0.0;
 
+    assert((char *) raw_memory + sim_irk_memory_calculate_size(config, dims, opts) >= c_ptr);
+
     return mem;
 }
 
@@ -460,6 +480,15 @@ int sim_irk_memory_set_to_zero(void *config_, void * dims_, void *opts_, void *m
         for (int ii=0; ii < nx; ii++)
             mem->xdot[ii] = 0.0;
     }
+    else if (!strcmp(field, "num_factorizations"))
+    {
+        mem->num_factorizations = 0;
+    }
+    else if (!strcmp(field, "jac_lu"))
+    {
+        // force a new factorization of dG_dK in the next call
+        mem->lu_valid = false;
+    }
     else
     {
         printf("sim_irk_memory_set: field %s is not supported! \n", field);
@@ -490,6 +519,11 @@ void sim_irk_memory_get(void *config_, void *dims_, void *mem_, const char *fiel
 		double *ptr = value;
 		*ptr = mem->time_la;
 	}
+    else if (!strcmp(field, "num_factorizations"))
+    {
+        int *ptr = value;
+        *ptr = mem->num_factorizations;
+    }
 	else
 	{
 		printf("sim_irk_memory_get field %s is not supported! \n", field);
@@ -734,6 +768,47 @@ int sim_irk_precompute(void *config_, sim_in *in, sim_out *out, void *opts_, voi
  * integrator
  ************************************************/
 
+// forward sensitivities of one integration step, columns c0 to c1-1 of dK_dxu_ss and S_forw_ss:
+// the columns are independent, given the factorization of dG_dK_ss
+static void sim_irk_forw_sens_cols(int nx, int nu, int nK, int ns, double step, double *b_vec,
+        bool identity_seed, struct blasfeo_dmat *dG_dxu_ss, struct blasfeo_dmat *dG_dK_ss,
+        int *ipiv_ss, struct blasfeo_dmat *dK_dxu_ss, struct blasfeo_dmat *S_forw_ss,
+        int c0, int c1)
+{
+    int nc = c1 - c0;
+    int cu = c0 > nx ? c0 : nx;  // first column of the u part
+
+    // set up right hand side
+    if (identity_seed)  // omit matrix multiplication for identity seed
+        blasfeo_dgecp(nK, nc, dG_dxu_ss, 0, c0, dK_dxu_ss, 0, c0);
+    else
+    {
+        // dK_dw = 0 * dK_dw + 1 * dG_dx * S_forw_old
+        blasfeo_dgemm_nn(nK, nc, nx, 1.0, dG_dxu_ss, 0, 0, S_forw_ss, 0, c0,
+                         0.0, dK_dxu_ss, 0, c0, dK_dxu_ss, 0, c0);
+        // dK_du = dK_du + 1 * dG_du
+        if (c1 > cu)
+            blasfeo_dgead(nK, c1 - cu, 1.0, dG_dxu_ss, 0, cu, dK_dxu_ss, 0, cu);
+    }
+
+    // solve linear system, row permutation restricted to the columns
+    for (int ii = 0; ii < nK; ii++)
+    {
+        if (ipiv_ss[ii] != ii)
+            blasfeo_drowsw(nc, dK_dxu_ss, ii, c0, dK_dxu_ss, ipiv_ss[ii], c0);
+    }
+    blasfeo_dtrsm_llnu(nK, nc, 1.0, dG_dK_ss, 0, 0, dK_dxu_ss, 0, c0, dK_dxu_ss, 0, c0);
+    blasfeo_dtrsm_lunn(nK, nc, 1.0, dG_dK_ss, 0, 0, dK_dxu_ss, 0, c0, dK_dxu_ss, 0, c0);
+
+    // update forward sensitivity
+    // NOTE(oj): dK_dxu_ss is actually -dK_dxu_ss, because alpha = -1.0
+    // was not supported by blasfeos backsolve initially.
+    for (int jj = 0; jj < ns; jj++)
+        blasfeo_dgead(nx, nc, -step * b_vec[jj], dK_dxu_ss, jj * nx, c0, S_forw_ss, 0, c0);
+}
+
+
+
 int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, void *work_)
 {
 	// Get variables from workspace, etc; -- 
@@ -821,6 +896,14 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     struct blasfeo_dmat *S_forw_ss = S_forw;
     int *ipiv_ss;
 
+    // newton matrix & pivots used in the forward sweep
+    bool lazy_jac = opts->jac_reuse_lazy;
+    bool new_jac;
+    struct blasfeo_dmat *jac_ss;
+    int *ipiv_jac;
+    double norm_step;
+    double norm_step_prev = 0.0;
+
 
 	// SET FUNCTION IN- & OUTPUT TYPES
     // INPUT: impl_ode
@@ -958,7 +1041,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             blasfeo_dgecp(nx, nx + nu, &S_forw[ss], 0, 0, S_forw_ss, 0, 0);
 
             // copy last jacobian factorization into dG_dK_ss
-            if (ss > 0 && opts->jac_reuse) {
+            if (ss > 0 && opts->jac_reuse && !lazy_jac) {
                 blasfeo_dgecp(nK, nK, &dG_dK[ss-1], 0, 0, dG_dK_ss, 0, 0);
                 for (int ii = 0; ii < nK; ii++) {
                     ipiv_ss[ii] = ipiv[nK*(ss-1) + ii];
@@ -974,15 +1057,24 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             S_forw_ss = S_forw;
         }
 
+        // with lazy jacobian reuse, the factorization lives in memory and survives the call
+        jac_ss = lazy_jac ? &mem->dG_dK_lu : dG_dK_ss;
+        ipiv_jac = lazy_jac ? mem->ipiv_lu : ipiv_ss;
+
         if ( opts->sens_adj || opts->sens_hess )  // store current xn
             blasfeo_dveccp(nx, xn, 0, &xn_traj[ss], 0);
 
         for (int iter = 0; iter < newton_iter; iter++)
         {
-            if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+            if (lazy_jac)
+                new_jac = !mem->lu_valid;
+            else
+                new_jac = (opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse);
+
+            if (new_jac)
             {
-                // if new jacobian gets computed, initialize dG_dK_ss with zeros
-                blasfeo_dgese(nK, nK, 0.0, dG_dK_ss, 0, 0);
+                // if new jacobian gets computed, initialize jac_ss with zeros
+                blasfeo_dgese(nK, nK, 0.0, jac_ss, 0, 0);
             }
 
             for (int ii = 0; ii < ns; ii++)
@@ -1003,27 +1095,27 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 impl_ode_res_out.xi = ii * (nx + nz);  // store output in this position of rG
 
                 // compute the residual of implicit ode at time t_ii
-                if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+                if (new_jac)
                 {   // evaluate the ode function & jacobian w.r.t. x, xdot;
-                    // &  compute jacobian dG_dK_ss;
+                    // &  compute jacobian jac_ss;
                     acados_tic(&timer_ad);
                     model->impl_ode_fun_jac_x_xdot_z->evaluate(
                         model->impl_ode_fun_jac_x_xdot_z, impl_ode_type_in, impl_ode_in,
                         impl_ode_fun_jac_x_xdot_z_type_out, impl_ode_fun_jac_x_xdot_z_out);
                     timing_ad += acados_toc(&timer_ad);
 
-                    // compute the blocks of dG_dK_ss
+                    // compute the blocks of jac_ss
                     for (int jj = 0; jj < ns; jj++)
-                    {  // compute the block (ii,jj)th block of dG_dK_ss
+                    {  // compute the block (ii,jj)th block of jac_ss
                         a = A_mat[ii + ns * jj] * step;
                         blasfeo_dgead(nx + nz, nx, a, df_dx, 0, 0,
-                                            dG_dK_ss, ii * (nx + nz), jj * nx);
+                                            jac_ss, ii * (nx + nz), jj * nx);
                         if (jj == ii)
                         {
                             blasfeo_dgead(nx + nz, nx, 1, df_dxdot, 0, 0,
-                                          dG_dK_ss, ii * (nx + nz), jj * nx);
+                                          jac_ss, ii * (nx + nz), jj * nx);
                             blasfeo_dgead(nx + nz, nz, 1, df_dz,    0, 0,
-                                          dG_dK_ss, ii * (nx + nz), (nx * ns) + jj * nz);
+                                          jac_ss, ii * (nx + nz), (nx * ns) + jj * nz);
                         }
                     }  // end jj
                 }
@@ -1045,26 +1137,39 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             acados_tic(&timer_la);
             // DGETRF computes an LU factorization of a general M-by-N matrix A
             // using partial pivoting with row interchanges.
-            // printf("dG_dK_ss = (IRK) \n");
-            // blasfeo_print_exp_dmat((nz+nx) *ns, (nz+nx) *ns, dG_dK_ss, 0, 0);
-            if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+            // printf("jac_ss = (IRK) \n");
+            // blasfeo_print_exp_dmat((nz+nx) *ns, (nz+nx) *ns, jac_ss, 0, 0);
+            if (new_jac)
             {
-                blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+                blasfeo_dgetrf_rp(nK, nK, jac_ss, 0, 0, jac_ss, 0, 0, ipiv_jac);
+                mem->num_factorizations++;
+                if (lazy_jac)
+                    mem->lu_valid = true;
             }
 
             // permute also the r.h.s
-            blasfeo_dvecpe(nK, ipiv_ss, rG, 0);
+            blasfeo_dvecpe(nK, ipiv_jac, rG, 0);
 
-            // solve dG_dK_ss * y = rG, dG_dK_ss on the (l)eft, (l)ower-trian, (n)o-trans
+            // solve jac_ss * y = rG, jac_ss on the (l)eft, (l)ower-trian, (n)o-trans
             // (u)nit trian
-            blasfeo_dtrsv_lnu(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
+            blasfeo_dtrsv_lnu(nK, jac_ss, 0, 0, rG, 0, rG, 0);
 
-            // solve dG_dK_ss * x = rG, dG_dK_ss on the (l)eft, (u)pper-trian, (n)o-trans
+            // solve jac_ss * x = rG, jac_ss on the (l)eft, (u)pper-trian, (n)o-trans
             // (n)o unit trian , and store x in rG
-            blasfeo_dtrsv_unn(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
+            blasfeo_dtrsv_unn(nK, jac_ss, 0, 0, rG, 0, rG, 0);
 
             timing_la += acados_toc(&timer_la);
 
+            if (lazy_jac)
+            {
+                // monitor the contraction rate of the simplified Newton iterations,
+                // refactorize at the current iterate if it degrades
+                blasfeo_dvecnrm_inf(nK, rG, 0, &norm_step);
+                if (iter > 0 && norm_step > opts->jac_reuse_theta_max * norm_step_prev)
+                    mem->lu_valid = false;
+                norm_step_prev = norm_step;
+            }
+
             // scale and add a generic strmat into a generic strmat // K = K - rG, where rG is
             // [DeltaK, DeltaZ]
             blasfeo_daxpy(nK, -1.0, rG, 0, K, 0, K, 0);
@@ -1123,38 +1228,44 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             // factorize dG_dK_ss
             acados_tic(&timer_la);
             blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+            mem->num_factorizations++;
+            if (lazy_jac)
+            {
+                // exact jacobian at the solution of this step: keep it for the next Newton solves
+                blasfeo_dgecp(nK, nK, dG_dK_ss, 0, 0, &mem->dG_dK_lu, 0, 0);
+                for (int ii = 0; ii < nK; ii++)
+                    mem->ipiv_lu[ii] = ipiv_ss[ii];
+                mem->lu_valid = true;
+            }
             timing_la += acados_toc(&timer_la);
 
-            // obtain dK_dxu
-            // set up right hand side
-            if (in->identity_seed && ss == 0) // omit matrix multiplication for identity seed
-                blasfeo_dgecp(nK, nx + nu, dG_dxu_ss, 0, 0, dK_dxu_ss, 0, 0);
+            // obtain dK_dxu and update the forward sensitivities
+            acados_tic(&timer_la);
+            bool identity_seed = in->identity_seed && ss == 0;
+            int nxu = nx + nu;
+            if (opts->sens_forw_tasks > 1)
+            {
+                // split the columns into tasks, whole panels of 4 columns each;
+                // the steps are sequential, the columns of one step are not
+                int ncol = (nxu + opts->sens_forw_tasks - 1) / opts->sens_forw_tasks;
+                ncol = (ncol + 3) / 4 * 4;
+                int cc;
+#if defined(ACADOS_WITH_OPENMP)
+                #pragma omp taskloop grainsize(1)
+#endif
+                for (cc = 0; cc < nxu; cc += ncol)
+                {
+                    int cc1 = cc + ncol < nxu ? cc + ncol : nxu;
+                    sim_irk_forw_sens_cols(nx, nu, nK, ns, step, b_vec, identity_seed, dG_dxu_ss,
+                        dG_dK_ss, ipiv_ss, dK_dxu_ss, S_forw_ss, cc, cc1);
+                }
+            }
             else
             {
-                // dK_dw = 0 * dK_dw + 1 * dG_dx * S_forw_old
-                blasfeo_dgemm_nn(nK, nx + nu, nx, 1.0, dG_dxu_ss, 0, 0, S_forw_ss, 0,
-                                    0, 0.0, dK_dxu_ss, 0, 0, dK_dxu_ss, 0, 0);
-                // printf("dG_dxu = \n");
-                // blasfeo_print_exp_dmat(nx + nz, nx+nu, dG_dxu_ss, 0, 0);
-                // dK_du = dK_du + 1 * dG_du
-                blasfeo_dgead(nK, nu, 1.0, dG_dxu_ss, 0, nx, dK_dxu_ss, 0, nx);
+                sim_irk_forw_sens_cols(nx, nu, nK, ns, step, b_vec, identity_seed, dG_dxu_ss,
+                    dG_dK_ss, ipiv_ss, dK_dxu_ss, S_forw_ss, 0, nxu);
             }
-            // solve linear system
-            acados_tic(&timer_la);
-            blasfeo_drowpe(nK, ipiv_ss, dK_dxu_ss);
-            blasfeo_dtrsm_llnu(nK, nx + nu, 1.0, dG_dK_ss, 0, 0, dK_dxu_ss, 0, 0, dK_dxu_ss, 0, 0);
-            blasfeo_dtrsm_lunn(nK, nx + nu, 1.0, dG_dK_ss, 0, 0, dK_dxu_ss, 0, 0, dK_dxu_ss, 0, 0);
             timing_la += acados_toc(&timer_la);
-
-            // printf("dK_dxu (solved) = (IRK, ss = %d) \n", ss);
-            // blasfeo_print_exp_dmat(nK, nx + nu, dK_dxu_ss, 0, 0);
-
-            // update forward sensitivity
-            // NOTE(oj): dK_dxu_ss is actually -dK_dxu_ss, because alpha = -1.0
-            // was not supported by blasfeos backsolve initially.
-            for (int jj = 0; jj < ns; jj++)
-                blasfeo_dgead(nx, nx + nu, -step * b_vec[jj], dK_dxu_ss, jj * nx, 0,
-                                                     S_forw_ss, 0, 0);
         }  // end if sens_forw || sens_hess 
 
 
@@ -1409,6 +1520,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 // factorize dG_dK_ss - already done in forw if hessian is active
                 acados_tic(&timer_la);
                 blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+                mem->num_factorizations++;
                 timing_la += acados_toc(&timer_la);
 
             }  // end if( !opts->sens_hess )
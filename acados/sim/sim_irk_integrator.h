@@ -141,6 +141,12 @@ typedef struct
     double *xdot;  // xdot[NX] - initialization for state derivatives k within the integrator
     double *z;     // z[NZ] - initialization for algebraic variables z
 
+    // factorization of dG_dK kept across calls if (opts->jac_reuse_lazy)
+    struct blasfeo_dmat dG_dK_lu;  // LU factors of dG_dK ((nx+nz)*ns, (nx+nz)*ns)
+    int *ipiv_lu;                  // index of pivot vector ((nx+nz)*ns)
+    bool lu_valid;                 // dG_dK_lu holds a usable factorization
+    int num_factorizations;        // number of factorizations of dG_dK performed
+
 	double time_sim;
 	double time_ad;
 	double time_la;
@@ -42,6 +42,32 @@
  * generic external function
  ************************************************/
 
+void external_function_evaluate_batch(external_function_generic **fun, int K,
+                                      ext_fun_arg_t *type_in, void ***in,
+                                      ext_fun_arg_t *type_out, void ***out)
+{
+    int k0 = 0;
+    while (k0 < K)
+    {
+        // run of instances sharing the batched entry point
+        int nk = 1;
+        if (fun[k0]->evaluate_batch != NULL)
+        {
+            while (k0 + nk < K && fun[k0 + nk]->evaluate_batch == fun[k0]->evaluate_batch)
+                nk++;
+        }
+
+        if (nk > 1)
+            fun[k0]->evaluate_batch((void **) fun + k0, nk, type_in, in + k0, type_out, out + k0);
+        else
+            fun[k0]->evaluate(fun[k0], type_in, in[k0], type_out, out[k0]);
+
+        k0 += nk;
+    }
+
+    return;
+}
+
 
 
 /************************************************
@@ -79,6 +105,7 @@ acados_size_t external_function_param_generic_calculate_size(external_function_p
 {
     // wrapper as evaluate function
     fun->evaluate = &external_function_param_generic_wrapper;
+    fun->evaluate_batch = NULL;
 
     // set param function
     fun->get_nparam = &external_function_param_generic_get_nparam;
@@ -668,6 +695,458 @@ static void d_cvt_dvec_args_to_casadi(struct blasfeo_dvec_args *in, double *out,
 
 
 
+// pointer to the storage of an argument, if it is the dense column-major layout of casadi
+// and the argument can be handed to the casadi function in place; NULL otherwise
+static double *d_casadi_arg_ptr(ext_fun_arg_t type, void *arg, const int *sparsity)
+{
+    int nrow = sparsity[0];
+    int ncol = sparsity[1];
+    int dense = sparsity[2];
+
+    if (!dense | (nrow <= 0) | (ncol <= 0))
+        return NULL;
+
+    switch (type)
+    {
+        case COLMAJ:
+            return (double *) arg;
+
+        case COLMAJ_ARGS:
+        {
+            struct colmaj_args *args = arg;
+            if ((args->lda == nrow) | (ncol == 1))
+                return args->A;
+            return NULL;
+        }
+
+        case BLASFEO_DVEC:
+        {
+            struct blasfeo_dvec *x = arg;
+            return x->pa;
+        }
+
+        case BLASFEO_DVEC_ARGS:
+        {
+            struct blasfeo_dvec_args *args = arg;
+            return args->x->pa + args->xi;
+        }
+
+#if !defined(LA_HIGH_PERFORMANCE)
+        // column-major matrix storage, with leading dimension m
+        case BLASFEO_DMAT:
+        {
+            struct blasfeo_dmat *A = arg;
+            if ((A->m == nrow) | (ncol == 1))
+                return A->pA;
+            return NULL;
+        }
+
+        case BLASFEO_DMAT_ARGS:
+        {
+            struct blasfeo_dmat_args *args = arg;
+            if ((args->A->m == nrow) | (ncol == 1))
+                return &BLASFEO_DMATEL(args->A, args->ai, args->aj);
+            return NULL;
+        }
+#endif  // LA_HIGH_PERFORMANCE
+
+        default:
+            // panel-major matrices and ignored arguments are converted
+            return NULL;
+    }
+}
+
+
+
+// size of the dense column-major mirror of a sparse matrix argument, 0 if not needed
+static int casadi_mirror_size(const int *sparsity)
+{
+    int nrow = sparsity[0];
+    int ncol = sparsity[1];
+    int dense = sparsity[2];
+
+    if (dense | (nrow <= 0) | (ncol <= 1))
+        return 0;
+    return nrow * ncol;
+}
+
+
+
+// panel-major matrix of a BLASFEO_DMAT(_ARGS) argument, NULL for the other types
+static struct blasfeo_dmat *d_casadi_arg_dmat(ext_fun_arg_t type, void *arg, int *ai, int *aj)
+{
+    *ai = 0;
+    *aj = 0;
+#if defined(LA_HIGH_PERFORMANCE)
+    if (type == BLASFEO_DMAT)
+        return arg;
+    if (type == BLASFEO_DMAT_ARGS)
+    {
+        struct blasfeo_dmat_args *args = arg;
+        *ai = args->ai;
+        *aj = args->aj;
+        return args->A;
+    }
+#endif  // LA_HIGH_PERFORMANCE
+    return NULL;
+}
+
+
+
+// sparse panel-major matrix input: one unpack into the column-major mirror and a gather of the
+// nonzeros, instead of a panel-major element access per nonzero; returns 0 if not applicable
+static int d_cvt_in_to_casadi_mirror(ext_fun_arg_t type_in, void *in, double *arg,
+                                     const int *sparsity, double *mirror)
+{
+    int ai, aj;
+    struct blasfeo_dmat *A = d_casadi_arg_dmat(type_in, in, &ai, &aj);
+    if (!A | !casadi_mirror_size(sparsity))
+        return 0;
+
+    int nrow = sparsity[0];
+    int ncol = sparsity[1];
+    const int *idxcol = sparsity + 2;
+    const int *row = sparsity + ncol + 3;
+
+    blasfeo_unpack_dmat(nrow, ncol, A, ai, aj, mirror, nrow);
+    for (int jj = 0; jj < ncol; jj++)
+    {
+        for (int idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
+            arg[idx] = mirror[row[idx] + jj * nrow];
+    }
+
+    return 1;
+}
+
+
+
+// sparse panel-major matrix output: scatter of the nonzeros into the column-major mirror and
+// one pack; returns 0 if not applicable
+static int d_cvt_casadi_to_out_mirror(double *res, const int *sparsity, ext_fun_arg_t type_out,
+                                      void *out, double *mirror)
+{
+    int ai, aj;
+    struct blasfeo_dmat *A = d_casadi_arg_dmat(type_out, out, &ai, &aj);
+    if (!A | !casadi_mirror_size(sparsity))
+        return 0;
+
+    int nrow = sparsity[0];
+    int ncol = sparsity[1];
+    const int *idxcol = sparsity + 2;
+    const int *row = sparsity + ncol + 3;
+
+    for (int ii = 0; ii < nrow * ncol; ii++)
+        mirror[ii] = 0.0;
+    for (int jj = 0; jj < ncol; jj++)
+    {
+        for (int idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
+            mirror[row[idx] + jj * nrow] = res[idx];
+    }
+    blasfeo_pack_dmat(nrow, ncol, mirror, nrow, A, ai, aj);
+
+    return 1;
+}
+
+
+
+// arguments and results handed to casadi in place must not overlap, since casadi may write
+// results before it has read all arguments; exits otherwise
+static void casadi_check_in_place(double **args_ptr, double **args, int *args_size, int n_in,
+                                  double **res_ptr, double **res, int *res_size, int n_out)
+{
+    for (int ii = 0; ii < n_in; ii++)
+    {
+        if (args_ptr[ii] == args[ii])
+            continue;
+        for (int jj = 0; jj < n_out; jj++)
+        {
+            if (res_ptr[jj] == res[jj])
+                continue;
+            if ((args_ptr[ii] < res_ptr[jj] + res_size[jj]) &
+                (res_ptr[jj] < args_ptr[ii] + args_size[ii]))
+            {
+                printf("\nexternal function zero copy: input %d overlaps output %d\n\n", ii, jj);
+                exit(1);
+            }
+        }
+    }
+
+    return;
+}
+
+
+
+// converts the input in of type type_in into the casadi argument arg
+static void d_cvt_in_to_casadi(ext_fun_arg_t type_in, void *in, double *arg, int *sparsity,
+                               int ii)
+{
+    switch (type_in)
+    {
+        case COLMAJ:
+            d_cvt_colmaj_to_casadi(in, arg, sparsity);
+            break;
+
+        case BLASFEO_DMAT:
+            d_cvt_dmat_to_casadi(in, arg, sparsity);
+            break;
+
+        case BLASFEO_DVEC:
+            d_cvt_dvec_to_casadi(in, arg, sparsity);
+            break;
+
+        case COLMAJ_ARGS:
+            d_cvt_colmaj_args_to_casadi(in, arg, sparsity);
+            break;
+
+        case BLASFEO_DMAT_ARGS:
+            d_cvt_dmat_args_to_casadi(in, arg, sparsity);
+            break;
+
+        case BLASFEO_DVEC_ARGS:
+            d_cvt_dvec_args_to_casadi(in, arg, sparsity);
+            break;
+
+        case IGNORE_ARGUMENT:
+            // do nothing
+            break;
+
+        default:
+            printf("\ntype in %d\n", type_in);
+            printf("\nUnknown external function argument type for argument %i\n\n", ii);
+            exit(1);
+    }
+
+    return;
+}
+
+
+
+// converts the casadi result res into the output out of type type_out
+static void d_cvt_casadi_to_out(double *res, int *sparsity, ext_fun_arg_t type_out, void *out,
+                                int ii)
+{
+    switch (type_out)
+    {
+        case COLMAJ:
+            d_cvt_casadi_to_colmaj(res, sparsity, out);
+            break;
+
+        case BLASFEO_DMAT:
+            d_cvt_casadi_to_dmat(res, sparsity, out);
+            break;
+
+        case BLASFEO_DVEC:
+            d_cvt_casadi_to_dvec(res, sparsity, out);
+            break;
+
+        case COLMAJ_ARGS:
+            d_cvt_casadi_to_colmaj_args(res, sparsity, out);
+            break;
+
+        case BLASFEO_DMAT_ARGS:
+            d_cvt_casadi_to_dmat_args(res, sparsity, out);
+            break;
+
+        case BLASFEO_DVEC_ARGS:
+            d_cvt_casadi_to_dvec_args(res, sparsity, out);
+            break;
+
+        case IGNORE_ARGUMENT:
+            // do nothing
+            break;
+
+        default:
+            printf("\ntype out %d\n", type_out);
+            printf("\nUnknown external function argument type for output %i\n\n", ii);
+            exit(1);
+    }
+
+    return;
+}
+
+
+
+/************************************************
+ * casadi map of an external function
+ ************************************************/
+
+acados_size_t external_function_casadi_map_calculate_size(external_function_casadi_map *map,
+                                                          int batch_size, int num_scratch)
+{
+    // loop index
+    int ii;
+
+    map->batch_size = batch_size;
+    map->num_scratch = num_scratch > 1 ? num_scratch : 1;
+
+    map->casadi_work(&map->args_num, &map->res_num, &map->iw_size, &map->w_size);
+
+    map->in_num = map->casadi_n_in();
+    map->out_num = map->casadi_n_out();
+
+    // args
+    map->args_size_tot = 0;
+    for (ii = 0; ii < map->args_num; ii++)
+        map->args_size_tot += casadi_nnz(map->casadi_sparsity_in(ii));
+
+    // res
+    map->res_size_tot = 0;
+    for (ii = 0; ii < map->res_num; ii++)
+        map->res_size_tot += casadi_nnz(map->casadi_sparsity_out(ii));
+
+    acados_size_t size = 0;
+
+    size += map->num_scratch * sizeof(external_function_casadi_map_scratch);  // scratch
+
+    // double pointers
+    size += map->num_scratch * map->args_num * sizeof(double *);  // args
+    size += map->num_scratch * map->res_num * sizeof(double *);   // res
+
+    // ints
+    size += map->args_num * sizeof(int);  // args_size
+    size += map->res_num * sizeof(int);   // res_size
+    size += map->num_scratch * map->iw_size * sizeof(int);  // iw
+
+    // doubles
+    size += map->num_scratch * map->args_size_tot * sizeof(double);  // args
+    size += map->num_scratch * map->res_size_tot * sizeof(double);   // res
+    size += map->num_scratch * map->w_size * sizeof(double);         // w
+
+    size += 8;  // initial align
+    size += 8;  // align to double
+
+    return size;
+}
+
+
+
+void external_function_casadi_map_assign(external_function_casadi_map *map, void *raw_memory)
+{
+    // loop index
+    int ii, jj, ss;
+
+    // save initial pointer to external memory
+    map->ptr_ext_mem = raw_memory;
+
+    // char pointer for byte advances
+    char *c_ptr = raw_memory;
+
+    // initial align
+    align_char_to(8, &c_ptr);
+
+    // scratch
+    map->scratch = (external_function_casadi_map_scratch *) c_ptr;
+    c_ptr += map->num_scratch * sizeof(external_function_casadi_map_scratch);
+
+    for (ss = 0; ss < map->num_scratch; ss++)
+    {
+        // args
+        assign_and_advance_double_ptrs(map->args_num, &map->scratch[ss].args, &c_ptr);
+        // res
+        assign_and_advance_double_ptrs(map->res_num, &map->scratch[ss].res, &c_ptr);
+    }
+
+    // args_size
+    assign_and_advance_int(map->args_num, &map->args_size, &c_ptr);
+    for (ii = 0; ii < map->args_num; ii++)
+        map->args_size[ii] = casadi_nnz(map->casadi_sparsity_in(ii));
+    // res_size
+    assign_and_advance_int(map->res_num, &map->res_size, &c_ptr);
+    for (ii = 0; ii < map->res_num; ii++)
+        map->res_size[ii] = casadi_nnz(map->casadi_sparsity_out(ii));
+    // iw
+    for (ss = 0; ss < map->num_scratch; ss++)
+        assign_and_advance_int(map->iw_size, &map->scratch[ss].iw, &c_ptr);
+
+    // align to double
+    align_char_to(8, &c_ptr);
+
+    for (ss = 0; ss < map->num_scratch; ss++)
+    {
+        external_function_casadi_map_scratch *scratch = map->scratch + ss;
+        // args
+        for (ii = 0; ii < map->args_num; ii++)
+            assign_and_advance_double(map->args_size[ii], &scratch->args[ii], &c_ptr);
+        // res
+        for (ii = 0; ii < map->res_num; ii++)
+            assign_and_advance_double(map->res_size[ii], &scratch->res[ii], &c_ptr);
+        // w
+        assign_and_advance_double(map->w_size, &scratch->w, &c_ptr);
+
+        // arguments of the instances left unused by a partially filled batch
+        for (ii = 0; ii < map->args_num; ii++)
+            for (jj = 0; jj < map->args_size[ii]; jj++)
+                scratch->args[ii][jj] = 0.0;
+
+        scratch->busy = 0;
+    }
+
+    assert((char *) raw_memory + external_function_casadi_map_calculate_size(map,
+           map->batch_size, map->num_scratch) >= c_ptr);
+
+    return;
+}
+
+
+
+// claim a free scratch memory of the map, NULL if all are in use by concurrent evaluations
+static external_function_casadi_map_scratch *casadi_map_scratch_claim(
+    external_function_casadi_map *map)
+{
+    for (int ss = 0; ss < map->num_scratch; ss++)
+    {
+        int busy;
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp atomic capture
+#endif
+        {
+            busy = map->scratch[ss].busy;
+            map->scratch[ss].busy = 1;
+        }
+        if (!busy)
+            return map->scratch + ss;
+    }
+
+    return NULL;
+}
+
+
+
+static void casadi_map_scratch_release(external_function_casadi_map_scratch *scratch)
+{
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp atomic write
+#endif
+    scratch->busy = 0;
+
+    return;
+}
+
+
+
+// the map has to evaluate batch_size instances of the function with the given in/out sizes
+static void casadi_map_check(external_function_casadi_map *map, int in_num, int out_num,
+                             int *args_size, int *res_size)
+{
+    int ii;
+
+    int ok = map->in_num == in_num && map->out_num == out_num;
+    for (ii = 0; ok && ii < in_num; ii++)
+        ok = map->args_size[ii] == map->batch_size * args_size[ii];
+    for (ii = 0; ok && ii < out_num; ii++)
+        ok = map->res_size[ii] == map->batch_size * res_size[ii];
+
+    if (!ok)
+    {
+        printf("\nexternal function casadi: map does not match the function to be batched\n\n");
+        exit(1);
+    }
+
+    return;
+}
+
+
+
 /************************************************
  * casadi external function
  ************************************************/
@@ -727,10 +1206,37 @@ void external_function_casadi_set_n_out(external_function_casadi *fun, void *val
 
 
 
+void external_function_casadi_set_zero_copy(external_function_casadi *fun, int value)
+{
+    fun->zero_copy = value;
+    return;
+}
+
+
+
+void external_function_casadi_set_map(external_function_casadi *fun,
+                                      external_function_casadi_map *map)
+{
+    if (map != NULL)
+        casadi_map_check(map, fun->in_num, fun->out_num, fun->args_size, fun->res_size);
+
+    fun->map = map;
+    fun->evaluate_batch = map != NULL ? &external_function_casadi_wrapper_batch : NULL;
+    return;
+}
+
+
+
 acados_size_t external_function_casadi_calculate_size(external_function_casadi *fun)
 {
     // casadi wrapper as evaluate
     fun->evaluate = &external_function_casadi_wrapper;
+    // batched evaluation only with a map, see set_map
+    fun->evaluate_batch = NULL;
+    fun->map = NULL;
+
+    // convert the arguments by default
+    fun->zero_copy = 0;
 
     // loop index
     int ii;
@@ -750,11 +1256,26 @@ acados_size_t external_function_casadi_calculate_size(external_function_casadi *
     for (ii = 0; ii < fun->res_num; ii++)
         fun->res_size_tot += casadi_nnz(fun->casadi_sparsity_out(ii));
 
+    // mirror, shared by all sparse matrix arguments
+    fun->mirror_size = 0;
+    for (ii = 0; ii < fun->in_num; ii++)
+    {
+        int tmp = casadi_mirror_size(fun->casadi_sparsity_in(ii));
+        fun->mirror_size = tmp > fun->mirror_size ? tmp : fun->mirror_size;
+    }
+    for (ii = 0; ii < fun->out_num; ii++)
+    {
+        int tmp = casadi_mirror_size(fun->casadi_sparsity_out(ii));
+        fun->mirror_size = tmp > fun->mirror_size ? tmp : fun->mirror_size;
+    }
+
     acados_size_t size = 0;
 
     // double pointers
     size += fun->args_num * sizeof(double *);  // args
     size += fun->res_num * sizeof(double *);   // res
+    size += fun->args_num * sizeof(double *);  // args_ptr
+    size += fun->res_num * sizeof(double *);   // res_ptr
 
     // ints
     size += fun->args_num * sizeof(int);  // args_size
@@ -765,6 +1286,7 @@ acados_size_t external_function_casadi_calculate_size(external_function_casadi *
     size += fun->args_size_tot * sizeof(double);  // args
     size += fun->res_size_tot * sizeof(double);   // res
     size += fun->w_size * sizeof(double);         // w
+    size += fun->mirror_size * sizeof(double);    // mirror
 
     size += 8;  // initial align
     size += 8;  // align to double
@@ -796,6 +1318,10 @@ void external_function_casadi_assign(external_function_casadi *fun, void *raw_me
     assign_and_advance_double_ptrs(fun->args_num, &fun->args, &c_ptr);
     // res
     assign_and_advance_double_ptrs(fun->res_num, &fun->res, &c_ptr);
+    // args_ptr
+    assign_and_advance_double_ptrs(fun->args_num, &fun->args_ptr, &c_ptr);
+    // res_ptr
+    assign_and_advance_double_ptrs(fun->res_num, &fun->res_ptr, &c_ptr);
 
     // args_size
     assign_and_advance_int(fun->args_num, &fun->args_size, &c_ptr);
@@ -819,6 +1345,14 @@ void external_function_casadi_assign(external_function_casadi *fun, void *raw_me
         assign_and_advance_double(fun->res_size[ii], &fun->res[ii], &c_ptr);
     // w
     assign_and_advance_double(fun->w_size, &fun->w, &c_ptr);
+    // mirror
+    assign_and_advance_double(fun->mirror_size, &fun->mirror, &c_ptr);
+
+    // pass the own argument and result arrays by default
+    for (ii = 0; ii < fun->args_num; ii++)
+        fun->args_ptr[ii] = fun->args[ii];
+    for (ii = 0; ii < fun->res_num; ii++)
+        fun->res_ptr[ii] = fun->res[ii];
 
     assert((char *) raw_memory + external_function_casadi_calculate_size(fun) >= c_ptr);
 
@@ -839,95 +1373,123 @@ void external_function_casadi_wrapper(void *self, ext_fun_arg_t *type_in, void *
     // in as args
     for (ii = 0; ii < fun->in_num; ii++)
     {
-        switch (type_in[ii])
+        if (fun->zero_copy)
         {
-            case COLMAJ:
-                d_cvt_colmaj_to_casadi(in[ii], (double *) fun->args[ii],
-                                       (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case BLASFEO_DMAT:
-                d_cvt_dmat_to_casadi(in[ii], (double *) fun->args[ii],
-                                     (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case BLASFEO_DVEC:
-                d_cvt_dvec_to_casadi(in[ii], (double *) fun->args[ii],
-                                     (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case COLMAJ_ARGS:
-                d_cvt_colmaj_args_to_casadi(in[ii], (double *) fun->args[ii],
-                                            (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case BLASFEO_DMAT_ARGS:
-                d_cvt_dmat_args_to_casadi(in[ii], (double *) fun->args[ii],
-                                          (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case BLASFEO_DVEC_ARGS:
-                d_cvt_dvec_args_to_casadi(in[ii], (double *) fun->args[ii],
-                                          (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case IGNORE_ARGUMENT:
-                // do nothing
-                break;
-
-            default:
-                printf("\ntype in %d\n", type_in[ii]);
-                printf("\nUnknown external function argument type for argument %i\n\n", ii);
-                exit(1);
+            fun->args_ptr[ii] = d_casadi_arg_ptr(type_in[ii], in[ii],
+                                                 fun->casadi_sparsity_in(ii));
+            if (fun->args_ptr[ii])
+                continue;
         }
+        fun->args_ptr[ii] = fun->args[ii];
+
+        if (fun->zero_copy && d_cvt_in_to_casadi_mirror(type_in[ii], in[ii], fun->args[ii],
+                                            fun->casadi_sparsity_in(ii), fun->mirror))
+            continue;
+
+        d_cvt_in_to_casadi(type_in[ii], in[ii], fun->args[ii],
+                           (int *) fun->casadi_sparsity_in(ii), ii);
     }
 
+    // out as res, written in place if possible
+    for (ii = 0; ii < fun->out_num; ii++)
+    {
+        fun->res_ptr[ii] = NULL;
+        if (fun->zero_copy)
+            fun->res_ptr[ii] = d_casadi_arg_ptr(type_out[ii], out[ii],
+                                                fun->casadi_sparsity_out(ii));
+        if (!fun->res_ptr[ii])
+            fun->res_ptr[ii] = fun->res[ii];
+    }
+
+    if (fun->zero_copy)
+        casadi_check_in_place(fun->args_ptr, fun->args, fun->args_size, fun->in_num, fun->res_ptr,
+                              fun->res, fun->res_size, fun->out_num);
+
     // call casadi function
-    fun->casadi_fun((const double **) fun->args, fun->res, fun->iw, fun->w, NULL);
+    fun->casadi_fun((const double **) fun->args_ptr, fun->res_ptr, fun->iw, fun->w, NULL);
 
     for (ii = 0; ii < fun->out_num; ii++)
     {
-        switch (type_out[ii])
+        // already written in place
+        if (fun->res_ptr[ii] != fun->res[ii])
+            continue;
+
+        if (fun->zero_copy && d_cvt_casadi_to_out_mirror(fun->res[ii],
+                    fun->casadi_sparsity_out(ii), type_out[ii], out[ii], fun->mirror))
+            continue;
+
+        d_cvt_casadi_to_out(fun->res[ii], (int *) fun->casadi_sparsity_out(ii), type_out[ii],
+                            out[ii], ii);
+    }
+
+    return;
+}
+
+
+
+void external_function_casadi_wrapper_batch(void **self, int K, ext_fun_arg_t *type_in,
+                                            void ***in, ext_fun_arg_t *type_out, void ***out)
+{
+    // loop index
+    int ii, kk;
+
+    int k0 = 0;
+    while (k0 < K)
+    {
+        // cast into external casadi function
+        external_function_casadi *fun = self[k0];
+        external_function_casadi_map *map = fun->map;
+
+        // consecutive instances sharing the map, up to its batch size
+        int nk = 1;
+        while (k0 + nk < K && nk < map->batch_size
+               && ((external_function_casadi *) self[k0 + nk])->map == map)
+            nk++;
+
+        // scratch memory of this batch, NULL if all are in use or nk == 1
+        external_function_casadi_map_scratch *scratch = NULL;
+        if (nk > 1)
+            scratch = casadi_map_scratch_claim(map);
+
+        if (scratch == NULL)
         {
-            case COLMAJ:
-                d_cvt_casadi_to_colmaj((double *) fun->res[ii],
-                                       (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
-
-            case BLASFEO_DMAT:
-                d_cvt_casadi_to_dmat((double *) fun->res[ii], (int *) fun->casadi_sparsity_out(ii),
-                                     out[ii]);
-                break;
-
-            case BLASFEO_DVEC:
-                d_cvt_casadi_to_dvec((double *) fun->res[ii], (int *) fun->casadi_sparsity_out(ii),
-                                     out[ii]);
-                break;
-
-            case COLMAJ_ARGS:
-                d_cvt_casadi_to_colmaj_args((double *) fun->res[ii],
-                                            (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
-
-            case BLASFEO_DMAT_ARGS:
-                d_cvt_casadi_to_dmat_args((double *) fun->res[ii],
-                                          (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
-
-            case BLASFEO_DVEC_ARGS:
-                d_cvt_casadi_to_dvec_args((double *) fun->res[ii],
-                                          (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
-
-            case IGNORE_ARGUMENT:
-                // do nothing
-                break;
-
-            default:
-                printf("\ntype out %d\n", type_out[ii]);
-                printf("\nUnknown external function argument type for output %i\n\n", ii);
-                exit(1);
+            // instance by instance in its own memory
+            for (kk = 0; kk < nk; kk++)
+            {
+                fun = self[k0 + kk];
+                fun->evaluate(fun, type_in, in[k0 + kk], type_out, out[k0 + kk]);
+            }
+            k0 += nk;
+            continue;
         }
+
+        // in as args, instance kk at offset kk * nnz
+        for (kk = 0; kk < nk; kk++)
+        {
+            fun = self[k0 + kk];
+            for (ii = 0; ii < fun->in_num; ii++)
+                d_cvt_in_to_casadi(type_in[ii], in[k0 + kk][ii],
+                                   scratch->args[ii] + kk * fun->args_size[ii],
+                                   (int *) fun->casadi_sparsity_in(ii), ii);
+        }
+
+        // call casadi map
+        map->casadi_fun((const double **) scratch->args, scratch->res, scratch->iw, scratch->w,
+                        NULL);
+
+        // res as out
+        for (kk = 0; kk < nk; kk++)
+        {
+            fun = self[k0 + kk];
+            for (ii = 0; ii < fun->out_num; ii++)
+                d_cvt_casadi_to_out(scratch->res[ii] + kk * fun->res_size[ii],
+                                    (int *) fun->casadi_sparsity_out(ii), type_out[ii],
+                                    out[k0 + kk][ii], ii);
+        }
+
+        casadi_map_scratch_release(scratch);
+
+        k0 += nk;
     }
 
     return;
@@ -991,6 +1553,27 @@ void external_function_param_casadi_set_n_out(external_function_param_casadi *fu
 }
 
 
+
+void external_function_param_casadi_set_zero_copy(external_function_param_casadi *fun, int value)
+{
+    fun->zero_copy = value;
+    return;
+}
+
+
+
+void external_function_param_casadi_set_map(external_function_param_casadi *fun,
+                                            external_function_casadi_map *map)
+{
+    if (map != NULL)
+        casadi_map_check(map, fun->in_num, fun->out_num, fun->args_size, fun->res_size);
+
+    fun->map = map;
+    fun->evaluate_batch = map != NULL ? &external_function_param_casadi_wrapper_batch : NULL;
+    return;
+}
+
+
 static void external_function_param_casadi_set_param(void *self, double *p)
 {
     external_function_param_casadi *fun = self;
@@ -1025,6 +1608,12 @@ acados_size_t external_function_param_casadi_calculate_size(external_function_pa
 
     // casadi wrapper as evaluate function
     fun->evaluate = &external_function_param_casadi_wrapper;
+    // batched evaluation only with a map, see set_map
+    fun->evaluate_batch = NULL;
+    fun->map = NULL;
+
+    // convert the arguments by default
+    fun->zero_copy = 0;
 
     // set param function
     fun->get_nparam = &external_function_param_casadi_get_nparam;
@@ -1049,11 +1638,26 @@ acados_size_t external_function_param_casadi_calculate_size(external_function_pa
     for (ii = 0; ii < fun->res_num; ii++)
         fun->res_size_tot += casadi_nnz(fun->casadi_sparsity_out(ii));
 
+    // mirror, shared by all sparse matrix arguments
+    fun->mirror_size = 0;
+    for (ii = 0; ii < fun->in_num; ii++)
+    {
+        int tmp = casadi_mirror_size(fun->casadi_sparsity_in(ii));
+        fun->mirror_size = tmp > fun->mirror_size ? tmp : fun->mirror_size;
+    }
+    for (ii = 0; ii < fun->out_num; ii++)
+    {
+        int tmp = casadi_mirror_size(fun->casadi_sparsity_out(ii));
+        fun->mirror_size = tmp > fun->mirror_size ? tmp : fun->mirror_size;
+    }
+
     acados_size_t size = 0;
 
     // double pointers
     size += fun->args_num * sizeof(double *);  // args
     size += fun->res_num * sizeof(double *);   // res
+    size += fun->args_num * sizeof(double *);  // args_ptr
+    size += fun->res_num * sizeof(double *);   // res_ptr
 
     // ints
     size += fun->args_num * sizeof(int);  // args_size
@@ -1064,6 +1668,7 @@ acados_size_t external_function_param_casadi_calculate_size(external_function_pa
     size += fun->args_size_tot * sizeof(double);  // args
     size += fun->res_size_tot * sizeof(double);   // res
     size += fun->w_size * sizeof(double);         // w
+    size += fun->mirror_size * sizeof(double);    // mirror
     size += fun->np * sizeof(double);             // p
 
     size += 8;  // initial align
@@ -1096,6 +1701,10 @@ void external_function_param_casadi_assign(external_function_param_casadi *fun,
     assign_and_advance_double_ptrs(fun->args_num, &fun->args, &c_ptr);
     // res
     assign_and_advance_double_ptrs(fun->res_num, &fun->res, &c_ptr);
+    // args_ptr
+    assign_and_advance_double_ptrs(fun->args_num, &fun->args_ptr, &c_ptr);
+    // res_ptr
+    assign_and_advance_double_ptrs(fun->res_num, &fun->res_ptr, &c_ptr);
 
     // args_size
     assign_and_advance_int(fun->args_num, &fun->args_size, &c_ptr);
@@ -1119,6 +1728,14 @@ void external_function_param_casadi_assign(external_function_param_casadi *fun,
         assign_and_advance_double(fun->res_size[ii], &fun->res[ii], &c_ptr);
     // w
     assign_and_advance_double(fun->w_size, &fun->w, &c_ptr);
+    // mirror
+    assign_and_advance_double(fun->mirror_size, &fun->mirror, &c_ptr);
+
+    // pass the own argument and result arrays by default
+    for (ii = 0; ii < fun->args_num; ii++)
+        fun->args_ptr[ii] = fun->args[ii];
+    for (ii = 0; ii < fun->res_num; ii++)
+        fun->res_ptr[ii] = fun->res[ii];
 
     assert((char *) raw_memory + external_function_param_casadi_calculate_size(fun, fun->np) >=
            c_ptr);
@@ -1141,94 +1758,130 @@ void external_function_param_casadi_wrapper(void *self, ext_fun_arg_t *type_in,
     // skip last argument (that is the parameters vector)
     for (ii = 0; ii < fun->in_num - 1; ii++)
     {
-        switch (type_in[ii])
+        if (fun->zero_copy)
         {
-            case COLMAJ:
-                d_cvt_colmaj_to_casadi(in[ii], (double *) fun->args[ii],
-                                       (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case BLASFEO_DMAT:
-                d_cvt_dmat_to_casadi(in[ii], (double *) fun->args[ii],
-                                     (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case BLASFEO_DVEC:
-                d_cvt_dvec_to_casadi(in[ii], (double *) fun->args[ii],
-                                     (int *) fun->casadi_sparsity_in(ii));
-                break;
-            case COLMAJ_ARGS:
-                d_cvt_colmaj_args_to_casadi(in[ii], (double *) fun->args[ii],
-                                            (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case BLASFEO_DMAT_ARGS:
-                d_cvt_dmat_args_to_casadi(in[ii], (double *) fun->args[ii],
-                                          (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case BLASFEO_DVEC_ARGS:
-                d_cvt_dvec_args_to_casadi(in[ii], (double *) fun->args[ii],
-                                          (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case IGNORE_ARGUMENT:
-                // do nothing
-                break;
-
-            default:
-                printf("\ntype in %d\n", type_in[ii]);
-                printf("\nUnknown external function argument type for argument %i\n\n", ii);
-                exit(1);
+            fun->args_ptr[ii] = d_casadi_arg_ptr(type_in[ii], in[ii],
+                                                 fun->casadi_sparsity_in(ii));
+            if (fun->args_ptr[ii])
+                continue;
         }
+        fun->args_ptr[ii] = fun->args[ii];
+
+        if (fun->zero_copy && d_cvt_in_to_casadi_mirror(type_in[ii], in[ii], fun->args[ii],
+                                            fun->casadi_sparsity_in(ii), fun->mirror))
+            continue;
+
+        d_cvt_in_to_casadi(type_in[ii], in[ii], fun->args[ii],
+                           (int *) fun->casadi_sparsity_in(ii), ii);
     }
     // parameters are last argument and set via external_function_param_casadi_set_param
+    fun->args_ptr[fun->in_num-1] = fun->args[fun->in_num-1];
+
+    // out as res, written in place if possible
+    for (ii = 0; ii < fun->out_num; ii++)
+    {
+        fun->res_ptr[ii] = NULL;
+        if (fun->zero_copy)
+            fun->res_ptr[ii] = d_casadi_arg_ptr(type_out[ii], out[ii],
+                                                fun->casadi_sparsity_out(ii));
+        if (!fun->res_ptr[ii])
+            fun->res_ptr[ii] = fun->res[ii];
+    }
+
+    if (fun->zero_copy)
+        casadi_check_in_place(fun->args_ptr, fun->args, fun->args_size, fun->in_num - 1,
+                              fun->res_ptr, fun->res, fun->res_size, fun->out_num);
 
     // call casadi function
-    fun->casadi_fun((const double **) fun->args, fun->res, fun->iw, fun->w, NULL);
+    fun->casadi_fun((const double **) fun->args_ptr, fun->res_ptr, fun->iw, fun->w, NULL);
 
     for (ii = 0; ii < fun->out_num; ii++)
     {
-        switch (type_out[ii])
+        // already written in place
+        if (fun->res_ptr[ii] != fun->res[ii])
+            continue;
+
+        if (fun->zero_copy && d_cvt_casadi_to_out_mirror(fun->res[ii],
+                    fun->casadi_sparsity_out(ii), type_out[ii], out[ii], fun->mirror))
+            continue;
+
+        d_cvt_casadi_to_out(fun->res[ii], (int *) fun->casadi_sparsity_out(ii), type_out[ii],
+                            out[ii], ii);
+    }
+
+    return;
+}
+
+
+
+void external_function_param_casadi_wrapper_batch(void **self, int K, ext_fun_arg_t *type_in,
+                                                  void ***in, ext_fun_arg_t *type_out, void ***out)
+{
+    // loop index
+    int ii, kk;
+
+    int k0 = 0;
+    while (k0 < K)
+    {
+        // cast into external casadi function
+        external_function_param_casadi *fun = self[k0];
+        external_function_casadi_map *map = fun->map;
+
+        // consecutive instances sharing the map, up to its batch size
+        int nk = 1;
+        while (k0 + nk < K && nk < map->batch_size
+               && ((external_function_param_casadi *) self[k0 + nk])->map == map)
+            nk++;
+
+        // scratch memory of this batch, NULL if all are in use or nk == 1
+        external_function_casadi_map_scratch *scratch = NULL;
+        if (nk > 1)
+            scratch = casadi_map_scratch_claim(map);
+
+        if (scratch == NULL)
         {
-            case COLMAJ:
-                d_cvt_casadi_to_colmaj((double *) fun->res[ii],
-                                       (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
-
-            case BLASFEO_DMAT:
-                d_cvt_casadi_to_dmat((double *) fun->res[ii], (int *) fun->casadi_sparsity_out(ii),
-                                     out[ii]);
-                break;
-
-            case BLASFEO_DVEC:
-                d_cvt_casadi_to_dvec((double *) fun->res[ii], (int *) fun->casadi_sparsity_out(ii),
-                                     out[ii]);
-                break;
-            case COLMAJ_ARGS:
-                d_cvt_casadi_to_colmaj_args((double *) fun->res[ii],
-                                            (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
-
-            case BLASFEO_DMAT_ARGS:
-                d_cvt_casadi_to_dmat_args((double *) fun->res[ii],
-                                          (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
-
-            case BLASFEO_DVEC_ARGS:
-                d_cvt_casadi_to_dvec_args((double *) fun->res[ii],
-                                          (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
-
-            case IGNORE_ARGUMENT:
-                // do nothing
-                break;
-
-            default:
-                printf("\ntype in %d\n", type_out[ii]);
-                printf("\nUnknown external function argument type for output %i\n\n", ii);
-                exit(1);
+            // instance by instance in its own memory
+            for (kk = 0; kk < nk; kk++)
+            {
+                fun = self[k0 + kk];
+                fun->evaluate(fun, type_in, in[k0 + kk], type_out, out[k0 + kk]);
+            }
+            k0 += nk;
+            continue;
         }
+
+        // in as args, instance kk at offset kk * nnz
+        for (kk = 0; kk < nk; kk++)
+        {
+            fun = self[k0 + kk];
+            // skip last argument (that is the parameters vector)
+            for (ii = 0; ii < fun->in_num - 1; ii++)
+                d_cvt_in_to_casadi(type_in[ii], in[k0 + kk][ii],
+                                   scratch->args[ii] + kk * fun->args_size[ii],
+                                   (int *) fun->casadi_sparsity_in(ii), ii);
+            // parameters of instance kk
+            ii = fun->in_num - 1;
+            for (int jj = 0; jj < fun->args_size[ii]; jj++)
+                scratch->args[ii][kk * fun->args_size[ii] + jj] = fun->args[ii][jj];
+        }
+
+        // call casadi map
+        map->casadi_fun((const double **) scratch->args, scratch->res, scratch->iw, scratch->w,
+                        NULL);
+
+        // res as out
+        for (kk = 0; kk < nk; kk++)
+        {
+            fun = self[k0 + kk];
+            for (ii = 0; ii < fun->out_num; ii++)
+                d_cvt_casadi_to_out(scratch->res[ii] + kk * fun->res_size[ii],
+                                    (int *) fun->casadi_sparsity_out(ii), type_out[ii],
+                                    out[k0 + kk][ii], ii);
+        }
+
+        casadi_map_scratch_release(scratch);
+
+        k0 += nk;
     }
 
     return;
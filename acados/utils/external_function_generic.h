@@ -80,10 +80,19 @@ typedef struct
 {
     // public members (have to be before private ones)
     void (*evaluate)(void *, ext_fun_arg_t *, void **, ext_fun_arg_t *, void **);
+    // optional, NULL if not supported: evaluates the K instances self[k] at once, with inputs
+    // in[k] and outputs out[k] of instance k, and argument types common to all instances
+    void (*evaluate_batch)(void **, int, ext_fun_arg_t *, void ***, ext_fun_arg_t *, void ***);
     // private members
     // .....
 } external_function_generic;
 
+// evaluates the K instances fun[k]: runs of instances sharing evaluate_batch are evaluated by it,
+// the other instances one by one
+void external_function_evaluate_batch(external_function_generic **fun, int K,
+                                      ext_fun_arg_t *type_in, void ***in,
+                                      ext_fun_arg_t *type_out, void ***out);
+
 
 
 /************************************************
@@ -95,6 +104,7 @@ typedef struct
 {
     // public members for core (have to be before private ones)
     void (*evaluate)(void *, ext_fun_arg_t *, void **, ext_fun_arg_t *, void **);
+    void (*evaluate_batch)(void **, int, ext_fun_arg_t *, void ***, ext_fun_arg_t *, void ***);
 	// public members for interfaces
     void (*get_nparam)(void *, int *);
     void (*set_param)(void *, double *);
@@ -123,6 +133,58 @@ void external_function_param_generic_get_nparam(void *self, int *np);
 void external_function_param_generic_set_param(void *self, double *p);
 
 
+/************************************************
+ * casadi map of an external function
+ ************************************************/
+
+// scratch memory of one evaluation of the map
+typedef struct
+{
+    double **args;
+    double **res;
+    double *w;
+    int *iw;
+    int busy;  // claimed by an evaluation in progress
+} external_function_casadi_map_scratch;
+
+// casadi function generated as f.map(batch_size) from the (parametric) casadi function f:
+// arguments and results of the batch_size instances are concatenated horizontally, i.e. instance k
+// of argument ii is stored at offset k * nnz(argument ii of f), parameters included;
+// shared by the instances of f via external_function_(param_)casadi_set_map;
+// up to num_scratch batches are evaluated concurrently (e.g. one per thread), each in its own
+// scratch memory, further concurrent batches fall back to the evaluation instance by instance
+typedef struct
+{
+    void *ptr_ext_mem;  // pointer to external memory
+    int (*casadi_fun)(const double **, double **, int *, double *, void *);
+    int (*casadi_work)(int *, int *, int *, int *);
+    const int *(*casadi_sparsity_in)(int);
+    const int *(*casadi_sparsity_out)(int);
+    int (*casadi_n_in)();
+    int (*casadi_n_out)();
+    external_function_casadi_map_scratch *scratch;
+    int *args_size;     // size of args[i]
+    int *res_size;      // size of res[i]
+    int args_num;       // number of args arrays
+    int args_size_tot;  // total size of args arrays
+    int res_num;        // number of res arrays
+    int res_size_tot;   // total size of res arrays
+    int in_num;         // number of input arrays
+    int out_num;        // number of output arrays
+    int iw_size;        // number of ints for worksapce
+    int w_size;         // number of doubles for workspace
+    int batch_size;     // number of instances evaluated per call of casadi_fun
+    int num_scratch;    // number of scratch memories
+} external_function_casadi_map;
+
+//
+acados_size_t external_function_casadi_map_calculate_size(external_function_casadi_map *map,
+                                                          int batch_size, int num_scratch);
+//
+void external_function_casadi_map_assign(external_function_casadi_map *map, void *mem);
+
+
+
 /************************************************
  * casadi external function
  ************************************************/
@@ -131,6 +193,7 @@ typedef struct
 {
     // public members (have to be the same as in the prototype, and before the private ones)
     void (*evaluate)(void *, ext_fun_arg_t *, void **, ext_fun_arg_t *, void **);
+    void (*evaluate_batch)(void **, int, ext_fun_arg_t *, void ***, ext_fun_arg_t *, void ***);
     // private members
     void *ptr_ext_mem;  // pointer to external memory
     int (*casadi_fun)(const double **, double **, int *, double *, void *);
@@ -153,6 +216,12 @@ typedef struct
     int out_num;        // number of output arrays
     int iw_size;        // number of ints for worksapce
     int w_size;         // number of doubles for workspace
+    double **args_ptr;  // arguments passed to casadi_fun: args, or the inputs themselves (zero copy)
+    double **res_ptr;   // results passed to casadi_fun: res, or the outputs themselves (zero copy)
+    int zero_copy;      // pass inputs and outputs in place where their layout is the casadi one
+    double *mirror;     // dense column-major copy of sparse panel-major matrices (zero copy)
+    int mirror_size;    // size of mirror
+    external_function_casadi_map *map;  // batched evaluation, NULL if not set
 } external_function_casadi;
 
 //
@@ -169,6 +238,15 @@ void external_function_casadi_set_sparsity_out(external_function_casadi *fun, vo
 void external_function_casadi_set_n_in(external_function_casadi *fun, void *value);
 //
 void external_function_casadi_set_n_out(external_function_casadi *fun, void *value);
+// zero copy: dense inputs and outputs whose storage is column-major (COLMAJ, BLASFEO_DVEC,
+// BLASFEO_DMAT with the reference BLASFEO layout) are handed to casadi_fun without conversion,
+// which requires inputs and outputs not to overlap (checked at each call); sparse panel-major
+// matrices are converted through a dense column-major mirror; to be called after create, default 0
+void external_function_casadi_set_zero_copy(external_function_casadi *fun, int value);
+// batched evaluation: instances sharing the map are evaluated batch_size at a time by the map,
+// which has to be created from the same casadi function; to be called after create, default NULL
+void external_function_casadi_set_map(external_function_casadi *fun,
+                                      external_function_casadi_map *map);
 //
 acados_size_t external_function_casadi_calculate_size(external_function_casadi *fun);
 //
@@ -176,6 +254,9 @@ void external_function_casadi_assign(external_function_casadi *fun, void *mem);
 //
 void external_function_casadi_wrapper(void *self, ext_fun_arg_t *type_in, void **in,
                                       ext_fun_arg_t *type_out, void **out);
+//
+void external_function_casadi_wrapper_batch(void **self, int K, ext_fun_arg_t *type_in,
+                                            void ***in, ext_fun_arg_t *type_out, void ***out);
 
 /************************************************
  * casadi external parametric function
@@ -185,6 +266,7 @@ typedef struct
 {
     // public members for core (have to be the same as in the prototype, and before the private ones)
     void (*evaluate)(void *, ext_fun_arg_t *, void **, ext_fun_arg_t *, void **);
+    void (*evaluate_batch)(void **, int, ext_fun_arg_t *, void ***, ext_fun_arg_t *, void ***);
 	// public members for interfaces
     void (*get_nparam)(void *, int *);
     void (*set_param)(void *, double *);
@@ -212,6 +294,12 @@ typedef struct
     int iw_size;        // number of ints for worksapce
     int w_size;         // number of doubles for workspace
     int np;             // number of parameters
+    double **args_ptr;  // arguments passed to casadi_fun: args, or the inputs themselves (zero copy)
+    double **res_ptr;   // results passed to casadi_fun: res, or the outputs themselves (zero copy)
+    int zero_copy;      // pass inputs and outputs in place where their layout is the casadi one
+    double *mirror;     // dense column-major copy of sparse panel-major matrices (zero copy)
+    int mirror_size;    // size of mirror
+    external_function_casadi_map *map;  // batched evaluation, NULL if not set
 } external_function_param_casadi;
 
 //
@@ -228,6 +316,11 @@ void external_function_param_casadi_set_sparsity_out(external_function_param_cas
 void external_function_param_casadi_set_n_in(external_function_param_casadi *fun, void *value);
 //
 void external_function_param_casadi_set_n_out(external_function_param_casadi *fun, void *value);
+// see external_function_casadi_set_zero_copy
+void external_function_param_casadi_set_zero_copy(external_function_param_casadi *fun, int value);
+// see external_function_casadi_set_map
+void external_function_param_casadi_set_map(external_function_param_casadi *fun,
+                                            external_function_casadi_map *map);
 //
 acados_size_t external_function_param_casadi_calculate_size(external_function_param_casadi *fun, int np);
 //
@@ -236,6 +329,9 @@ void external_function_param_casadi_assign(external_function_param_casadi *fun,
 void external_function_param_casadi_wrapper(void *self, ext_fun_arg_t *type_in, void **in,
                                             ext_fun_arg_t *type_out, void **out);
 //
+void external_function_param_casadi_wrapper_batch(void **self, int K, ext_fun_arg_t *type_in,
+                                                  void ***in, ext_fun_arg_t *type_out, void ***out);
+//
 void external_function_param_casadi_get_nparam(void *self, int *np);
 
 #ifdef __cplusplus
@@ -33,9 +33,12 @@
 
 
 // external
+#include <float.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+// blasfeo
+#include "blasfeo/include/blasfeo_d_aux.h"
 // acados
 #include "acados/utils/math.h"
 #include "acados/utils/types.h"
@@ -817,282 +820,204 @@ void expm(int row, double *A)
 
 
 
-static double hypot2(double x, double y)
-{
-    return sqrt(x*x + y*y);
-}
+#define JACOBI_MAX_SWEEPS 50
 
 
 
-/* Symmetric Householder reduction to tridiagonal form. */
-static void tred2(int dim, double *V, double *d, double *e)
+// pair kk of round r of the round robin ordering of m (even) indices: (m-1, r) for kk = 0, else
+// (r+kk, r-kk) modulo m-1; every pair once in the m-1 rounds of a sweep, disjoint within a round
+static void jacobi_pair(int m, int r, int kk, int *p, int *q)
 {
-    /* This is derived from the Algol procedures tred2 by
-    Bowdler, Martin, Reinsch, and Wilkinson, Handbook for
-    Auto. Comp., Vol.ii-Linear Algebra, and the corresponding
-    Fortran subroutine in EISPACK. */
-
-    int i, j, k;
-    double f, g, h, hh, scale;
-    for (j = 0; j < dim; j++)
+    if (kk == 0)
     {
-        d[j] = V[(dim - 1) * dim + j];
+        *p = m - 1;
+        *q = r;
+        return;
     }
+    int a = r + kk;
+    int b = r - kk;
+    *p = a < m - 1 ? a : a - (m - 1);
+    *q = b >= 0 ? b : b + (m - 1);
+}
 
-    /* Householder reduction to tridiagonal form. */
 
-    for (i = dim - 1; i > 0; i--)
-    {
-        /* Scale to avoid under/overflow. */
 
-        scale = 0.0;
-        h = 0.0;
-        for (k = 0; k < i; k++)
-        {
-            scale = scale + fabs(d[k]);
-        }
-        if (scale == 0.0)
+// cyclic Jacobi on the dense column-major symmetric matrix A (lda = dim), overwritten;
+// each round applies the dim/2 disjoint rotations of the round robin ordering at once, such that
+// every update runs along contiguous columns: A*J and V*J on column pairs, then J'*(A*J) column
+// by column; V: eigenvectors in the columns, column-major; cs: workspace of dim doubles
+static int jacobi_colmaj(int dim, double *A, double *V, double *d, double *cs)
+{
+    int ii, jj, kk, p, q, r, sweep;
+    double app, aqq, apq, theta, t, c, s, x, y;
+    double *Ap, *Aq, *Aj;
+
+    int m = dim + dim % 2;  // even number of indices, for odd dim index dim is a dummy
+    int k0 = dim % 2;       // for odd dim pair 0 of every round is (dim, r): skipped
+
+    // V = eye(dim)
+    for (ii = 0; ii < dim * dim; ii++)
+        V[ii] = 0.0;
+    for (ii = 0; ii < dim; ii++)
+        V[ii * (dim + 1)] = 1.0;
+
+    // Frobenius norm, invariant under the rotations: the sweeps stop at off-diagonal norm
+    // DBL_EPSILON * norm, and entries below that share of it are not rotated
+    double norm = 0.0;
+    for (ii = 0; ii < dim * dim; ii++)
+        norm += A[ii] * A[ii];
+    norm = sqrt(norm);
+    double tol_rot = dim > 1 ? DBL_EPSILON * norm / dim : 0.0;
+
+    for (sweep = 0; sweep < JACOBI_MAX_SWEEPS; sweep++)
+    {
+        double off = 0.0;
+        for (jj = 0; jj < dim; jj++)
         {
-            e[i] = d[i - 1];
-            for (j = 0; j < i; j++)
+            for (ii = 0; ii < dim; ii++)
             {
-                d[j] = V[(i - 1) * dim + j];
-                V[i * dim + j] = 0.0;
-                V[j * dim + i] = 0.0;
+                if (ii != jj)
+                    off += A[ii + dim * jj] * A[ii + dim * jj];
             }
         }
-        else
-        {
-            /* Generate Householder vector. */
+        if (sqrt(off) <= DBL_EPSILON * norm)
+            break;
 
-            for (k = 0; k < i; k++)
-            {
-                d[k] /= scale;
-                h += d[k] * d[k];
-            }
-            f = d[i - 1];
-            g = sqrt(h);
-            if (f > 0)
-            {
-                g = -g;
-            }
-            e[i] = scale * g;
-            h = h - f * g;
-            d[i - 1] = f - g;
-            for (j = 0; j < i; j++)
+        for (r = 0; r < m - 1; r++)
+        {
+            // rotations annihilating A(p,q), from the entries before the round
+            for (kk = k0; kk < m / 2; kk++)
             {
-                e[j] = 0.0;
+                jacobi_pair(m, r, kk, &p, &q);
+                apq = A[q + dim * p];
+                c = 1.0;
+                s = 0.0;
+                if (fabs(apq) > tol_rot)
+                {
+                    app = A[p + dim * p];
+                    aqq = A[q + dim * q];
+                    theta = (aqq - app) / (2.0 * apq);
+                    if (fabs(theta) > 1e150)
+                        t = 0.5 / theta;
+                    else
+                        t = (theta >= 0.0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+                    c = 1.0 / sqrt(t * t + 1.0);
+                    s = t * c;
+                }
+                cs[2 * (kk - k0)] = c;
+                cs[2 * (kk - k0) + 1] = s;
             }
 
-            /* Apply similarity transformation to remaining columns. */
-
-            for (j = 0; j < i; j++)
+            // A = A * J, V = V * J: columns p and q
+            for (kk = k0; kk < m / 2; kk++)
             {
-                f = d[j];
-                V[j * dim + i] = f;
-                g = e[j] + V[j * dim + j] * f;
-                for (k = j + 1; k <= i - 1; k++)
+                c = cs[2 * (kk - k0)];
+                s = cs[2 * (kk - k0) + 1];
+                if (s == 0.0)
+                    continue;
+                jacobi_pair(m, r, kk, &p, &q);
+                Ap = A + dim * p;
+                Aq = A + dim * q;
+                for (ii = 0; ii < dim; ii++)
                 {
-                    g += V[k * dim + j] * d[k];
-                    e[k] += V[k * dim + j] * f;
+                    x = Ap[ii];
+                    y = Aq[ii];
+                    Ap[ii] = c * x - s * y;
+                    Aq[ii] = s * x + c * y;
                 }
-                e[j] = g;
-            }
-            f = 0.0;
-            for (j = 0; j < i; j++)
-            {
-                e[j] /= h;
-                f += e[j] * d[j];
-            }
-            hh = f / (h + h);
-            for (j = 0; j < i; j++)
-            {
-                e[j] -= hh * d[j];
-            }
-            for (j = 0; j < i; j++)
-            {
-                f = d[j];
-                g = e[j];
-                for (k = j; k <= i - 1; k++)
+                Ap = V + dim * p;
+                Aq = V + dim * q;
+                for (ii = 0; ii < dim; ii++)
                 {
-                    V[k * dim + j] -= (f * e[k] + g * d[k]);
+                    x = Ap[ii];
+                    y = Aq[ii];
+                    Ap[ii] = c * x - s * y;
+                    Aq[ii] = s * x + c * y;
                 }
-                d[j] = V[(i - 1) * dim + j];
-                V[i * dim + j] = 0.0;
             }
-        }
-        d[i] = h;
-    }
 
-    /* Accumulate transformations. */
-
-    for (i = 0; i < dim - 1; i++)
-    {
-        V[(dim - 1) * dim + i] = V[i * dim + i];
-        V[i * dim + i] = 1.0;
-        h = d[i + 1];
-        if (h != 0.0)
-        {
-            for (k = 0; k <= i; k++)
-            {
-                d[k] = V[k * dim + i + 1] / h;
-            }
-            for (j = 0; j <= i; j++)
+            // A = J' * A: rows p and q, one column at a time
+            for (jj = 0; jj < dim; jj++)
             {
-                g = 0.0;
-                for (k = 0; k <= i; k++)
-                {
-                    g += V[k * dim + i + 1] * V[k * dim + j];
-                }
-                for (k = 0; k <= i; k++)
+                Aj = A + dim * jj;
+                for (kk = k0; kk < m / 2; kk++)
                 {
-                    V[k * dim + j] -= g * d[k];
+                    c = cs[2 * (kk - k0)];
+                    s = cs[2 * (kk - k0) + 1];
+                    if (s == 0.0)
+                        continue;
+                    jacobi_pair(m, r, kk, &p, &q);
+                    x = Aj[p];
+                    y = Aj[q];
+                    Aj[p] = c * x - s * y;
+                    Aj[q] = s * x + c * y;
                 }
             }
-        }
-        for (k = 0; k <= i; k++)
-        {
-            V[k * dim + i + 1] = 0.0;
+
+            // annihilated up to rounding
+            for (kk = k0; kk < m / 2; kk++)
+            {
+                if (cs[2 * (kk - k0) + 1] == 0.0)
+                    continue;
+                jacobi_pair(m, r, kk, &p, &q);
+                A[q + dim * p] = 0.0;
+                A[p + dim * q] = 0.0;
+            }
         }
     }
-    for (j = 0; j < dim; j++)
-    {
-        d[j] = V[(dim - 1) * dim + j];
-        V[(dim - 1) * dim + j] = 0.0;
-    }
-    if (dim > 0)
-    {
-        V[(dim - 1) * dim + dim - 1] = 1.0;
-        e[0] = 0.0;
-    }
+
+    for (ii = 0; ii < dim; ii++)
+        d[ii] = A[ii * (dim + 1)];
+
+    return sweep;
 }
 
 
 
-/* Symmetric tridiagonal QL algorithm. */
-static void tql2(int dim, double *V, double *d, double *e)
+void acados_eigen_decomposition(int dim, double *A, double *V, double *d, double *e)
 {
-    /*  This is derived from the Algol procedures tql2, by
-    Bowdler, Martin, Reinsch, and Wilkinson, Handbook for
-    Auto. Comp., Vol.ii-Linear Algebra, and the corresponding
-    Fortran subroutine in EISPACK. */
-    // http://www.netlib.org/eispack/tql2.f
-
-    int i, m, l, k;
-    double g, p, r, dl1, h, f, tst1, eps;
-    double c, c2, c3, el1, s, s2;
+    int i, j;
+    double tmp;
 
-    for (i = 1; i < dim; i++)
-    {
-        e[i - 1] = e[i];
-    }
-    e[dim - 1] = 0.0;
+    jacobi_colmaj(dim, A, V, d, e);
 
-    f = 0.0;
-    tst1 = 0.0;
-    eps = pow(2.0, -52.0);
-    for (l = 0; l < dim; l++)
+    // V[i*dim+k] is entry i of eigenvector k
+    for (i = 0; i < dim; i++)
     {
-        /* Find small subdiagonal element */
-
-        tst1 = fmax(tst1, fabs(d[l]) + fabs(e[l]));
-        m = l;
-        while (m < dim-1)
+        for (j = i + 1; j < dim; j++)
         {
-            if (fabs(e[m]) <= eps * tst1)
-            {
-                break;
-            }
-            m++;
+            tmp = V[i * dim + j];
+            V[i * dim + j] = V[j * dim + i];
+            V[j * dim + i] = tmp;
         }
+    }
 
-        /* If m == l, d[l] is an eigenvalue,
-        otherwise, iterate. */
-
-        if (m > l)
-        {
-            int iter = 0;
-            do
-            {
-                iter = iter + 1;
-                /* Compute implicit shift */
-
-                g = d[l];
-                p = (d[l + 1] - g) / (2.0 * e[l]);
-                r = hypot2(p, 1.0);
-                if (p < 0)
-                {
-                    r = -r;
-                }
-                d[l] = e[l] / (p + r);
-                d[l + 1] = e[l] * (p + r);
-                dl1 = d[l + 1];
-                h = g - d[l];
-                for (i = l + 2; i < dim; i++)
-                {
-                    d[i] -= h;
-                }
-                f = f + h;
-
-                /* Implicit QL transformation. */
+    return;
+}
 
-                p = d[m];
-                c = 1.0;
-                c2 = c;
-                c3 = c;
-                el1 = e[l + 1];
-                s = 0.0;
-                s2 = 0.0;
-                for (i = m - 1; i >= l; i--)
-                {
-                    c3 = c2;
-                    c2 = c;
-                    s2 = s;
-                    g = c * e[i];
-                    h = c * p;
-                    r = hypot2(p, e[i]);
-                    e[i + 1] = s * r;
-                    s = e[i] / r;
-                    c = p / r;
-                    p = c * d[i] - s * g;
-                    d[i + 1] = h + s * (c * g + s * d[i]);
-
-                    /* Accumulate transformation. */
-
-                    for (k = 0; k < dim; k++)
-                    {
-                        h = V[k * dim + i + 1];
-                        V[k * dim + i + 1] = s * V[k * dim + i] + c * h;
-                        V[k * dim + i] = c * V[k * dim + i] - s * h;
-                    }
-                }
-                p = -s * s2 * c3 * el1 * e[l] / dl1;
-                e[l] = s * p;
-                d[l] = c * p;
 
-                /* Check for convergence. */
 
-            } while (fabs(e[l]) > eps * tst1 && iter < 20); /* (Check iteration count here.) */
-        }
-        d[l] = d[l] + f;
-        e[l] = 0.0;
-    }
+int acados_eigen_decomposition_dmat_work_size(int dim)
+{
+    return 2 * dim * dim + dim;
 }
 
 
 
-void acados_eigen_decomposition(int dim, double *A, double *V, double *d, double *e)
+int acados_eigen_decomposition_dmat(int dim, struct blasfeo_dmat *A, int ai, int aj,
+                                    struct blasfeo_dmat *V, int vi, int vj, double *d,
+                                    double *work)
 {
-    int i, j;
+    double *A_cm = work;
+    double *V_cm = A_cm + dim * dim;
+    double *cs = V_cm + dim * dim;
 
-    for (i=0; i<dim; i++)
-        for (j=0; j<dim; j++)
-            V[i*dim+j] = A[i*dim+j];
+    // one unpack and one pack, the rotations run on the column-major copies
+    blasfeo_unpack_dmat(dim, dim, A, ai, aj, A_cm, dim);
+    int sweep = jacobi_colmaj(dim, A_cm, V_cm, d, cs);
+    blasfeo_pack_dmat(dim, dim, V_cm, dim, V, vi, vj);
 
-    tred2(dim, V, d, e);
-    tql2(dim, V, d, e);
-
-    return;
+    return sweep;
 }
 
 
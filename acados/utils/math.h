@@ -40,6 +40,8 @@ extern "C" {
 
 #include "acados/utils/types.h"
 
+#include "blasfeo/include/blasfeo_common.h"
+
 #if defined(__MABX2__)
 double fmax(double a, double b);
 #endif
@@ -92,7 +94,16 @@ void expm(int row, double *A);
 // void d_compute_qp_size_ocp2dense_rev(int N, int *nx, int *nu, int *nb, int **hidxb, int *ng,
 //                                      int *nvd, int *ned, int *nbd, int *ngd);
 
+// symmetric eigen decomposition A = V * diag(d) * V' by cyclic Jacobi rotations, row-major V
+// (V[i*dim+k] is entry i of eigenvector k); A is overwritten, e is a workspace of dim doubles
 void acados_eigen_decomposition(int dim, double *A, double *V, double *d, double *e);
+// number of doubles of the workspace of acados_eigen_decomposition_dmat
+int acados_eigen_decomposition_dmat_work_size(int dim);
+// symmetric eigen decomposition A = V * diag(d) * V' of BLASFEO matrices, A holds the full
+// symmetric matrix and is not modified; returns the number of sweeps
+int acados_eigen_decomposition_dmat(int dim, struct blasfeo_dmat *A, int ai, int aj,
+                                    struct blasfeo_dmat *V, int vi, int vj, double *d,
+                                    double *work);
 
 double minimum_of_doubles(double *x, int n);
 
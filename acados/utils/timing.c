@@ -34,6 +34,9 @@
 
 #include "acados/utils/timing.h"
 
+#include <stdio.h>
+#include <stdlib.h>
+
 #ifdef MEASURE_TIMINGS
 
 #if (defined _WIN32 || defined _WIN64) && !(defined __MINGW32__ || defined __MINGW64__)
@@ -138,9 +141,186 @@ real_t acados_toc(acados_timer* t)
 
 #endif  // (defined _WIN32 || _WIN64)
 
+/************************************************
+ * event recorder
+ ************************************************/
+
+// atomic counters and thread local storage of the recorder; events can be recorded from any
+// thread (OpenMP, pthreads), the build uses C99, where GCC and clang provide builtins
+#if defined(_MSC_VER)
+typedef volatile long trace_counter;
+#define TRACE_THREAD_LOCAL __declspec(thread)
+#define TRACE_FETCH_ADD(counter) (InterlockedIncrement(counter) - 1)
+#define TRACE_LOAD(counter) InterlockedCompareExchange(counter, 0, 0)
+#define TRACE_STORE(counter, value) InterlockedExchange(counter, value)
+#elif (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+typedef atomic_int trace_counter;
+#define TRACE_THREAD_LOCAL _Thread_local
+#define TRACE_FETCH_ADD(counter) atomic_fetch_add(counter, 1)
+#define TRACE_LOAD(counter) atomic_load(counter)
+#define TRACE_STORE(counter, value) atomic_store(counter, value)
+#else
+typedef int trace_counter;
+#define TRACE_THREAD_LOCAL __thread
+#define TRACE_FETCH_ADD(counter) __atomic_fetch_add(counter, 1, __ATOMIC_SEQ_CST)
+#define TRACE_LOAD(counter) __atomic_load_n(counter, __ATOMIC_SEQ_CST)
+#define TRACE_STORE(counter, value) __atomic_store_n(counter, value, __ATOMIC_SEQ_CST)
+#endif
+
+typedef struct
+{
+    const char *name;
+    int arg;
+    int tid;
+    real_t begin;  // [us] since acados_trace_start
+    real_t end;
+} acados_trace_event;
+
+typedef struct
+{
+    acados_trace_event *events;
+    int max_events;
+    trace_counter n_events;  // can exceed max_events, the excess events are dropped
+    trace_counter active;
+    trace_counter n_threads;  // number of threads that recorded an event so far
+    acados_timer t0;
+} acados_trace;
+
+static acados_trace trace;
+
+// id of the calling thread, numbered in the order of the first recorded event
+static TRACE_THREAD_LOCAL int trace_tid = -1;
+
+
+
+static real_t acados_trace_time(void)
+{
+    // copy, since acados_toc writes into the timer and the recorder is shared by all threads
+    acados_timer t = trace.t0;
+    return 1e6 * acados_toc(&t);
+}
+
+
+
+void acados_trace_start(int max_events)
+{
+    if (max_events > trace.max_events)
+    {
+        free(trace.events);
+        trace.events = malloc(max_events * sizeof(acados_trace_event));
+        trace.max_events = max_events;
+    }
+    TRACE_STORE(&trace.n_events, 0);
+    acados_tic(&trace.t0);
+    TRACE_STORE(&trace.active, 1);
+}
+
+
+
+void acados_trace_stop(void)
+{
+    TRACE_STORE(&trace.active, 0);
+}
+
+
+
+int acados_trace_begin(const char *name, int arg)
+{
+    if (!TRACE_LOAD(&trace.active))
+        return -1;
+
+    int event = TRACE_FETCH_ADD(&trace.n_events);
+
+    if (event >= trace.max_events)
+        return -1;
+
+    if (trace_tid < 0)
+        trace_tid = TRACE_FETCH_ADD(&trace.n_threads);
+
+    trace.events[event].name = name;
+    trace.events[event].arg = arg;
+    trace.events[event].tid = trace_tid;
+    trace.events[event].end = -1.0;
+    trace.events[event].begin = acados_trace_time();
+
+    return event;
+}
+
+
+
+void acados_trace_end(int event)
+{
+    if (event < 0)
+        return;
+
+    trace.events[event].end = acados_trace_time();
+}
+
+
+
+int acados_trace_write(const char *filename)
+{
+    FILE *file = fopen(filename, "w");
+    if (file == NULL)
+    {
+        printf("\nerror: acados_trace_write: cannot open %s\n", filename);
+        return 1;
+    }
+
+    int n_recorded = TRACE_LOAD(&trace.n_events);
+    int n_events = n_recorded < trace.max_events ? n_recorded : trace.max_events;
+    if (n_recorded > trace.max_events)
+        printf("\nacados_trace_write: buffer full, dropped %d events\n",
+               n_recorded - trace.max_events);
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    int first = 1;
+    for (int i = 0; i < n_events; i++)
+    {
+        acados_trace_event *ev = trace.events + i;
+        // skip unfinished events
+        if (ev->end < 0.0)
+            continue;
+
+        fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+                first ? "" : ",\n", ev->name, ev->tid, ev->begin, ev->end - ev->begin);
+        if (ev->arg >= 0)
+            fprintf(file, ",\"args\":{\"i\":%d}", ev->arg);
+        fprintf(file, "}");
+        first = 0;
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    fclose(file);
+    return 0;
+}
+
+
+
+void acados_trace_free(void)
+{
+    free(trace.events);
+    trace.events = NULL;
+    trace.max_events = 0;
+    TRACE_STORE(&trace.n_events, 0);
+    TRACE_STORE(&trace.active, 0);
+}
+
 #else  // Dummy functions when timing is off
 
 void acados_tic(acados_timer *t) {}
 real_t acados_toc(acados_timer *t) { return 0; }
 
+void acados_trace_start(int max_events) {}
+void acados_trace_stop(void) {}
+int acados_trace_begin(const char *name, int arg) { return -1; }
+void acados_trace_end(int event) {}
+int acados_trace_write(const char *filename)
+{
+    printf("\nerror: acados_trace_write: acados was compiled without MEASURE_TIMINGS\n");
+    return 1;
+}
+void acados_trace_free(void) {}
+
 #endif  // MEASURE_TIMINGS
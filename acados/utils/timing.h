@@ -118,6 +118,30 @@ void acados_tic(acados_timer* t);
 /** A function which returns the elapsed time. */
 real_t acados_toc(acados_timer* t);
 
+/* Event recorder, writes the events in the Chrome trace format (chrome://tracing, Perfetto).
+ * Events are only recorded between acados_trace_start and acados_trace_stop, and only if
+ * acados is compiled with MEASURE_TIMINGS. Events can be recorded from any thread; the thread id
+ * of an event numbers the recording threads in the order of their first event. */
+
+/** Allocates a buffer for max_events events and starts recording. */
+void acados_trace_start(int max_events);
+
+/** Stops recording, the recorded events are kept until the next start or free. */
+void acados_trace_stop(void);
+
+/** Records the begin of an event, arg (e.g. the stage) is ignored if negative.
+ *  Returns the event handle to be passed to acados_trace_end, -1 if not recording. */
+int acados_trace_begin(const char *name, int arg);
+
+/** Records the end of an event. */
+void acados_trace_end(int event);
+
+/** Writes the recorded events to a JSON file, returns 0 on success. */
+int acados_trace_write(const char *filename);
+
+/** Frees the event buffer. */
+void acados_trace_free(void);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+// Micro-benchmark of the projecting regularization of a random symmetric indefinite matrix:
+// on a column-major array, with unpack and pack (acados_project), against the BLASFEO matrix
+// version (acados_project_dmat), for sizes 4..64; both use the Jacobi eigen decomposition.
+//
+//   bench_eigen [n_rep]
+
+// standard
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+// blasfeo
+#include "blasfeo/include/blasfeo_common.h"
+#include "blasfeo/include/blasfeo_d_aux.h"
+#include "blasfeo/include/blasfeo_d_aux_ext_dep.h"
+// acados
+#include "acados/ocp_nlp/ocp_nlp_reg_common.h"
+#include "acados/utils/math.h"
+#include "acados/utils/timing.h"
+
+#define N_REP 1000
+#define EPSILON 1e-4
+
+
+
+int main(int argc, char *argv[])
+{
+    int sizes[] = {4, 8, 12, 16, 24, 32, 40, 48, 64};
+    int n_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    int n_rep = argc > 1 ? atoi(argv[1]) : N_REP;
+
+    acados_timer timer;
+
+    printf("\n%6s %14s %14s %10s %14s\n", "n", "unpack [us]", "dmat [us]", "speedup", "max diff");
+
+    for (int ss = 0; ss < n_sizes; ss++)
+    {
+        int n = sizes[ss];
+
+        double *A0 = malloc(n*n*sizeof(double));
+        double *A = malloc(n*n*sizeof(double));
+        double *V = malloc(n*n*sizeof(double));
+        double *d = malloc(n*sizeof(double));
+        double *e = malloc(n*sizeof(double));
+        double *work = malloc(acados_eigen_decomposition_dmat_work_size(n)*sizeof(double));
+
+        struct blasfeo_dmat sA0, sA1, sA2, sV, sW;
+        blasfeo_allocate_dmat(n, n, &sA0);
+        blasfeo_allocate_dmat(n, n, &sA1);
+        blasfeo_allocate_dmat(n, n, &sA2);
+        blasfeo_allocate_dmat(n, n, &sV);
+        blasfeo_allocate_dmat(n, n, &sW);
+
+        // random symmetric matrix, eigenvalues of both signs
+        srand(n);
+        for (int jj = 0; jj < n; jj++)
+        {
+            for (int ii = jj; ii < n; ii++)
+            {
+                double tmp = 2.0 * rand() / RAND_MAX - 1.0;
+                A0[ii+n*jj] = tmp;
+                A0[jj+n*ii] = tmp;
+            }
+        }
+        blasfeo_pack_dmat(n, n, A0, n, &sA0, 0, 0);
+
+        // reference: unpack, column-major array, pack
+        double time_ref = 0.0;
+        for (int rep = 0; rep < n_rep; rep++)
+        {
+            blasfeo_dgecp(n, n, &sA0, 0, 0, &sA1, 0, 0);
+            acados_tic(&timer);
+            blasfeo_unpack_dmat(n, n, &sA1, 0, 0, A, n);
+            acados_project(n, A, V, d, e, EPSILON);
+            blasfeo_pack_dmat(n, n, A, n, &sA1, 0, 0);
+            time_ref += acados_toc(&timer);
+        }
+
+        // BLASFEO matrix
+        double time_dmat = 0.0;
+        for (int rep = 0; rep < n_rep; rep++)
+        {
+            blasfeo_dgecp(n, n, &sA0, 0, 0, &sA2, 0, 0);
+            acados_tic(&timer);
+            acados_project_dmat(n, &sA2, 0, 0, &sV, &sW, d, work, EPSILON);
+            time_dmat += acados_toc(&timer);
+        }
+
+        // both must give the same projected matrix
+        double max_diff = 0.0;
+        for (int jj = 0; jj < n; jj++)
+            for (int ii = 0; ii < n; ii++)
+                max_diff = fmax(max_diff,
+                    fabs(blasfeo_dgeex1(&sA1, ii, jj) - blasfeo_dgeex1(&sA2, ii, jj)));
+
+        time_ref *= 1e6 / n_rep;
+        time_dmat *= 1e6 / n_rep;
+
+        printf("%6d %14.3f %14.3f %10.2f %14.3e\n", n, time_ref, time_dmat, time_ref / time_dmat,
+               max_diff);
+
+        blasfeo_free_dmat(&sA0);
+        blasfeo_free_dmat(&sA1);
+        blasfeo_free_dmat(&sA2);
+        blasfeo_free_dmat(&sV);
+        blasfeo_free_dmat(&sW);
+        free(A0);
+        free(A);
+        free(V);
+        free(d);
+        free(e);
+        free(work);
+    }
+
+    printf("\n");
+
+    return 0;
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// Micro-benchmark of the overhead of the casadi external function wrapper per call. A linear
+// model f = A*x + B*u with its dense Jacobian J = [A B], written as casadi generates functions,
+// is evaluated directly on arrays, through the wrapper converting the BLASFEO arguments, and
+// through the wrapper in zero copy mode, for nx = 2..24 and nu = nx/2.
+//
+//   bench_external_function [n_rep]
+
+// standard
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+// blasfeo
+#include "blasfeo/include/blasfeo_common.h"
+#include "blasfeo/include/blasfeo_d_aux.h"
+#include "blasfeo/include/blasfeo_d_aux_ext_dep.h"
+// acados
+#include "acados/utils/external_function_generic.h"
+#include "acados/utils/timing.h"
+#include "acados_c/external_function_interface.h"
+
+#define N_REP 100000
+
+
+
+/************************************************
+ * linear model, in the casadi calling convention
+ ************************************************/
+
+static int model_nx, model_nu;
+static double *model_AB;  // [A B], column-major
+static int model_sp_x[3], model_sp_u[3], model_sp_f[3], model_sp_J[3];
+
+static int lin_model(const double **arg, double **res, int *iw, double *w, void *mem)
+{
+    int nx = model_nx;
+    int nu = model_nu;
+    const double *x = arg[0];
+    const double *u = arg[1];
+    double *f = res[0];
+    double *J = res[1];
+
+    if (f)
+    {
+        for (int ii = 0; ii < nx; ii++)
+            f[ii] = 0.0;
+        for (int jj = 0; jj < nx; jj++)
+            for (int ii = 0; ii < nx; ii++)
+                f[ii] += model_AB[ii+nx*jj] * x[jj];
+        for (int jj = 0; jj < nu; jj++)
+            for (int ii = 0; ii < nx; ii++)
+                f[ii] += model_AB[ii+nx*(nx+jj)] * u[jj];
+    }
+    if (J)
+    {
+        for (int ii = 0; ii < nx*(nx+nu); ii++)
+            J[ii] = model_AB[ii];
+    }
+
+    return 0;
+}
+
+static int lin_model_work(int *sz_arg, int *sz_res, int *sz_iw, int *sz_w)
+{
+    *sz_arg = 2;
+    *sz_res = 2;
+    *sz_iw = 0;
+    *sz_w = 0;
+    return 0;
+}
+
+static const int *lin_model_sparsity_in(int ii)
+{
+    return ii == 0 ? model_sp_x : ii == 1 ? model_sp_u : NULL;
+}
+
+static const int *lin_model_sparsity_out(int ii)
+{
+    return ii == 0 ? model_sp_f : ii == 1 ? model_sp_J : NULL;
+}
+
+static int lin_model_n_in()
+{
+    return 2;
+}
+
+static int lin_model_n_out()
+{
+    return 2;
+}
+
+
+
+static void set_dense_sparsity(int nrow, int ncol, int *sparsity)
+{
+    sparsity[0] = nrow;
+    sparsity[1] = ncol;
+    sparsity[2] = 1;
+}
+
+
+
+int main(int argc, char *argv[])
+{
+    int sizes[] = {2, 4, 6, 8, 12, 16, 24};
+    int n_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    int n_rep = argc > 1 ? atoi(argv[1]) : N_REP;
+
+    acados_timer timer;
+
+    printf("\n%4s %4s %12s %12s %12s %12s %12s %12s\n", "nx", "nu", "direct [ns]", "convert [ns]",
+           "zero cp [ns]", "ovh conv", "ovh zero cp", "max diff");
+
+    for (int ss = 0; ss < n_sizes; ss++)
+    {
+        int nx = sizes[ss];
+        int nu = nx / 2;
+
+        model_nx = nx;
+        model_nu = nu;
+        set_dense_sparsity(nx, 1, model_sp_x);
+        set_dense_sparsity(nu, 1, model_sp_u);
+        set_dense_sparsity(nx, 1, model_sp_f);
+        set_dense_sparsity(nx, nx+nu, model_sp_J);
+
+        model_AB = malloc(nx*(nx+nu)*sizeof(double));
+        double *x = malloc(nx*sizeof(double));
+        double *u = malloc(nu*sizeof(double));
+        double *f = malloc(nx*sizeof(double));
+        double *J = malloc(nx*(nx+nu)*sizeof(double));
+
+        srand(nx);
+        for (int ii = 0; ii < nx*(nx+nu); ii++)
+            model_AB[ii] = 2.0 * rand() / RAND_MAX - 1.0;
+        for (int ii = 0; ii < nx; ii++)
+            x[ii] = 2.0 * rand() / RAND_MAX - 1.0;
+        for (int ii = 0; ii < nu; ii++)
+            u[ii] = 2.0 * rand() / RAND_MAX - 1.0;
+
+        // BLASFEO arguments, as passed by the integrators
+        struct blasfeo_dvec sx, su, sf0, sf1;
+        struct blasfeo_dmat sJ0, sJ1;
+        blasfeo_allocate_dvec(nx, &sx);
+        blasfeo_allocate_dvec(nu, &su);
+        blasfeo_allocate_dvec(nx, &sf0);
+        blasfeo_allocate_dvec(nx, &sf1);
+        blasfeo_allocate_dmat(nx, nx+nu, &sJ0);
+        blasfeo_allocate_dmat(nx, nx+nu, &sJ1);
+        blasfeo_pack_dvec(nx, x, 1, &sx, 0);
+        blasfeo_pack_dvec(nu, u, 1, &su, 0);
+
+        external_function_casadi fun;
+        external_function_casadi_set_fun(&fun, &lin_model);
+        external_function_casadi_set_work(&fun, &lin_model_work);
+        external_function_casadi_set_sparsity_in(&fun, &lin_model_sparsity_in);
+        external_function_casadi_set_sparsity_out(&fun, &lin_model_sparsity_out);
+        external_function_casadi_set_n_in(&fun, &lin_model_n_in);
+        external_function_casadi_set_n_out(&fun, &lin_model_n_out);
+        external_function_casadi_create(&fun);
+
+        ext_fun_arg_t type_in[2] = {BLASFEO_DVEC, BLASFEO_DVEC};
+        void *in[2] = {&sx, &su};
+        ext_fun_arg_t type_out[2] = {BLASFEO_DVEC, BLASFEO_DMAT};
+        void *out0[2] = {&sf0, &sJ0};
+        void *out1[2] = {&sf1, &sJ1};
+
+        // the function alone, on column-major arrays
+        const double *arg[2] = {x, u};
+        double *res[2] = {f, J};
+        acados_tic(&timer);
+        for (int rep = 0; rep < n_rep; rep++)
+            lin_model(arg, res, NULL, NULL, NULL);
+        double time_direct = acados_toc(&timer);
+
+        // wrapper, converting the arguments
+        external_function_casadi_set_zero_copy(&fun, 0);
+        acados_tic(&timer);
+        for (int rep = 0; rep < n_rep; rep++)
+            fun.evaluate(&fun, type_in, in, type_out, out0);
+        double time_convert = acados_toc(&timer);
+
+        // wrapper, zero copy
+        external_function_casadi_set_zero_copy(&fun, 1);
+        acados_tic(&timer);
+        for (int rep = 0; rep < n_rep; rep++)
+            fun.evaluate(&fun, type_in, in, type_out, out1);
+        double time_zero_copy = acados_toc(&timer);
+
+        // both modes must give the same outputs
+        double max_diff = 0.0;
+        for (int ii = 0; ii < nx; ii++)
+            max_diff = fmax(max_diff, fabs(BLASFEO_DVECEL(&sf0, ii) - BLASFEO_DVECEL(&sf1, ii)));
+        for (int jj = 0; jj < nx+nu; jj++)
+            for (int ii = 0; ii < nx; ii++)
+                max_diff = fmax(max_diff, fabs(BLASFEO_DMATEL(&sJ0, ii, jj)
+                                               - BLASFEO_DMATEL(&sJ1, ii, jj)));
+
+        time_direct *= 1e9 / n_rep;
+        time_convert *= 1e9 / n_rep;
+        time_zero_copy *= 1e9 / n_rep;
+
+        printf("%4d %4d %12.1f %12.1f %12.1f %12.1f %12.1f %12.3e\n", nx, nu, time_direct,
+               time_convert, time_zero_copy, time_convert - time_direct,
+               time_zero_copy - time_direct, max_diff);
+
+        external_function_casadi_free(&fun);
+        blasfeo_free_dvec(&sx);
+        blasfeo_free_dvec(&su);
+        blasfeo_free_dvec(&sf0);
+        blasfeo_free_dvec(&sf1);
+        blasfeo_free_dmat(&sJ0);
+        blasfeo_free_dmat(&sJ1);
+        free(model_AB);
+        free(x);
+        free(u);
+        free(f);
+        free(J);
+    }
+
+    printf("\n");
+
+    return 0;
+}
@@ -0,0 +1,1061 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+// Benchmark of the OCP NLP solvers on a fixed set of problems and solver configurations.
+// Every configuration is solved n_warmup + n_rep times from the same initial guess, the
+// timings of the last n_rep solves are summarized and written to a JSON file; for SQP, the
+// globalizations (fixed step, merit backtracking, filter line search) are compared by iterations
+// and time:
+//
+//   bench_ocp_nlp [output.json] [n_rep] [n_warmup]
+
+// standard
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+// acados
+#include "acados_c/external_function_interface.h"
+#include "acados_c/ocp_nlp_interface.h"
+#include "acados/utils/timing.h"
+#include "acados/utils/types.h"
+// models
+#include "examples/c/chain_model/chain_model.h"
+#include "examples/c/implicit_chain_model/chain_model_impl.h"
+#include "examples/c/crane_model/crane_model.h"
+#include "examples/c/pendulum_model/pendulum_model.h"
+#include "examples/c/wt_model_nx6/nx6p2/wt_model.h"
+
+#include "examples/c/chain_model/x0_nm2.c"
+#include "examples/c/chain_model/x0_nm3.c"
+#include "examples/c/chain_model/x0_nm4.c"
+#include "examples/c/chain_model/xN_nm2.c"
+#include "examples/c/chain_model/xN_nm3.c"
+#include "examples/c/chain_model/xN_nm4.c"
+// wind turbine: x0_ref, u0_ref, wind0_ref, y_ref
+#include "examples/c/wt_model_nx6/setup.c"
+
+#define MAX_SQP_ITER 50
+#define N_WARMUP 5
+#define N_REP 50
+
+#define BENCH_CASADI_FUN(fun) \
+    { .casadi_fun = &fun, .casadi_work = &fun##_work, \
+      .casadi_sparsity_in = &fun##_sparsity_in, .casadi_sparsity_out = &fun##_sparsity_out, \
+      .casadi_n_in = &fun##_n_in, .casadi_n_out = &fun##_n_out }
+
+
+
+/************************************************
+ * problems
+ ************************************************/
+
+typedef struct bench_problem_ bench_problem;
+typedef struct bench_config_ bench_config;
+typedef struct bench_result_ bench_result;
+
+struct bench_problem_
+{
+    const char *name;
+    int nx;
+    int nu;
+    int N;
+    double T;
+    double umax;
+    double *x0;
+    double *xref;
+    // ERK
+    external_function_casadi expl_vde_for;
+    // IRK
+    external_function_casadi impl_ode_fun;
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    const char *impl_ode_fun_jac_x_xdot_field;
+    const char *impl_ode_jac_x_xdot_u_field;
+    // GNSF model functions available (only generated for the wind turbine)
+    int gnsf;
+    // problems with their own formulation; NULL for the tracking problem of bench_run
+    void (*run)(bench_problem *prob, bench_config *cfg, int n_warmup, int n_rep,
+                bench_result *res);
+};
+
+static void bench_run_wind_turbine(bench_problem *prob, bench_config *cfg, int n_warmup,
+                                   int n_rep, bench_result *res);
+
+static double x0_cartpole[] = {0.0, 0.3, 0.0, 0.0};
+static double xref_cartpole[] = {0.0, 0.0, 0.0, 0.0};
+
+static bench_problem problems[] = {
+    {"chain_nm2", 6, 3, 20, 5.0, 10.0, x0_nm2, xN_nm2,
+     BENCH_CASADI_FUN(vde_chain_nm2),
+     BENCH_CASADI_FUN(casadi_impl_ode_fun_chain_nm2),
+     BENCH_CASADI_FUN(casadi_impl_ode_fun_jac_x_xdot_chain_nm2),
+     BENCH_CASADI_FUN(casadi_impl_ode_jac_x_xdot_u_chain_nm2),
+     "impl_ode_fun_jac_x_xdot", "impl_ode_jac_x_xdot_u"},
+    {"chain_nm3", 12, 3, 20, 5.0, 10.0, x0_nm3, xN_nm3,
+     BENCH_CASADI_FUN(vde_chain_nm3),
+     BENCH_CASADI_FUN(casadi_impl_ode_fun_chain_nm3),
+     BENCH_CASADI_FUN(casadi_impl_ode_fun_jac_x_xdot_chain_nm3),
+     BENCH_CASADI_FUN(casadi_impl_ode_jac_x_xdot_u_chain_nm3),
+     "impl_ode_fun_jac_x_xdot", "impl_ode_jac_x_xdot_u"},
+    {"chain_nm4", 18, 3, 20, 5.0, 10.0, x0_nm4, xN_nm4,
+     BENCH_CASADI_FUN(vde_chain_nm4),
+     BENCH_CASADI_FUN(casadi_impl_ode_fun_chain_nm4),
+     BENCH_CASADI_FUN(casadi_impl_ode_fun_jac_x_xdot_chain_nm4),
+     BENCH_CASADI_FUN(casadi_impl_ode_jac_x_xdot_u_chain_nm4),
+     "impl_ode_fun_jac_x_xdot", "impl_ode_jac_x_xdot_u"},
+    {"crane", 4, 1, 20, 2.0, 10.0, x0_cartpole, xref_cartpole,
+     BENCH_CASADI_FUN(vdeFun),
+     BENCH_CASADI_FUN(casadi_impl_ode_fun),
+     BENCH_CASADI_FUN(casadi_impl_ode_fun_jac_x_xdot),
+     BENCH_CASADI_FUN(casadi_impl_ode_jac_x_xdot_u),
+     "impl_ode_fun_jac_x_xdot", "impl_ode_jac_x_xdot_u"},
+    {"pendulum", 4, 1, 20, 2.0, 40.0, x0_cartpole, xref_cartpole,
+     BENCH_CASADI_FUN(pendulum_ode_expl_vde_forw),
+     BENCH_CASADI_FUN(pendulum_ode_impl_ode_fun),
+     BENCH_CASADI_FUN(pendulum_ode_impl_ode_fun_jac_x_xdot_z),
+     BENCH_CASADI_FUN(pendulum_ode_impl_ode_jac_x_xdot_u_z),
+     "impl_ode_fun_jac_x_xdot_z", "impl_ode_jac_x_xdot_u_z"},
+    // the wind turbine of examples/c/wind_turbine_nmpc.c, parametric in the wind speed
+    {.name = "wind_turb", .nx = 8, .nu = 2, .N = 40, .x0 = x0_ref, .gnsf = 1,
+     .run = &bench_run_wind_turbine},
+};
+
+
+
+/************************************************
+ * solver configurations
+ ************************************************/
+
+struct bench_config_
+{
+    ocp_nlp_solver_t nlp_solver;
+    ocp_qp_solver_t qp_solver;
+    sim_solver_t sim_solver;
+    const char *globalization;
+};
+
+static ocp_nlp_solver_t nlp_solvers[] = {SQP, SQP_RTI};
+
+// compared for SQP; SQP_RTI takes full steps
+static const char *globalizations[] = {"fixed_step", "merit_backtracking", "filter_line_search"};
+
+static ocp_qp_solver_t qp_solvers[] = {
+    PARTIAL_CONDENSING_HPIPM,
+    FULL_CONDENSING_HPIPM,
+#ifdef ACADOS_WITH_QPOASES
+    FULL_CONDENSING_QPOASES,
+#endif
+#ifdef ACADOS_WITH_OSQP
+    PARTIAL_CONDENSING_OSQP,
+#endif
+};
+
+// GNSF only for problems with GNSF model functions, see bench_problem.gnsf
+static sim_solver_t sim_solvers[] = {ERK, ERK_INTERLEAVED, IRK, GNSF};
+
+
+
+static const char *nlp_solver_name(ocp_nlp_solver_t solver)
+{
+    switch (solver)
+    {
+        case SQP:
+            return "SQP";
+        case SQP_RTI:
+            return "SQP_RTI";
+        default:
+            return "unknown";
+    }
+}
+
+
+
+static const char *qp_solver_name(ocp_qp_solver_t solver)
+{
+    switch (solver)
+    {
+        case PARTIAL_CONDENSING_HPIPM:
+            return "PARTIAL_CONDENSING_HPIPM";
+        case FULL_CONDENSING_HPIPM:
+            return "FULL_CONDENSING_HPIPM";
+#ifdef ACADOS_WITH_QPOASES
+        case FULL_CONDENSING_QPOASES:
+            return "FULL_CONDENSING_QPOASES";
+#endif
+#ifdef ACADOS_WITH_OSQP
+        case PARTIAL_CONDENSING_OSQP:
+            return "PARTIAL_CONDENSING_OSQP";
+#endif
+        default:
+            return "unknown";
+    }
+}
+
+
+
+static const char *sim_solver_name(sim_solver_t solver)
+{
+    switch (solver)
+    {
+        case ERK:
+            return "ERK";
+        case ERK_INTERLEAVED:
+            return "ERK_INTERLEAVED";
+        case IRK:
+            return "IRK";
+        case GNSF:
+            return "GNSF";
+        default:
+            return "unknown";
+    }
+}
+
+
+
+/************************************************
+ * benchmark
+ ************************************************/
+
+struct bench_result_
+{
+    int status;
+    int sqp_iter;
+    double time_min;
+    double time_median;
+    double time_p99;
+    double time_mean;
+    double time_lin;
+    double time_qp_sol;
+};
+
+
+
+static int compare_double(const void *a, const void *b)
+{
+    double da = *(const double *) a;
+    double db = *(const double *) b;
+    return (da > db) - (da < db);
+}
+
+
+
+// solver options common to all problems
+static void *bench_opts_create(ocp_nlp_config *config, ocp_nlp_dims *dims, bench_config *cfg,
+                               int sim_ns, int sim_steps)
+{
+    int N = dims->N;
+
+    void *nlp_opts = ocp_nlp_solver_opts_create(config, dims);
+
+    int max_iter = MAX_SQP_ITER;
+    double tol = 1e-6;
+
+    for (int i = 0; i < N; i++)
+    {
+        ocp_nlp_solver_opts_set_at_stage(config, nlp_opts, i, "dynamics_ns", &sim_ns);
+        ocp_nlp_solver_opts_set_at_stage(config, nlp_opts, i, "dynamics_num_steps", &sim_steps);
+    }
+
+    if (cfg->nlp_solver == SQP)
+    {
+        ocp_nlp_solver_opts_set(config, nlp_opts, "globalization", (void *) cfg->globalization);
+        ocp_nlp_solver_opts_set(config, nlp_opts, "max_iter", &max_iter);
+        ocp_nlp_solver_opts_set(config, nlp_opts, "tol_stat", &tol);
+        ocp_nlp_solver_opts_set(config, nlp_opts, "tol_eq", &tol);
+        ocp_nlp_solver_opts_set(config, nlp_opts, "tol_ineq", &tol);
+        ocp_nlp_solver_opts_set(config, nlp_opts, "tol_comp", &tol);
+    }
+
+    if (cfg->qp_solver == PARTIAL_CONDENSING_HPIPM)
+    {
+        int cond_N = N / 4;
+        ocp_nlp_solver_opts_set(config, nlp_opts, "qp_cond_N", &cond_N);
+    }
+
+    return nlp_opts;
+}
+
+
+
+// solves n_warmup + n_rep times from the initial guess x = x0, u = 0 and summarizes the timings
+// of the last n_rep solves
+static void bench_solve(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
+                        void *nlp_opts, double *x0, int n_warmup, int n_rep, bench_result *res)
+{
+    int N = dims->N;
+
+    ocp_nlp_out *nlp_out = ocp_nlp_out_create(config, dims);
+    ocp_nlp_solver *solver = ocp_nlp_solver_create(config, dims, nlp_opts);
+    ocp_nlp_precompute(solver, nlp_in, nlp_out);
+
+    double *u0 = calloc(dims->nu[0], sizeof(double));
+    double *times = malloc(n_rep * sizeof(double));
+
+    acados_timer timer;
+
+    res->status = ACADOS_SUCCESS;
+    for (int rep = 0; rep < n_warmup + n_rep; rep++)
+    {
+        // same initial guess in every repetition
+        for (int i = 0; i <= N; i++)
+        {
+            ocp_nlp_out_set(config, dims, nlp_out, i, "x", x0);
+            if (i < N)
+                ocp_nlp_out_set(config, dims, nlp_out, i, "u", u0);
+        }
+
+        acados_tic(&timer);
+        int status = ocp_nlp_solve(solver, nlp_in, nlp_out);
+        double time = acados_toc(&timer);
+
+        if (rep >= n_warmup)
+        {
+            times[rep - n_warmup] = time;
+            if (status != ACADOS_SUCCESS)
+                res->status = status;
+        }
+    }
+
+    ocp_nlp_get(config, solver, "sqp_iter", &res->sqp_iter);
+    ocp_nlp_get(config, solver, "time_lin", &res->time_lin);
+    ocp_nlp_get(config, solver, "time_qp_sol", &res->time_qp_sol);
+
+    qsort(times, n_rep, sizeof(double), compare_double);
+    res->time_min = times[0];
+    res->time_median = n_rep % 2 ? times[n_rep / 2]
+                                 : 0.5 * (times[n_rep / 2 - 1] + times[n_rep / 2]);
+    int idx_p99 = (int) ceil(0.99 * n_rep) - 1;
+    res->time_p99 = times[idx_p99 < 0 ? 0 : idx_p99];
+    res->time_mean = 0.0;
+    for (int rep = 0; rep < n_rep; rep++)
+        res->time_mean += times[rep];
+    res->time_mean /= n_rep;
+
+    ocp_nlp_solver_destroy(solver);
+    ocp_nlp_out_destroy(nlp_out);
+
+    free(u0);
+    free(times);
+}
+
+
+
+static void bench_run(bench_problem *prob, bench_config *cfg, int n_warmup, int n_rep,
+                      bench_result *res)
+{
+    int N = prob->N;
+    int nx_ = prob->nx;
+    int nu_ = prob->nu;
+    int ny_ = nx_ + nu_;
+
+    /************************************************
+    * dimensions
+    ************************************************/
+
+    int *nx = malloc((N + 1) * sizeof(int));
+    int *nu = malloc((N + 1) * sizeof(int));
+    int *nz = malloc((N + 1) * sizeof(int));
+    int *ns = malloc((N + 1) * sizeof(int));
+    int *ny = malloc((N + 1) * sizeof(int));
+    int *nbx = malloc((N + 1) * sizeof(int));
+    int *nbu = malloc((N + 1) * sizeof(int));
+    int *ng = malloc((N + 1) * sizeof(int));
+    int *nh = malloc((N + 1) * sizeof(int));
+
+    for (int i = 0; i <= N; i++)
+    {
+        nx[i] = nx_;
+        nu[i] = i < N ? nu_ : 0;
+        nz[i] = 0;
+        ns[i] = 0;
+        ny[i] = nx[i] + nu[i];
+        nbx[i] = i == 0 ? nx_ : 0;
+        nbu[i] = nu[i];
+        ng[i] = 0;
+        nh[i] = 0;
+    }
+
+    /************************************************
+    * plan + config + dims
+    ************************************************/
+
+    ocp_nlp_plan *plan = ocp_nlp_plan_create(N);
+
+    plan->nlp_solver = cfg->nlp_solver;
+    plan->ocp_qp_solver_plan.qp_solver = cfg->qp_solver;
+
+    for (int i = 0; i <= N; i++)
+    {
+        plan->nlp_cost[i] = LINEAR_LS;
+        plan->nlp_constraints[i] = BGH;
+    }
+    for (int i = 0; i < N; i++)
+    {
+        plan->nlp_dynamics[i] = CONTINUOUS_MODEL;
+        plan->sim_solver_plan[i].sim_solver = cfg->sim_solver;
+    }
+
+    ocp_nlp_config *config = ocp_nlp_config_create(*plan);
+
+    ocp_nlp_dims *dims = ocp_nlp_dims_create(config);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nx", nx);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nu", nu);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nz", nz);
+    ocp_nlp_dims_set_opt_vars(config, dims, "ns", ns);
+
+    for (int i = 0; i <= N; i++)
+    {
+        ocp_nlp_dims_set_cost(config, dims, i, "ny", &ny[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbx", &nbx[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbu", &nbu[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "ng", &ng[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nh", &nh[i]);
+    }
+
+    /************************************************
+    * external functions
+    ************************************************/
+
+    external_function_casadi *expl_vde_for = malloc(N * sizeof(external_function_casadi));
+    external_function_casadi *impl_ode_fun = malloc(N * sizeof(external_function_casadi));
+    external_function_casadi *impl_ode_fun_jac_x_xdot = malloc(N * sizeof(external_function_casadi));
+    external_function_casadi *impl_ode_jac_x_xdot_u = malloc(N * sizeof(external_function_casadi));
+
+    for (int i = 0; i < N; i++)
+    {
+        expl_vde_for[i] = prob->expl_vde_for;
+        impl_ode_fun[i] = prob->impl_ode_fun;
+        impl_ode_fun_jac_x_xdot[i] = prob->impl_ode_fun_jac_x_xdot;
+        impl_ode_jac_x_xdot_u[i] = prob->impl_ode_jac_x_xdot_u;
+    }
+
+    if (cfg->sim_solver != IRK)
+    {
+        external_function_casadi_create_array(N, expl_vde_for);
+    }
+    else
+    {
+        external_function_casadi_create_array(N, impl_ode_fun);
+        external_function_casadi_create_array(N, impl_ode_fun_jac_x_xdot);
+        external_function_casadi_create_array(N, impl_ode_jac_x_xdot_u);
+    }
+
+    /************************************************
+    * nlp_in
+    ************************************************/
+
+    ocp_nlp_in *nlp_in = ocp_nlp_in_create(config, dims);
+
+    for (int i = 0; i < N; i++)
+        nlp_in->Ts[i] = prob->T / N;
+
+    // cost: least squares tracking of xref
+    double *Vx = calloc(ny_ * nx_, sizeof(double));
+    double *Vu = calloc(ny_ * nu_, sizeof(double));
+    double *W = calloc(ny_ * ny_, sizeof(double));
+    double *yref = calloc(ny_, sizeof(double));
+    for (int j = 0; j < nx_; j++)
+    {
+        Vx[j * (ny_ + 1)] = 1.0;
+        W[j * (ny_ + 1)] = 1.0;
+        yref[j] = prob->xref[j];
+    }
+    for (int j = 0; j < nu_; j++)
+    {
+        Vu[nx_ + j * (ny_ + 1)] = 1.0;
+        W[(nx_ + j) * (ny_ + 1)] = 1e-2;
+    }
+
+    for (int i = 0; i < N; i++)
+    {
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "Vx", Vx);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "Vu", Vu);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "W", W);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "yref", yref);
+    }
+
+    double *VxN = calloc(nx_ * nx_, sizeof(double));
+    double *WN = calloc(nx_ * nx_, sizeof(double));
+    for (int j = 0; j < nx_; j++)
+    {
+        VxN[j * (nx_ + 1)] = 1.0;
+        WN[j * (nx_ + 1)] = 1.0;
+    }
+    ocp_nlp_cost_model_set(config, dims, nlp_in, N, "Vx", VxN);
+    ocp_nlp_cost_model_set(config, dims, nlp_in, N, "W", WN);
+    ocp_nlp_cost_model_set(config, dims, nlp_in, N, "yref", yref);
+
+    // dynamics
+    for (int i = 0; i < N; i++)
+    {
+        int set_fun_status = 0;
+        if (cfg->sim_solver != IRK)
+        {
+            set_fun_status |= ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                    "expl_vde_for", &expl_vde_for[i]);
+        }
+        else
+        {
+            set_fun_status |= ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                    "impl_ode_fun", &impl_ode_fun[i]);
+            set_fun_status |= ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                    prob->impl_ode_fun_jac_x_xdot_field, &impl_ode_fun_jac_x_xdot[i]);
+            set_fun_status |= ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                    prob->impl_ode_jac_x_xdot_u_field, &impl_ode_jac_x_xdot_u[i]);
+        }
+        if (set_fun_status != 0)
+            exit(1);
+    }
+
+    // constraints
+    int *idxbx0 = malloc(nx_ * sizeof(int));
+    for (int j = 0; j < nx_; j++)
+        idxbx0[j] = j;
+    int *idxbu = malloc(nu_ * sizeof(int));
+    double *lbu = malloc(nu_ * sizeof(double));
+    double *ubu = malloc(nu_ * sizeof(double));
+    for (int j = 0; j < nu_; j++)
+    {
+        idxbu[j] = j;
+        lbu[j] = -prob->umax;
+        ubu[j] = prob->umax;
+    }
+
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "idxbx", idxbx0);
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "lbx", prob->x0);
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "ubx", prob->x0);
+    for (int i = 0; i < N; i++)
+    {
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, i, "idxbu", idxbu);
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, i, "lbu", lbu);
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, i, "ubu", ubu);
+    }
+
+    /************************************************
+    * opts
+    ************************************************/
+
+    int sim_ns = cfg->sim_solver != IRK ? 4 : 2;
+    void *nlp_opts = bench_opts_create(config, dims, cfg, sim_ns, 1);
+
+    /************************************************
+    * solve
+    ************************************************/
+
+    bench_solve(config, dims, nlp_in, nlp_opts, prob->x0, n_warmup, n_rep, res);
+
+    /************************************************
+    * free memory
+    ************************************************/
+
+    ocp_nlp_solver_opts_destroy(nlp_opts);
+    ocp_nlp_in_destroy(nlp_in);
+
+    if (cfg->sim_solver != IRK)
+    {
+        external_function_casadi_free_array(N, expl_vde_for);
+    }
+    else
+    {
+        external_function_casadi_free_array(N, impl_ode_fun);
+        external_function_casadi_free_array(N, impl_ode_fun_jac_x_xdot);
+        external_function_casadi_free_array(N, impl_ode_jac_x_xdot_u);
+    }
+    free(expl_vde_for);
+    free(impl_ode_fun);
+    free(impl_ode_fun_jac_x_xdot);
+    free(impl_ode_jac_x_xdot_u);
+
+    ocp_nlp_dims_destroy(dims);
+    ocp_nlp_config_destroy(config);
+    ocp_nlp_plan_destroy(plan);
+
+    free(nx);
+    free(nu);
+    free(nz);
+    free(ns);
+    free(ny);
+    free(nbx);
+    free(nbu);
+    free(ng);
+    free(nh);
+
+    free(Vx);
+    free(Vu);
+    free(W);
+    free(yref);
+    free(VxN);
+    free(WN);
+    free(idxbx0);
+    free(idxbu);
+    free(lbu);
+    free(ubu);
+}
+
+
+// wind turbine: tracking of the rotor speed and electrical power reference with bounds on the
+// input rates, the rotor speed, the pitch angle and the generator torque; the soft bound on the
+// electrical power of the example is left out, it needs a hand-written constraint function
+static void bench_run_wind_turbine(bench_problem *prob, bench_config *cfg, int n_warmup,
+                                   int n_rep, bench_result *res)
+{
+    int N = prob->N;
+    int nx_ = prob->nx;
+    int nu_ = prob->nu;
+    int ny_ = 4;
+    int np = 1;
+
+    /************************************************
+    * dimensions
+    ************************************************/
+
+    int *nx = malloc((N + 1) * sizeof(int));
+    int *nu = malloc((N + 1) * sizeof(int));
+    int *nz = malloc((N + 1) * sizeof(int));
+    int *ns = malloc((N + 1) * sizeof(int));
+    int *ny = malloc((N + 1) * sizeof(int));
+    int *nbx = malloc((N + 1) * sizeof(int));
+    int *nbu = malloc((N + 1) * sizeof(int));
+    int *ng = malloc((N + 1) * sizeof(int));
+    int *nh = malloc((N + 1) * sizeof(int));
+
+    for (int i = 0; i <= N; i++)
+    {
+        nx[i] = nx_;
+        nu[i] = i < N ? nu_ : 0;
+        nz[i] = 0;
+        ns[i] = 0;
+        ny[i] = i < N ? ny_ : 2;
+        nbx[i] = i == 0 ? nx_ : 3;
+        nbu[i] = nu[i];
+        ng[i] = 0;
+        nh[i] = 0;
+    }
+
+    /************************************************
+    * plan + config + dims
+    ************************************************/
+
+    ocp_nlp_plan *plan = ocp_nlp_plan_create(N);
+
+    plan->nlp_solver = cfg->nlp_solver;
+    plan->ocp_qp_solver_plan.qp_solver = cfg->qp_solver;
+
+    for (int i = 0; i <= N; i++)
+    {
+        plan->nlp_cost[i] = LINEAR_LS;
+        plan->nlp_constraints[i] = BGH;
+    }
+    for (int i = 0; i < N; i++)
+    {
+        plan->nlp_dynamics[i] = CONTINUOUS_MODEL;
+        plan->sim_solver_plan[i].sim_solver = cfg->sim_solver;
+    }
+
+    ocp_nlp_config *config = ocp_nlp_config_create(*plan);
+
+    ocp_nlp_dims *dims = ocp_nlp_dims_create(config);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nx", nx);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nu", nu);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nz", nz);
+    ocp_nlp_dims_set_opt_vars(config, dims, "ns", ns);
+
+    for (int i = 0; i <= N; i++)
+    {
+        ocp_nlp_dims_set_cost(config, dims, i, "ny", &ny[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbx", &nbx[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbu", &nbu[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "ng", &ng[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nh", &nh[i]);
+    }
+
+    /************************************************
+    * external functions
+    ************************************************/
+
+    external_function_param_casadi expl_vde_for_fun = BENCH_CASADI_FUN(wt_nx6p2_expl_vde_for);
+    external_function_param_casadi impl_ode_fun_fun = BENCH_CASADI_FUN(wt_nx6p2_impl_ode_fun);
+    external_function_param_casadi impl_ode_fun_jac_x_xdot_fun =
+        BENCH_CASADI_FUN(wt_nx6p2_impl_ode_fun_jac_x_xdot);
+    external_function_param_casadi impl_ode_jac_x_xdot_u_fun =
+        BENCH_CASADI_FUN(wt_nx6p2_impl_ode_jac_x_xdot_u);
+    external_function_param_casadi phi_fun_fun = BENCH_CASADI_FUN(wt_nx6p2_phi_fun);
+    external_function_param_casadi phi_fun_jac_y_fun = BENCH_CASADI_FUN(wt_nx6p2_phi_fun_jac_y);
+    external_function_param_casadi phi_jac_y_uhat_fun = BENCH_CASADI_FUN(wt_nx6p2_phi_jac_y_uhat);
+    external_function_param_casadi f_lo_fun = BENCH_CASADI_FUN(wt_nx6p2_f_lo_fun_jac_x1k1uz);
+    external_function_casadi get_matrices_fun = BENCH_CASADI_FUN(wt_nx6p2_get_matrices_fun);
+
+    external_function_param_casadi *expl_vde_for =
+        malloc(N * sizeof(external_function_param_casadi));
+    external_function_param_casadi *impl_ode_fun =
+        malloc(N * sizeof(external_function_param_casadi));
+    external_function_param_casadi *impl_ode_fun_jac_x_xdot =
+        malloc(N * sizeof(external_function_param_casadi));
+    external_function_param_casadi *impl_ode_jac_x_xdot_u =
+        malloc(N * sizeof(external_function_param_casadi));
+    external_function_param_casadi *phi_fun = malloc(N * sizeof(external_function_param_casadi));
+    external_function_param_casadi *phi_fun_jac_y =
+        malloc(N * sizeof(external_function_param_casadi));
+    external_function_param_casadi *phi_jac_y_uhat =
+        malloc(N * sizeof(external_function_param_casadi));
+    external_function_param_casadi *f_lo_jac_x1_x1dot_u_z =
+        malloc(N * sizeof(external_function_param_casadi));
+
+    for (int i = 0; i < N; i++)
+    {
+        expl_vde_for[i] = expl_vde_for_fun;
+        impl_ode_fun[i] = impl_ode_fun_fun;
+        impl_ode_fun_jac_x_xdot[i] = impl_ode_fun_jac_x_xdot_fun;
+        impl_ode_jac_x_xdot_u[i] = impl_ode_jac_x_xdot_u_fun;
+        phi_fun[i] = phi_fun_fun;
+        phi_fun_jac_y[i] = phi_fun_jac_y_fun;
+        phi_jac_y_uhat[i] = phi_jac_y_uhat_fun;
+        f_lo_jac_x1_x1dot_u_z[i] = f_lo_fun;
+    }
+
+    // wind speed of the first sampling times as parameter
+    if (cfg->sim_solver == GNSF)
+    {
+        external_function_param_casadi_create_array(N, phi_fun, np);
+        external_function_param_casadi_create_array(N, phi_fun_jac_y, np);
+        external_function_param_casadi_create_array(N, phi_jac_y_uhat, np);
+        external_function_param_casadi_create_array(N, f_lo_jac_x1_x1dot_u_z, np);
+        external_function_casadi_create(&get_matrices_fun);
+        for (int i = 0; i < N; i++)
+        {
+            phi_fun[i].set_param(phi_fun + i, wind0_ref + i);
+            phi_fun_jac_y[i].set_param(phi_fun_jac_y + i, wind0_ref + i);
+            phi_jac_y_uhat[i].set_param(phi_jac_y_uhat + i, wind0_ref + i);
+            f_lo_jac_x1_x1dot_u_z[i].set_param(f_lo_jac_x1_x1dot_u_z + i, wind0_ref + i);
+        }
+
+        int gnsf_nx1 = 8;
+        int gnsf_nz1 = 0;
+        int gnsf_nout = 1;
+        int gnsf_ny = 5;
+        int gnsf_nuhat = 0;
+        for (int i = 0; i < N; i++)
+        {
+            ocp_nlp_dims_set_dynamics(config, dims, i, "gnsf_nx1", &gnsf_nx1);
+            ocp_nlp_dims_set_dynamics(config, dims, i, "gnsf_nz1", &gnsf_nz1);
+            ocp_nlp_dims_set_dynamics(config, dims, i, "gnsf_nout", &gnsf_nout);
+            ocp_nlp_dims_set_dynamics(config, dims, i, "gnsf_ny", &gnsf_ny);
+            ocp_nlp_dims_set_dynamics(config, dims, i, "gnsf_nuhat", &gnsf_nuhat);
+        }
+    }
+    else if (cfg->sim_solver != IRK)
+    {
+        external_function_param_casadi_create_array(N, expl_vde_for, np);
+        for (int i = 0; i < N; i++)
+            expl_vde_for[i].set_param(expl_vde_for + i, wind0_ref + i);
+    }
+    else
+    {
+        external_function_param_casadi_create_array(N, impl_ode_fun, np);
+        external_function_param_casadi_create_array(N, impl_ode_fun_jac_x_xdot, np);
+        external_function_param_casadi_create_array(N, impl_ode_jac_x_xdot_u, np);
+        for (int i = 0; i < N; i++)
+        {
+            impl_ode_fun[i].set_param(impl_ode_fun + i, wind0_ref + i);
+            impl_ode_fun_jac_x_xdot[i].set_param(impl_ode_fun_jac_x_xdot + i, wind0_ref + i);
+            impl_ode_jac_x_xdot_u[i].set_param(impl_ode_jac_x_xdot_u + i, wind0_ref + i);
+        }
+    }
+
+    /************************************************
+    * nlp_in
+    ************************************************/
+
+    ocp_nlp_in *nlp_in = ocp_nlp_in_create(config, dims);
+
+    for (int i = 0; i < N; i++)
+        nlp_in->Ts[i] = 0.2;
+
+    // cost: y = [x[0]; x[4]; u[0]; u[1]], terminal y = [x[0]; x[4]]
+    double *Vx = calloc(ny_ * nx_, sizeof(double));
+    double *Vu = calloc(ny_ * nu_, sizeof(double));
+    double *W = calloc(ny_ * ny_, sizeof(double));
+    double *VxN = calloc(2 * nx_, sizeof(double));
+    double *WN = calloc(2 * 2, sizeof(double));
+
+    Vx[0 + ny_ * 0] = 1.0;
+    Vx[1 + ny_ * 4] = 1.0;
+    Vu[2 + ny_ * 0] = 1.0;
+    Vu[3 + ny_ * 1] = 1.0;
+    VxN[0 + 2 * 0] = 1.0;
+    VxN[1 + 2 * 4] = 1.0;
+
+    W[0 + ny_ * 0] = 1.5114;
+    W[1 + ny_ * 0] = -0.0649;
+    W[0 + ny_ * 1] = -0.0649;
+    W[1 + ny_ * 1] = 0.0180;
+    W[2 + ny_ * 2] = 0.01;
+    W[3 + ny_ * 3] = 0.001;
+    WN[0 + 2 * 0] = 1.5114;
+    WN[1 + 2 * 0] = -0.0649;
+    WN[0 + 2 * 1] = -0.0649;
+    WN[1 + 2 * 1] = 0.0180;
+
+    for (int i = 0; i < N; i++)
+    {
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "Vx", Vx);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "Vu", Vu);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "W", W);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "yref", y_ref + 4 * i);
+    }
+    ocp_nlp_cost_model_set(config, dims, nlp_in, N, "Vx", VxN);
+    ocp_nlp_cost_model_set(config, dims, nlp_in, N, "W", WN);
+    ocp_nlp_cost_model_set(config, dims, nlp_in, N, "yref", y_ref + 4 * N);
+
+    // dynamics
+    for (int i = 0; i < N; i++)
+    {
+        int set_fun_status = 0;
+        if (cfg->sim_solver == GNSF)
+        {
+            set_fun_status |= ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                    "phi_fun", &phi_fun[i]);
+            set_fun_status |= ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                    "phi_fun_jac_y", &phi_fun_jac_y[i]);
+            set_fun_status |= ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                    "phi_jac_y_uhat", &phi_jac_y_uhat[i]);
+            set_fun_status |= ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                    "f_lo_jac_x1_x1dot_u_z", &f_lo_jac_x1_x1dot_u_z[i]);
+            set_fun_status |= ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                    "get_gnsf_matrices", &get_matrices_fun);
+        }
+        else if (cfg->sim_solver != IRK)
+        {
+            set_fun_status |= ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                    "expl_vde_for", &expl_vde_for[i]);
+        }
+        else
+        {
+            set_fun_status |= ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                    "impl_ode_fun", &impl_ode_fun[i]);
+            set_fun_status |= ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                    "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot[i]);
+            set_fun_status |= ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                    "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u[i]);
+        }
+        if (set_fun_status != 0)
+            exit(1);
+    }
+
+    // constraints: pitch angle rate and generator torque rate; rotor speed, pitch angle and
+    // generator torque
+    int idxbu[] = {0, 1};
+    double lbu[] = {-8.0, -1.0};
+    double ubu[] = {8.0, 1.0};
+    int idxbx[] = {0, 6, 7};
+    double lbx[] = {6.0 / 60 * 2 * 3.14159265359, 0.0, 0.0};
+    double ubx[] = {13.0 / 60 * 2 * 3.14159265359, 35.0, 5.0};
+
+    int *idxbx0 = malloc(nx_ * sizeof(int));
+    for (int j = 0; j < nx_; j++)
+        idxbx0[j] = j;
+
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "idxbx", idxbx0);
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "lbx", prob->x0);
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "ubx", prob->x0);
+    for (int i = 0; i <= N; i++)
+    {
+        if (i < N)
+        {
+            ocp_nlp_constraints_model_set(config, dims, nlp_in, i, "idxbu", idxbu);
+            ocp_nlp_constraints_model_set(config, dims, nlp_in, i, "lbu", lbu);
+            ocp_nlp_constraints_model_set(config, dims, nlp_in, i, "ubu", ubu);
+        }
+        if (i > 0)
+        {
+            ocp_nlp_constraints_model_set(config, dims, nlp_in, i, "idxbx", idxbx);
+            ocp_nlp_constraints_model_set(config, dims, nlp_in, i, "lbx", lbx);
+            ocp_nlp_constraints_model_set(config, dims, nlp_in, i, "ubx", ubx);
+        }
+    }
+
+    /************************************************
+    * opts
+    ************************************************/
+
+    // as in the example: ERK with 10 steps, IRK and GNSF with one step of 4 stages
+    int sim_steps = cfg->sim_solver == ERK || cfg->sim_solver == ERK_INTERLEAVED ? 10 : 1;
+    void *nlp_opts = bench_opts_create(config, dims, cfg, 4, sim_steps);
+
+    /************************************************
+    * solve
+    ************************************************/
+
+    bench_solve(config, dims, nlp_in, nlp_opts, prob->x0, n_warmup, n_rep, res);
+
+    /************************************************
+    * free memory
+    ************************************************/
+
+    ocp_nlp_solver_opts_destroy(nlp_opts);
+    ocp_nlp_in_destroy(nlp_in);
+
+    if (cfg->sim_solver == GNSF)
+    {
+        external_function_param_casadi_free_array(N, phi_fun);
+        external_function_param_casadi_free_array(N, phi_fun_jac_y);
+        external_function_param_casadi_free_array(N, phi_jac_y_uhat);
+        external_function_param_casadi_free_array(N, f_lo_jac_x1_x1dot_u_z);
+        external_function_casadi_free(&get_matrices_fun);
+    }
+    else if (cfg->sim_solver != IRK)
+    {
+        external_function_param_casadi_free_array(N, expl_vde_for);
+    }
+    else
+    {
+        external_function_param_casadi_free_array(N, impl_ode_fun);
+        external_function_param_casadi_free_array(N, impl_ode_fun_jac_x_xdot);
+        external_function_param_casadi_free_array(N, impl_ode_jac_x_xdot_u);
+    }
+    free(expl_vde_for);
+    free(impl_ode_fun);
+    free(impl_ode_fun_jac_x_xdot);
+    free(impl_ode_jac_x_xdot_u);
+    free(phi_fun);
+    free(phi_fun_jac_y);
+    free(phi_jac_y_uhat);
+    free(f_lo_jac_x1_x1dot_u_z);
+
+    ocp_nlp_dims_destroy(dims);
+    ocp_nlp_config_destroy(config);
+    ocp_nlp_plan_destroy(plan);
+
+    free(nx);
+    free(nu);
+    free(nz);
+    free(ns);
+    free(ny);
+    free(nbx);
+    free(nbu);
+    free(ng);
+    free(nh);
+
+    free(Vx);
+    free(Vu);
+    free(W);
+    free(VxN);
+    free(WN);
+    free(idxbx0);
+}
+
+
+
+int main(int argc, char **argv)
+{
+    const char *filename = argc > 1 ? argv[1] : "bench_ocp_nlp.json";
+    int n_rep = argc > 2 ? atoi(argv[2]) : N_REP;
+    int n_warmup = argc > 3 ? atoi(argv[3]) : N_WARMUP;
+
+    if (n_rep < 1)
+    {
+        printf("\nerror: bench_ocp_nlp: n_rep must be positive\n");
+        exit(1);
+    }
+
+    FILE *file = fopen(filename, "w");
+    if (file == NULL)
+    {
+        printf("\nerror: bench_ocp_nlp: cannot open %s\n", filename);
+        exit(1);
+    }
+
+    int n_problems = sizeof(problems) / sizeof(bench_problem);
+    int n_nlp_solvers = sizeof(nlp_solvers) / sizeof(ocp_nlp_solver_t);
+    int n_qp_solvers = sizeof(qp_solvers) / sizeof(ocp_qp_solver_t);
+    int n_sim_solvers = sizeof(sim_solvers) / sizeof(sim_solver_t);
+    int n_globalizations = sizeof(globalizations) / sizeof(const char *);
+
+    fprintf(file, "{\n  \"n_warmup\": %d,\n  \"n_rep\": %d,\n  \"results\": [", n_warmup, n_rep);
+
+    printf("\n%-10s %-8s %-26s %-9s %-18s %6s %4s %12s %12s\n", "problem", "nlp", "qp", "sim",
+           "globalization", "status", "iter", "median [ms]", "p99 [ms]");
+
+    int first = 1;
+    int status = 0;
+    bench_config cfg;
+    bench_result res;
+
+    for (int ip = 0; ip < n_problems; ip++)
+    for (int in = 0; in < n_nlp_solvers; in++)
+    for (int iq = 0; iq < n_qp_solvers; iq++)
+    for (int is = 0; is < n_sim_solvers; is++)
+    for (int ig = 0; ig < (nlp_solvers[in] == SQP ? n_globalizations : 1); ig++)
+    {
+        bench_problem *prob = problems + ip;
+        if (sim_solvers[is] == GNSF && !prob->gnsf)
+            continue;
+
+        cfg.nlp_solver = nlp_solvers[in];
+        cfg.qp_solver = qp_solvers[iq];
+        cfg.sim_solver = sim_solvers[is];
+        cfg.globalization = globalizations[ig];
+
+        if (prob->run != NULL)
+            prob->run(prob, &cfg, n_warmup, n_rep, &res);
+        else
+            bench_run(prob, &cfg, n_warmup, n_rep, &res);
+        if (res.status != ACADOS_SUCCESS)
+            status = 1;
+
+        printf("%-10s %-8s %-26s %-9s %-18s %6d %4d %12.4f %12.4f\n", prob->name,
+               nlp_solver_name(cfg.nlp_solver), qp_solver_name(cfg.qp_solver),
+               sim_solver_name(cfg.sim_solver), cfg.globalization, res.status, res.sqp_iter,
+               1e3 * res.time_median, 1e3 * res.time_p99);
+
+        fprintf(file, "%s\n    {\"problem\": \"%s\", \"nx\": %d, \"nu\": %d, \"N\": %d, "
+                "\"nlp_solver\": \"%s\", \"qp_solver\": \"%s\", \"sim_solver\": \"%s\", "
+                "\"globalization\": \"%s\", \"status\": %d, \"sqp_iter\": %d, "
+                "\"time_min\": %e, \"time_median\": %e, \"time_p99\": %e, \"time_mean\": %e, "
+                "\"time_lin\": %e, \"time_qp_sol\": %e}",
+                first ? "" : ",", prob->name, prob->nx, prob->nu, prob->N,
+                nlp_solver_name(cfg.nlp_solver), qp_solver_name(cfg.qp_solver),
+                sim_solver_name(cfg.sim_solver), cfg.globalization, res.status, res.sqp_iter,
+                res.time_min, res.time_median, res.time_p99, res.time_mean, res.time_lin,
+                res.time_qp_sol);
+        first = 0;
+    }
+
+    fprintf(file, "\n  ]\n}\n");
+    fclose(file);
+
+    printf("\nresults written to %s\n\n", filename);
+
+    return status;
+}
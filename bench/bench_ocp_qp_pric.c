@@ -0,0 +1,247 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// Long-horizon OCP QP: HPIPM (sequential Riccati recursion) against the partitioned Riccati
+// interior point method on 1..16 threads, on a random QP with state and input bounds, both
+// through PARTIAL_CONDENSING_* without condensing (qp_cond_N = N).
+//
+//   bench_ocp_qp_pric [N] [nx] [nu] [n_rep]
+
+// standard
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+// acados
+#include "acados/utils/math.h"
+#include "acados_c/ocp_qp_interface.h"
+
+#define N_REP 20
+#define MAX_THREADS 16
+
+
+
+static double rand_sym(void)
+{
+    return 2.0 * rand() / RAND_MAX - 1.0;
+}
+
+
+
+int main(int argc, char *argv[])
+{
+    int N = argc > 1 ? atoi(argv[1]) : 400;
+    int nx = argc > 2 ? atoi(argv[2]) : 8;
+    int nu = argc > 3 ? atoi(argv[3]) : 3;
+    int n_rep = argc > 4 ? atoi(argv[4]) : N_REP;
+
+    int nbx = nx / 2;
+    int nu_e = 0;
+
+    double *A = malloc(nx*nx*sizeof(double));
+    double *B = malloc(nx*nu*sizeof(double));
+    double *b = calloc(nx, sizeof(double));
+    double *Q = calloc(nx*nx, sizeof(double));
+    double *R = calloc(nu*nu, sizeof(double));
+    double *q = malloc(nx*sizeof(double));
+    double *r = calloc(nu, sizeof(double));
+    double *x0 = malloc(nx*sizeof(double));
+    int *idxbx0 = malloc(nx*sizeof(int));
+    int *idxbx = malloc(nbx*sizeof(int));
+    int *idxbu = malloc(nu*sizeof(int));
+    double *lbx = malloc(nbx*sizeof(double));
+    double *ubx = malloc(nbx*sizeof(double));
+    double *lbu = malloc(nu*sizeof(double));
+    double *ubu = malloc(nu*sizeof(double));
+
+    srand(1);
+    for (int ii = 0; ii < nx*nx; ii++)
+        A[ii] = 0.05 * rand_sym();
+    for (int ii = 0; ii < nx; ii++)
+        A[ii*(nx+1)] += 1.0;
+    for (int ii = 0; ii < nx*nu; ii++)
+        B[ii] = rand_sym();
+    for (int ii = 0; ii < nx; ii++)
+    {
+        Q[ii*(nx+1)] = 1.0;
+        q[ii] = 0.1 * rand_sym();
+        x0[ii] = rand_sym();
+        idxbx0[ii] = ii;
+    }
+    for (int ii = 0; ii < nu; ii++)
+    {
+        R[ii*(nu+1)] = 1.0;
+        idxbu[ii] = ii;
+        lbu[ii] = -0.5;
+        ubu[ii] = 0.5;
+    }
+    for (int ii = 0; ii < nbx; ii++)
+    {
+        idxbx[ii] = 2*ii;
+        lbx[ii] = -2.0;
+        ubx[ii] = 2.0;
+    }
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    plan.qp_solver = PARTIAL_CONDENSING_PRIC;
+    ocp_qp_xcond_solver_config *config_pric = ocp_qp_xcond_solver_config_create(plan);
+
+    ocp_qp_dims *dims = ocp_qp_dims_create(N);
+    for (int ii = 0; ii <= N; ii++)
+    {
+        ocp_qp_dims_set(config, dims, ii, "nx", &nx);
+        ocp_qp_dims_set(config, dims, ii, "nu", ii < N ? &nu : &nu_e);
+        if (ii < N)
+            ocp_qp_dims_set(config, dims, ii, "nbu", &nu);
+        ocp_qp_dims_set(config, dims, ii, "nbx", ii == 0 ? &nx : &nbx);
+    }
+    ocp_qp_dims_set(config, dims, 0, "nbxe", &nx);
+
+    ocp_qp_in *qp_in = ocp_qp_in_create(dims);
+    for (int ii = 0; ii <= N; ii++)
+    {
+        if (ii < N)
+        {
+            ocp_qp_in_set(config, qp_in, ii, "A", A);
+            ocp_qp_in_set(config, qp_in, ii, "B", B);
+            ocp_qp_in_set(config, qp_in, ii, "b", b);
+            ocp_qp_in_set(config, qp_in, ii, "R", R);
+            ocp_qp_in_set(config, qp_in, ii, "r", r);
+            ocp_qp_in_set(config, qp_in, ii, "idxbu", idxbu);
+            ocp_qp_in_set(config, qp_in, ii, "lbu", lbu);
+            ocp_qp_in_set(config, qp_in, ii, "ubu", ubu);
+        }
+        ocp_qp_in_set(config, qp_in, ii, "Q", Q);
+        ocp_qp_in_set(config, qp_in, ii, "q", q);
+        if (ii == 0)
+        {
+            ocp_qp_in_set(config, qp_in, ii, "idxbx", idxbx0);
+            ocp_qp_in_set(config, qp_in, ii, "lbx", x0);
+            ocp_qp_in_set(config, qp_in, ii, "ubx", x0);
+            ocp_qp_in_set(config, qp_in, ii, "idxbxe", idxbx0);
+        }
+        else
+        {
+            ocp_qp_in_set(config, qp_in, ii, "idxbx", idxbx);
+            ocp_qp_in_set(config, qp_in, ii, "lbx", lbx);
+            ocp_qp_in_set(config, qp_in, ii, "ubx", ubx);
+        }
+    }
+
+    ocp_qp_xcond_solver_dims *solver_dims = ocp_qp_xcond_solver_dims_create_from_ocp_qp_dims(config, dims);
+
+    ocp_qp_out *qp_out_ref = ocp_qp_out_create(dims);
+    ocp_qp_out *qp_out = ocp_qp_out_create(dims);
+
+    printf("\nN = %d, nx = %d, nu = %d, %d repetitions\n", N, nx, nu, n_rep);
+    printf("\n%8s %8s %14s %12s %12s %14s\n", "threads", "iter", "solve [ms]", "vs HPIPM",
+           "vs 1 thr", "max diff");
+
+    double time_hpipm = 0.0, time_one = 0.0;
+
+    // 0: HPIPM, then the partitioned Riccati on 1, 2, 4, 8, 16 threads
+    for (int num_threads = 0; num_threads <= MAX_THREADS; num_threads = num_threads ? 2*num_threads : 1)
+    {
+        ocp_qp_xcond_solver_config *solver_config = num_threads == 0 ? config : config_pric;
+
+        void *opts = ocp_qp_xcond_solver_opts_create(solver_config, solver_dims);
+        ocp_qp_xcond_solver_opts_set(solver_config, opts, "cond_N", &N);
+        if (num_threads > 0)
+            ocp_qp_xcond_solver_opts_set(solver_config, opts, "num_threads", &num_threads);
+        ocp_qp_solver *qp_solver = ocp_qp_create(solver_config, solver_dims, opts);
+
+        ocp_qp_out *out = num_threads == 0 ? qp_out_ref : qp_out;
+
+        double time_solve = 1e10;
+        int iter = 0;
+        for (int rep = 0; rep < n_rep; rep++)
+        {
+            int status = ocp_qp_solve(qp_solver, qp_in, out);
+            if (status != ACADOS_SUCCESS)
+                printf("\nqp solver returned status %d\n", status);
+
+            qp_info *info = (qp_info *) out->misc;
+            time_solve = MIN(time_solve, info->solve_QP_time);
+            iter = info->num_iter;
+        }
+
+        double max_diff = 0.0;
+        for (int ii = 0; ii <= N; ii++)
+        {
+            for (int jj = 0; jj < qp_out->ux[ii].m; jj++)
+                max_diff = fmax(max_diff, fabs(BLASFEO_DVECEL(out->ux+ii, jj) -
+                                               BLASFEO_DVECEL(qp_out_ref->ux+ii, jj)));
+        }
+
+        if (num_threads == 0)
+            time_hpipm = time_solve;
+        if (num_threads == 1)
+            time_one = time_solve;
+
+        printf("%8d %8d %14.3f %12.2f %12.2f %14.3e\n", num_threads, iter, 1e3*time_solve,
+               time_hpipm / time_solve, num_threads > 0 ? time_one / time_solve : 0.0, max_diff);
+
+        ocp_qp_solver_destroy(qp_solver);
+        ocp_qp_xcond_solver_opts_free(opts);
+    }
+
+    printf("\n");
+
+    ocp_qp_out_free(qp_out);
+    ocp_qp_out_free(qp_out_ref);
+    ocp_qp_in_free(qp_in);
+    ocp_qp_xcond_solver_dims_free(solver_dims);
+    ocp_qp_dims_free(dims);
+    ocp_qp_xcond_solver_config_free(config_pric);
+    ocp_qp_xcond_solver_config_free(config);
+
+    free(A);
+    free(B);
+    free(b);
+    free(Q);
+    free(R);
+    free(q);
+    free(r);
+    free(x0);
+    free(idxbx0);
+    free(idxbx);
+    free(idxbu);
+    free(lbx);
+    free(ubx);
+    free(lbu);
+    free(ubu);
+
+    return 0;
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+// Automatic choice of the partial condensing horizon ("cond_N_auto"): the horizon predicted best
+// by the calibrated cost model against the one measured best, solving a random QP with state and
+// input bounds with PARTIAL_CONDENSING_HPIPM for every N2 = 1, ..., N.
+//
+//   bench_pcond_auto [N] [nx] [nu] [n_rep]
+
+// standard
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+// acados
+#include "acados/utils/math.h"
+#include "acados/utils/timing.h"
+#include "acados_c/ocp_qp_interface.h"
+
+#define N_REP 20
+
+
+
+static double rand_sym(void)
+{
+    return 2.0 * rand() / RAND_MAX - 1.0;
+}
+
+
+
+int main(int argc, char *argv[])
+{
+    int N = argc > 1 ? atoi(argv[1]) : 50;
+    int nx = argc > 2 ? atoi(argv[2]) : 8;
+    int nu = argc > 3 ? atoi(argv[3]) : 3;
+    int n_rep = argc > 4 ? atoi(argv[4]) : N_REP;
+
+    int nbx = nx / 2;
+    int nu_e = 0;
+
+    double *A = malloc(nx*nx*sizeof(double));
+    double *B = malloc(nx*nu*sizeof(double));
+    double *b = calloc(nx, sizeof(double));
+    double *Q = calloc(nx*nx, sizeof(double));
+    double *R = calloc(nu*nu, sizeof(double));
+    double *q = malloc(nx*sizeof(double));
+    double *r = calloc(nu, sizeof(double));
+    double *x0 = malloc(nx*sizeof(double));
+    int *idxbx0 = malloc(nx*sizeof(int));
+    int *idxbx = malloc(nbx*sizeof(int));
+    int *idxbu = malloc(nu*sizeof(int));
+    double *lbx = malloc(nbx*sizeof(double));
+    double *ubx = malloc(nbx*sizeof(double));
+    double *lbu = malloc(nu*sizeof(double));
+    double *ubu = malloc(nu*sizeof(double));
+
+    srand(1);
+    for (int ii = 0; ii < nx*nx; ii++)
+        A[ii] = 0.05 * rand_sym();
+    for (int ii = 0; ii < nx; ii++)
+        A[ii*(nx+1)] += 1.0;
+    for (int ii = 0; ii < nx*nu; ii++)
+        B[ii] = rand_sym();
+    for (int ii = 0; ii < nx; ii++)
+    {
+        Q[ii*(nx+1)] = 1.0;
+        q[ii] = 0.1 * rand_sym();
+        x0[ii] = rand_sym();
+        idxbx0[ii] = ii;
+    }
+    for (int ii = 0; ii < nu; ii++)
+    {
+        R[ii*(nu+1)] = 1.0;
+        idxbu[ii] = ii;
+        lbu[ii] = -0.5;
+        ubu[ii] = 0.5;
+    }
+    for (int ii = 0; ii < nbx; ii++)
+    {
+        idxbx[ii] = 2*ii;
+        lbx[ii] = -2.0;
+        ubx[ii] = 2.0;
+    }
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+
+    ocp_qp_dims *dims = ocp_qp_dims_create(N);
+    for (int ii = 0; ii <= N; ii++)
+    {
+        ocp_qp_dims_set(config, dims, ii, "nx", &nx);
+        ocp_qp_dims_set(config, dims, ii, "nu", ii < N ? &nu : &nu_e);
+        if (ii < N)
+            ocp_qp_dims_set(config, dims, ii, "nbu", &nu);
+        ocp_qp_dims_set(config, dims, ii, "nbx", ii == 0 ? &nx : &nbx);
+    }
+    ocp_qp_dims_set(config, dims, 0, "nbxe", &nx);
+
+    ocp_qp_in *qp_in = ocp_qp_in_create(dims);
+    for (int ii = 0; ii <= N; ii++)
+    {
+        if (ii < N)
+        {
+            ocp_qp_in_set(config, qp_in, ii, "A", A);
+            ocp_qp_in_set(config, qp_in, ii, "B", B);
+            ocp_qp_in_set(config, qp_in, ii, "b", b);
+            ocp_qp_in_set(config, qp_in, ii, "R", R);
+            ocp_qp_in_set(config, qp_in, ii, "r", r);
+            ocp_qp_in_set(config, qp_in, ii, "idxbu", idxbu);
+            ocp_qp_in_set(config, qp_in, ii, "lbu", lbu);
+            ocp_qp_in_set(config, qp_in, ii, "ubu", ubu);
+        }
+        ocp_qp_in_set(config, qp_in, ii, "Q", Q);
+        ocp_qp_in_set(config, qp_in, ii, "q", q);
+        if (ii == 0)
+        {
+            ocp_qp_in_set(config, qp_in, ii, "idxbx", idxbx0);
+            ocp_qp_in_set(config, qp_in, ii, "lbx", x0);
+            ocp_qp_in_set(config, qp_in, ii, "ubx", x0);
+            ocp_qp_in_set(config, qp_in, ii, "idxbxe", idxbx0);
+        }
+        else
+        {
+            ocp_qp_in_set(config, qp_in, ii, "idxbx", idxbx);
+            ocp_qp_in_set(config, qp_in, ii, "lbx", lbx);
+            ocp_qp_in_set(config, qp_in, ii, "ubx", ubx);
+        }
+    }
+
+    ocp_qp_xcond_solver_dims *solver_dims =
+        ocp_qp_xcond_solver_dims_create_from_ocp_qp_dims(config, dims);
+
+    ocp_qp_out *qp_out = ocp_qp_out_create(dims);
+
+    // predictions of the cost model
+    int N_auto = 1;
+    int N2_pred;
+    double *N2_cost;
+    void *opts = ocp_qp_xcond_solver_opts_create(config, solver_dims);
+    ocp_qp_xcond_solver_opts_set(config, opts, "cond_N_auto", &N_auto);
+    ocp_qp_solver *qp_solver = ocp_qp_create(config, solver_dims, opts);
+    config->memory_get(config, qp_solver->mem, "cond_N", &N2_pred);
+    config->memory_get(config, qp_solver->mem, "cond_N_cost", &N2_cost);
+
+    double *time_meas = malloc((N+1)*sizeof(double));
+
+    printf("\nN = %d, nx = %d, nu = %d, %d repetitions\n", N, nx, nu, n_rep);
+    printf("\n%6s %16s %16s %8s\n", "N2", "predicted [ms]", "measured [ms]", "iter");
+
+    // measured time of a QP solution (condensing, solution, expansion) for every N2
+    acados_timer timer;
+    int N2_meas = N;
+    for (int N2 = 1; N2 <= N; N2++)
+    {
+        void *opts_N2 = ocp_qp_xcond_solver_opts_create(config, solver_dims);
+        ocp_qp_xcond_solver_opts_set(config, opts_N2, "cond_N", &N2);
+        ocp_qp_solver *qp_solver_N2 = ocp_qp_create(config, solver_dims, opts_N2);
+
+        int iter = 0;
+        time_meas[N2] = 1e10;
+        for (int rep = 0; rep < n_rep; rep++)
+        {
+            acados_tic(&timer);
+            int status = ocp_qp_solve(qp_solver_N2, qp_in, qp_out);
+            time_meas[N2] = MIN(time_meas[N2], acados_toc(&timer));
+            if (status != ACADOS_SUCCESS)
+                printf("\nqp solver returned status %d for N2 = %d\n", status, N2);
+        }
+        config->memory_get(config, qp_solver_N2->mem, "iter", &iter);
+
+        if (time_meas[N2] < time_meas[N2_meas])
+            N2_meas = N2;
+
+        printf("%6d %16.4f %16.4f %8d\n", N2, 1e3*N2_cost[N2], 1e3*time_meas[N2], iter);
+
+        ocp_qp_solver_destroy(qp_solver_N2);
+        ocp_qp_xcond_solver_opts_free(opts_N2);
+    }
+
+    printf("\npredicted best N2 = %d (%.4f ms measured), measured best N2 = %d (%.4f ms)\n",
+           N2_pred, 1e3*time_meas[N2_pred], N2_meas, 1e3*time_meas[N2_meas]);
+    printf("time at the predicted N2 / best time: %.2f\n\n",
+           time_meas[N2_pred] / time_meas[N2_meas]);
+
+    free(time_meas);
+
+    ocp_qp_solver_destroy(qp_solver);
+    ocp_qp_xcond_solver_opts_free(opts);
+    ocp_qp_out_free(qp_out);
+    ocp_qp_in_free(qp_in);
+    ocp_qp_xcond_solver_dims_free(solver_dims);
+    ocp_qp_dims_free(dims);
+    ocp_qp_xcond_solver_config_free(config);
+
+    free(A);
+    free(B);
+    free(b);
+    free(Q);
+    free(R);
+    free(q);
+    free(r);
+    free(x0);
+    free(idxbx0);
+    free(idxbx);
+    free(idxbu);
+    free(lbx);
+    free(ubx);
+    free(lbu);
+    free(ubu);
+
+    return 0;
+}
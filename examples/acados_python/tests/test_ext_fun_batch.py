@@ -0,0 +1,118 @@
+#
+# Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+# Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+# Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+# Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+#
+# This file is part of acados.
+#
+# The 2-Clause BSD License
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.;
+#
+import sys
+sys.path.insert(0, '../getting_started/common')
+
+from acados_template import AcadosOcp, AcadosOcpSolver
+from pendulum_model import export_pendulum_ode_model
+import numpy as np
+import scipy.linalg
+from casadi import vertcat, cos
+
+# batched evaluation (casadi maps) of the ERK forward VDE, NONLINEAR_LS path cost and BGH path
+# constraints has to give the same iterates as the stage-wise evaluation
+N = 20
+Tf = 1.0
+Fmax = 80
+tol = 1e-8
+
+def solve_pendulum(ext_fun_batch_size):
+    ocp = AcadosOcp()
+
+    model = export_pendulum_ode_model()
+    # distinct solver per setting
+    model.name = f'pendulum_batch_{ext_fun_batch_size}'
+    ocp.model = model
+    ocp.code_export_directory = f'c_generated_code_{model.name}'
+
+    nx = model.x.size()[0]
+    nu = model.u.size()[0]
+    ny = nx + nu
+
+    ocp.dims.N = N
+
+    # nonlinear least squares cost
+    Q = 2*np.diag([1e3, 1e3, 1e-2, 1e-2])
+    R = 2*np.diag([1e-2])
+    ocp.cost.cost_type = 'NONLINEAR_LS'
+    ocp.cost.cost_type_e = 'NONLINEAR_LS'
+    ocp.cost.W = scipy.linalg.block_diag(Q, R)
+    ocp.cost.W_e = Q
+    ocp.model.cost_y_expr = vertcat(model.x, model.u)
+    ocp.model.cost_y_expr_e = model.x
+    ocp.cost.yref = np.zeros((ny, ))
+    ocp.cost.yref_e = np.zeros((nx, ))
+
+    # nonlinear constraint h: force bound, scaled down with the pole tilted
+    ocp.constraints.lh = np.array([-Fmax])
+    ocp.constraints.uh = np.array([+Fmax])
+    ocp.model.con_h_expr = model.u * (1.5 - 0.5 * cos(model.x[1]))
+
+    ocp.constraints.x0 = np.array([0.0, np.pi, 0.0, 0.0])
+
+    ocp.solver_options.qp_solver = 'PARTIAL_CONDENSING_HPIPM'
+    ocp.solver_options.hessian_approx = 'GAUSS_NEWTON'
+    ocp.solver_options.integrator_type = 'ERK'
+    ocp.solver_options.nlp_solver_type = 'SQP'
+    ocp.solver_options.ext_fun_batch_size = ext_fun_batch_size
+    ocp.solver_options.tf = Tf
+
+    ocp_solver = AcadosOcpSolver(ocp, json_file = f'acados_ocp_{model.name}.json')
+
+    status = ocp_solver.solve()
+    if status != 0:
+        raise Exception(f'acados returned status {status} with ext_fun_batch_size {ext_fun_batch_size}.')
+
+    simX = np.array([ocp_solver.get(i, "x") for i in range(N+1)])
+    simU = np.array([ocp_solver.get(i, "u") for i in range(N)])
+    sqp_iter = ocp_solver.get_stats('sqp_iter')
+
+    return simX, simU, sqp_iter
+
+
+simX_ref, simU_ref, sqp_iter_ref = solve_pendulum(0)
+
+# full batches, and a last partial batch (N = 20 not a multiple of 3)
+for ext_fun_batch_size in [4, 3]:
+    simX, simU, sqp_iter = solve_pendulum(ext_fun_batch_size)
+
+    err_x = np.max(np.abs(simX - simX_ref))
+    err_u = np.max(np.abs(simU - simU_ref))
+    print(f'ext_fun_batch_size {ext_fun_batch_size}: sqp_iter {sqp_iter} (stage-wise {sqp_iter_ref}), ' +
+          f'max deviation x {err_x:.2e}, u {err_u:.2e}')
+
+    if sqp_iter != sqp_iter_ref or err_x > tol or err_u > tol:
+        raise Exception(f'batched evaluation with ext_fun_batch_size {ext_fun_batch_size} ' +
+                        'does not match the stage-wise evaluation.')
+
+print('test_ext_fun_batch: success')
@@ -77,6 +77,8 @@
 #define TF 3.75
 #define MAX_SQP_ITERS 10
 #define NREP 10
+// globalization: "fixed_step", "merit_backtracking" or "filter_line_search"
+#define GLOBALIZATION "fixed_step"
 
 // constraints (at stage 0): 0 box, 1 general
 #define CONSTRAINTS 1
@@ -1350,6 +1352,7 @@ int main()
     ocp_nlp_solver_opts_set(config, nlp_opts, "tol_eq", &tol_eq);
     ocp_nlp_solver_opts_set(config, nlp_opts, "tol_ineq", &tol_ineq);
     ocp_nlp_solver_opts_set(config, nlp_opts, "tol_comp", &tol_comp);
+    ocp_nlp_solver_opts_set(config, nlp_opts, "globalization", GLOBALIZATION);
 
     /************************************************
     * ocp_nlp out
@@ -0,0 +1,431 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+// Batched solution of N_BATCH independent chain OCPs (e.g. scenario MPC):
+// compares solving the instances one after the other with ocp_nlp_solve_batch, checks that both
+// give the same solutions and reports the throughput per thread.
+
+// standard
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#if defined(ACADOS_WITH_OPENMP)
+#include <omp.h>
+#endif
+// acados
+#include "acados_c/external_function_interface.h"
+#include "acados_c/ocp_nlp_interface.h"
+#include "acados/utils/math.h"
+#include "acados/utils/timing.h"
+#include "acados/utils/types.h"
+// model
+#include "examples/c/chain_model/chain_model.h"
+#include "examples/c/chain_model/x0_nm3.c"
+#include "examples/c/chain_model/xN_nm3.c"
+
+#define NN 20
+#define TF 5.0
+#define NMF 2  // number of free masses
+#define N_BATCH 16
+#define NREP 10
+
+
+
+int main()
+{
+    int NX = 6 * NMF;
+    int NU = 3;
+
+    /************************************************
+    * problem dimensions
+    ************************************************/
+
+    int nx[NN + 1], nu[NN + 1], nbx[NN + 1], nbu[NN + 1], ng[NN + 1], nh[NN + 1];
+    int ny[NN + 1], nz[NN + 1], ns[NN + 1];
+
+    for (int i = 0; i <= NN; i++)
+    {
+        nx[i] = NX;
+        nu[i] = i < NN ? NU : 0;
+        nbx[i] = i == 0 ? NX : 0;
+        nbu[i] = nu[i];
+        ng[i] = 0;
+        nh[i] = 0;
+        ny[i] = nx[i] + nu[i];
+        nz[i] = 0;
+        ns[i] = 0;
+    }
+
+    /************************************************
+    * problem data
+    ************************************************/
+
+    double UMAX = 10;
+
+    double *yref = calloc(NX + NU, sizeof(double));
+    for (int i = 0; i < NX; i++)
+        yref[i] = xN_nm3[i];
+
+    double *Vx = calloc((NX + NU) * NX, sizeof(double));
+    for (int i = 0; i < NX; i++)
+        Vx[i * (NX + NU + 1)] = 1.0;
+
+    double *Vu = calloc((NX + NU) * NU, sizeof(double));
+    for (int i = 0; i < NU; i++)
+        Vu[NX + i * (NX + NU + 1)] = 1.0;
+
+    double *VxN = calloc(NX * NX, sizeof(double));
+    for (int i = 0; i < NX; i++)
+        VxN[i * (NX + 1)] = 1.0;
+
+    double *W = calloc((NX + NU) * (NX + NU), sizeof(double));
+    for (int i = 0; i < NX; i++)
+        W[i * (NX + NU + 1)] = 1e-2;
+    for (int i = NX; i < NX + NU; i++)
+        W[i * (NX + NU + 1)] = 1.0;
+
+    double *WN = calloc(NX * NX, sizeof(double));
+    for (int i = 0; i < NX; i++)
+        WN[i * (NX + 1)] = 1e-2;
+
+    int *idxbx0 = malloc(NX * sizeof(int));
+    for (int i = 0; i < NX; i++)
+        idxbx0[i] = i;
+
+    int *idxbu = malloc(NU * sizeof(int));
+    double *lbu = malloc(NU * sizeof(double));
+    double *ubu = malloc(NU * sizeof(double));
+    for (int i = 0; i < NU; i++)
+    {
+        idxbu[i] = i;
+        lbu[i] = -UMAX;
+        ubu[i] = UMAX;
+    }
+
+    double *x0 = malloc(NX * sizeof(double));
+    double *u0 = calloc(NU, sizeof(double));
+
+    /************************************************
+    * plan + config + dims (shared by all instances)
+    ************************************************/
+
+    ocp_nlp_plan *plan = ocp_nlp_plan_create(NN);
+
+    plan->nlp_solver = SQP;
+    plan->ocp_qp_solver_plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+
+    for (int i = 0; i <= NN; i++)
+    {
+        plan->nlp_cost[i] = LINEAR_LS;
+        plan->nlp_constraints[i] = BGH;
+    }
+
+    for (int i = 0; i < NN; i++)
+    {
+        plan->nlp_dynamics[i] = CONTINUOUS_MODEL;
+        plan->sim_solver_plan[i].sim_solver = ERK;
+    }
+
+    ocp_nlp_config *config = ocp_nlp_config_create(*plan);
+
+    ocp_nlp_dims *dims = ocp_nlp_dims_create(config);
+
+    ocp_nlp_dims_set_opt_vars(config, dims, "nx", nx);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nu", nu);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nz", nz);
+    ocp_nlp_dims_set_opt_vars(config, dims, "ns", ns);
+
+    for (int i = 0; i <= NN; i++)
+    {
+        ocp_nlp_dims_set_cost(config, dims, i, "ny", &ny[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbx", &nbx[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbu", &nbu[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "ng", &ng[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nh", &nh[i]);
+    }
+
+    /************************************************
+    * dynamics (the casadi functions are read-only and can be shared)
+    ************************************************/
+
+    external_function_casadi *expl_vde_for = malloc(NN * sizeof(external_function_casadi));
+    for (int i = 0; i < NN; i++)
+    {
+        expl_vde_for[i].casadi_fun = &vde_chain_nm3;
+        expl_vde_for[i].casadi_work = &vde_chain_nm3_work;
+        expl_vde_for[i].casadi_sparsity_in = &vde_chain_nm3_sparsity_in;
+        expl_vde_for[i].casadi_sparsity_out = &vde_chain_nm3_sparsity_out;
+        expl_vde_for[i].casadi_n_in = &vde_chain_nm3_n_in;
+        expl_vde_for[i].casadi_n_out = &vde_chain_nm3_n_out;
+    }
+    // one set of external functions per instance, since they hold their own workspace
+    external_function_casadi **expl_vde_for_batch = malloc(N_BATCH * sizeof(external_function_casadi *));
+    for (int k = 0; k < N_BATCH; k++)
+    {
+        expl_vde_for_batch[k] = malloc(NN * sizeof(external_function_casadi));
+        for (int i = 0; i < NN; i++)
+            expl_vde_for_batch[k][i] = expl_vde_for[i];
+        external_function_casadi_create_array(NN, expl_vde_for_batch[k]);
+    }
+
+    /************************************************
+    * instances
+    ************************************************/
+
+    ocp_nlp_in **nlp_in = malloc(N_BATCH * sizeof(ocp_nlp_in *));
+    ocp_nlp_out **nlp_out = malloc(N_BATCH * sizeof(ocp_nlp_out *));
+    void **nlp_opts = malloc(N_BATCH * sizeof(void *));
+    ocp_nlp_solver **solver = malloc(N_BATCH * sizeof(ocp_nlp_solver *));
+
+    int max_iter = 10;
+    double tol = 1e-8;
+    int ns_erk = 4;
+
+    for (int k = 0; k < N_BATCH; k++)
+    {
+        nlp_in[k] = ocp_nlp_in_create(config, dims);
+
+        for (int i = 0; i < NN; i++)
+            nlp_in[k]->Ts[i] = TF / NN;
+
+        // cost
+        for (int i = 0; i < NN; i++)
+        {
+            ocp_nlp_cost_model_set(config, dims, nlp_in[k], i, "Vx", Vx);
+            ocp_nlp_cost_model_set(config, dims, nlp_in[k], i, "Vu", Vu);
+            ocp_nlp_cost_model_set(config, dims, nlp_in[k], i, "W", W);
+            ocp_nlp_cost_model_set(config, dims, nlp_in[k], i, "yref", yref);
+        }
+        ocp_nlp_cost_model_set(config, dims, nlp_in[k], NN, "Vx", VxN);
+        ocp_nlp_cost_model_set(config, dims, nlp_in[k], NN, "W", WN);
+        ocp_nlp_cost_model_set(config, dims, nlp_in[k], NN, "yref", yref);
+
+        // dynamics
+        for (int i = 0; i < NN; i++)
+        {
+            if (ocp_nlp_dynamics_model_set(config, dims, nlp_in[k], i, "expl_vde_for",
+                                           &expl_vde_for_batch[k][i]))
+                exit(1);
+        }
+
+        // constraints: every instance starts from a differently perturbed initial state
+        for (int i = 0; i < NX; i++)
+            x0[i] = x0_nm3[i] * (1.0 + 0.02 * k);
+
+        ocp_nlp_constraints_model_set(config, dims, nlp_in[k], 0, "idxbx", idxbx0);
+        ocp_nlp_constraints_model_set(config, dims, nlp_in[k], 0, "lbx", x0);
+        ocp_nlp_constraints_model_set(config, dims, nlp_in[k], 0, "ubx", x0);
+        for (int i = 0; i < NN; i++)
+        {
+            ocp_nlp_constraints_model_set(config, dims, nlp_in[k], i, "idxbu", idxbu);
+            ocp_nlp_constraints_model_set(config, dims, nlp_in[k], i, "lbu", lbu);
+            ocp_nlp_constraints_model_set(config, dims, nlp_in[k], i, "ubu", ubu);
+        }
+
+        // opts: every instance needs its own opts
+        nlp_opts[k] = ocp_nlp_solver_opts_create(config, dims);
+        for (int i = 0; i < NN; i++)
+            ocp_nlp_solver_opts_set_at_stage(config, nlp_opts[k], i, "dynamics_ns", &ns_erk);
+        ocp_nlp_solver_opts_set(config, nlp_opts[k], "max_iter", &max_iter);
+        ocp_nlp_solver_opts_set(config, nlp_opts[k], "tol_stat", &tol);
+        ocp_nlp_solver_opts_set(config, nlp_opts[k], "tol_eq", &tol);
+        ocp_nlp_solver_opts_set(config, nlp_opts[k], "tol_ineq", &tol);
+        ocp_nlp_solver_opts_set(config, nlp_opts[k], "tol_comp", &tol);
+
+        nlp_out[k] = ocp_nlp_out_create(config, dims);
+
+        solver[k] = ocp_nlp_solver_create(config, dims, nlp_opts[k]);
+        ocp_nlp_precompute(solver[k], nlp_in[k], nlp_out[k]);
+    }
+
+    /************************************************
+    * solve: sequential vs batch
+    ************************************************/
+
+    acados_timer timer;
+    int status = ACADOS_SUCCESS;
+    int tmp_status;
+
+    double time_seq = 0.0;
+    double time_batch = 0.0;
+
+    // solutions and iterations of the sequential solves, to be compared with the batch ones
+    int nux = NX + NU;
+    double *ux_seq = malloc(N_BATCH * (NN + 1) * nux * sizeof(double));
+    int sqp_iter_seq[N_BATCH];
+
+    for (int rep = 0; rep < NREP; rep++)
+    {
+        // sequential
+        for (int k = 0; k < N_BATCH; k++)
+        {
+            for (int i = 0; i <= NN; i++)
+            {
+                ocp_nlp_out_set(config, dims, nlp_out[k], i, "x", xN_nm3);
+                if (i < NN)
+                    ocp_nlp_out_set(config, dims, nlp_out[k], i, "u", u0);
+            }
+        }
+
+        acados_tic(&timer);
+        for (int k = 0; k < N_BATCH; k++)
+        {
+            tmp_status = ocp_nlp_solve(solver[k], nlp_in[k], nlp_out[k]);
+            if (tmp_status != ACADOS_SUCCESS)
+                status = tmp_status;
+        }
+        time_seq += acados_toc(&timer);
+
+        for (int k = 0; k < N_BATCH; k++)
+        {
+            ocp_nlp_get(config, solver[k], "sqp_iter", &sqp_iter_seq[k]);
+            for (int i = 0; i <= NN; i++)
+            {
+                double *ux_k_i = ux_seq + (k * (NN + 1) + i) * nux;
+                ocp_nlp_out_get(config, dims, nlp_out[k], i, "x", ux_k_i);
+                if (i < NN)
+                    ocp_nlp_out_get(config, dims, nlp_out[k], i, "u", ux_k_i + NX);
+            }
+        }
+
+        // batch
+        for (int k = 0; k < N_BATCH; k++)
+        {
+            for (int i = 0; i <= NN; i++)
+            {
+                ocp_nlp_out_set(config, dims, nlp_out[k], i, "x", xN_nm3);
+                if (i < NN)
+                    ocp_nlp_out_set(config, dims, nlp_out[k], i, "u", u0);
+            }
+        }
+
+        acados_tic(&timer);
+        tmp_status = ocp_nlp_solve_batch(solver, nlp_in, nlp_out, N_BATCH);
+        time_batch += acados_toc(&timer);
+        if (tmp_status != ACADOS_SUCCESS)
+            status = tmp_status;
+    }
+
+    time_seq /= NREP;
+    time_batch /= NREP;
+
+    // batch against sequential, last repetition
+    int sqp_iter;
+    double max_diff = 0.0;
+    double *ux_batch = malloc(nux * sizeof(double));
+    for (int k = 0; k < N_BATCH; k++)
+    {
+        ocp_nlp_get(config, solver[k], "sqp_iter", &sqp_iter);
+        ocp_nlp_get(config, solver[k], "status", &tmp_status);
+
+        double max_diff_k = 0.0;
+        for (int i = 0; i <= NN; i++)
+        {
+            double *ux_k_i = ux_seq + (k * (NN + 1) + i) * nux;
+            int nux_i = i < NN ? nux : NX;
+            ocp_nlp_out_get(config, dims, nlp_out[k], i, "x", ux_batch);
+            if (i < NN)
+                ocp_nlp_out_get(config, dims, nlp_out[k], i, "u", ux_batch + NX);
+            for (int j = 0; j < nux_i; j++)
+                max_diff_k = fmax(max_diff_k, fabs(ux_batch[j] - ux_k_i[j]));
+        }
+        max_diff = fmax(max_diff, max_diff_k);
+
+        printf("instance %2d: status %d, sqp iter %d (sequential %d), max diff to sequential %e\n",
+               k, tmp_status, sqp_iter, sqp_iter_seq[k], max_diff_k);
+        if (sqp_iter != sqp_iter_seq[k])
+            status = ACADOS_FAILURE;
+    }
+    if (max_diff > 1e-10)
+        status = ACADOS_FAILURE;
+    free(ux_batch);
+    free(ux_seq);
+
+    int n_threads = 1;
+#if defined(ACADOS_WITH_OPENMP)
+    n_threads = MIN(omp_get_max_threads(), N_BATCH);
+#endif
+
+    printf("\n%d instances, N = %d, nx = %d, nu = %d, %d threads\n", N_BATCH, NN, NX, NU,
+           n_threads);
+    printf("sequential: %8.3f ms (%8.1f solves/s)\n", time_seq * 1e3, N_BATCH / time_seq);
+    printf("batch:      %8.3f ms (%8.1f solves/s, %8.1f solves/s per thread)\n",
+           time_batch * 1e3, N_BATCH / time_batch, N_BATCH / time_batch / n_threads);
+    printf("speedup:    %8.2f (parallel efficiency %.2f)\n", time_seq / time_batch,
+           time_seq / time_batch / n_threads);
+    printf("max diff batch vs sequential solution: %e\n", max_diff);
+
+    /************************************************
+    * free memory
+    ************************************************/
+
+    for (int k = 0; k < N_BATCH; k++)
+    {
+        ocp_nlp_solver_destroy(solver[k]);
+        ocp_nlp_solver_opts_destroy(nlp_opts[k]);
+        ocp_nlp_out_destroy(nlp_out[k]);
+        ocp_nlp_in_destroy(nlp_in[k]);
+        external_function_casadi_free_array(NN, expl_vde_for_batch[k]);
+        free(expl_vde_for_batch[k]);
+    }
+    free(solver);
+    free(nlp_opts);
+    free(nlp_out);
+    free(nlp_in);
+    free(expl_vde_for_batch);
+    free(expl_vde_for);
+
+    ocp_nlp_dims_destroy(dims);
+    ocp_nlp_config_destroy(config);
+    ocp_nlp_plan_destroy(plan);
+
+    free(yref);
+    free(Vx);
+    free(Vu);
+    free(VxN);
+    free(W);
+    free(WN);
+    free(idxbx0);
+    free(idxbu);
+    free(lbu);
+    free(ubu);
+    free(x0);
+    free(u0);
+
+    if (status == ACADOS_SUCCESS)
+        printf("\nsuccess!\n\n");
+    else
+        printf("\nfailure!\n\n");
+
+    return status;
+}
@@ -0,0 +1,380 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+// Scaling of the stage-parallel SQP with the horizon length N and the number of threads,
+// on the chain problem with 3 masses. Compile acados with ACADOS_WITH_OPENMP to obtain
+// timings for more than one thread; thread pinning and spinning are controlled through
+// the usual OpenMP environment variables, e.g.
+//   OMP_PROC_BIND=close OMP_PLACES=cores OMP_WAIT_POLICY=active GOMP_SPINCOUNT=100000
+
+// standard
+#include <stdio.h>
+#include <stdlib.h>
+#if defined(ACADOS_WITH_OPENMP)
+#include <omp.h>
+#endif
+// acados
+#include "acados_c/external_function_interface.h"
+#include "acados_c/ocp_nlp_interface.h"
+#include "acados/utils/math.h"
+#include "acados/utils/timing.h"
+#include "acados/utils/types.h"
+// model
+#include "examples/c/chain_model/chain_model.h"
+#include "examples/c/chain_model/x0_nm3.c"
+#include "examples/c/chain_model/xN_nm3.c"
+
+#define TF 5.0
+#define NMF 2  // number of free masses
+#define NREP 20
+
+
+
+static int solve_chain(int NN, int num_threads, double *time_solve, int *sqp_iter)
+{
+    int NX = 6 * NMF;
+    int NU = 3;
+
+    /************************************************
+    * problem dimensions
+    ************************************************/
+
+    int *nx = malloc((NN + 1) * sizeof(int));
+    int *nu = malloc((NN + 1) * sizeof(int));
+    int *nbx = malloc((NN + 1) * sizeof(int));
+    int *nbu = malloc((NN + 1) * sizeof(int));
+    int *ng = malloc((NN + 1) * sizeof(int));
+    int *nh = malloc((NN + 1) * sizeof(int));
+    int *ny = malloc((NN + 1) * sizeof(int));
+    int *nz = malloc((NN + 1) * sizeof(int));
+    int *ns = malloc((NN + 1) * sizeof(int));
+
+    for (int i = 0; i <= NN; i++)
+    {
+        nx[i] = NX;
+        nu[i] = i < NN ? NU : 0;
+        nbx[i] = i == 0 ? NX : 0;
+        nbu[i] = nu[i];
+        ng[i] = 0;
+        nh[i] = 0;
+        ny[i] = nx[i] + nu[i];
+        nz[i] = 0;
+        ns[i] = 0;
+    }
+
+    /************************************************
+    * problem data
+    ************************************************/
+
+    double UMAX = 10;
+
+    double *yref = calloc(NX + NU, sizeof(double));
+    for (int i = 0; i < NX; i++)
+        yref[i] = xN_nm3[i];
+
+    double *Vx = calloc((NX + NU) * NX, sizeof(double));
+    for (int i = 0; i < NX; i++)
+        Vx[i * (NX + NU + 1)] = 1.0;
+
+    double *Vu = calloc((NX + NU) * NU, sizeof(double));
+    for (int i = 0; i < NU; i++)
+        Vu[NX + i * (NX + NU + 1)] = 1.0;
+
+    double *VxN = calloc(NX * NX, sizeof(double));
+    for (int i = 0; i < NX; i++)
+        VxN[i * (NX + 1)] = 1.0;
+
+    double *W = calloc((NX + NU) * (NX + NU), sizeof(double));
+    for (int i = 0; i < NX; i++)
+        W[i * (NX + NU + 1)] = 1e-2;
+    for (int i = NX; i < NX + NU; i++)
+        W[i * (NX + NU + 1)] = 1.0;
+
+    double *WN = calloc(NX * NX, sizeof(double));
+    for (int i = 0; i < NX; i++)
+        WN[i * (NX + 1)] = 1e-2;
+
+    int *idxbx0 = malloc(NX * sizeof(int));
+    for (int i = 0; i < NX; i++)
+        idxbx0[i] = i;
+
+    int *idxbu = malloc(NU * sizeof(int));
+    double *lbu = malloc(NU * sizeof(double));
+    double *ubu = malloc(NU * sizeof(double));
+    for (int i = 0; i < NU; i++)
+    {
+        idxbu[i] = i;
+        lbu[i] = -UMAX;
+        ubu[i] = UMAX;
+    }
+
+    double *u0 = calloc(NU, sizeof(double));
+
+    /************************************************
+    * plan + config + dims
+    ************************************************/
+
+    ocp_nlp_plan *plan = ocp_nlp_plan_create(NN);
+
+    plan->nlp_solver = SQP;
+    plan->ocp_qp_solver_plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+
+    for (int i = 0; i <= NN; i++)
+    {
+        plan->nlp_cost[i] = LINEAR_LS;
+        plan->nlp_constraints[i] = BGH;
+    }
+
+    for (int i = 0; i < NN; i++)
+    {
+        plan->nlp_dynamics[i] = CONTINUOUS_MODEL;
+        plan->sim_solver_plan[i].sim_solver = ERK;
+    }
+
+    ocp_nlp_config *config = ocp_nlp_config_create(*plan);
+
+    ocp_nlp_dims *dims = ocp_nlp_dims_create(config);
+
+    ocp_nlp_dims_set_opt_vars(config, dims, "nx", nx);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nu", nu);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nz", nz);
+    ocp_nlp_dims_set_opt_vars(config, dims, "ns", ns);
+
+    for (int i = 0; i <= NN; i++)
+    {
+        ocp_nlp_dims_set_cost(config, dims, i, "ny", &ny[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbx", &nbx[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbu", &nbu[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "ng", &ng[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nh", &nh[i]);
+    }
+
+    /************************************************
+    * dynamics
+    ************************************************/
+
+    external_function_casadi *expl_vde_for = malloc(NN * sizeof(external_function_casadi));
+    for (int i = 0; i < NN; i++)
+    {
+        expl_vde_for[i].casadi_fun = &vde_chain_nm3;
+        expl_vde_for[i].casadi_work = &vde_chain_nm3_work;
+        expl_vde_for[i].casadi_sparsity_in = &vde_chain_nm3_sparsity_in;
+        expl_vde_for[i].casadi_sparsity_out = &vde_chain_nm3_sparsity_out;
+        expl_vde_for[i].casadi_n_in = &vde_chain_nm3_n_in;
+        expl_vde_for[i].casadi_n_out = &vde_chain_nm3_n_out;
+    }
+    external_function_casadi_create_array(NN, expl_vde_for);
+
+    /************************************************
+    * nlp_in
+    ************************************************/
+
+    ocp_nlp_in *nlp_in = ocp_nlp_in_create(config, dims);
+
+    for (int i = 0; i < NN; i++)
+        nlp_in->Ts[i] = TF / NN;
+
+    // cost
+    for (int i = 0; i < NN; i++)
+    {
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "Vx", Vx);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "Vu", Vu);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "W", W);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "yref", yref);
+    }
+    ocp_nlp_cost_model_set(config, dims, nlp_in, NN, "Vx", VxN);
+    ocp_nlp_cost_model_set(config, dims, nlp_in, NN, "W", WN);
+    ocp_nlp_cost_model_set(config, dims, nlp_in, NN, "yref", yref);
+
+    // dynamics
+    for (int i = 0; i < NN; i++)
+    {
+        if (ocp_nlp_dynamics_model_set(config, dims, nlp_in, i, "expl_vde_for", &expl_vde_for[i]))
+            exit(1);
+    }
+
+    // constraints
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "idxbx", idxbx0);
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "lbx", x0_nm3);
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "ubx", x0_nm3);
+    for (int i = 0; i < NN; i++)
+    {
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, i, "idxbu", idxbu);
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, i, "lbu", lbu);
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, i, "ubu", ubu);
+    }
+
+    /************************************************
+    * opts
+    ************************************************/
+
+    void *nlp_opts = ocp_nlp_solver_opts_create(config, dims);
+
+    int max_iter = 10;
+    double tol = 1e-8;
+    int ns_erk = 4;
+
+    for (int i = 0; i < NN; i++)
+        ocp_nlp_solver_opts_set_at_stage(config, nlp_opts, i, "dynamics_ns", &ns_erk);
+    ocp_nlp_solver_opts_set(config, nlp_opts, "max_iter", &max_iter);
+    ocp_nlp_solver_opts_set(config, nlp_opts, "tol_stat", &tol);
+    ocp_nlp_solver_opts_set(config, nlp_opts, "tol_eq", &tol);
+    ocp_nlp_solver_opts_set(config, nlp_opts, "tol_ineq", &tol);
+    ocp_nlp_solver_opts_set(config, nlp_opts, "tol_comp", &tol);
+    ocp_nlp_solver_opts_set(config, nlp_opts, "num_threads", &num_threads);
+
+    /************************************************
+    * solve
+    ************************************************/
+
+    ocp_nlp_out *nlp_out = ocp_nlp_out_create(config, dims);
+
+    ocp_nlp_solver *solver = ocp_nlp_solver_create(config, dims, nlp_opts);
+    ocp_nlp_precompute(solver, nlp_in, nlp_out);
+
+    acados_timer timer;
+    int status = ACADOS_SUCCESS;
+    double time_min = 1e12;
+    double time_tmp;
+
+    for (int rep = 0; rep < NREP; rep++)
+    {
+        for (int i = 0; i <= NN; i++)
+        {
+            ocp_nlp_out_set(config, dims, nlp_out, i, "x", xN_nm3);
+            if (i < NN)
+                ocp_nlp_out_set(config, dims, nlp_out, i, "u", u0);
+        }
+
+        acados_tic(&timer);
+        status = ocp_nlp_solve(solver, nlp_in, nlp_out);
+        time_tmp = acados_toc(&timer);
+        if (time_tmp < time_min)
+            time_min = time_tmp;
+    }
+
+    *time_solve = time_min;
+    ocp_nlp_get(config, solver, "sqp_iter", sqp_iter);
+
+    /************************************************
+    * free memory
+    ************************************************/
+
+    ocp_nlp_solver_destroy(solver);
+    ocp_nlp_out_destroy(nlp_out);
+    ocp_nlp_solver_opts_destroy(nlp_opts);
+    ocp_nlp_in_destroy(nlp_in);
+    external_function_casadi_free_array(NN, expl_vde_for);
+    free(expl_vde_for);
+
+    ocp_nlp_dims_destroy(dims);
+    ocp_nlp_config_destroy(config);
+    ocp_nlp_plan_destroy(plan);
+
+    free(nx);
+    free(nu);
+    free(nbx);
+    free(nbu);
+    free(ng);
+    free(nh);
+    free(ny);
+    free(nz);
+    free(ns);
+
+    free(yref);
+    free(Vx);
+    free(Vu);
+    free(VxN);
+    free(W);
+    free(WN);
+    free(idxbx0);
+    free(idxbu);
+    free(lbu);
+    free(ubu);
+    free(u0);
+
+    return status;
+}
+
+
+
+int main()
+{
+    int horizons[] = {20, 50, 100, 200};
+    int n_horizons = sizeof(horizons) / sizeof(int);
+
+#if defined(ACADOS_WITH_OPENMP)
+    int max_threads = omp_get_max_threads();
+#else
+    int max_threads = 1;
+#endif
+
+    int status = ACADOS_SUCCESS;
+    int tmp_status, sqp_iter;
+    double time_1, time_p;
+
+    printf("\n   N   sqp_iter   1 thread [ms]   %2d threads [ms]   speedup\n", max_threads);
+
+    for (int j = 0; j < n_horizons; j++)
+    {
+        tmp_status = solve_chain(horizons[j], 1, &time_1, &sqp_iter);
+        if (tmp_status != ACADOS_SUCCESS)
+            status = tmp_status;
+
+        time_p = time_1;
+        if (max_threads > 1)
+        {
+            tmp_status = solve_chain(horizons[j], max_threads, &time_p, &sqp_iter);
+            if (tmp_status != ACADOS_SUCCESS)
+                status = tmp_status;
+        }
+
+        printf("%4d   %8d   %13.3f   %15.3f   %7.2f\n", horizons[j], sqp_iter,
+               time_1 * 1e3, time_p * 1e3, time_1 / time_p);
+    }
+
+    // record the events of the solves for N = 100, open the file in chrome://tracing or Perfetto
+    acados_trace_start(100000);
+    solve_chain(100, max_threads, &time_p, &sqp_iter);
+    acados_trace_stop();
+    if (!acados_trace_write("nonlinear_chain_ocp_nlp_trace.json"))
+        printf("\nwrote trace of N = 100 to nonlinear_chain_ocp_nlp_trace.json\n");
+    acados_trace_free();
+
+    if (status == ACADOS_SUCCESS)
+        printf("\nsuccess!\n\n");
+    else
+        printf("\nfailure!\n\n");
+
+    return status;
+}
@@ -58,6 +58,15 @@
 
 #define MAX_SQP_ITERS 10
 #define NREP 1
+// globalization: "fixed_step", "merit_backtracking" or "filter_line_search" (SQP only)
+#define GLOBALIZATION "fixed_step"
+// with qpOASES: run the closed loop with SQP_RTI and FULL_CONDENSING_QPOASES twice, without (0)
+// and with (1) reuse of the qpOASES QProblem across calls ("qp_hotstart_reuse"), and compare
+#ifdef ACADOS_WITH_QPOASES
+#define QPOASES_HOTSTART_COMPARISON 1
+#else
+#define QPOASES_HOTSTART_COMPARISON 0
+#endif
 
 
 
@@ -541,16 +550,24 @@ int main()
 
     ocp_nlp_plan *plan = ocp_nlp_plan_create(NN);
 
+#if QPOASES_HOTSTART_COMPARISON
+    plan->nlp_solver = SQP_RTI;
+#else
     plan->nlp_solver = SQP;
     // plan->nlp_solver = SQP_RTI;
+#endif
 
     for (int i = 0; i <= NN; i++)
         plan->nlp_cost[i] = LINEAR_LS;
 
+#if QPOASES_HOTSTART_COMPARISON
+    plan->ocp_qp_solver_plan.qp_solver = FULL_CONDENSING_QPOASES;
+#else
     plan->ocp_qp_solver_plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
     // plan->ocp_qp_solver_plan.qp_solver = FULL_CONDENSING_HPIPM;
     // plan->ocp_qp_solver_plan.qp_solver = FULL_CONDENSING_QPOASES;
     // plan->ocp_qp_solver_plan.qp_solver = FULL_CONDENSING_QORE;
+#endif
 
     for (int i = 0; i < NN; i++)
     {
@@ -820,6 +837,7 @@ int main()
 		ocp_nlp_solver_opts_set(config, nlp_opts, "tol_eq", &tol_eq);
 		ocp_nlp_solver_opts_set(config, nlp_opts, "tol_ineq", &tol_ineq);
 		ocp_nlp_solver_opts_set(config, nlp_opts, "tol_comp", &tol_comp);
+		ocp_nlp_solver_opts_set(config, nlp_opts, "globalization", GLOBALIZATION);
     }
     else if (plan->nlp_solver == SQP_RTI)
     {
@@ -892,6 +910,25 @@ int main()
         ocp_nlp_solver_opts_set(config, nlp_opts, "qp_cond_N", &cond_N);
     }
 
+    int n_runs = 1;
+
+#ifdef ACADOS_WITH_QPOASES
+    // qpOASES opts: in RTI every QP belongs to a new sampling time, warm start it from the
+    // working set of the previous QP, shifted by one stage (the condensed inputs are stored
+    // in reversed stage order, u_{N-1} first)
+    if (plan->ocp_qp_solver_plan.qp_solver == FULL_CONDENSING_QPOASES &&
+        plan->nlp_solver == SQP_RTI)
+    {
+        n_runs = 2;  // qp_hotstart_reuse = 0, 1
+        int qp_warm_start = 1;
+        bool warm_start_first_qp = true;
+        int shift_nv = nu_;
+        ocp_nlp_solver_opts_set(config, nlp_opts, "qp_warm_start", &qp_warm_start);
+        ocp_nlp_solver_opts_set(config, nlp_opts, "warm_start_first_qp", &warm_start_first_qp);
+        ocp_nlp_solver_opts_set(config, nlp_opts, "qp_warm_start_shift_nv", &shift_nv);
+    }
+#endif
+
     // update opts after manual changes
     ocp_nlp_solver_opts_update(config, dims, nlp_opts);
 
@@ -920,127 +957,158 @@ int main()
 	double *x_sim = malloc(nx_*(n_sim+1)*sizeof(double));
 	double *u_sim = malloc(nu_*(n_sim+0)*sizeof(double));
 
-    acados_timer timer;
-    acados_tic(&timer);
-
-    for (int rep = 0; rep < NREP; rep++)
+    for (int run = 0; run < n_runs; run++)
     {
-        // TODO(oj): @giaf how should this be done? using the ocp_nlp_out_set()
-        //    seems unintuitive for warmstarting
-        // warm start output initial guess of solution
-        for (int i=0; i<=NN; i++)
+        int qp_iter_tot = 0;
+        int num_hotstarts = 0;
+#ifdef ACADOS_WITH_QPOASES
+        if (n_runs > 1)
         {
-            blasfeo_pack_dvec(2, u0_ref, 1, nlp_out->ux+i, 0);
-//            blasfeo_pack_dvec(1, wind0_ref+i, 1, nlp_out->ux+i, 2);
-            blasfeo_pack_dvec(nx[i], x0_ref, 1, nlp_out->ux+i, nu[i]);
+            ocp_nlp_solver_opts_set(config, solver->opts, "qp_hotstart_reuse", &run);
+            ocp_nlp_get(config, solver, "qp_num_hotstarts", &num_hotstarts);
         }
+#endif
 
-        // set x0 as box constraint
-        ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "lbx", x0_ref);
-        ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "ubx", x0_ref);
-
-		// store x0
-		for(int ii=0; ii<nx_; ii++) x_sim[ii] = x0_ref[ii];
+        acados_timer timer;
+        acados_tic(&timer);
 
-        for (int idx = 0; idx < n_sim; idx++)
+        for (int rep = 0; rep < NREP; rep++)
         {
-            // update wind distrurbance as external function parameter
-            for (int ii=0; ii<NN; ii++)
+            // TODO(oj): @giaf how should this be done? using the ocp_nlp_out_set()
+            //    seems unintuitive for warmstarting
+            // warm start output initial guess of solution
+            for (int i=0; i<=NN; i++)
             {
-                if (plan->sim_solver_plan[ii].sim_solver == ERK)
-                {
-                    expl_vde_for[ii].set_param(expl_vde_for+ii, wind0_ref+idx+ii);
-                }
-                else if (plan->sim_solver_plan[ii].sim_solver == IRK || plan->sim_solver_plan[ii].sim_solver == LIFTED_IRK)
-                {
-                    impl_ode_fun[ii].set_param(impl_ode_fun+ii, wind0_ref+idx+ii);
-                    impl_ode_fun_jac_x_xdot[ii].set_param(impl_ode_fun_jac_x_xdot+ii, wind0_ref+idx+ii);
-                    impl_ode_jac_x_xdot_u[ii].set_param(impl_ode_jac_x_xdot_u+ii, wind0_ref+idx+ii);
-                    impl_ode_fun_jac_x_xdot_u[ii].set_param(impl_ode_fun_jac_x_xdot_u+ii, wind0_ref+idx+ii);
-                }
-                else if (plan->sim_solver_plan[ii].sim_solver == GNSF)
+                blasfeo_pack_dvec(2, u0_ref, 1, nlp_out->ux+i, 0);
+    //            blasfeo_pack_dvec(1, wind0_ref+i, 1, nlp_out->ux+i, 2);
+                blasfeo_pack_dvec(nx[i], x0_ref, 1, nlp_out->ux+i, nu[i]);
+            }
+
+            // set x0 as box constraint
+            ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "lbx", x0_ref);
+            ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "ubx", x0_ref);
+
+    		// store x0
+    		for(int ii=0; ii<nx_; ii++) x_sim[ii] = x0_ref[ii];
+
+            for (int idx = 0; idx < n_sim; idx++)
+            {
+                // update wind distrurbance as external function parameter
+                for (int ii=0; ii<NN; ii++)
                 {
-                    phi_fun[ii].set_param(phi_fun+ii, wind0_ref+idx+ii);
-                    phi_fun_jac_y[ii].set_param(phi_fun_jac_y+ii, wind0_ref+idx+ii);
-                    phi_jac_y_uhat[ii].set_param(phi_jac_y_uhat+ii, wind0_ref+idx+ii);
-                    f_lo_jac_x1_x1dot_u_z[ii].set_param(f_lo_jac_x1_x1dot_u_z+ii, wind0_ref+idx+ii);
+                    if (plan->sim_solver_plan[ii].sim_solver == ERK)
+                    {
+                        expl_vde_for[ii].set_param(expl_vde_for+ii, wind0_ref+idx+ii);
+                    }
+                    else if (plan->sim_solver_plan[ii].sim_solver == IRK || plan->sim_solver_plan[ii].sim_solver == LIFTED_IRK)
+                    {
+                        impl_ode_fun[ii].set_param(impl_ode_fun+ii, wind0_ref+idx+ii);
+                        impl_ode_fun_jac_x_xdot[ii].set_param(impl_ode_fun_jac_x_xdot+ii, wind0_ref+idx+ii);
+                        impl_ode_jac_x_xdot_u[ii].set_param(impl_ode_jac_x_xdot_u+ii, wind0_ref+idx+ii);
+                        impl_ode_fun_jac_x_xdot_u[ii].set_param(impl_ode_fun_jac_x_xdot_u+ii, wind0_ref+idx+ii);
+                    }
+                    else if (plan->sim_solver_plan[ii].sim_solver == GNSF)
+                    {
+                        phi_fun[ii].set_param(phi_fun+ii, wind0_ref+idx+ii);
+                        phi_fun_jac_y[ii].set_param(phi_fun_jac_y+ii, wind0_ref+idx+ii);
+                        phi_jac_y_uhat[ii].set_param(phi_jac_y_uhat+ii, wind0_ref+idx+ii);
+                        f_lo_jac_x1_x1dot_u_z[ii].set_param(f_lo_jac_x1_x1dot_u_z+ii, wind0_ref+idx+ii);
+                    }
+                    else
+                    {
+                        printf("\nWrong sim name\n\n");
+                        exit(1);
+                    }
                 }
-                else
+                // update reference
+                for (int i = 0; i <= NN; i++)
                 {
-                    printf("\nWrong sim name\n\n");
-                    exit(1);
+                    ocp_nlp_cost_model_set(config, dims, nlp_in, i, "yref", &y_ref[(idx + i)*4]);
                 }
-            }
-            // update reference
-            for (int i = 0; i <= NN; i++)
-            {
-                ocp_nlp_cost_model_set(config, dims, nlp_in, i, "yref", &y_ref[(idx + i)*4]);
-            }
 
-            // solve NLP
-            status = ocp_nlp_solve(solver, nlp_in, nlp_out);
+                // solve NLP
+                status = ocp_nlp_solve(solver, nlp_in, nlp_out);
 
-			// evaluate parametric sensitivity of solution
-//			ocp_nlp_out_print(dims, nlp_out);
-			ocp_nlp_eval_param_sens(solver, "ex", 0, 0, sens_nlp_out);
-//			ocp_nlp_out_print(dims, nlp_out);
+                int qp_iter;
+                ocp_nlp_get(config, solver, "qp_iter", &qp_iter);
+                qp_iter_tot += qp_iter;
 
-            // update initial condition
-            // TODO(dimitris): maybe simulate system instead of passing x[1] as next state
-            ocp_nlp_out_get(config, dims, nlp_out, 1, "x", specific_x);
-            ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "lbx", specific_x);
-            ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "ubx", specific_x);
+    			// evaluate parametric sensitivity of solution
+    //			ocp_nlp_out_print(dims, nlp_out);
+    			ocp_nlp_eval_param_sens(solver, "ex", 0, 0, sens_nlp_out);
+    //			ocp_nlp_out_print(dims, nlp_out);
 
-			// store trajectory
-            ocp_nlp_out_get(config, dims, nlp_out, 1, "x", x_sim+(idx+1)*nx_);
-            ocp_nlp_out_get(config, dims, nlp_out, 0, "u", u_sim+idx*nu_);
+                // update initial condition
+                // TODO(dimitris): maybe simulate system instead of passing x[1] as next state
+                ocp_nlp_out_get(config, dims, nlp_out, 1, "x", specific_x);
+                ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "lbx", specific_x);
+                ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "ubx", specific_x);
 
-            // print info
-            if (true)
-            {
-                int sqp_iter;
-                double time_lin, time_qp_sol, time_tot;
+    			// store trajectory
+                ocp_nlp_out_get(config, dims, nlp_out, 1, "x", x_sim+(idx+1)*nx_);
+                ocp_nlp_out_get(config, dims, nlp_out, 0, "u", u_sim+idx*nu_);
+
+                // print info
+                if (true)
+                {
+                    int sqp_iter;
+                    double time_lin, time_qp_sol, time_tot;
 
-                ocp_nlp_get(config, solver, "sqp_iter", &sqp_iter);
-                ocp_nlp_get(config, solver, "time_tot", &time_tot);
-                ocp_nlp_get(config, solver, "time_qp_sol", &time_qp_sol);
-                ocp_nlp_get(config, solver, "time_lin", &time_lin);
+                    ocp_nlp_get(config, solver, "sqp_iter", &sqp_iter);
+                    ocp_nlp_get(config, solver, "time_tot", &time_tot);
+                    ocp_nlp_get(config, solver, "time_qp_sol", &time_qp_sol);
+                    ocp_nlp_get(config, solver, "time_lin", &time_lin);
 
-                printf("\nproblem #%d, status %d, iters %d, time (total %f, lin %f, qp_sol %f) ms\n",
-                    idx, status, sqp_iter, time_tot*1e3, time_lin*1e3, time_qp_sol*1e3);
+                    printf("\nproblem #%d, status %d, iters %d, time (total %f, lin %f, qp_sol %f) ms\n",
+                        idx, status, sqp_iter, time_tot*1e3, time_lin*1e3, time_qp_sol*1e3);
 
-                printf("xsim = \n");
-                ocp_nlp_out_get(config, dims, nlp_out, 0, "x", x_end);
-                d_print_mat(1, nx[0], x_end, 1);
-                printf("electrical power = %f\n", 0.944*97/100* x_end[0] * x_end[5]);
-            }
-            if (status!=0)
-            {
-                if (plan->nlp_solver == SQP)  // RTI has no residual
+                    printf("xsim = \n");
+                    ocp_nlp_out_get(config, dims, nlp_out, 0, "x", x_end);
+                    d_print_mat(1, nx[0], x_end, 1);
+                    printf("electrical power = %f\n", 0.944*97/100* x_end[0] * x_end[5]);
+                }
+                if (status!=0)
                 {
-                    ocp_nlp_res *residual;
-                    ocp_nlp_get(config, solver, "nlp_res", &residual);
-                    printf("\nresiduals\n");
-                    ocp_nlp_res_print(dims, residual);
-                    exit(1);
+                    if (plan->nlp_solver == SQP)  // RTI has no residual
+                    {
+                        ocp_nlp_res *residual;
+                        ocp_nlp_get(config, solver, "nlp_res", &residual);
+                        printf("\nresiduals\n");
+                        ocp_nlp_res_print(dims, residual);
+                        exit(1);
+                    }
                 }
-            }
 
-            // shift trajectories
-            if (true)
-            {
-                ocp_nlp_out_get(config, dims, nlp_out, NN-1, "u", u_end);
-                ocp_nlp_out_get(config, dims, nlp_out, NN-1, "x", x_end);
+                // shift trajectories
+                if (true)
+                {
+                    ocp_nlp_out_get(config, dims, nlp_out, NN-1, "u", u_end);
+                    ocp_nlp_out_get(config, dims, nlp_out, NN-1, "x", x_end);
 
-                shift_states(dims, nlp_out, x_end);
-                shift_controls(dims, nlp_out, u_end);
+                    shift_states(dims, nlp_out, x_end);
+                    shift_controls(dims, nlp_out, u_end);
+                }
             }
         }
-    }
 
-    double time = acados_toc(&timer)/NREP;
+        double time = acados_toc(&timer)/NREP;
 
-    printf("\n\ntotal time (including printing) = %f ms (time per SQP = %f)\n\n", time*1e3, time*1e3/n_sim);
+#ifdef ACADOS_WITH_QPOASES
+        if (n_runs > 1)
+        {
+            int num_hotstarts_end;
+            ocp_nlp_get(config, solver, "qp_num_hotstarts", &num_hotstarts_end);
+            num_hotstarts = num_hotstarts_end - num_hotstarts;
+        }
+#endif
+
+        printf("\n\ntotal time (including printing) = %f ms (time per SQP = %f)\n\n", time*1e3, time*1e3/n_sim);
+        printf("QP iterations of the last QP per problem: total %d, average %f\n\n", qp_iter_tot,
+            (double) qp_iter_tot / (NREP*n_sim));
+        if (n_runs > 1)
+            printf("qp_hotstart_reuse = %d: %d of %d QPs hot started\n\n", run, num_hotstarts,
+                NREP*n_sim);
+    }
 
 #if 0
 	d_print_mat(nx_, n_sim+1, x_sim, nx_);
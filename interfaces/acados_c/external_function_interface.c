@@ -215,3 +215,30 @@ void external_function_param_casadi_free_array(int size, external_function_param
 
     return;
 }
+
+
+
+/************************************************
+ * casadi map of an external function
+ ************************************************/
+
+void external_function_casadi_map_create(external_function_casadi_map *map, int batch_size,
+                                         int num_scratch)
+{
+    acados_size_t map_size = external_function_casadi_map_calculate_size(map, batch_size,
+                                                                         num_scratch);
+    void *map_mem = acados_malloc(1, map_size);
+    assert(map_mem != 0);
+    external_function_casadi_map_assign(map, map_mem);
+
+    return;
+}
+
+
+
+void external_function_casadi_map_free(external_function_casadi_map *map)
+{
+    free(map->ptr_ext_mem);
+
+    return;
+}
@@ -85,6 +85,18 @@ void external_function_param_casadi_free_array(int size, external_function_param
 
 
 
+/************************************************
+ * casadi map of an external function
+ ************************************************/
+
+// num_scratch: number of batches evaluated concurrently, e.g. the number of threads
+void external_function_casadi_map_create(external_function_casadi_map *map, int batch_size,
+                                         int num_scratch);
+//
+void external_function_casadi_map_free(external_function_casadi_map *map);
+
+
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
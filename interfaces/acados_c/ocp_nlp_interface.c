@@ -272,6 +272,10 @@ ocp_nlp_config *ocp_nlp_config_create(ocp_nlp_plan plan)
                     case LIFTED_IRK:
                         sim_lifted_irk_config_initialize_default(config->dynamics[i]->sim_solver);
                         break;
+                    case ERK_INTERLEAVED:
+                        sim_erk_interleaved_config_initialize_default(
+                            config->dynamics[i]->sim_solver);
+                        break;
                     default:
                         printf("\nerror: ocp_nlp_config_create: unsupported plan->sim_solver\n");
                         exit(1);
@@ -372,6 +376,7 @@ ocp_nlp_in *ocp_nlp_in_create(ocp_nlp_config *config, ocp_nlp_dims *dims)
 void ocp_nlp_in_destroy(void *in_)
 {
     ocp_nlp_in *in = in_;
+    ocp_nlp_modify_hook_call(&in->modify_hook, -1, NULL);
     free(in->raw_memory);
 }
 
@@ -380,6 +385,8 @@ void ocp_nlp_in_destroy(void *in_)
 void ocp_nlp_in_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in, int stage,
         const char *field, void *value)
 {
+    ocp_nlp_modify_hook_call(&in->modify_hook, stage, field);
+
     if (!strcmp(field, "Ts"))
     {
         double *Ts_value = value;
@@ -400,6 +407,8 @@ int ocp_nlp_dynamics_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_n
 {
     ocp_nlp_dynamics_config *dynamics_config = config->dynamics[stage];
 
+    ocp_nlp_modify_hook_call(&in->modify_hook, stage, field);
+
     dynamics_config->model_set(dynamics_config, dims->dynamics[stage], in->dynamics[stage], field, value);
 
     return ACADOS_SUCCESS;
@@ -412,6 +421,8 @@ int ocp_nlp_cost_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims,
 {
     ocp_nlp_cost_config *cost_config = config->cost[stage];
 
+    ocp_nlp_modify_hook_call(&in->modify_hook, stage, field);
+
     return cost_config->model_set(cost_config, dims->cost[stage], in->cost[stage], field, value);
 
 }
@@ -423,6 +434,8 @@ int ocp_nlp_constraints_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims,
 {
     ocp_nlp_constraints_config *constr_config = config->constraints[stage];
 
+    ocp_nlp_modify_hook_call(&in->modify_hook, stage, field);
+
     return constr_config->model_set(constr_config, dims->constraints[stage],
             in->constraints[stage], field, value);
 }
@@ -455,6 +468,7 @@ ocp_nlp_out *ocp_nlp_out_create(ocp_nlp_config *config, ocp_nlp_dims *dims)
 void ocp_nlp_out_destroy(void *out_)
 {
     ocp_nlp_out *out = out_;
+    ocp_nlp_modify_hook_call(&out->modify_hook, -1, NULL);
     free(out->raw_memory);
 }
 
@@ -463,6 +477,8 @@ void ocp_nlp_out_destroy(void *out_)
 void ocp_nlp_out_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
         int stage, const char *field, void *value)
 {
+    ocp_nlp_modify_hook_call(&out->modify_hook, stage, field);
+
     if (!strcmp(field, "x"))
     {
         double *double_values = value;
@@ -517,6 +533,8 @@ void ocp_nlp_out_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *ou
 void ocp_nlp_out_get(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
         int stage, const char *field, void *value)
 {
+    ocp_nlp_modify_hook_wait(&out->modify_hook);
+
     if (!strcmp(field, "x"))
     {
         double *double_values = value;
@@ -573,6 +591,253 @@ void ocp_nlp_out_get(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *ou
 
 
 
+/* field handles */
+
+static ocp_nlp_field_handle *ocp_nlp_field_create_self(int N, ocp_nlp_modify_hook *modify_hook,
+        const char *field)
+{
+    acados_size_t bytes = ocp_nlp_field_handle_calculate_size(N);
+
+    void *ptr = acados_calloc(1, bytes);
+    assert(ptr != 0);
+
+    ocp_nlp_field_handle *handle = ocp_nlp_field_handle_assign(N, ptr);
+    handle->raw_memory = ptr;
+
+    handle->modify_hook = modify_hook;
+    strncpy(handle->field, field, sizeof(handle->field) - 1);
+    handle->field[sizeof(handle->field) - 1] = '\0';
+
+    return handle;
+}
+
+
+
+static void ocp_nlp_field_check_available(ocp_nlp_field_handle *handle, const char *fun_name,
+        const char *field)
+{
+    for (int stage = 0; stage <= handle->N; stage++)
+    {
+        if (handle->vec[stage])
+            return;
+    }
+
+    printf("\nerror: %s: field %s not available\n", fun_name, field);
+    exit(1);
+}
+
+
+
+ocp_nlp_field_handle *ocp_nlp_cost_model_field_create(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_in *in, const char *field)
+{
+    int N = dims->N;
+
+    ocp_nlp_field_handle *handle = ocp_nlp_field_create_self(N, &in->modify_hook, field);
+
+    for (int stage = 0; stage <= N; stage++)
+    {
+        ocp_nlp_cost_config *cost_config = config->cost[stage];
+
+        if (cost_config->model_get_vec_ptr)
+        {
+            cost_config->model_get_vec_ptr(cost_config, dims->cost[stage], in->cost[stage], field,
+                    &handle->vec[stage], &handle->offset[stage], &handle->size[stage]);
+        }
+    }
+
+    ocp_nlp_field_check_available(handle, "ocp_nlp_cost_model_field_create", field);
+
+    return handle;
+}
+
+
+
+ocp_nlp_field_handle *ocp_nlp_constraints_model_field_create(ocp_nlp_config *config,
+        ocp_nlp_dims *dims, ocp_nlp_in *in, const char *field)
+{
+    int N = dims->N;
+
+    ocp_nlp_field_handle *handle = ocp_nlp_field_create_self(N, &in->modify_hook, field);
+
+    for (int stage = 0; stage <= N; stage++)
+    {
+        ocp_nlp_constraints_config *constr_config = config->constraints[stage];
+
+        if (constr_config->model_get_vec_ptr)
+        {
+            constr_config->model_get_vec_ptr(constr_config, dims->constraints[stage],
+                    in->constraints[stage], field, &handle->vec[stage], &handle->offset[stage],
+                    &handle->size[stage]);
+        }
+    }
+
+    ocp_nlp_field_check_available(handle, "ocp_nlp_constraints_model_field_create", field);
+
+    return handle;
+}
+
+
+
+ocp_nlp_field_handle *ocp_nlp_out_field_create(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_out *out, const char *field)
+{
+    int N = dims->N;
+
+    ocp_nlp_field_handle *handle = ocp_nlp_field_create_self(N, &out->modify_hook, field);
+
+    for (int stage = 0; stage <= N; stage++)
+    {
+        int nx = dims->nx[stage];
+        int nu = dims->nu[stage];
+        int ns = dims->ns[stage];
+
+        if (!strcmp(field, "x"))
+        {
+            handle->vec[stage] = &out->ux[stage];
+            handle->offset[stage] = nu;
+            handle->size[stage] = nx;
+        }
+        else if (!strcmp(field, "u"))
+        {
+            handle->vec[stage] = &out->ux[stage];
+            handle->offset[stage] = 0;
+            handle->size[stage] = nu;
+        }
+        else if (!strcmp(field, "sl"))
+        {
+            handle->vec[stage] = &out->ux[stage];
+            handle->offset[stage] = nu + nx;
+            handle->size[stage] = ns;
+        }
+        else if (!strcmp(field, "su"))
+        {
+            handle->vec[stage] = &out->ux[stage];
+            handle->offset[stage] = nu + nx + ns;
+            handle->size[stage] = ns;
+        }
+        else if (!strcmp(field, "pi"))
+        {
+            // no dynamics after the last stage
+            if (stage < N)
+            {
+                handle->vec[stage] = &out->pi[stage];
+                handle->offset[stage] = 0;
+                handle->size[stage] = dims->nx[stage+1];
+            }
+        }
+        else if (!strcmp(field, "lam"))
+        {
+            handle->vec[stage] = &out->lam[stage];
+            handle->offset[stage] = 0;
+            handle->size[stage] = 2*dims->ni[stage];
+        }
+        else if (!strcmp(field, "t"))
+        {
+            handle->vec[stage] = &out->t[stage];
+            handle->offset[stage] = 0;
+            handle->size[stage] = 2*dims->ni[stage];
+        }
+        else if (!strcmp(field, "z"))
+        {
+            handle->vec[stage] = &out->z[stage];
+            handle->offset[stage] = 0;
+            handle->size[stage] = dims->nz[stage];
+        }
+        else
+        {
+            printf("\nerror: ocp_nlp_out_field_create: field %s not available\n", field);
+            exit(1);
+        }
+    }
+
+    return handle;
+}
+
+
+
+void ocp_nlp_field_destroy(void *handle_)
+{
+    ocp_nlp_field_handle *handle = handle_;
+    free(handle->raw_memory);
+}
+
+
+
+void ocp_nlp_field_set(ocp_nlp_field_handle *handle, int stage, const double *value)
+{
+    if (!handle->vec[stage])
+    {
+        printf("\nerror: ocp_nlp_field_set: field not available at stage %d\n", stage);
+        exit(1);
+    }
+
+    ocp_nlp_modify_hook_call(handle->modify_hook, stage, handle->field);
+
+    blasfeo_pack_dvec(handle->size[stage], (double *) value, 1, handle->vec[stage],
+                      handle->offset[stage]);
+}
+
+
+
+void ocp_nlp_field_get(ocp_nlp_field_handle *handle, int stage, double *value)
+{
+    if (!handle->vec[stage])
+    {
+        printf("\nerror: ocp_nlp_field_get: field not available at stage %d\n", stage);
+        exit(1);
+    }
+
+    ocp_nlp_modify_hook_wait(handle->modify_hook);
+
+    blasfeo_unpack_dvec(handle->size[stage], handle->vec[stage], handle->offset[stage], value, 1);
+}
+
+
+
+int ocp_nlp_field_set_horizon(ocp_nlp_field_handle *handle, int stage_begin, int stage_end,
+        const double *value)
+{
+    int idx = 0;
+
+    for (int stage = stage_begin; stage < stage_end; stage++)
+    {
+        if (handle->vec[stage])
+        {
+            ocp_nlp_modify_hook_call(handle->modify_hook, stage, handle->field);
+            blasfeo_pack_dvec(handle->size[stage], (double *) value + idx, 1, handle->vec[stage],
+                              handle->offset[stage]);
+            idx += handle->size[stage];
+        }
+    }
+
+    return idx;
+}
+
+
+
+int ocp_nlp_field_get_horizon(ocp_nlp_field_handle *handle, int stage_begin, int stage_end,
+        double *value)
+{
+    int idx = 0;
+
+    ocp_nlp_modify_hook_wait(handle->modify_hook);
+
+    for (int stage = stage_begin; stage < stage_end; stage++)
+    {
+        if (handle->vec[stage])
+        {
+            blasfeo_unpack_dvec(handle->size[stage], handle->vec[stage], handle->offset[stage],
+                                value + idx, 1);
+            idx += handle->size[stage];
+        }
+    }
+
+    return idx;
+}
+
+
+
 int ocp_nlp_dims_get_from_attr(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
         int stage, const char *field)
 {
@@ -928,8 +1193,13 @@ ocp_nlp_solver *ocp_nlp_solver_create(ocp_nlp_config *config, ocp_nlp_dims *dims
 }
 
 
-void ocp_nlp_solver_destroy(void *solver)
+void ocp_nlp_solver_destroy(void *solver_)
 {
+    ocp_nlp_solver *solver = solver_;
+
+    if (solver->config->terminate)
+        solver->config->terminate(solver->config, solver->mem, solver->work);
+
     free(solver);
 }
 
@@ -943,6 +1213,42 @@ int ocp_nlp_solve(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_o
 
 
 
+int ocp_nlp_solve_batch(ocp_nlp_solver **solvers, ocp_nlp_in **nlp_in, ocp_nlp_out **nlp_out,
+                        int N_batch)
+{
+    // status of the first failing instance, or ACADOS_SUCCESS
+    int status = ACADOS_SUCCESS;
+    int first_fail = N_batch;
+
+    // NOTE: instances are independent, so they are solved concurrently; OpenMP parallel regions
+    // inside the single solvers are nested and therefore executed by one thread each
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int ii = 0; ii < N_batch; ii++)
+    {
+        int tmp_status = ocp_nlp_solve(solvers[ii], nlp_in[ii], nlp_out[ii]);
+
+        if (tmp_status != ACADOS_SUCCESS)
+        {
+#if defined(ACADOS_WITH_OPENMP)
+            #pragma omp critical
+#endif
+            {
+                if (ii < first_fail)
+                {
+                    first_fail = ii;
+                    status = tmp_status;
+                }
+            }
+        }
+    }
+
+    return status;
+}
+
+
+
 int ocp_nlp_precompute(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out)
 {
     return solver->config->precompute(solver->config, solver->dims, nlp_in, nlp_out,
@@ -1049,6 +1355,11 @@ void ocp_nlp_set(ocp_nlp_config *config, ocp_nlp_solver *solver,
         blasfeo_pack_dvec(nout, double_values, 1, &mem->sim_guess[stage], 0);
         mem->set_sim_guess[stage] = true;
     }
+    else if (!strcmp(field, "reset_latency_hist"))
+    {
+        for (int i = 0; i < OCP_NLP_LATENCY_HIST_SIZE; i++)
+            mem->latency_hist[i] = 0;
+    }
     else
     {
         printf("\nerror: ocp_nlp_mem_set: field %s not available\n", field);
@@ -279,6 +279,78 @@ void ocp_nlp_out_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *ou
 void ocp_nlp_out_get(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
         int stage, const char *field, void *value);
 
+
+/* field handles */
+
+/// Resolves a vector field of the cost module of all stages, e.g. yref, zl, Zu, such that it can be
+/// set and read with ocp_nlp_field_set/get without string comparisons.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param in The inputs struct.
+/// \param field The name of the field.
+ocp_nlp_field_handle *ocp_nlp_cost_model_field_create(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_in *in, const char *field);
+
+/// Resolves a vector field of the constraints module of all stages, e.g. lbx, ubx, lbu, ubu, lg,
+/// ug, lh, uh, lsbx.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param in The inputs struct.
+/// \param field The name of the field.
+ocp_nlp_field_handle *ocp_nlp_constraints_model_field_create(ocp_nlp_config *config,
+        ocp_nlp_dims *dims, ocp_nlp_in *in, const char *field);
+
+/// Resolves a field of the output struct of all stages, either x, u, sl, su, pi, lam, t, z.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param out The output struct.
+/// \param field The name of the field.
+ocp_nlp_field_handle *ocp_nlp_out_field_create(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_out *out, const char *field);
+
+/// Destructor of a field handle.
+///
+/// \param handle The field handle.
+void ocp_nlp_field_destroy(void *handle);
+
+/// Sets the field at the given stage.
+///
+/// \param handle The field handle.
+/// \param stage Stage number.
+/// \param value The values, of the size of the field at this stage.
+void ocp_nlp_field_set(ocp_nlp_field_handle *handle, int stage, const double *value);
+
+/// Gets the field at the given stage.
+///
+/// \param handle The field handle.
+/// \param stage Stage number.
+/// \param value Pointer to the output memory.
+void ocp_nlp_field_get(ocp_nlp_field_handle *handle, int stage, double *value);
+
+/// Sets the field on the stages stage_begin, ..., stage_end-1 from one contiguous array, which
+/// holds the values of the stages one after the other. Stages where the field is not available
+/// are skipped. Returns the number of values read.
+///
+/// \param handle The field handle.
+/// \param stage_begin First stage.
+/// \param stage_end One past the last stage.
+/// \param value The values of all stages.
+int ocp_nlp_field_set_horizon(ocp_nlp_field_handle *handle, int stage_begin, int stage_end,
+        const double *value);
+
+/// Gets the field on the stages stage_begin, ..., stage_end-1 into one contiguous array, with the
+/// same layout as in ocp_nlp_field_set_horizon. Returns the number of values written.
+///
+/// \param handle The field handle.
+/// \param stage_begin First stage.
+/// \param stage_end One past the last stage.
+/// \param value Pointer to the output memory.
+int ocp_nlp_field_get_horizon(ocp_nlp_field_handle *handle, int stage_begin, int stage_end,
+        double *value);
+
 //
 void ocp_nlp_get_at_stage(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_solver *solver,
         int stage, const char *field, void *value);
@@ -351,6 +423,20 @@ void ocp_nlp_solver_destroy(void *solver);
 /// \param nlp_out The output struct.
 int ocp_nlp_solve(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out);
 
+/// Solves a batch of independent optimal control problems, e.g. for scenario or
+/// multi-robot MPC. If acados is compiled with OpenMP, the instances are solved
+/// concurrently, one instance per thread. Each solver must have its own opts,
+/// memory, nlp_in and nlp_out; the config and dims can be shared.
+/// The per-instance status can be retrieved with ocp_nlp_get(..., "status", ...).
+///
+/// \param solvers Array of N_batch solver structs.
+/// \param nlp_in Array of N_batch inputs structs.
+/// \param nlp_out Array of N_batch output structs.
+/// \param N_batch Number of instances.
+/// \return ACADOS_SUCCESS if all instances succeeded, the status of the first failing instance otherwise.
+int ocp_nlp_solve_batch(ocp_nlp_solver **solvers, ocp_nlp_in **nlp_in, ocp_nlp_out **nlp_out,
+        int N_batch);
+
 /// Performs precomputations for the solver. Needs to be called before
 /// ocl_nlp_solve (TBC).
 ///
@@ -383,6 +469,19 @@ void ocp_nlp_eval_param_sens(ocp_nlp_solver *solver, char *field, int stage, int
 /// \param config The configuration struct.
 /// \param solver The solver struct.
 /// \param field Supports "sqp_iter", "status", "nlp_res", "time_tot", ...
+///        Per-stage linearization times (opts "stage_timings"): "time_lin_dyn" (N doubles),
+///        "time_lin_cost", "time_lin_constr" (N+1 doubles). Regularization and QP solution act
+///        on the whole horizon and are timed in total only ("time_reg", "time_qp_sol").
+///        Histogram of the solve times: "latency_hist" ("latency_hist_size" ints).
+///        With the SQP-RTI option "async_preparation", the getter waits for the preparation in
+///        flight, so timings and statistics refer to the last completed phases.
+///        Stages projected by the last PROJECT regularization: "reg_num_projected" (int).
+///        Partial condensing horizon: "qp_cond_N" (int); with opts "qp_cond_N_auto" the
+///        predicted QP solution time per candidate horizon: "qp_cond_N_cost" (double *, N+1).
+///        Blocks recondensed in the last partial condensing (opts "qp_cond_incremental",
+///        default 1, recondenses only blocks with changed stage matrices):
+///        "qp_cond_num_recond_blocks" (int).
+///        With full condensing these return -1 (int) and NULL (qp_cond_N_cost).
 /// \param return_value_ Pointer to the output memory.
 void ocp_nlp_get(ocp_nlp_config *config, ocp_nlp_solver *solver,
         const char *field, void *return_value_);
@@ -393,7 +492,8 @@ void ocp_nlp_get(ocp_nlp_config *config, ocp_nlp_solver *solver,
 /// \param config The configuration struct.
 /// \param solver The ocp_nlp_solver struct.
 /// \param stage Stage number.
-/// \param field Supports "z_guess", "xdot_guess" (IRK), "phi_guess" (GNSF-IRK)
+/// \param field Supports "z_guess", "xdot_guess" (IRK), "phi_guess" (GNSF-IRK),
+///        "reset_latency_hist" (clears the solve time histogram, stage and value are ignored)
 /// \param value The initial guess for the algebraic variables in the integrator (if continuous model is used).
 void ocp_nlp_set(ocp_nlp_config *config, ocp_nlp_solver *solver,
         int stage, const char *field, void *value);
@@ -56,6 +56,7 @@
 #endif
 
 #include "acados/ocp_qp/ocp_qp_hpipm.h"
+#include "acados/ocp_qp/ocp_qp_pric.h"
 #ifdef ACADOS_WITH_HPMPC
 #include "acados/ocp_qp/ocp_qp_hpmpc.h"
 #endif
@@ -114,6 +115,11 @@ void ocp_qp_xcond_solver_config_initialize_from_plan(
 			ocp_qp_partial_condensing_config_initialize_default(solver_config->xcond);
             break;
 #endif
+        case PARTIAL_CONDENSING_PRIC:
+			ocp_qp_xcond_solver_config_initialize_default(solver_config);
+            ocp_qp_pric_config_initialize_default(solver_config->qp_solver);
+			ocp_qp_partial_condensing_config_initialize_default(solver_config->xcond);
+            break;
         case FULL_CONDENSING_HPIPM:
 			ocp_qp_xcond_solver_config_initialize_default(solver_config);
             dense_qp_hpipm_config_initialize_default(solver_config->qp_solver);
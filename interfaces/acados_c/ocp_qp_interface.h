@@ -55,10 +55,12 @@ extern "C" {
 ///   FULL_CONDENSING_QPOASES
 ///   FULL_CONDENSING_QORE
 ///   FULL_CONDENSING_OOQP
+///   PARTIAL_CONDENSING_PRIC
 ///   INVALID_QP_SOLVER
 ///
-/// Note: In this enumeration the partial condensing solvers have to be
-///       specified before the full condensing solvers.
+/// Note: In this enumeration the partial condensing solvers are specified
+///       before the full condensing solvers. Solvers added later are appended
+///       before INVALID_QP_SOLVER, to keep the values of the existing ones.
 typedef enum {
     PARTIAL_CONDENSING_HPIPM,
 #ifdef ACADOS_WITH_HPMPC
@@ -97,6 +99,8 @@ typedef enum {
 #else
     FULL_CONDENSING_OOQP_NOT_AVAILABLE,
 #endif
+    // appended, to keep the values of the solvers above
+    PARTIAL_CONDENSING_PRIC,
     INVALID_QP_SOLVER,
 } ocp_qp_solver_t;
 
@@ -79,6 +79,9 @@ sim_config *sim_config_create(sim_solver_plan_t plan)
         case LIFTED_IRK:
             sim_lifted_irk_config_initialize_default(solver_config);
             break;
+        case ERK_INTERLEAVED:
+            sim_erk_interleaved_config_initialize_default(solver_config);
+            break;
         case INVALID_SIM_SOLVER:
             printf("\nerror: sim_config_create: forgot to initialize plan->sim_solver\n");
             exit(1);
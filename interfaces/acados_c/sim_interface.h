@@ -49,6 +49,7 @@ typedef enum
     IRK,
     GNSF,
     LIFTED_IRK,
+    ERK_INTERLEAVED,  // ERK, integrates several shooting intervals in lockstep within ocp_nlp
     INVALID_SIM_SOLVER,
 } sim_solver_t;
 
@@ -2155,12 +2155,17 @@ class AcadosOcpOptions:
         self.__globalization_use_SOC = 0
         self.__full_step_dual = 0
         self.__eps_sufficient_descent = 1e-4
+        self.__filter_gamma_theta = 1e-5
+        self.__filter_gamma_phi = 1e-8
+        self.__ext_fun_batch_size = 0
+        self.__ext_fun_zero_copy = 0
+        self.__fast_path_interface = 0
 
 
     @property
     def qp_solver(self):
         """QP solver to be used in the NLP solver.
-        String in ('PARTIAL_CONDENSING_HPIPM', 'FULL_CONDENSING_QPOASES', 'FULL_CONDENSING_HPIPM', 'PARTIAL_CONDENSING_QPDUNES', 'PARTIAL_CONDENSING_OSQP').
+        String in ('PARTIAL_CONDENSING_HPIPM', 'FULL_CONDENSING_QPOASES', 'FULL_CONDENSING_HPIPM', 'PARTIAL_CONDENSING_QPDUNES', 'PARTIAL_CONDENSING_OSQP', 'PARTIAL_CONDENSING_PRIC').
         Default: 'PARTIAL_CONDENSING_HPIPM'.
         """
         return self.__qp_solver
@@ -2193,8 +2198,10 @@ class AcadosOcpOptions:
     @property
     def globalization(self):
         """Globalization type.
-        String in ('FIXED_STEP', 'MERIT_BACKTRACKING').
+        String in ('FIXED_STEP', 'MERIT_BACKTRACKING', 'FILTER_LINE_SEARCH').
         Default: 'FIXED_STEP'.
+        'FILTER_LINE_SEARCH' is available for nlp_solver_type 'SQP' only and uses alpha_min,
+        alpha_reduction, eps_sufficient_descent, filter_gamma_theta and filter_gamma_phi.
 
         .. note:: preliminary implementation.
         """
@@ -2389,6 +2396,50 @@ class AcadosOcpOptions:
         """
         return self.__eps_sufficient_descent
 
+    @property
+    def filter_gamma_theta(self):
+        """
+        FILTER_LINE_SEARCH: required relative reduction of the infeasibility, also the filter margin
+        in the infeasibility, see Waechter2006, eq. (18).
+        Type: float in (0, 1),
+        default: 1e-5.
+        """
+        return self.__filter_gamma_theta
+
+    @property
+    def filter_gamma_phi(self):
+        """
+        FILTER_LINE_SEARCH: required reduction of the objective, relative to the infeasibility,
+        also the filter margin in the objective, see Waechter2006, eq. (18).
+        Type: float in (0, 1),
+        default: 1e-8.
+        """
+        return self.__filter_gamma_phi
+
+    @property
+    def ext_fun_batch_size(self):
+        """
+        Number of stages evaluated by one call of the batched (casadi map) external functions, i.e.
+        explicit ODE forward VDE (integrator_type ERK), NONLINEAR_LS path cost and BGH path constraints.
+        Each function f is additionally generated as f.map(ext_fun_batch_size); the dynamics of
+        ext_fun_batch_size consecutive stages are integrated in lockstep.
+        Type: int >= 0;
+        default: 0, i.e. stage-wise evaluation.
+        """
+        return self.__ext_fun_batch_size
+
+    @property
+    def ext_fun_zero_copy(self):
+        """
+        Zero copy argument passing of the casadi external functions of the solver, set for each of
+        them after creation with external_function_param_casadi_set_zero_copy:
+        dense column-major inputs and outputs are handed to casadi in place, sparse panel-major matrices are
+        converted through a dense column-major mirror. Can be changed per function in the generated code.
+        Type: int in [0, 1];
+        default: 0.
+        """
+        return self.__ext_fun_zero_copy
+
     @property
     def globalization_use_SOC(self):
         """
@@ -2408,6 +2459,20 @@ class AcadosOcpOptions:
         """
         return self.__full_step_dual
 
+    @property
+    def fast_path_interface(self):
+        """
+        Determines if an allocation free fast-path interface, with the dimensions used for code generation
+        baked in, is generated next to the generic one:
+        :code:`set_x0`, :code:`set_yref`, :code:`get_u0`, and for SQP_RTI :code:`rti_step`.
+        They write to and read from the acados structures directly, bypassing the string based field dispatch
+        of the acados C interface. The solver core is the generic one.
+        If 1, the number of shooting intervals cannot be changed at creation.
+        Type: int; 0 or 1;
+        default: 0.
+        """
+        return self.__fast_path_interface
+
     @property
     def nlp_solver_tol_ineq(self):
         """NLP solver inequality tolerance"""
@@ -2515,7 +2580,8 @@ class AcadosOcpOptions:
     def qp_solver(self, qp_solver):
         qp_solvers = ('PARTIAL_CONDENSING_HPIPM', \
                 'FULL_CONDENSING_QPOASES', 'FULL_CONDENSING_HPIPM', \
-                'PARTIAL_CONDENSING_QPDUNES', 'PARTIAL_CONDENSING_OSQP')
+                'PARTIAL_CONDENSING_QPDUNES', 'PARTIAL_CONDENSING_OSQP', \
+                'PARTIAL_CONDENSING_PRIC')
         if qp_solver in qp_solvers:
             self.__qp_solver = qp_solver
         else:
@@ -2589,7 +2655,7 @@ class AcadosOcpOptions:
 
     @globalization.setter
     def globalization(self, globalization):
-        globalization_types = ('MERIT_BACKTRACKING', 'FIXED_STEP')
+        globalization_types = ('MERIT_BACKTRACKING', 'FIXED_STEP', 'FILTER_LINE_SEARCH')
         if globalization in globalization_types:
             self.__globalization = globalization
         else:
@@ -2611,6 +2677,20 @@ class AcadosOcpOptions:
         else:
             raise Exception(f'Invalid value for line_search_use_sufficient_descent. Possible values are 0, 1, got {line_search_use_sufficient_descent}')
 
+    @ext_fun_batch_size.setter
+    def ext_fun_batch_size(self, ext_fun_batch_size):
+        if isinstance(ext_fun_batch_size, int) and ext_fun_batch_size >= 0:
+            self.__ext_fun_batch_size = ext_fun_batch_size
+        else:
+            raise Exception(f'Invalid value for ext_fun_batch_size. Expected nonnegative int, got {ext_fun_batch_size}')
+
+    @ext_fun_zero_copy.setter
+    def ext_fun_zero_copy(self, ext_fun_zero_copy):
+        if ext_fun_zero_copy in [0, 1]:
+            self.__ext_fun_zero_copy = ext_fun_zero_copy
+        else:
+            raise Exception(f'Invalid value for ext_fun_zero_copy. Possible values are 0, 1, got {ext_fun_zero_copy}')
+
     @globalization_use_SOC.setter
     def globalization_use_SOC(self, globalization_use_SOC):
         if globalization_use_SOC in [0, 1]:
@@ -2625,6 +2705,13 @@ class AcadosOcpOptions:
         else:
             raise Exception(f'Invalid value for full_step_dual. Possible values are 0, 1, got {full_step_dual}')
 
+    @fast_path_interface.setter
+    def fast_path_interface(self, fast_path_interface):
+        if fast_path_interface in [0, 1]:
+            self.__fast_path_interface = fast_path_interface
+        else:
+            raise Exception(f'Invalid value for fast_path_interface. Possible values are 0, 1, got {fast_path_interface}')
+
     @eps_sufficient_descent.setter
     def eps_sufficient_descent(self, eps_sufficient_descent):
         if isinstance(eps_sufficient_descent, float) and eps_sufficient_descent > 0:
@@ -2632,6 +2719,20 @@ class AcadosOcpOptions:
         else:
             raise Exception('Invalid eps_sufficient_descent value. eps_sufficient_descent must be a positive float. Exiting')
 
+    @filter_gamma_theta.setter
+    def filter_gamma_theta(self, filter_gamma_theta):
+        if isinstance(filter_gamma_theta, float) and 0 < filter_gamma_theta < 1:
+            self.__filter_gamma_theta = filter_gamma_theta
+        else:
+            raise Exception(f'Invalid value for filter_gamma_theta. Expected float in (0, 1), got {filter_gamma_theta}')
+
+    @filter_gamma_phi.setter
+    def filter_gamma_phi(self, filter_gamma_phi):
+        if isinstance(filter_gamma_phi, float) and 0 < filter_gamma_phi < 1:
+            self.__filter_gamma_phi = filter_gamma_phi
+        else:
+            raise Exception(f'Invalid value for filter_gamma_phi. Expected float in (0, 1), got {filter_gamma_phi}')
+
     @sim_method_num_stages.setter
     def sim_method_num_stages(self, sim_method_num_stages):
 
@@ -566,6 +566,7 @@ def ocp_generate_external_functions(acados_ocp, model):
         opts = dict(generate_hess=0)
     code_export_dir = acados_ocp.code_export_directory
     opts['code_export_directory'] = code_export_dir
+    opts['ext_fun_batch_size'] = acados_ocp.solver_options.ext_fun_batch_size
 
     if acados_ocp.model.dyn_ext_fun_type != 'casadi':
         raise Exception("ocp_generate_external_functions: dyn_ext_fun_type only supports 'casadi' for now.\
@@ -1198,9 +1199,11 @@ class AcadosOcpSolver:
             - time_qp_solver_call: CPU time inside qp solver (without converting the QP)
             - time_qp_xcond: time_glob: CPU time globalization
             - time_solution_sensitivities: CPU time for previous call to eval_param_sens
+            - time_qp_soc: CPU time for second order correction QPs (not included in time_qp)
             - time_reg: CPU time regularization
             - sqp_iter: number of SQP iterations
             - qp_iter: vector of QP iterations for last SQP call
+            - qp_iter_soc: number of QP iterations in second order correction QPs
             - statistics: table with info about last iteration
             - stat_m: number of rows in statistics matrix
             - stat_n: number of columns in statistics matrix
@@ -1218,9 +1221,11 @@ class AcadosOcpSolver:
                   'time_qp_xcond',
                   'time_glob',
                   'time_solution_sensitivities',
+                  'time_qp_soc',
                   'time_reg',
                   'sqp_iter',
                   'qp_iter',
+                  'qp_iter_soc',
                   'statistics',
                   'stat_m',
                   'stat_n',
@@ -1234,7 +1239,7 @@ class AcadosOcpSolver:
             raise Exception('AcadosOcpSolver.get_stats(): {} is not a valid argument.\
                     \n Possible values are {}. Exiting.'.format(fields, fields))
 
-        if field_ in ['sqp_iter', 'stat_m', 'stat_n']:
+        if field_ in ['sqp_iter', 'stat_m', 'stat_n', 'qp_iter_soc']:
             out = np.ascontiguousarray(np.zeros((1,)), dtype=np.int64)
             out_data = cast(out.ctypes.data, POINTER(c_int64))
 
@@ -1608,10 +1613,10 @@ class AcadosOcpSolver:
         """
         Set options of the solver.
 
-            :param field: string, e.g. 'print_level', 'rti_phase', 'initialize_t_slacks', 'step_length', 'alpha_min', 'alpha_reduction', 'qp_warm_start', 'line_search_use_sufficient_descent', 'full_step_dual', 'globalization_use_SOC'
+            :param field: string, e.g. 'print_level', 'rti_phase', 'initialize_t_slacks', 'step_length', 'alpha_min', 'alpha_reduction', 'qp_warm_start', 'line_search_use_sufficient_descent', 'full_step_dual', 'globalization_use_SOC', 'soc_qp_hot_start'
             :param value: of type int, float
         """
-        int_fields = ['print_level', 'rti_phase', 'initialize_t_slacks', 'qp_warm_start', 'line_search_use_sufficient_descent', 'full_step_dual', 'globalization_use_SOC']
+        int_fields = ['print_level', 'rti_phase', 'initialize_t_slacks', 'qp_warm_start', 'line_search_use_sufficient_descent', 'full_step_dual', 'globalization_use_SOC', 'soc_qp_hot_start']
         double_fields = ['step_length', 'tol_eq', 'tol_stat', 'tol_ineq', 'tol_comp', 'alpha_min', 'alpha_reduction', 'eps_sufficient_descent']
         string_fields = ['globalization']
 
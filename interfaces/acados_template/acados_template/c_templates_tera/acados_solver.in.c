@@ -35,10 +35,29 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+{%- if solver_options.ext_fun_batch_size > 1 %}
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+{%- endif %}
 // acados
 #include "acados/utils/print.h"
 #include "acados_c/ocp_nlp_interface.h"
 #include "acados_c/external_function_interface.h"
+{%- if solver_options.fast_path_interface == 1 %}
+// module headers, for the fast-path functions
+{%- if constraints.constr_type == "BGP" %}
+#include "acados/ocp_nlp/ocp_nlp_constraints_bgp.h"
+{%- else %}
+#include "acados/ocp_nlp/ocp_nlp_constraints_bgh.h"
+{%- endif %}
+{%- if cost.cost_type_0 == "LINEAR_LS" or cost.cost_type == "LINEAR_LS" or cost.cost_type_e == "LINEAR_LS" %}
+#include "acados/ocp_nlp/ocp_nlp_cost_ls.h"
+{%- endif %}
+{%- if cost.cost_type_0 == "NONLINEAR_LS" or cost.cost_type == "NONLINEAR_LS" or cost.cost_type_e == "NONLINEAR_LS" %}
+#include "acados/ocp_nlp/ocp_nlp_cost_nls.h"
+{%- endif %}
+{%- endif %}
 
 // example specific
 #include "{{ model.name }}_model/{{ model.name }}_model.h"
@@ -234,7 +253,12 @@ ocp_nlp_dims* {{ model.name }}_acados_create_2_create_and_set_dimensions({{ mode
     *  dimensions
     ************************************************/
     #define NINTNP1MEMS 17
+{%- if solver_options.fast_path_interface == 1 %}
+    // N is fixed to the number of shooting intervals used for code generation
+    int intNp1mem[({{ model.name | upper }}_N+1)*NINTNP1MEMS];
+{%- else %}
     int* intNp1mem = (int*)malloc( (N+1)*sizeof(int)*NINTNP1MEMS );
+{%- endif %}
 
     int* nx    = intNp1mem + (N+1)*0;
     int* nu    = intNp1mem + (N+1)*1;
@@ -356,7 +380,9 @@ ocp_nlp_dims* {{ model.name }}_acados_create_2_create_and_set_dimensions({{ mode
 {%- if cost.cost_type_e == "NONLINEAR_LS" or cost.cost_type_e == "LINEAR_LS" %}
     ocp_nlp_dims_set_cost(nlp_config, nlp_dims, N, "ny", &ny[N]);
 {%- endif %}
+{%- if solver_options.fast_path_interface != 1 %}
     free(intNp1mem);
+{%- endif %}
 
 {%- if solver_options.integrator_type == "GNSF" -%}
     // GNSF specific dimensions
@@ -402,8 +428,29 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
         capsule->__CAPSULE_FNC__.casadi_sparsity_out = & __MODEL_BASE_FNC__ ## _sparsity_out; \
         capsule->__CAPSULE_FNC__.casadi_work = & __MODEL_BASE_FNC__ ## _work; \
         external_function_param_casadi_create(&capsule->__CAPSULE_FNC__ , {{ dims.np }}); \
+        external_function_param_casadi_set_zero_copy(&capsule->__CAPSULE_FNC__, {{ solver_options.ext_fun_zero_copy }}); \
     }while(false)
 
+{%- if solver_options.ext_fun_batch_size > 1 %}
+
+    // maps of the external functions evaluated {{ solver_options.ext_fun_batch_size }} stages at a time,
+    // one scratch memory per batch in flight, i.e. per thread
+    int ext_fun_num_scratch = 1;
+#if defined(_OPENMP)
+    ext_fun_num_scratch = omp_get_max_threads();
+#endif
+
+#define MAP_CASADI_MAP(__CAPSULE_MAP__, __MODEL_BASE_FNC__) do{ \
+        capsule->__CAPSULE_MAP__.casadi_fun = & __MODEL_BASE_FNC__ ## _map; \
+        capsule->__CAPSULE_MAP__.casadi_n_in = & __MODEL_BASE_FNC__ ## _map_n_in; \
+        capsule->__CAPSULE_MAP__.casadi_n_out = & __MODEL_BASE_FNC__ ## _map_n_out; \
+        capsule->__CAPSULE_MAP__.casadi_sparsity_in = & __MODEL_BASE_FNC__ ## _map_sparsity_in; \
+        capsule->__CAPSULE_MAP__.casadi_sparsity_out = & __MODEL_BASE_FNC__ ## _map_sparsity_out; \
+        capsule->__CAPSULE_MAP__.casadi_work = & __MODEL_BASE_FNC__ ## _map_work; \
+        external_function_casadi_map_create(&capsule->__CAPSULE_MAP__, {{ solver_options.ext_fun_batch_size }}, ext_fun_num_scratch); \
+    }while(false)
+{%- endif %}
+
 {% if constraints.constr_type == "BGP" %}
     // constraints.constr_type == "BGP"
     capsule->phi_constraint = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*N);
@@ -426,6 +473,11 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
     for (int i = 0; i < N; i++) {
         MAP_CASADI_FNC(nl_constr_h_fun_jac[i], {{ model.name }}_constr_h_fun_jac_uxt_zt);
     }
+    {%- if solver_options.ext_fun_batch_size > 1 %}
+    MAP_CASADI_MAP(nl_constr_h_fun_jac_map, {{ model.name }}_constr_h_fun_jac_uxt_zt);
+    for (int i = 0; i < N; i++)
+        external_function_param_casadi_set_map(&capsule->nl_constr_h_fun_jac[i], &capsule->nl_constr_h_fun_jac_map);
+    {%- endif %}
     capsule->nl_constr_h_fun = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*N);
     for (int i = 0; i < N; i++) {
         MAP_CASADI_FNC(nl_constr_h_fun[i], {{ model.name }}_constr_h_fun);
@@ -453,6 +505,11 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
     for (int i = 0; i < N; i++) {
         MAP_CASADI_FNC(forw_vde_casadi[i], {{ model.name }}_expl_vde_forw);
     }
+    {%- if solver_options.ext_fun_batch_size > 1 %}
+    MAP_CASADI_MAP(forw_vde_casadi_map, {{ model.name }}_expl_vde_forw);
+    for (int i = 0; i < N; i++)
+        external_function_param_casadi_set_map(&capsule->forw_vde_casadi[i], &capsule->forw_vde_casadi_map);
+    {%- endif %}
 
     capsule->expl_ode_fun = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*N);
     for (int i = 0; i < N; i++) {
@@ -613,6 +670,11 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
     {
         MAP_CASADI_FNC(cost_y_fun_jac_ut_xt[i], {{ model.name }}_cost_y_fun_jac_ut_xt);
     }
+    {%- if solver_options.ext_fun_batch_size > 1 %}
+    MAP_CASADI_MAP(cost_y_fun_jac_ut_xt_map, {{ model.name }}_cost_y_fun_jac_ut_xt);
+    for (int i = 0; i < N-1; i++)
+        external_function_param_casadi_set_map(&capsule->cost_y_fun_jac_ut_xt[i], &capsule->cost_y_fun_jac_ut_xt_map);
+    {%- endif %}
 
     capsule->cost_y_hess = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*N);
     for (int i = 0; i < N-1; i++)
@@ -1730,9 +1792,32 @@ void {{ model.name }}_acados_create_6_set_opts({{ model.name }}_solver_capsule*
 
     double eps_sufficient_descent = {{ solver_options.eps_sufficient_descent }};
     ocp_nlp_solver_opts_set(nlp_config, capsule->nlp_opts, "eps_sufficient_descent", &eps_sufficient_descent);
+{%- elif solver_options.globalization == "FILTER_LINE_SEARCH" %}
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "globalization", "filter_line_search");
+
+    double alpha_min = {{ solver_options.alpha_min }};
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "alpha_min", &alpha_min);
+
+    double alpha_reduction = {{ solver_options.alpha_reduction }};
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "alpha_reduction", &alpha_reduction);
+
+    double eps_sufficient_descent = {{ solver_options.eps_sufficient_descent }};
+    ocp_nlp_solver_opts_set(nlp_config, capsule->nlp_opts, "eps_sufficient_descent", &eps_sufficient_descent);
+
+    double filter_gamma_theta = {{ solver_options.filter_gamma_theta }};
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "filter_gamma_theta", &filter_gamma_theta);
+
+    double filter_gamma_phi = {{ solver_options.filter_gamma_phi }};
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "filter_gamma_phi", &filter_gamma_phi);
 {%- endif -%}
     int full_step_dual = {{ solver_options.full_step_dual }};
     ocp_nlp_solver_opts_set(nlp_config, capsule->nlp_opts, "full_step_dual", &full_step_dual);
+{%- if solver_options.integrator_type == "ERK" and solver_options.ext_fun_batch_size > 1 %}
+
+    // integrate the stages of one call of the forward VDE map in lockstep
+    int dyn_batch_size = {{ solver_options.ext_fun_batch_size }};
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "dyn_batch_size", &dyn_batch_size);
+{%- endif %}
 
 {%- if dims.nz > 0 %}
     // TODO: these options are lower level -> should be encapsulated! maybe through hessian approx option.
@@ -2000,6 +2085,15 @@ int {{ model.name }}_acados_create_with_discretization({{ model.name }}_solver_c
              N, {{ model.name | upper }}_N);
         return 1;
     }
+{%- if solver_options.fast_path_interface == 1 %}
+    // the fast-path interface has the dimensions used for code generation baked in
+    if (N != {{ model.name | upper }}_N) {
+        fprintf(stderr, "{{ model.name }}_acados_create_with_discretization: the solver was generated with " \
+            "fast_path_interface, the number of shooting intervals (= %d) must match the one used " \
+            "during code generation (= %d)!\n", N, {{ model.name | upper }}_N);
+        return 1;
+    }
+{%- endif %}
 
     // number of expected runtime parameters
     capsule->nlp_np = NP;
@@ -2014,6 +2108,7 @@ int {{ model.name }}_acados_create_with_discretization({{ model.name }}_solver_c
     {{ model.name }}_acados_create_3_create_and_set_functions(capsule);
 
     // 4) set default parameters in functions
+    capsule->nlp_in = NULL;  // created in 5)
     {{ model.name }}_acados_create_4_set_default_parameters(capsule);
 
     // 5) create and set nlp_in
@@ -2084,6 +2179,11 @@ int {{ model.name }}_acados_update_params({{ model.name }}_solver_capsule* capsu
 
 {%- if dims.np > 0 %}
     const int N = capsule->nlp_solver_plan->N;
+
+    // the parameters are read by the external functions, e.g. in an asynchronous preparation phase
+    if (capsule->nlp_in)
+        ocp_nlp_modify_hook_call(&capsule->nlp_in->modify_hook, stage, "parameter_values");
+
     if (stage < N && stage >= 0)
     {
     {%- if solver_options.integrator_type == "IRK" %}
@@ -2190,6 +2290,119 @@ int {{ model.name }}_acados_update_params({{ model.name }}_solver_capsule* capsu
 
 
 
+{%- if solver_options.fast_path_interface == 1 %}
+
+
+/**
+ * Fast-path interface: all dimensions and offsets are those used for code generation, the data is
+ * written to and read from the acados structures directly. Like the generic setters and getters,
+ * they go through the modify hooks of nlp_in and nlp_out, which synchronize with a solver working
+ * on them concurrently (the asynchronous preparation of SQP_RTI).
+ */
+void {{ model.name }}_acados_set_x0({{ model.name }}_solver_capsule* capsule, const double *x0)
+{
+{%- if dims.nbx_0 > 0 %}
+{%- if constraints.constr_type == "BGP" %}
+    ocp_nlp_constraints_bgp_model *model = capsule->nlp_in->constraints[0];
+    // d = [lbu lbx lg lphi ubu ubx ug uphi]
+    double *lbx = model->d.pa + NBU;
+    double *ubx = model->d.pa + NBU + NBX0 + NG + NPHI + NBU;
+{%- else %}
+    ocp_nlp_constraints_bgh_model *model = capsule->nlp_in->constraints[0];
+    // d = [lbu lbx lg lh ubu ubx ug uh]
+    double *lbx = model->d.pa + NBU;
+    double *ubx = model->d.pa + NBU + NBX0 + NG + NH + NBU;
+{%- endif %}
+    ocp_nlp_modify_hook_call(&capsule->nlp_in->modify_hook, 0, "lbx");
+    ocp_nlp_modify_hook_call(&capsule->nlp_in->modify_hook, 0, "ubx");
+{%- for i in range(end=dims.nbx_0) %}
+    lbx[{{ i }}] = x0[{{ constraints.idxbx_0[i] }}];
+    ubx[{{ i }}] = x0[{{ constraints.idxbx_0[i] }}];
+{%- endfor %}
+{%- endif %}
+}
+
+
+int {{ model.name }}_acados_set_yref({{ model.name }}_solver_capsule* capsule, int stage, const double *yref)
+{
+    double *y_ref;
+
+    if (stage >= 0 && stage <= {{ model.name | upper }}_N)
+        ocp_nlp_modify_hook_call(&capsule->nlp_in->modify_hook, stage, "yref");
+
+    if (stage == 0)
+    {
+{%- if cost.cost_type_0 == "LINEAR_LS" %}
+        y_ref = ((ocp_nlp_cost_ls_model *) capsule->nlp_in->cost[0])->y_ref.pa;
+        for (int j = 0; j < NY0; j++)
+            y_ref[j] = yref[j];
+        return 0;
+{%- elif cost.cost_type_0 == "NONLINEAR_LS" %}
+        y_ref = ((ocp_nlp_cost_nls_model *) capsule->nlp_in->cost[0])->y_ref.pa;
+        for (int j = 0; j < NY0; j++)
+            y_ref[j] = yref[j];
+        return 0;
+{%- endif %}
+    }
+    else if (stage < {{ model.name | upper }}_N)
+    {
+{%- if cost.cost_type == "LINEAR_LS" %}
+        y_ref = ((ocp_nlp_cost_ls_model *) capsule->nlp_in->cost[stage])->y_ref.pa;
+        for (int j = 0; j < NY; j++)
+            y_ref[j] = yref[j];
+        return 0;
+{%- elif cost.cost_type == "NONLINEAR_LS" %}
+        y_ref = ((ocp_nlp_cost_nls_model *) capsule->nlp_in->cost[stage])->y_ref.pa;
+        for (int j = 0; j < NY; j++)
+            y_ref[j] = yref[j];
+        return 0;
+{%- endif %}
+    }
+    else if (stage == {{ model.name | upper }}_N)
+    {
+{%- if cost.cost_type_e == "LINEAR_LS" %}
+        y_ref = ((ocp_nlp_cost_ls_model *) capsule->nlp_in->cost[stage])->y_ref.pa;
+        for (int j = 0; j < NYN; j++)
+            y_ref[j] = yref[j];
+        return 0;
+{%- elif cost.cost_type_e == "NONLINEAR_LS" %}
+        y_ref = ((ocp_nlp_cost_nls_model *) capsule->nlp_in->cost[stage])->y_ref.pa;
+        for (int j = 0; j < NYN; j++)
+            y_ref[j] = yref[j];
+        return 0;
+{%- endif %}
+    }
+
+    // stage out of range, or cost module without y_ref
+    return 1;
+}
+
+
+void {{ model.name }}_acados_get_u0({{ model.name }}_solver_capsule* capsule, double *u0)
+{
+    ocp_nlp_modify_hook_wait(&capsule->nlp_out->modify_hook);
+
+    // ux = [u; x; s]
+    const double *ux = capsule->nlp_out->ux[0].pa;
+    for (int j = 0; j < NU; j++)
+        u0[j] = ux[j];
+}
+
+{%- if solver_options.nlp_solver_type == "SQP_RTI" %}
+
+
+int {{ model.name }}_acados_rti_step({{ model.name }}_solver_capsule* capsule, const double *x0, double *u0)
+{
+    {{ model.name }}_acados_set_x0(capsule, x0);
+    int solver_status = ocp_nlp_solve(capsule->nlp_solver, capsule->nlp_in, capsule->nlp_out);
+    {{ model.name }}_acados_get_u0(capsule, u0);
+
+    return solver_status;
+}
+{%- endif %}
+{%- endif %}{# fast_path_interface #}
+
+
 int {{ model.name }}_acados_solve({{ model.name }}_solver_capsule* capsule)
 {
     // solve NLP 
@@ -2252,6 +2465,9 @@ int {{ model.name }}_acados_free({{ model.name }}_solver_capsule* capsule)
     }
     free(capsule->forw_vde_casadi);
     free(capsule->expl_ode_fun);
+    {%- if solver_options.ext_fun_batch_size > 1 %}
+    external_function_casadi_map_free(&capsule->forw_vde_casadi_map);
+    {%- endif %}
     {%- if solver_options.hessian_approx == "EXACT" %}
     free(capsule->hess_vde_casadi);
     {%- endif %}
@@ -2315,6 +2531,9 @@ int {{ model.name }}_acados_free({{ model.name }}_solver_capsule* capsule)
     free(capsule->cost_y_fun);
     free(capsule->cost_y_fun_jac_ut_xt);
     free(capsule->cost_y_hess);
+    {%- if solver_options.ext_fun_batch_size > 1 %}
+    external_function_casadi_map_free(&capsule->cost_y_fun_jac_ut_xt_map);
+    {%- endif %}
 {%- elif cost.cost_type == "EXTERNAL" %}
     for (int i = 0; i < N - 1; i++)
     {
@@ -2351,6 +2570,9 @@ int {{ model.name }}_acados_free({{ model.name }}_solver_capsule* capsule)
   {%- endif %}
     free(capsule->nl_constr_h_fun_jac);
     free(capsule->nl_constr_h_fun);
+  {%- if solver_options.ext_fun_batch_size > 1 %}
+    external_function_casadi_map_free(&capsule->nl_constr_h_fun_jac_map);
+  {%- endif %}
   {%- if solver_options.hessian_approx == "EXACT" %}
     free(capsule->nl_constr_h_fun_jac_hess);
   {%- endif %}
@@ -67,6 +67,9 @@
 #define {{ model.name | upper }}_NHN    {{ dims.nh_e }}
 #define {{ model.name | upper }}_NPHIN  {{ dims.nphi_e }}
 #define {{ model.name | upper }}_NR     {{ dims.nr }}
+{%- if solver_options.fast_path_interface == 1 %}
+#define {{ model.name | upper }}_FAST_PATH_INTERFACE 1
+{%- endif %}
 
 #ifdef __cplusplus
 extern "C" {
@@ -92,6 +95,9 @@ typedef struct {{ model.name }}_solver_capsule
     // dynamics
 {% if solver_options.integrator_type == "ERK" %}
     external_function_param_casadi *forw_vde_casadi;
+{%- if solver_options.ext_fun_batch_size > 1 %}
+    external_function_casadi_map forw_vde_casadi_map;  // batched evaluation of the stages
+{%- endif %}
     external_function_param_casadi *expl_ode_fun;
 {% if solver_options.hessian_approx == "EXACT" %}
     external_function_param_casadi *hess_vde_casadi;
@@ -125,6 +131,9 @@ typedef struct {{ model.name }}_solver_capsule
 {% if cost.cost_type == "NONLINEAR_LS" %}
     external_function_param_casadi *cost_y_fun;
     external_function_param_casadi *cost_y_fun_jac_ut_xt;
+{%- if solver_options.ext_fun_batch_size > 1 %}
+    external_function_casadi_map cost_y_fun_jac_ut_xt_map;  // batched evaluation of the stages
+{%- endif %}
     external_function_param_casadi *cost_y_hess;
 {%- elif cost.cost_type == "EXTERNAL" %}
     external_function_param_{{ cost.cost_ext_fun_type }} *ext_cost_fun;
@@ -157,6 +166,9 @@ typedef struct {{ model.name }}_solver_capsule
     external_function_param_casadi *phi_constraint;
 {% elif constraints.constr_type == "BGH" and dims.nh > 0 %}
     external_function_param_casadi *nl_constr_h_fun_jac;
+{%- if solver_options.ext_fun_batch_size > 1 %}
+    external_function_casadi_map nl_constr_h_fun_jac_map;  // batched evaluation of the stages
+{%- endif %}
     external_function_param_casadi *nl_constr_h_fun;
     external_function_param_casadi *nl_constr_h_fun_jac_hess;
 {%- endif %}
@@ -195,6 +207,26 @@ int {{ model.name }}_acados_update_params({{ model.name }}_solver_capsule * caps
 int {{ model.name }}_acados_solve({{ model.name }}_solver_capsule * capsule);
 int {{ model.name }}_acados_free({{ model.name }}_solver_capsule * capsule);
 void {{ model.name }}_acados_print_stats({{ model.name }}_solver_capsule * capsule);
+{%- if solver_options.fast_path_interface == 1 %}
+
+// fast path, with the dimensions used for code generation
+/**
+ * Fixes the bounded components of the initial state (idxbx_0) to the values in x0, of size NX.
+ */
+void {{ model.name }}_acados_set_x0({{ model.name }}_solver_capsule * capsule, const double *x0);
+/**
+ * Sets the cost reference of a (nonlinear) least-squares stage. Returns 0 on success, 1 if the stage is out
+ * of range or its cost has no reference.
+ */
+int {{ model.name }}_acados_set_yref({{ model.name }}_solver_capsule * capsule, int stage, const double *yref);
+void {{ model.name }}_acados_get_u0({{ model.name }}_solver_capsule * capsule, double *u0);
+{%- if solver_options.nlp_solver_type == "SQP_RTI" %}
+/**
+ * One real-time iteration: sets x0, solves, and writes the first control to u0. Returns the solver status.
+ */
+int {{ model.name }}_acados_rti_step({{ model.name }}_solver_capsule * capsule, const double *x0, double *u0);
+{%- endif %}
+{%- endif %}
 
 ocp_nlp_in *{{ model.name }}_acados_get_nlp_in({{ model.name }}_solver_capsule * capsule);
 ocp_nlp_out *{{ model.name }}_acados_get_nlp_out({{ model.name }}_solver_capsule * capsule);
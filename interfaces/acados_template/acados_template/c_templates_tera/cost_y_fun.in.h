@@ -53,6 +53,14 @@ const int *{{ model.name }}_cost_y_fun_jac_ut_xt_sparsity_in(int);
 const int *{{ model.name }}_cost_y_fun_jac_ut_xt_sparsity_out(int);
 int {{ model.name }}_cost_y_fun_jac_ut_xt_n_in(void);
 int {{ model.name }}_cost_y_fun_jac_ut_xt_n_out(void);
+{%- if solver_options.ext_fun_batch_size > 1 %}
+int {{ model.name }}_cost_y_fun_jac_ut_xt_map(const real_t** arg, real_t** res, int* iw, real_t* w, void *mem);
+int {{ model.name }}_cost_y_fun_jac_ut_xt_map_work(int *, int *, int *, int *);
+const int *{{ model.name }}_cost_y_fun_jac_ut_xt_map_sparsity_in(int);
+const int *{{ model.name }}_cost_y_fun_jac_ut_xt_map_sparsity_out(int);
+int {{ model.name }}_cost_y_fun_jac_ut_xt_map_n_in(void);
+int {{ model.name }}_cost_y_fun_jac_ut_xt_map_n_out(void);
+{%- endif %}
 
 int {{ model.name }}_cost_y_hess(const real_t** arg, real_t** res, int* iw, real_t* w, void *mem);
 int {{ model.name }}_cost_y_hess_work(int *, int *, int *, int *);
@@ -45,6 +45,14 @@ const int *{{ model.name }}_constr_h_fun_jac_uxt_zt_sparsity_in(int);
 const int *{{ model.name }}_constr_h_fun_jac_uxt_zt_sparsity_out(int);
 int {{ model.name }}_constr_h_fun_jac_uxt_zt_n_in(void);
 int {{ model.name }}_constr_h_fun_jac_uxt_zt_n_out(void);
+{%- if solver_options.ext_fun_batch_size > 1 %}
+int {{ model.name }}_constr_h_fun_jac_uxt_zt_map(const real_t** arg, real_t** res, int* iw, real_t* w, void *mem);
+int {{ model.name }}_constr_h_fun_jac_uxt_zt_map_work(int *, int *, int *, int *);
+const int *{{ model.name }}_constr_h_fun_jac_uxt_zt_map_sparsity_in(int);
+const int *{{ model.name }}_constr_h_fun_jac_uxt_zt_map_sparsity_out(int);
+int {{ model.name }}_constr_h_fun_jac_uxt_zt_map_n_in(void);
+int {{ model.name }}_constr_h_fun_jac_uxt_zt_map_n_out(void);
+{%- endif %}
 
 int {{ model.name }}_constr_h_fun(const real_t** arg, real_t** res, int* iw, real_t* w, void *mem);
 int {{ model.name }}_constr_h_fun_work(int *, int *, int *, int *);
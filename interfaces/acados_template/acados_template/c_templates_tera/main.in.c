@@ -38,6 +38,7 @@
 // acados
 #include "acados/utils/print.h"
 #include "acados/utils/math.h"
+#include "acados/utils/timing.h"
 #include "acados_c/ocp_nlp_interface.h"
 #include "acados_c/external_function_interface.h"
 #include "acados_solver_{{ model.name }}.h"
@@ -201,6 +202,101 @@ int main()
     printf(" SQP iterations %2d\n minimum time for %d solve %f [ms]\n KKT %e\n",
            sqp_iter, NTIMINGS, min_time*1000, kkt_norm_inf);
 
+{%- if solver_options.fast_path_interface == 1 and solver_options.nlp_solver_type == "SQP_RTI" %}
+
+    /* RTI latency: string based C interface vs fast-path interface */
+    // one tick: set x0 and the references on all stages, call the solver, get u0
+    int n_rti = 1000;
+    acados_timer timer;
+    double time_tick, time_solver;
+    double x_rti[NX];
+    double u_rti[NU+1];
+    double lbx_rti[NBX0+1];
+{%- if (cost.cost_type_0 == "LINEAR_LS" or cost.cost_type_0 == "NONLINEAR_LS") and dims.ny_0 > 0 %}
+    double yref_0_rti[NY0];
+    {%- for j in range(end=dims.ny_0) %}
+    yref_0_rti[{{ j }}] = {{ cost.yref_0[j] }};
+    {%- endfor %}
+{%- endif %}
+{%- if (cost.cost_type == "LINEAR_LS" or cost.cost_type == "NONLINEAR_LS") and dims.ny > 0 %}
+    double yref_rti[NY];
+    {%- for j in range(end=dims.ny) %}
+    yref_rti[{{ j }}] = {{ cost.yref[j] }};
+    {%- endfor %}
+{%- endif %}
+{%- if (cost.cost_type_e == "LINEAR_LS" or cost.cost_type_e == "NONLINEAR_LS") and dims.ny_e > 0 %}
+    double yref_e_rti[NYN];
+    {%- for j in range(end=dims.ny_e) %}
+    yref_e_rti[{{ j }}] = {{ cost.yref_e[j] }};
+    {%- endfor %}
+{%- endif %}
+
+    // initial state taken from the bounds used for code generation
+    for (int j = 0; j < NX; j++)
+        x_rti[j] = 0.0;
+    for (int j = 0; j < NBX0; j++)
+        x_rti[idxbx0[j]] = lbx0[j];
+
+    double time_generic = 0.0, time_generic_min = 1e12, time_generic_solver = 0.0;
+    double time_fast = 0.0, time_fast_min = 1e12, time_fast_solver = 0.0;
+
+    for (int ii = 0; ii < n_rti; ii++)
+    {
+        acados_tic(&timer);
+        for (int j = 0; j < NBX0; j++)
+            lbx_rti[j] = x_rti[idxbx0[j]];
+        ocp_nlp_constraints_model_set(nlp_config, nlp_dims, nlp_in, 0, "lbx", lbx_rti);
+        ocp_nlp_constraints_model_set(nlp_config, nlp_dims, nlp_in, 0, "ubx", lbx_rti);
+{%- if (cost.cost_type_0 == "LINEAR_LS" or cost.cost_type_0 == "NONLINEAR_LS") and dims.ny_0 > 0 %}
+        ocp_nlp_cost_model_set(nlp_config, nlp_dims, nlp_in, 0, "yref", yref_0_rti);
+{%- endif %}
+{%- if (cost.cost_type == "LINEAR_LS" or cost.cost_type == "NONLINEAR_LS") and dims.ny > 0 %}
+        for (int i = 1; i < N; i++)
+            ocp_nlp_cost_model_set(nlp_config, nlp_dims, nlp_in, i, "yref", yref_rti);
+{%- endif %}
+{%- if (cost.cost_type_e == "LINEAR_LS" or cost.cost_type_e == "NONLINEAR_LS") and dims.ny_e > 0 %}
+        ocp_nlp_cost_model_set(nlp_config, nlp_dims, nlp_in, N, "yref", yref_e_rti);
+{%- endif %}
+        status = {{ model.name }}_acados_solve(acados_ocp_capsule);
+        ocp_nlp_out_get(nlp_config, nlp_dims, nlp_out, 0, "u", u_rti);
+        time_tick = acados_toc(&timer);
+
+        ocp_nlp_get(nlp_config, nlp_solver, "time_tot", &time_solver);
+        time_generic += time_tick;
+        time_generic_solver += time_solver;
+        time_generic_min = MIN(time_tick, time_generic_min);
+    }
+
+    for (int ii = 0; ii < n_rti; ii++)
+    {
+        acados_tic(&timer);
+{%- if (cost.cost_type_0 == "LINEAR_LS" or cost.cost_type_0 == "NONLINEAR_LS") and dims.ny_0 > 0 %}
+        {{ model.name }}_acados_set_yref(acados_ocp_capsule, 0, yref_0_rti);
+{%- endif %}
+{%- if (cost.cost_type == "LINEAR_LS" or cost.cost_type == "NONLINEAR_LS") and dims.ny > 0 %}
+        for (int i = 1; i < N; i++)
+            {{ model.name }}_acados_set_yref(acados_ocp_capsule, i, yref_rti);
+{%- endif %}
+{%- if (cost.cost_type_e == "LINEAR_LS" or cost.cost_type_e == "NONLINEAR_LS") and dims.ny_e > 0 %}
+        {{ model.name }}_acados_set_yref(acados_ocp_capsule, N, yref_e_rti);
+{%- endif %}
+        status = {{ model.name }}_acados_rti_step(acados_ocp_capsule, x_rti, u_rti);
+        time_tick = acados_toc(&timer);
+
+        ocp_nlp_get(nlp_config, nlp_solver, "time_tot", &time_solver);
+        time_fast += time_tick;
+        time_fast_solver += time_solver;
+        time_fast_min = MIN(time_tick, time_fast_min);
+    }
+
+    printf("\nRTI latency over %d ticks [us]:\n", n_rti);
+    printf(" %-12s %10s %10s %12s\n", "interface", "mean", "min", "overhead");
+    printf(" %-12s %10.2f %10.2f %12.2f\n", "generic", 1e6*time_generic/n_rti, 1e6*time_generic_min,
+           1e6*(time_generic - time_generic_solver)/n_rti);
+    printf(" %-12s %10.2f %10.2f %12.2f\n", "fast path", 1e6*time_fast/n_rti, 1e6*time_fast_min,
+           1e6*(time_fast - time_fast_solver)/n_rti);
+{%- endif %}{# fast_path_interface, SQP_RTI #}
+
     // free solver
     status = {{ model.name }}_acados_free(acados_ocp_capsule);
     if (status) {
@@ -35,6 +35,9 @@ SOURCES = { ...
         {%- if solver_options.integrator_type == 'ERK' %}
             '{{ model.name }}_model/{{ model.name }}_expl_ode_fun.c', ...
             '{{ model.name }}_model/{{ model.name }}_expl_vde_forw.c',...
+            {%- if solver_options.ext_fun_batch_size > 1 %}
+            '{{ model.name }}_model/{{ model.name }}_expl_vde_forw_map.c',...
+            {%- endif %}
             {%- if solver_options.hessian_approx == 'EXACT' %}
             '{{ model.name }}_model/{{ model.name }}_expl_ode_hess.c',...
             {%- endif %}
@@ -75,6 +78,9 @@ SOURCES = { ...
         {%- if cost.cost_type == "NONLINEAR_LS" %}
             '{{ model.name }}_cost/{{ model.name }}_cost_y_fun.c',...
             '{{ model.name }}_cost/{{ model.name }}_cost_y_fun_jac_ut_xt.c',...
+            {%- if solver_options.ext_fun_batch_size > 1 %}
+            '{{ model.name }}_cost/{{ model.name }}_cost_y_fun_jac_ut_xt_map.c',...
+            {%- endif %}
             '{{ model.name }}_cost/{{ model.name }}_cost_y_hess.c',...
         {%- elif cost.cost_type == "EXTERNAL" %}
             '{{ model.name }}_cost/{{ model.name }}_cost_ext_cost_fun.c',...
@@ -94,6 +100,9 @@ SOURCES = { ...
             '{{ model.name }}_constraints/{{ model.name }}_constr_h_fun.c', ...
             '{{ model.name }}_constraints/{{ model.name }}_constr_h_fun_jac_uxt_zt_hess.c', ...
             '{{ model.name }}_constraints/{{ model.name }}_constr_h_fun_jac_uxt_zt.c', ...
+            {%- if solver_options.ext_fun_batch_size > 1 %}
+            '{{ model.name }}_constraints/{{ model.name }}_constr_h_fun_jac_uxt_zt_map.c', ...
+            {%- endif %}
         {%- elif constraints.constr_type == "BGP" and dims.nphi > 0 %}
             '{{ model.name }}_constraints/{{ model.name }}_phi_constraint.c', ...
         {%- endif %}
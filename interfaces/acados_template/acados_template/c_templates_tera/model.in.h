@@ -150,6 +150,16 @@ const int *{{ model.name }}_expl_vde_forw_sparsity_in(int);
 const int *{{ model.name }}_expl_vde_forw_sparsity_out(int);
 int {{ model.name }}_expl_vde_forw_n_in(void);
 int {{ model.name }}_expl_vde_forw_n_out(void);
+{%- if solver_options.ext_fun_batch_size and solver_options.ext_fun_batch_size > 1 %}
+
+// explicit forward VDE of solver_options.ext_fun_batch_size stages
+int {{ model.name }}_expl_vde_forw_map(const real_t** arg, real_t** res, int* iw, real_t* w, void *mem);
+int {{ model.name }}_expl_vde_forw_map_work(int *, int *, int *, int *);
+const int *{{ model.name }}_expl_vde_forw_map_sparsity_in(int);
+const int *{{ model.name }}_expl_vde_forw_map_sparsity_out(int);
+int {{ model.name }}_expl_vde_forw_map_n_in(void);
+int {{ model.name }}_expl_vde_forw_map_n_out(void);
+{%- endif %}
 
 // explicit adjoint VDE
 int {{ model.name }}_expl_vde_adj(const real_t** arg, real_t** res, int* iw, real_t* w, void *mem);
@@ -33,7 +33,7 @@
 
 import os
 from casadi import *
-from .utils import ALLOWED_CASADI_VERSIONS, is_empty, casadi_length, casadi_version_warning
+from .utils import ALLOWED_CASADI_VERSIONS, is_empty, casadi_length, casadi_version_warning, generate_c_code_map
 
 def generate_c_code_constraint( model, con_name, is_terminal, opts ):
 
@@ -110,6 +110,8 @@ def generate_c_code_constraint( model, con_name, is_terminal, opts ):
                     [con_h_expr, jac_ux_t, jac_z_t])
 
             constraint_fun_jac_tran.generate(fun_name, casadi_opts)
+            if not is_terminal and opts.get('ext_fun_batch_size', 0) > 1:
+                generate_c_code_map(constraint_fun_jac_tran, opts['ext_fun_batch_size'], casadi_opts)
             if opts['generate_hess']:
 
                 if is_terminal:
@@ -33,7 +33,7 @@
 
 import os
 from casadi import *
-from .utils import ALLOWED_CASADI_VERSIONS, is_empty, casadi_version_warning
+from .utils import ALLOWED_CASADI_VERSIONS, is_empty, casadi_version_warning, generate_c_code_map
 
 def generate_c_code_explicit_ode( model, opts ):
 
@@ -45,6 +45,7 @@ def generate_c_code_explicit_ode( model, opts ):
 
     generate_hess = opts["generate_hess"]
     code_export_dir = opts["code_export_directory"]
+    ext_fun_batch_size = opts.get("ext_fun_batch_size", 0)
 
     # load model
     x = model.x
@@ -112,6 +113,8 @@ def generate_c_code_explicit_ode( model, opts ):
 
     fun_name = model_name + '_expl_vde_forw'
     expl_vde_forw.generate(fun_name, casadi_opts)
+    if ext_fun_batch_size > 1:
+        generate_c_code_map(expl_vde_forw, ext_fun_batch_size, casadi_opts)
 
     fun_name = model_name + '_expl_vde_adj'
     expl_vde_adj.generate(fun_name, casadi_opts)
@@ -33,7 +33,7 @@
 
 import os
 from casadi import *
-from .utils import ALLOWED_CASADI_VERSIONS, casadi_length, casadi_version_warning
+from .utils import ALLOWED_CASADI_VERSIONS, casadi_length, casadi_version_warning, generate_c_code_map
 
 def generate_c_code_nls_cost( model, cost_name, stage_type, opts ):
 
@@ -101,6 +101,8 @@ def generate_c_code_nls_cost( model, cost_name, stage_type, opts ):
     y_fun_jac_ut_xt = Function(fun_name, [x, u, p], \
             [ cost_expr, cost_jac_expr ])
     y_fun_jac_ut_xt.generate( fun_name, casadi_opts )
+    if stage_type == 'path' and opts.get('ext_fun_batch_size', 0) > 1:
+        generate_c_code_map(y_fun_jac_ut_xt, opts['ext_fun_batch_size'], casadi_opts)
 
     suffix_name = '_hess'
     fun_name = cost_name + middle_name + suffix_name
@@ -129,6 +129,20 @@ def casadi_length(x):
                         + " Got: " + str(type(x)))
 
 
+def generate_c_code_map(fun, batch_size, casadi_opts):
+    """
+    Generate fun.map(batch_size) as <name of fun>_map, evaluating batch_size instances of fun
+    in one call, with arguments and results of the instances concatenated horizontally;
+    see external_function_casadi_map in acados/utils/external_function_generic.h
+    """
+    fun_name = fun.name() + '_map'
+    fun_map = fun.map(fun_name, 'serial', batch_size, [], [])
+    if fun.is_a('SXFunction'):
+        # a single expression graph for all instances
+        fun_map = fun_map.expand(fun_name)
+    fun_map.generate(fun_name, casadi_opts)
+
+
 def make_model_consistent(model):
     x = model.x
     xdot = model.xdot
@@ -765,7 +765,8 @@ void setup_and_solve_nlp(int NN,
     std::string const& cost_str,
     std::string const& qp_solver_str,
     std::string const& model_str,
-    std::string const& integrator_str
+    std::string const& integrator_str,
+    std::string const& globalization_str = "fixed_step"
     )
 {
     /************************************************
@@ -1410,6 +1411,8 @@ void setup_and_solve_nlp(int NN,
     ocp_nlp_solver_opts_set(config, nlp_opts, "tol_eq", &tol_eq);
     ocp_nlp_solver_opts_set(config, nlp_opts, "tol_ineq", &tol_ineq);
     ocp_nlp_solver_opts_set(config, nlp_opts, "tol_comp", &tol_comp);
+    ocp_nlp_solver_opts_set(config, nlp_opts, "globalization",
+                            (void *) globalization_str.c_str());
 
     /************************************************
     * ocp_nlp out
@@ -1636,3 +1639,21 @@ TEST_CASE("chain example", "[NLP solver]")
         }  // horizon lenght
     }
 }  // TEST_CASE
+
+
+
+/************************************************
+* TEST CASE: nonlinear chain, filter line search
+************************************************/
+
+TEST_CASE("chain example, filter line search", "[NLP solver]")
+{
+    for (int NMF : {2, 3})
+    {
+        SECTION("Number of masses: " + std::to_string(NMF))
+        {
+            setup_and_solve_nlp(20, NMF, "BOX", "MIXED", "SPARSE_HPIPM", "CONTINUOUS", "MIXED",
+                                "filter_line_search");
+        }
+    }
+}  // TEST_CASE
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#include "catch/include/catch.hpp"
+
+// std
+#include <stdlib.h>
+
+// acados
+#include "acados/ocp_nlp/ocp_nlp_globalization_filter.h"
+
+
+
+static ocp_nlp_filter_memory *create_filter(int max_size, void **raw_memory)
+{
+    *raw_memory = calloc(1, ocp_nlp_filter_memory_calculate_size(max_size));
+    return ocp_nlp_filter_memory_assign(max_size, *raw_memory);
+}
+
+
+
+TEST_CASE("filter acceptance", "[filter]")
+{
+    void *raw_memory;
+    ocp_nlp_filter_memory *filter = create_filter(4, &raw_memory);
+
+    // the empty filter accepts everything
+    REQUIRE(ocp_nlp_filter_is_acceptable(filter, 1e10, 1e10) == 1);
+
+    ocp_nlp_filter_add(filter, 1.0, 1.0);
+    REQUIRE(filter->size == 1);
+
+    // dominated: neither infeasibility nor objective improves
+    REQUIRE(ocp_nlp_filter_is_acceptable(filter, 1.0, 1.0) == 0);
+    REQUIRE(ocp_nlp_filter_is_acceptable(filter, 2.0, 1.5) == 0);
+    // acceptable: better in at least one of the two
+    REQUIRE(ocp_nlp_filter_is_acceptable(filter, 0.5, 2.0) == 1);
+    REQUIRE(ocp_nlp_filter_is_acceptable(filter, 2.0, 0.5) == 1);
+
+    ocp_nlp_filter_reset(filter);
+    REQUIRE(filter->size == 0);
+    REQUIRE(ocp_nlp_filter_is_acceptable(filter, 1.0, 1.0) == 1);
+
+    free(raw_memory);
+}
+
+
+
+TEST_CASE("filter dominance pruning", "[filter]")
+{
+    void *raw_memory;
+    ocp_nlp_filter_memory *filter = create_filter(4, &raw_memory);
+
+    ocp_nlp_filter_add(filter, 3.0, 1.0);
+    ocp_nlp_filter_add(filter, 2.0, 2.0);
+    ocp_nlp_filter_add(filter, 1.0, 3.0);
+    REQUIRE(filter->size == 3);
+
+    // dominates (2, 2) and (1, 3), but not (3, 1)
+    ocp_nlp_filter_add(filter, 1.0, 2.0);
+    REQUIRE(filter->size == 2);
+    for (int j = 0; j < filter->size; j++)
+    {
+        bool kept = (filter->theta[j] == 3.0 && filter->phi[j] == 1.0) ||
+                    (filter->theta[j] == 1.0 && filter->phi[j] == 2.0);
+        REQUIRE(kept);
+    }
+
+    REQUIRE(ocp_nlp_filter_is_acceptable(filter, 2.0, 2.0) == 0);
+    REQUIRE(ocp_nlp_filter_is_acceptable(filter, 0.5, 2.5) == 1);
+
+    free(raw_memory);
+}
+
+
+
+TEST_CASE("filter eviction when full", "[filter]")
+{
+    const int max_size = 3;
+    void *raw_memory;
+    ocp_nlp_filter_memory *filter = create_filter(max_size, &raw_memory);
+
+    // mutually non-dominated entries
+    ocp_nlp_filter_add(filter, 4.0, 1.0);
+    ocp_nlp_filter_add(filter, 3.0, 2.0);
+    ocp_nlp_filter_add(filter, 2.0, 3.0);
+    REQUIRE(filter->size == max_size);
+
+    // the entry with the largest infeasibility (4, 1) makes room for the new one
+    ocp_nlp_filter_add(filter, 1.0, 4.0);
+    REQUIRE(filter->size == max_size);
+    for (int j = 0; j < filter->size; j++)
+        REQUIRE(filter->theta[j] != 4.0);
+
+    bool found = false;
+    for (int j = 0; j < filter->size; j++)
+        found = found || (filter->theta[j] == 1.0 && filter->phi[j] == 4.0);
+    REQUIRE(found);
+
+    // the evicted entry no longer blocks points it dominated
+    REQUIRE(ocp_nlp_filter_is_acceptable(filter, 5.0, 1.5) == 1);
+
+    free(raw_memory);
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "catch/include/catch.hpp"
+
+// std
+#include <math.h>
+#include <stdlib.h>
+
+// blasfeo
+#include "blasfeo/include/blasfeo_d_aux.h"
+#include "blasfeo/include/blasfeo_d_aux_ext_dep.h"
+#include "blasfeo/include/blasfeo_d_blas.h"
+
+// acados
+#include "acados/ocp_nlp/ocp_nlp_reg_common.h"
+#include "acados/utils/math.h"
+
+#define EPSILON 1e-4
+
+
+
+// random symmetric matrix, column-major; graded: diagonal of very different magnitudes and small
+// off-diagonal entries, where a threshold relative to the diagonal would stop too early
+static void random_symmetric(int n, bool graded, double *A)
+{
+    for (int jj = 0; jj < n; jj++)
+    {
+        for (int ii = jj; ii < n; ii++)
+        {
+            double tmp = 2.0 * rand() / RAND_MAX - 1.0;
+            if (graded)
+                tmp *= ii == jj ? pow(10.0, 6 - (12 * ii) / n) : 1e-3;
+            A[ii + n * jj] = tmp;
+            A[jj + n * ii] = tmp;
+        }
+    }
+}
+
+
+
+TEST_CASE("Jacobi eigen decomposition", "[regularization]")
+{
+    std::vector<int> sizes = {1, 2, 3, 5, 8, 13, 24};
+
+    for (int graded = 0; graded < 2; graded++)
+    {
+        for (int n : sizes)
+        {
+            SECTION("n = " + std::to_string(n) + (graded ? ", graded" : ""))
+            {
+                srand(n);
+                std::vector<double> A0(n * n), A(n * n), V(n * n), d(n), d_dmat(n), e(n);
+                std::vector<double> work(acados_eigen_decomposition_dmat_work_size(n));
+                random_symmetric(n, graded, A0.data());
+
+                double norm = 0.0;
+                for (int ii = 0; ii < n * n; ii++)
+                    norm += A0[ii] * A0[ii];
+                norm = sqrt(norm);
+
+                struct blasfeo_dmat sA, sV;
+                blasfeo_allocate_dmat(n, n, &sA);
+                blasfeo_allocate_dmat(n, n, &sV);
+                blasfeo_pack_dmat(n, n, A0.data(), n, &sA, 0, 0);
+
+                int sweeps = acados_eigen_decomposition_dmat(n, &sA, 0, 0, &sV, 0, 0,
+                                                             d_dmat.data(), work.data());
+                REQUIRE(sweeps < 50);
+
+                double max_diff_A = 0.0;
+                double max_res = 0.0;
+                double max_orth = 0.0;
+                for (int jj = 0; jj < n; jj++)
+                {
+                    for (int ii = 0; ii < n; ii++)
+                    {
+                        // A is not modified
+                        max_diff_A = fmax(max_diff_A,
+                                          fabs(blasfeo_dgeex1(&sA, ii, jj) - A0[ii + n * jj]));
+                        // A = V * diag(d) * V', V' * V = I
+                        double a = 0.0;
+                        double o = 0.0;
+                        for (int kk = 0; kk < n; kk++)
+                        {
+                            a += blasfeo_dgeex1(&sV, ii, kk) * d_dmat[kk] *
+                                 blasfeo_dgeex1(&sV, jj, kk);
+                            o += blasfeo_dgeex1(&sV, kk, ii) * blasfeo_dgeex1(&sV, kk, jj);
+                        }
+                        max_res = fmax(max_res, fabs(a - A0[ii + n * jj]));
+                        max_orth = fmax(max_orth, fabs(o - (ii == jj ? 1.0 : 0.0)));
+                    }
+                }
+                REQUIRE(max_diff_A == 0.0);
+                REQUIRE(max_res <= 1e-12 * norm);
+                REQUIRE(max_orth <= 1e-12);
+
+                // same eigenvalues from the column-major version
+                A = A0;
+                acados_eigen_decomposition(n, A.data(), V.data(), d.data(), e.data());
+                std::sort(d.begin(), d.end());
+                std::sort(d_dmat.begin(), d_dmat.end());
+                for (int ii = 0; ii < n; ii++)
+                    REQUIRE(fabs(d[ii] - d_dmat[ii]) <= 1e-12 * norm);
+
+                blasfeo_free_dmat(&sA);
+                blasfeo_free_dmat(&sV);
+            }
+        }
+    }
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("projecting regularization", "[regularization]")
+{
+    std::vector<int> sizes = {1, 4, 7, 16};
+
+    for (int n : sizes)
+    {
+        SECTION("n = " + std::to_string(n))
+        {
+            srand(n);
+            std::vector<double> A0(n * n), A(n * n), V(n * n), d(n), e(n);
+            std::vector<double> work(acados_eigen_decomposition_dmat_work_size(n));
+            random_symmetric(n, false, A0.data());
+
+            struct blasfeo_dmat sA, sV, sW;
+            blasfeo_allocate_dmat(n, n, &sA);
+            blasfeo_allocate_dmat(n, n, &sV);
+            blasfeo_allocate_dmat(n, n, &sW);
+            blasfeo_pack_dmat(n, n, A0.data(), n, &sA, 0, 0);
+
+            A = A0;
+            acados_project(n, A.data(), V.data(), d.data(), e.data(), EPSILON);
+            acados_project_dmat(n, &sA, 0, 0, &sV, &sW, d.data(), work.data(), EPSILON);
+
+            // both versions give the same matrix
+            double max_diff = 0.0;
+            for (int jj = 0; jj < n; jj++)
+                for (int ii = 0; ii < n; ii++)
+                    max_diff = fmax(max_diff, fabs(blasfeo_dgeex1(&sA, ii, jj) - A[ii + n * jj]));
+            REQUIRE(max_diff <= 1e-12);
+
+            // all eigenvalues of the result are at least EPSILON
+            acados_eigen_decomposition(n, A.data(), V.data(), d.data(), e.data());
+            for (int ii = 0; ii < n; ii++)
+                REQUIRE(d[ii] >= EPSILON * (1.0 - 1e-8));
+
+            blasfeo_free_dmat(&sA);
+            blasfeo_free_dmat(&sV);
+            blasfeo_free_dmat(&sW);
+        }
+    }
+}  // END_TEST_CASE
@@ -264,7 +264,12 @@ void ext_fun_h1(void *fun, ext_fun_arg_t *type_in, void **in, ext_fun_arg_t *typ
 
 
 
-void setup_and_solve_nlp(std::string const& integrator_str, std::string const& qp_solver_str)
+// soc_qp_hot_start >= 0: merit backtracking with second order correction, SOC QPs solved with the
+// given soc_qp_hot_start; the residuals and step sizes of all SQP iterations and the solutions are
+// appended to iterates, the QP iterations spent on SOC QPs are summed up in qp_iter_soc
+void setup_and_solve_nlp(std::string const& integrator_str, std::string const& qp_solver_str,
+                         int soc_qp_hot_start = -1, std::vector<double> *iterates = NULL,
+                         int *qp_iter_soc = NULL)
 {
     // _MM_SET_EXCEPTION_MASK(_MM_GET_EXCEPTION_MASK() & ~_MM_MASK_INVALID);
     int nx_ = 8;
@@ -962,6 +967,14 @@ void setup_and_solve_nlp(std::string const& integrator_str, std::string const& q
     ocp_nlp_solver_opts_set(config, nlp_opts, "tol_ineq", &tol_ineq);
     ocp_nlp_solver_opts_set(config, nlp_opts, "tol_comp", &tol_comp);
 
+    if (soc_qp_hot_start >= 0)
+    {
+        int use_SOC = 1;
+        ocp_nlp_solver_opts_set(config, nlp_opts, "globalization", (void *) "merit_backtracking");
+        ocp_nlp_solver_opts_set(config, nlp_opts, "globalization_use_SOC", &use_SOC);
+        ocp_nlp_solver_opts_set(config, nlp_opts, "soc_qp_hot_start", &soc_qp_hot_start);
+    }
+
 
     // partial condensing
     if (plan->ocp_qp_solver_plan.qp_solver == PARTIAL_CONDENSING_HPIPM)
@@ -1080,6 +1093,31 @@ void setup_and_solve_nlp(std::string const& integrator_str, std::string const& q
         printf("\nproblem #%d, status %d, iters %d, time (total %f, lin %f, qp_sol %f) ms\n",
             idx, status, sqp_iter, time_tot*1e3, time_lin*1e3, time_qp_sol*1e3);
 
+        if (iterates != NULL)
+        {
+            double *stat;
+            int stat_n, qp_iter_soc_idx;
+            ocp_nlp_get(config, solver, "stat", &stat);
+            ocp_nlp_get(config, solver, "stat_n", &stat_n);
+            ocp_nlp_get(config, solver, "qp_iter_soc", &qp_iter_soc_idx);
+            *qp_iter_soc += qp_iter_soc_idx;
+
+            // residuals of every iterate and step sizes, not the QP iterations
+            iterates->push_back(sqp_iter);
+            for (int ii = 0; ii <= sqp_iter; ii++)
+            {
+                for (int jj = 0; jj < 4; jj++)
+                    iterates->push_back(stat[ii*stat_n+jj]);
+                if (ii > 0)
+                    iterates->push_back(stat[ii*stat_n+6]);
+            }
+            for (int ii = 0; ii <= NN; ii++)
+            {
+                for (int jj = 0; jj < nu[ii]+nx[ii]; jj++)
+                    iterates->push_back(BLASFEO_DVECEL(nlp_out->ux+ii, jj));
+            }
+        }
+
         // TODO(oj): rather simulate then take x from SQP solution
         printf("xsim = \n");
         ocp_nlp_out_get(config, dims, nlp_out, 0, "x", x_end);
@@ -1231,3 +1269,37 @@ TEST_CASE("wind turbine nmpc", "[NLP solver]")
         }
     }
 }
+
+
+
+/************************************************
+* TEST CASE: wind turbine, SOC QP hot start
+************************************************/
+
+TEST_CASE("wind turbine nmpc, SOC QP hot start", "[NLP solver]")
+{
+    // the hot started SOC QP solution satisfies the QP solver tolerances, the SQP iterates have
+    // to be the same as with the SOC QPs solved by the IPM, with fewer QP iterations
+    std::vector<double> iterates[2];
+    int qp_iter_soc[2] = {0, 0};
+
+    for (int soc_qp_hot_start = 0; soc_qp_hot_start < 2; soc_qp_hot_start++)
+    {
+        setup_and_solve_nlp("ERK", "SPARSE_HPIPM", soc_qp_hot_start, &iterates[soc_qp_hot_start],
+                            &qp_iter_soc[soc_qp_hot_start]);
+    }
+
+    double max_diff = 0.0;
+    REQUIRE(iterates[0].size() == iterates[1].size());
+    for (size_t ii = 0; ii < iterates[0].size(); ii++)
+    {
+        double diff = fabs(iterates[1][ii] - iterates[0][ii]) / (1.0 + fabs(iterates[0][ii]));
+        max_diff = diff > max_diff ? diff : max_diff;
+    }
+    printf("\nSOC QP iterations: %d (IPM), %d (hot start), max rel diff of the iterates %e\n",
+           qp_iter_soc[0], qp_iter_soc[1], max_diff);
+
+    REQUIRE(max_diff <= 1e-6);
+    REQUIRE(qp_iter_soc[0] > 0);
+    REQUIRE(qp_iter_soc[1] < qp_iter_soc[0]);
+}
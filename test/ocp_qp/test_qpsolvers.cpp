@@ -32,6 +32,7 @@
  */
 
 
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -261,3 +262,381 @@ TEST_CASE("mass spring example", "[QP solvers]")
     }  // END_FOR_SOLVERS
 
 }  // END_TEST_CASE
+
+
+
+// max abs difference of the primal solutions of two qp_out
+static double max_diff_ux(ocp_qp_dims *dims, ocp_qp_out *qp_out_a, ocp_qp_out *qp_out_b)
+{
+    double max_diff = 0.0;
+
+    for (int ii = 0; ii <= dims->N; ii++)
+    {
+        for (int jj = 0; jj < dims->nx[ii] + dims->nu[ii] + 2 * dims->ns[ii]; jj++)
+        {
+            double diff = BLASFEO_DVECEL(qp_out_a->ux + ii, jj)
+                          - BLASFEO_DVECEL(qp_out_b->ux + ii, jj);
+            max_diff = (diff > max_diff) ? diff : (-diff > max_diff) ? -diff : max_diff;
+        }
+    }
+
+    return max_diff;
+}
+
+
+
+TEST_CASE("partitioned Riccati vs HPIPM", "[QP solvers]")
+{
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 0;
+
+    ocp_qp_solver_plan_t plan;
+
+    // reference solution: HPIPM, not condensed
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims =
+        create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+    ocp_qp_out *qp_out_ref = ocp_qp_out_create(qp_dims->orig_dims);
+
+    ocp_qp_xcond_solver_opts *opts =
+        (ocp_qp_xcond_solver_opts *) ocp_qp_xcond_solver_opts_create(config, qp_dims);
+    ocp_qp_xcond_solver_opts_set(config, opts, "cond_N", &N);
+    ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+    REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out_ref) == 0);
+    free(qp_solver);
+    free(opts);
+
+    plan.qp_solver = PARTIAL_CONDENSING_PRIC;
+    ocp_qp_xcond_solver_config *config_pric = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+
+    // one chunk is the plain Riccati recursion, more chunks exercise the coupling
+    for (int num_threads : {1, 2, 4})
+    {
+        SECTION("num_threads = " + std::to_string(num_threads))
+        {
+            opts = (ocp_qp_xcond_solver_opts *) ocp_qp_xcond_solver_opts_create(config_pric,
+                                                                                qp_dims);
+            ocp_qp_xcond_solver_opts_set(config_pric, opts, "cond_N", &N);
+            ocp_qp_xcond_solver_opts_set(config_pric, opts, "num_threads", &num_threads);
+            double tol_stat = 1e-8;
+            ocp_qp_xcond_solver_opts_set(config_pric, opts, "tol_stat", &tol_stat);
+            qp_solver = ocp_qp_create(config_pric, qp_dims, opts);
+
+            REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+
+            double res[4];
+            ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out, res);
+            printf("\nPRIC (num_threads = %d) inf norm res: %e, %e, %e, %e\n", num_threads,
+                   res[0], res[1], res[2], res[3]);
+
+            REQUIRE(max_diff_ux(qp_dims->orig_dims, qp_out, qp_out_ref) <= 1e-6);
+
+            free(qp_solver);
+            free(opts);
+        }
+    }
+
+    free(qp_out);
+    free(qp_out_ref);
+    free(qp_in);
+    free(qp_dims);
+    free(config_pric);
+    free(config);
+}
+
+
+
+TEST_CASE("full condensing, block-column vs HPIPM condensing", "[QP solvers]")
+{
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;  // state bounds become general constraints of the dense qp
+    int ng_ = 0;
+    int ngN = 0;
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = FULL_CONDENSING_HPIPM;
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims =
+        create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+    ocp_qp_out *qp_out_ref = ocp_qp_out_create(qp_dims->orig_dims);
+    ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+
+    // reference solution: HPIPM condensing (cond_num_threads = 0)
+    void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+    ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+    REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out_ref) == 0);
+    free(qp_solver);
+    free(opts);
+
+    // one thread, and more threads than column groups of the dense qp
+    for (int num_threads : {1, 2, 4, 32})
+    {
+        SECTION("cond_num_threads = " + std::to_string(num_threads))
+        {
+            opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+            ocp_qp_xcond_solver_opts_set(config, (ocp_qp_xcond_solver_opts *) opts,
+                                         "cond_num_threads", &num_threads);
+            qp_solver = ocp_qp_create(config, qp_dims, opts);
+
+            // twice: the second condensing overwrites the dense qp of the first
+            for (int rep = 0; rep < 2; rep++)
+            {
+                REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+
+                double res[4];
+                ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out, res);
+                printf("\nblock-column condensing (cond_num_threads = %d) inf norm res: "
+                       "%e, %e, %e, %e\n", num_threads, res[0], res[1], res[2], res[3]);
+                for (int ii = 0; ii < 4; ii++)
+                    REQUIRE(res[ii] <= 1e-8);
+
+                REQUIRE(max_diff_ux(qp_dims->orig_dims, qp_out, qp_out_ref) <= 1e-8);
+            }
+
+            free(qp_solver);
+            free(opts);
+        }
+    }
+
+    free(qp_out);
+    free(qp_out_ref);
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+}
+
+
+
+#ifdef ACADOS_WITH_OSQP
+TEST_CASE("OSQP partial update on a sequence of changed QPs", "[QP solvers]")
+{
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 0;
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_OSQP;
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims =
+        create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+
+    // solver 0 passes the full P and A on every call, solver 1 only the changed entries
+    ocp_qp_solver *qp_solver[2];
+    ocp_qp_out *qp_out[2];
+    void *opts[2];
+    for (int ii = 0; ii < 2; ii++)
+    {
+        int partial_update = ii;
+        opts[ii] = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+        ocp_qp_xcond_solver_opts_set(config, (ocp_qp_xcond_solver_opts *) opts[ii], "cond_N", &N);
+        ocp_qp_xcond_solver_opts_set(config, (ocp_qp_xcond_solver_opts *) opts[ii],
+                                     "partial_update", &partial_update);
+        qp_solver[ii] = ocp_qp_create(config, qp_dims, opts[ii]);
+        qp_out[ii] = ocp_qp_out_create(qp_dims->orig_dims);
+    }
+
+    // 0: first QP, 1: new vectors only, 2: one Hessian entry, 3: one dynamics entry, 4: unchanged
+    int new_factorization[] = {1, 0, 1, 1, 0};
+    int num_fact_prev = 0;
+    for (int qp_idx = 0; qp_idx < 5; qp_idx++)
+    {
+        if (qp_idx == 1)
+        {
+            BLASFEO_DVECEL(qp_in->rqz+4, 0) += 0.5;
+            BLASFEO_DVECEL(qp_in->b+2, 1) -= 0.1;
+        }
+        else if (qp_idx == 2)
+        {
+            BLASFEO_DMATEL(qp_in->RSQrq+7, nu_, nu_) += 0.5;
+        }
+        else if (qp_idx == 3)
+        {
+            BLASFEO_DMATEL(qp_in->BAbt+3, 0, 1) *= 1.1;
+        }
+
+        for (int ii = 0; ii < 2; ii++)
+        {
+            REQUIRE(ocp_qp_solve(qp_solver[ii], qp_in, qp_out[ii]) == 0);
+
+            double res[4];
+            ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out[ii], res);
+            for (int jj = 0; jj < 4; jj++)
+                REQUIRE(res[jj] <= solver_tolerance("SPARSE_OSQP"));
+        }
+        printf("\nOSQP QP %d: max diff ux partial vs full update %e\n", qp_idx,
+               max_diff_ux(qp_dims->orig_dims, qp_out[1], qp_out[0]));
+        REQUIRE(max_diff_ux(qp_dims->orig_dims, qp_out[1], qp_out[0]) <= 1e-6);
+
+        // the full update refactorizes on every call, the partial one only if P or A changed
+        int num_fact[2];
+        for (int ii = 0; ii < 2; ii++)
+            config->memory_get(config, qp_solver[ii]->mem, "num_factorizations", &num_fact[ii]);
+        REQUIRE(num_fact[0] == qp_idx + 1);
+        REQUIRE(num_fact[1] == num_fact_prev + new_factorization[qp_idx]);
+        num_fact_prev = num_fact[1];
+    }
+
+    for (int ii = 0; ii < 2; ii++)
+    {
+        free(qp_solver[ii]);
+        free(qp_out[ii]);
+        free(opts[ii]);
+    }
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+}
+#endif
+
+
+
+// max abs difference of the data of two qps with the same dimensions (lower triangle of RSQrq)
+static double max_diff_qp_in(ocp_qp_in *qp_a, ocp_qp_in *qp_b)
+{
+    ocp_qp_dims *dims = qp_a->dim;
+    double max_diff = 0.0;
+    double diff;
+
+    for (int ii = 0; ii <= dims->N; ii++)
+    {
+        int nv = dims->nu[ii] + dims->nx[ii];
+        int ng = dims->ng[ii];
+        int nd = 2 * dims->nb[ii] + 2 * dims->ng[ii] + 2 * dims->ns[ii];
+
+        for (int jj = 0; jj < nv; jj++)
+        {
+            for (int kk = 0; kk <= jj; kk++)
+            {
+                diff = fabs(BLASFEO_DMATEL(qp_a->RSQrq + ii, jj, kk)
+                            - BLASFEO_DMATEL(qp_b->RSQrq + ii, jj, kk));
+                max_diff = diff > max_diff ? diff : max_diff;
+            }
+            for (int kk = 0; kk < ng; kk++)
+            {
+                diff = fabs(BLASFEO_DMATEL(qp_a->DCt + ii, jj, kk)
+                            - BLASFEO_DMATEL(qp_b->DCt + ii, jj, kk));
+                max_diff = diff > max_diff ? diff : max_diff;
+            }
+            if (ii < dims->N)
+            {
+                for (int kk = 0; kk < dims->nx[ii + 1]; kk++)
+                {
+                    diff = fabs(BLASFEO_DMATEL(qp_a->BAbt + ii, jj, kk)
+                                - BLASFEO_DMATEL(qp_b->BAbt + ii, jj, kk));
+                    max_diff = diff > max_diff ? diff : max_diff;
+                }
+            }
+            diff = fabs(BLASFEO_DVECEL(qp_a->rqz + ii, jj) - BLASFEO_DVECEL(qp_b->rqz + ii, jj));
+            max_diff = diff > max_diff ? diff : max_diff;
+        }
+        if (ii < dims->N)
+        {
+            for (int jj = 0; jj < dims->nx[ii + 1]; jj++)
+            {
+                diff = fabs(BLASFEO_DVECEL(qp_a->b + ii, jj) - BLASFEO_DVECEL(qp_b->b + ii, jj));
+                max_diff = diff > max_diff ? diff : max_diff;
+            }
+        }
+        for (int jj = 0; jj < nd; jj++)
+        {
+            diff = fabs(BLASFEO_DVECEL(qp_a->d + ii, jj) - BLASFEO_DVECEL(qp_b->d + ii, jj));
+            max_diff = diff > max_diff ? diff : max_diff;
+        }
+    }
+
+    return max_diff;
+}
+
+
+
+TEST_CASE("incremental partial condensing vs full recondensing", "[QP solvers]")
+{
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 0;
+    int N2 = 5;  // blocks of 3 stages
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims =
+        create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+
+    // solver 0 recondenses all blocks on every call, solver 1 only the changed ones
+    ocp_qp_solver *qp_solver[2];
+    ocp_qp_out *qp_out[2];
+    void *opts[2];
+    for (int ii = 0; ii < 2; ii++)
+    {
+        int incremental = ii;
+        opts[ii] = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+        ocp_qp_xcond_solver_opts_set(config, (ocp_qp_xcond_solver_opts *) opts[ii], "cond_N", &N2);
+        ocp_qp_xcond_solver_opts_set(config, (ocp_qp_xcond_solver_opts *) opts[ii],
+                                     "cond_incremental", &incremental);
+        qp_solver[ii] = ocp_qp_create(config, qp_dims, opts[ii]);
+        qp_out[ii] = ocp_qp_out_create(qp_dims->orig_dims);
+    }
+
+    // 0: first QP, 1: one Hessian entry of stage 7, 2: gradient only, 3: dynamics of stage 14
+    int recond_blocks[] = {N2 + 1, 1, 0, 1};
+    for (int qp_idx = 0; qp_idx < 4; qp_idx++)
+    {
+        if (qp_idx == 1)
+            BLASFEO_DMATEL(qp_in->RSQrq + 7, nu_, nu_) += 0.5;
+        else if (qp_idx == 2)
+            BLASFEO_DVECEL(qp_in->rqz + 10, 0) += 0.5;
+        else if (qp_idx == 3)
+            BLASFEO_DMATEL(qp_in->BAbt + 14, 0, 1) *= 1.1;
+
+        int num_recond_blocks[2];
+        for (int ii = 0; ii < 2; ii++)
+        {
+            REQUIRE(ocp_qp_solve(qp_solver[ii], qp_in, qp_out[ii]) == 0);
+            config->memory_get(config, qp_solver[ii]->mem, "num_recond_blocks",
+                               &num_recond_blocks[ii]);
+        }
+
+        ocp_qp_in *pcond_qp_in[2];
+        for (int ii = 0; ii < 2; ii++)
+            pcond_qp_in[ii] =
+                (ocp_qp_in *) ((ocp_qp_xcond_solver_memory *) qp_solver[ii]->mem)->xcond_qp_in;
+        double diff_qp = max_diff_qp_in(pcond_qp_in[1], pcond_qp_in[0]);
+        double diff_sol = max_diff_ux(qp_dims->orig_dims, qp_out[1], qp_out[0]);
+        printf("\npartial condensing QP %d: recondensed blocks %d (full %d), max diff qp %e, "
+               "max diff ux %e\n", qp_idx, num_recond_blocks[1], num_recond_blocks[0], diff_qp,
+               diff_sol);
+
+        REQUIRE(num_recond_blocks[0] == N2 + 1);
+        REQUIRE(num_recond_blocks[1] == recond_blocks[qp_idx]);
+        REQUIRE(diff_qp <= 1e-10);
+        REQUIRE(diff_sol <= 1e-8);
+    }
+
+    for (int ii = 0; ii < 2; ii++)
+    {
+        free(qp_solver[ii]);
+        free(qp_out[ii]);
+        free(opts[ii]);
+    }
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+}
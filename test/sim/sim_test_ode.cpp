@@ -38,6 +38,7 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -604,3 +605,141 @@ TEST_CASE("wt_nx3_example", "[integrators]")
     external_function_casadi_free(&get_matrices_fun);
 
 }  // END_TEST_CASE
+
+
+
+TEST_CASE("wt_nx3_erk_interleaved", "[integrators]")
+{
+    // ERK_INTERLEAVED has to reproduce ERK on every problem of the batch;
+    // n_batch > SIM_ERK_INTERLEAVED_MAX also covers the chunking
+    const int nx = 3;
+    const int nu = 4;
+    const int NF = nx + nu;
+    const int n_batch = 11;
+
+    double T = 0.05;
+    double tol = 1e-12;
+
+    external_function_casadi expl_ode_fun;
+    expl_ode_fun.casadi_fun = &casadi_expl_ode_fun;
+    expl_ode_fun.casadi_work = &casadi_expl_ode_fun_work;
+    expl_ode_fun.casadi_sparsity_in = &casadi_expl_ode_fun_sparsity_in;
+    expl_ode_fun.casadi_sparsity_out = &casadi_expl_ode_fun_sparsity_out;
+    expl_ode_fun.casadi_n_in = &casadi_expl_ode_fun_n_in;
+    expl_ode_fun.casadi_n_out = &casadi_expl_ode_fun_n_out;
+    external_function_casadi_create(&expl_ode_fun);
+
+    external_function_casadi expl_vde_for;
+    expl_vde_for.casadi_fun = &casadi_expl_vde_for;
+    expl_vde_for.casadi_work = &casadi_expl_vde_for_work;
+    expl_vde_for.casadi_sparsity_in = &casadi_expl_vde_for_sparsity_in;
+    expl_vde_for.casadi_sparsity_out = &casadi_expl_vde_for_sparsity_out;
+    expl_vde_for.casadi_n_in = &casadi_expl_vde_for_n_in;
+    expl_vde_for.casadi_n_out = &casadi_expl_vde_for_n_out;
+    external_function_casadi_create(&expl_vde_for);
+
+    sim_solver_t plans[2] = {ERK, ERK_INTERLEAVED};
+    sim_config *config[2];
+    void *dims[2];
+    sim_opts *opts[2];
+    sim_solver *solver[2][n_batch];
+    sim_in *in[2][n_batch];
+    sim_out *out[2][n_batch];
+
+    for (int k = 0; k < 2; k++)
+    {
+        sim_solver_plan_t plan;
+        plan.sim_solver = plans[k];
+        config[k] = sim_config_create(plan);
+
+        dims[k] = sim_dims_create(config[k]);
+        sim_dims_set(config[k], dims[k], "nx", &nx);
+        sim_dims_set(config[k], dims[k], "nu", &nu);
+
+        opts[k] = (sim_opts *) sim_opts_create(config[k], dims[k]);
+        opts[k]->sens_forw = true;
+        opts[k]->sens_adj = false;
+        opts[k]->ns = 4;
+        opts[k]->num_steps = 3;
+
+        for (int b = 0; b < n_batch; b++)
+        {
+            in[k][b] = sim_in_create(config[k], dims[k]);
+            out[k][b] = sim_out_create(config[k], dims[k]);
+            in[k][b]->T = T;
+
+            sim_in_set(config[k], dims[k], in[k][b], "expl_ode_fun", &expl_ode_fun);
+            sim_in_set(config[k], dims[k], in[k][b], "expl_vde_for", &expl_vde_for);
+
+            // seeds forw
+            for (int ii = 0; ii < nx * NF; ii++)
+                in[k][b]->S_forw[ii] = 0.0;
+            for (int ii = 0; ii < nx; ii++)
+                in[k][b]->S_forw[ii * (nx + 1)] = 1.0;
+            in[k][b]->identity_seed = true;
+
+            // a different point per problem
+            for (int ii = 0; ii < nx; ii++)
+                in[k][b]->x[ii] = x0[ii] * (1.0 + 0.01 * b);
+            for (int ii = 0; ii < nu; ii++)
+                in[k][b]->u[ii] = u_sim[b * nu + ii];
+
+            solver[k][b] = sim_solver_create(config[k], dims[k], opts[k]);
+        }
+    }
+
+    // reference: one ERK call per problem
+    for (int b = 0; b < n_batch; b++)
+        REQUIRE(sim_solve(solver[0][b], in[0][b], out[0][b]) == 0);
+
+    // interleaved: one batched call
+    sim_in *b_in[n_batch];
+    sim_out *b_out[n_batch];
+    void *b_opts[n_batch];
+    void *b_mem[n_batch];
+    void *b_work[n_batch];
+    for (int b = 0; b < n_batch; b++)
+    {
+        b_in[b] = in[1][b];
+        b_out[b] = out[1][b];
+        b_opts[b] = solver[1][b]->opts;
+        b_mem[b] = solver[1][b]->mem;
+        b_work[b] = solver[1][b]->work;
+    }
+    REQUIRE(config[1]->evaluate_batch != NULL);
+    REQUIRE(config[1]->evaluate_batch(config[1], b_in, b_out, b_opts, b_mem, b_work,
+                                      n_batch) == 0);
+
+    for (int b = 0; b < n_batch; b++)
+    {
+        double max_error = 0.0;
+        for (int ii = 0; ii < nx; ii++)
+            max_error = std::max(max_error, fabs(out[1][b]->xn[ii] - out[0][b]->xn[ii]));
+
+        double max_error_forw = 0.0;
+        for (int ii = 0; ii < nx * NF; ii++)
+            max_error_forw = std::max(max_error_forw,
+                                      fabs(out[1][b]->S_forw[ii] - out[0][b]->S_forw[ii]));
+
+        std::cout << "ERK_INTERLEAVED problem " << b << ": error xn " << max_error
+                  << ", error S_forw " << max_error_forw << std::endl;
+        REQUIRE(max_error <= tol);
+        REQUIRE(max_error_forw <= tol);
+    }
+
+    for (int k = 0; k < 2; k++)
+    {
+        for (int b = 0; b < n_batch; b++)
+        {
+            sim_solver_destroy(solver[k][b]);
+            sim_in_destroy(in[k][b]);
+            sim_out_destroy(out[k][b]);
+        }
+        sim_opts_destroy(opts[k]);
+        sim_dims_destroy(dims[k]);
+        sim_config_destroy(config[k]);
+    }
+
+    external_function_casadi_free(&expl_ode_fun);
+    external_function_casadi_free(&expl_vde_for);
+}  // END_TEST_CASE